@@ -0,0 +1,146 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Point Cloud Export Sample
+// This sample demonstrates how to export every depth frame of a recorded file to a point cloud file.
+// The vertices and the uvmap are calculated by the projection module, and the point clouds are written in binary
+// PLY or PCD format by the point cloud writer worker threads, while the main thread reads the next frames.
+
+#include <memory>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <librealsense/rs.hpp>
+#include "rs_sdk.h"
+#include "unistd.h"
+
+using namespace rs::core;
+using namespace rs::utils;
+using namespace std;
+
+int main(int argc, char* argv[]) try
+{
+    if (argc < 3)
+    {
+        cerr << "usage: " << argv[0] << " <playback file> <output directory> [ply|pcd] [workers count]" << endl;
+        return -1;
+    }
+    if (access(argv[1], F_OK) == -1)
+    {
+        cerr << "playback file does not exists" << endl;
+        return -1;
+    }
+    const string input_file(argv[1]);
+    const string output_directory(argv[2]);
+    const bool is_pcd = argc > 3 && string(argv[3]) == "pcd";
+    const uint32_t workers_count = argc > 4 ? static_cast<uint32_t>(stoi(argv[4])) : 0;
+
+    rs::playback::context context(input_file.c_str());
+    if(context.get_device_count() == 0)
+    {
+        cerr << "failed to open playback file" << endl;
+        return -1;
+    }
+    rs::playback::device* device = context.get_playback_device();
+
+    if(device->get_stream_mode_count(rs::stream::depth) == 0)
+    {
+        cerr << "depth stream is not available in the playback file" << endl;
+        return -1;
+    }
+    const bool has_color = device->get_stream_mode_count(rs::stream::color) > 0;
+
+    //enable the recorded depth and color streams
+    vector<rs::stream> streams = { rs::stream::depth };
+    if(has_color)
+        streams.push_back(rs::stream::color);
+    for(auto stream : streams)
+    {
+        int width, height, fps;
+        rs::format format;
+        device->get_stream_mode(stream, 0, width, height, format, fps);
+        device->enable_stream(stream, width, height, format, fps);
+    }
+
+    //read the frames as fast as possible, without dropping frames
+    device->set_real_time(false);
+
+    intrinsics depth_intrin = convert_intrinsics(device->get_stream_intrinsics(rs::stream::depth));
+    intrinsics color_intrin = has_color ? convert_intrinsics(device->get_stream_intrinsics(rs::stream::color)) : depth_intrin;
+    extrinsics extrin = has_color ? convert_extrinsics(device->get_extrinsics(rs::stream::depth, rs::stream::color)) : extrinsics{};
+    auto projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&color_intrin, &depth_intrin, &extrin));
+
+    auto writer = get_unique_ptr_with_releaser(point_cloud_writer_interface::create_instance(is_pcd ? point_cloud_format::pcd : point_cloud_format::ply,
+                                                                                            workers_count));
+
+    const sizeI32 depth_size = { depth_intrin.width, depth_intrin.height };
+    vector<point3dF32> vertices(depth_size.width * depth_size.height);
+    vector<pointF32> uvmap(has_color ? vertices.size() : 0);
+
+    device->start();
+    auto start_time = chrono::steady_clock::now();
+    int frame_index = 0;
+    while(device->is_streaming())
+    {
+        device->wait_for_frames();
+
+        image_info depth_info = { depth_size.width, depth_size.height,
+                                  convert_pixel_format(device->get_stream_format(rs::stream::depth)),
+                                  depth_size.width * static_cast<int32_t>(sizeof(uint16_t)) };
+        auto depth_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depth_info,
+                                                                                                      {device->get_frame_data(rs::stream::depth), nullptr},
+                                                                                                      stream_type::depth,
+                                                                                                      image_interface::flag::any,
+                                                                                                      device->get_frame_timestamp(rs::stream::depth),
+                                                                                                      device->get_frame_number(rs::stream::depth)));
+        if(projection->query_vertices(depth_image.get(), vertices.data()) < status_no_error)
+        {
+            cerr << "failed to query vertices of frame " << frame_index << endl;
+            continue;
+        }
+
+        unique_ptr<image_interface, void(*)(image_interface*)> color_image(nullptr, [](image_interface* image) { if(image) image->release(); });
+        if(has_color)
+        {
+            const rs::format color_format = device->get_stream_format(rs::stream::color);
+            image_info color_info = { color_intrin.width, color_intrin.height, convert_pixel_format(color_format),
+                                      color_intrin.width * get_pixel_size(convert_pixel_format(color_format)) };
+            color_image.reset(image_interface::create_instance_from_raw_data(&color_info,
+                                                                             {device->get_frame_data(rs::stream::color), nullptr},
+                                                                             stream_type::color,
+                                                                             image_interface::flag::any,
+                                                                             device->get_frame_timestamp(rs::stream::color),
+                                                                             device->get_frame_number(rs::stream::color)));
+            if(projection->query_uvmap(depth_image.get(), uvmap.data()) < status_no_error)
+                color_image.reset();
+        }
+
+        //the writer copies the frame, the device buffers and the vertices can be reused right away
+        point_cloud_frame frame = { vertices.data(), depth_size, color_image.get(), color_image ? uvmap.data() : nullptr };
+        stringstream file_path;
+        file_path << output_directory << "/frame_" << frame_index << (is_pcd ? ".pcd" : ".ply");
+        if(writer->write_async(file_path.str().c_str(), frame) < status_no_error)
+            cerr << "failed to queue frame " << frame_index << endl;
+        frame_index++;
+    }
+    device->stop();
+
+    if(writer->flush() < status_no_error)
+        cerr << "some point clouds failed to be written" << endl;
+    const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+
+    auto stats = writer->query_statistics();
+    cout << "exported " << stats.frames_written << " point clouds, " << stats.points_written << " points, "
+         << stats.bytes_written / (1024 * 1024) << " MB" << endl;
+    cout << "writer throughput: " << stats.frames_per_second << " frames/s, end to end: "
+         << (seconds > 0 ? stats.frames_written / seconds : 0) << " frames/s" << endl;
+    return 0;
+}
+
+catch(rs::error e)
+{
+    std::cout << e.what() << std::endl;
+    return -1;
+}
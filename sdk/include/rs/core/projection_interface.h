@@ -221,6 +221,58 @@ namespace rs
             */
             virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color) = 0;
 
+            /**
+            * @brief Retrieves UV map for a region of interest of a specific depth image.
+            *
+            * Computes only the UV map pixels inside the region of interest, at a cost proportional to the region area.
+            * The values are identical to the \c query_uvmap values of the same pixels.
+            * @param[in]  depth                  Depth image instance
+            * @param[in]  roi                    Region of interest, in depth image coordinates. Must be inside of the depth image.
+            * @param[out] uvmap                  UV map, to be returned. A \c roi.width*roi.height array if \c full_frame_output is false,
+            *                                    otherwise a depth size \c width*height array where only the region of interest is written.
+            * @param[in]  full_frame_output      Selects the layout of the \c uvmap array
+            * @return status_no_error            Successful execution
+            * @return status_handle_invalid      Invalid depth image or uvmap array passed as parameter
+            * @return status_param_unsupported   Region of interest is empty or outside of the depth image
+            * @return status_data_unavailable    Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_uvmap_roi(image_interface *depth, rect roi, pointF32 *uvmap, bool full_frame_output) = 0;
+
+            /**
+            * @brief Retrieves Inversed UV map for a region of interest of the color image.
+            *
+            * Computes only the Inversed UV map pixels inside the color region of interest. The values are identical to the
+            * \c query_invuvmap values of the same pixels. The UV map of the whole depth image is still required, since any
+            * depth pixel can be mapped into the region, but the inversion cost is proportional to the region area.
+            * @param[in]  depth                  Depth image instance
+            * @param[in]  roi                    Region of interest, in color image coordinates. Must be inside of the color image.
+            * @param[out] inv_uvmap              Inversed UV Map, to be returned. A \c roi.width*roi.height array if \c full_frame_output is false,
+            *                                    otherwise a color size \c width*height array where only the region of interest is written.
+            * @param[in]  full_frame_output      Selects the layout of the \c inv_uvmap array
+            * @return status_no_error            Successful execution
+            * @return status_handle_invalid      Invalid depth image or invuvmap array passed as parameter
+            * @return status_param_unsupported   Region of interest is empty or outside of the color image
+            * @return status_data_unavailable    Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_invuvmap_roi(image_interface *depth, rect roi, pointF32 *inv_uvmap, bool full_frame_output) = 0;
+
+            /**
+            * @brief Retrieves 3D points for a region of interest of a specific depth image, with units in millimeters.
+            *
+            * Computes only the vertices inside the region of interest, at a cost proportional to the region area.
+            * The values are identical to the \c query_vertices values of the same pixels.
+            * @param[in]  depth                   Depth image instance
+            * @param[in]  roi                     Region of interest, in depth image coordinates. Must be inside of the depth image.
+            * @param[out] vertices                3D vertices, to be returned. A \c roi.width*roi.height array if \c full_frame_output is false,
+            *                                     otherwise a depth size \c width*height array where only the region of interest is written.
+            * @param[in]  full_frame_output       Selects the layout of the \c vertices array
+            * @return status_no_error             Successful execution
+            * @return status_handle_invalid       Invalid depth image or vertices array passed as parameter
+            * @return status_param_unsupported    Region of interest is empty or outside of the depth image
+            * @return status_data_unavailable     Incorrect depth or color data passed in projection initialization
+            */
+            virtual status query_vertices_roi(image_interface *depth, rect roi, point3dF32 *vertices, bool full_frame_output) = 0;
+
 
              /**
              * @brief Creates an instance and initializes, based on intrinsic and extrinsic parameters.
@@ -10,6 +10,7 @@
 #pragma once
 #include "rs_core.h"
 #include "rs/cv_modules/max_depth_value_module/max_depth_value_output_interface.h"
+#include "rs/utils/async_video_module_base.h"
 
 #ifdef WIN32 
 #ifdef realsense_max_depth_value_module_EXPORTS
@@ -43,9 +44,14 @@ namespace rs
              * @brief Constructor
              * @param m_milliseconds_added_to_simulate_larger_computation_time  Milliseconds added to simulate larger computation time
              * @param is_async_processing                                       Configures the module in sync or async processing mode
+             * @param workers_count                                             Number of async processing threads, zero uses the number of hardware threads
+             * @param input_queue_size                                          Maximal number of images waiting for async processing, when the queue
+             *                                                                  is full the oldest image is dropped
              */
             max_depth_value_module(uint64_t m_milliseconds_added_to_simulate_larger_computation_time = 0,
-                                   bool is_async_processing = true);
+                                   bool is_async_processing = true,
+                                   uint32_t workers_count = 1,
+                                   uint32_t input_queue_size = 1);
 
             max_depth_value_module(const max_depth_value_module&) = delete;
             max_depth_value_module& operator= (const max_depth_value_module&) = delete;
@@ -66,6 +72,16 @@ namespace rs
             // max_depth_value_output_interface interface
             max_depth_value_output_data get_max_depth_value_data() override;
 
+            /**
+             * @brief Returns the counters of the async processing queue: queued, dropped, processed and failed images.
+             */
+            rs::utils::async_processing_statistics query_processing_statistics();
+
+            /**
+             * @brief Returns the processing time and the latency of the processed images.
+             */
+            rs::utils::async_video_module_timing query_processing_timing();
+
             ~max_depth_value_module();
         private:
             max_depth_value_module_impl * m_pimpl;
@@ -28,6 +28,10 @@ namespace rs
         /**
         * @brief Implements \c rs::core::context_interface for playback from recorded files. 
 		*
+		* The file path may instead name a live stream endpoint, \c unix:<path>, \c tcp:<host>:<port> or \c fd:<descriptor> of a connected
+		* socket or pipe, streamed by a record context. The constructor listens on the endpoint and waits for a single recorder to connect.
+		* A live stream is played as its samples arrive, real time playback is disabled by default, its frame count is the number of frames
+		* received so far, and stopping the device continues from the latest sample when it is started again.
 		* See the interface class for more details.
         */
         class DLL_EXPORT context : public rs::core::context_interface
@@ -39,13 +43,14 @@ namespace rs
             /**
             * @brief Gets number of available playback devices.
             *
-            * The playback context provides access to the single device that was recorded in the session. Therefore, this method always returns 1.
+            * The playback context provides access to the devices that were recorded in the session, each file device is a playback device.
+            * A file recorded from a single device provides a single playback device.
             * @return int Number of available devices
             */
             int get_device_count() const override;
 
             /**
-            * @brief Gets single playback device.
+            * @brief Gets a playback device.
             *
             * The method returns \c rs::playback::device, down-casted to \c rs::device.
             * @param[in] index Zero-based index of device to retrieve
@@ -61,12 +66,23 @@ namespace rs
              */
              device * get_playback_device();
 
+             /**
+             * @brief Gets a playback device by index.
+             *
+             * The devices of a file recorded from several devices are played by a single reader, which reads their samples in the order
+             * of their capture. The position in the file and the real time mode are shared by these devices.
+             * @param[in] index Zero-based index of device to retrieve
+             * @return playback::device* Requested device, null if the index is out of range.
+             */
+             device * get_playback_device(int index);
+
         private:
             context(const context& cxt) = delete;
             context& operator=(const context& cxt) = delete;
 
             rs_device **    m_devices;
             bool            m_init_status;
+            int             m_device_count;
         };
     }
 }
@@ -9,6 +9,7 @@
   
 #pragma once
 #include <librealsense/rs.hpp>
+#include "rs/core/types.h"
 
 #ifdef WIN32 
 #ifdef realsense_playback_EXPORTS
@@ -160,6 +161,16 @@ namespace rs
             * @return core::file_info File info.
             */
             file_info get_file_info();
+
+            /**
+            * @brief Gets the region of the camera frames, which was recorded for the requested stream.
+            *
+            * The played frames and the stream intrinsics describe the region. The region offset maps the pixels of the played
+            * frames to the pixels of the camera frames.
+            * @param[in] stream  Stream type for which the region is queried
+            * @return core::rect Recorded region, of zero size when the whole frames were recorded
+            */
+            core::rect get_region_of_interest(rs::stream stream);
         };
     }
 }
@@ -28,14 +28,35 @@ namespace rs
         /**
         * @brief Extends \c rs::core::context for capturing data to file during live camera streaming. 
 		*
+		* All the devices of the context are recorded into the same file, each device with its own streams. The file is created
+		* when the first device starts streaming, with the streams enabled on all the devices at that time. The recording is paused
+		* while none of the devices is streaming.
+		* The file path may instead name a live stream endpoint, \c unix:<path>, \c tcp:<host>:<port> or \c fd:<descriptor>, to stream the
+		* recording to a playback context reading the same endpoint, see \c rs::playback::context. The recorder connects to the endpoint when
+		* the recording starts, and waits up to 3 seconds for the playback side to listen.
 		* See the interface class for more details.
         */
         class DLL_EXPORT context : public rs::core::context
         {
         public:
             context(const char * file_path);
+
+            /**
+            * @brief Creates a context recording the devices of another context, for example re-recording a playback context.
+            *
+            * The source context must outlive this context.
+            * @param[in] file_path      Path of the recorded file
+            * @param[in] source_context Context owning the recorded devices
+            */
+            context(const char * file_path, rs::core::context_interface & source_context);
             virtual ~context();
 
+            /**
+            * @brief Gets the device count owned by this context.
+            * @return int Number of devices
+            */
+            int get_device_count() const override;
+
             /**
             * @brief Retrieves a device by index.
             *
@@ -59,7 +80,8 @@ namespace rs
             context(const context& cxt) = delete;
             context& operator=(const context& cxt) = delete;
 
-            rs_device ** m_devices;
+            rs_device **    m_devices;
+            int             m_device_count;
         };
     }
 }
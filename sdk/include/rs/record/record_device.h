@@ -9,6 +9,7 @@
 #pragma once
 #include <librealsense/rs.hpp>
 #include "rs/core/status.h"
+#include "rs/core/types.h"
 
 #ifdef WIN32 
 #ifdef realsense_record_EXPORTS
@@ -70,6 +71,16 @@ namespace rs
             */
             void resume_record();
 
+            /**
+            * @brief Returns whether the streams data is still written to the file.
+            *
+            * A failed write, such as a full disk or a live stream reader which went away, stops the recording while the device keeps streaming.
+            * The following streams data is not captured, and the file holds the data captured before the failure.
+            * @return status_no_error Successful execution.
+            * @return status_file_write_failed Writing to the file failed, the recording stopped.
+            */
+            core::status query_record_status();
+
             /**
             * @brief Sets the selected stream compression behavior.
             *
@@ -92,6 +103,102 @@ namespace rs
             * @return compression_level Requested compression level
             */
             compression_level get_compression_level(rs::stream stream);
+
+            /**
+            * @brief Sets the expected size of the recorded file, for the preallocation of its disk space.
+            *
+            * The method can be called only before record device start is called.
+            * The disk space is reserved ahead of the written data in large extents, which avoids the file fragmentation and the file system
+            * stalls on extent allocation. The unused reserved space is released when the recording stops, the file content is not affected.
+            * Setting the size to 0 disables the preallocation, which is the default. Preallocation is supported on Linux only.
+            * @param[in] expected_file_size  Expected recorded file size in bytes
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_preallocation_size(uint64_t expected_file_size);
+
+            /**
+            * @brief Sets the expected duration of the recording, for the preallocation of the disk space of the recorded file.
+            *
+            * Same as \c set_preallocation_size(), with the expected size computed on start from the uncompressed frame size and the frame rate
+            * of the enabled streams. Setting the duration to 0 disables the preallocation.
+            * @param[in] expected_duration_seconds  Expected recording duration in seconds
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_preallocation_duration(uint32_t expected_duration_seconds);
+
+            /**
+            * @brief Enables writing the recorded file with direct I/O.
+            *
+            * The method can be called only before record device start is called.
+            * Direct I/O bypasses the page cache, so a sustained high bandwidth recording doesn't fill the system memory with the
+            * written file and doesn't trigger writeback storms. The data is written in large aligned blocks, with several writes outstanding.
+            * Where direct I/O is not supported by the platform or the file system, the file is written with buffered I/O. Disabled by default.
+            * @param[in] enable  True to write the recorded file with direct I/O
+            * @return status_no_error Successful execution.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_direct_io(bool enable);
+
+            /**
+            * @brief Records only every Nth frame of the selected stream.
+            *
+            * The method can be called only before record device start is called.
+            * The skipped frames are still delivered to the application, they are skipped before they are copied or compressed,
+            * and they are not reported as frame drops in playback. The frame count of the stream in the file is the count of
+            * the recorded frames. The default decimation is 1, which records all the frames.
+            * @param[in] stream  Stream for which the decimation is set
+            * @param[in] decimation  Number of frames per recorded frame
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument Decimation is 0.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_frame_decimation(rs::stream stream, uint32_t decimation);
+
+            /**
+            * @brief Limits the rate of the recorded frames of the selected stream.
+            *
+            * Same as \c set_frame_decimation(), with the recorded frames selected by their time stamps, so they are evenly spaced at
+            * the requested rate, also where the rate is not a divisor of the stream frame rate. The stream keeps its configured
+            * frame rate in the file. Setting the frame rate to 0 removes the limit, which is the default.
+            * @param[in] stream  Stream for which the rate is set
+            * @param[in] framerate  Maximal recorded frames per second
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument Frame rate is negative.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_recorded_frame_rate(rs::stream stream, double framerate);
+
+            /**
+            * @brief Records only every Nth motion event of the selected motion source.
+            *
+            * The method can be called only before record device start is called.
+            * The skipped events are still delivered to the application. The default decimation is 1, which records all the events.
+            * @param[in] motion_event  Motion source for which the decimation is set
+            * @param[in] decimation  Number of events per recorded event
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument Decimation is 0.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_motion_decimation(rs::event motion_event, uint32_t decimation);
+
+            /**
+            * @brief Records only a region of the frames of the selected stream.
+            *
+            * The method can be called only before record device start is called.
+            * Only the region is copied, compressed and written, the application still gets the whole frames. The region is fitted
+            * into the frames on start, with the width and the offset of packed YUV formats rounded down to even values.
+            * The recorded stream has the size of the region, and its intrinsics are shifted by the region offset, so projection of
+            * the played frames needs no compensation. The region is available in playback by \c rs::playback::device::get_region_of_interest().
+            * Setting a region of zero size records the whole frames, which is the default.
+            * @param[in] stream  Stream for which the region is set
+            * @param[in] roi  Region of the frames to record, in pixels of the camera frames
+            * @return status_no_error Successful execution.
+            * @return status_invalid_argument The region has a negative offset or size.
+            * @return status_invalid_state The recording was already started.
+            */
+            core::status set_region_of_interest(rs::stream stream, const core::rect & roi);
         };
     }
 }
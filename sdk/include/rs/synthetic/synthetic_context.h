@@ -0,0 +1,105 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file synthetic_context.h
+* @brief Describes the \c rs::synthetic::context class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include <librealsense/rs.hpp>
+#include "rs/core/context_interface.h"
+
+#ifdef WIN32
+#ifdef realsense_synthetic_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_synthetic_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace synthetic
+    {
+        /**
+        * @brief Configuration of a generated stream.
+        */
+        struct stream_config
+        {
+            rs::stream  stream;
+            int         width;
+            int         height;
+            rs::format  format;         /**< Any format with a known pixel size                                         */
+            int         framerate;      /**< Frames per second, may be far above the camera rates, 0 for no pacing     */
+            uint32_t    jitter_us;      /**< Maximal random delay added to each frame time stamp and delivery, 0 for none */
+            uint32_t    drop_interval;  /**< Every drop_interval-th frame is skipped, 0 for no drops                     */
+        };
+
+        /**
+        * @brief Configuration of the generated motion events.
+        */
+        struct motion_config
+        {
+            uint32_t    rate;           /**< Accelerometer and gyro events per second each, 0 for a device without motion */
+            uint32_t    drop_interval;  /**< Every drop_interval-th event pair is skipped, 0 for no drops                 */
+        };
+
+        /**
+        * @brief Configuration of a synthetic device.
+        */
+        struct device_config
+        {
+            std::vector<stream_config>  streams;
+            motion_config               motion;
+        };
+
+        /**
+        * @brief Implements \c rs::core::context_interface for a device generating frames and motion events without a camera.
+        *
+        * The device exposes the same \c rs::device interface as a camera, with a single mode per configured stream, and generates
+        * a scrolling pattern on each stream at the configured rate. The frame numbers start at 1 and keep counting over the dropped frames,
+        * and the frame time stamps are derived from the frame numbers, so the injected jitter and drops are visible to the application.
+        * The number of the dropped frames is reported by the \c RS_OPTION_TOTAL_FRAME_DROPS option.
+        * It is meant for load testing the record, pipeline and synchronization code at rates beyond those of a real camera.
+        */
+        class DLL_EXPORT context : public rs::core::context_interface
+        {
+        public:
+            context(const device_config & config);
+
+            /**
+            * @brief Creates a context of several synthetic devices, for example to load test a multi device recording.
+            *
+            * @param[in] configs        Configuration of each device, in the order of the device indices
+            */
+            context(const std::vector<device_config> & configs);
+            ~context();
+
+            /**
+            * @brief Gets number of available synthetic devices.
+            *
+            * @return int Number of available devices, the number of configured devices
+            */
+            int get_device_count() const override;
+
+            /**
+            * @brief Gets the synthetic device.
+            *
+            * @param[in] index Zero-based index of device to retrieve
+            * @return rs::device* Requested device, null if the index is out of range
+            */
+            rs::device * get_device(int index) override;
+
+        private:
+            context(const context& cxt) = delete;
+            context& operator=(const context& cxt) = delete;
+
+            std::vector<rs_device *> m_devices;
+        };
+    }
+}
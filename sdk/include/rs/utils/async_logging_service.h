@@ -0,0 +1,145 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file async_logging_service.h
+* @brief Describes the \c rs::utils::async_logging_service class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include "rs/utils/logging_service.h"
+
+#ifdef WIN32
+#ifdef realsense_log_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_log_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Logging service which writes the messages of another logging service from a background thread.
+        *
+        * \c log and \c logw copy the message, its level and its location into a fixed size record of a preallocated lock-free ring
+        * buffer, and return without taking a lock or allocating memory. A background thread passes the records to the wrapped logging
+        * service, which applies its layout and writes them. Messages longer than \c max_message_length characters are truncated,
+        * the file and function names must be static strings, as provided by the \c LOG_* macros.
+        * The wrapped logging service timestamps a message when the background thread writes it, which may be later than the log call.
+        *
+        * The level, name and configuration methods are forwarded to the wrapped logging service, which must outlive this instance.
+        */
+        class DLL_EXPORT async_logging_service : public logging_service
+        {
+        public:
+            /**
+            * @brief Behavior of a log call when the ring buffer is full.
+            */
+            enum class overflow_policy
+            {
+                drop,   /**< The message is dropped and counted, the number of dropped messages is logged once there is room */
+                block   /**< The log call waits for the background thread to free a record                                   */
+            };
+
+            static const size_t max_message_length = 255;   /**< Maximal number of characters of a message, including wide characters */
+
+            /**
+            * @brief Constructor: allocates the ring buffer and starts the background thread.
+            * @param[in] logger           Wrapped logging service, which writes the messages
+            * @param[in] capacity         Number of records in the ring buffer, rounded up to a power of two
+            * @param[in] policy           Behavior of a log call when the ring buffer is full
+            */
+            async_logging_service(logging_service * logger, uint32_t capacity = 4096, overflow_policy policy = overflow_policy::drop);
+
+            async_logging_service(const async_logging_service &) = delete;
+            async_logging_service & operator=(const async_logging_service &) = delete;
+
+            /**
+            * @brief Destructor: writes the pending records and stops the background thread.
+            */
+            virtual ~async_logging_service();
+
+            virtual rs::core::status   set_logger_name(const wchar_t* name) override;
+            virtual rs::core::status   configure(config_mode config_mode, const wchar_t* config, int file_watch_delay) override;
+            virtual bool               is_configured() override;
+            virtual rs::core::status   set_level(log_level level) override;
+            virtual bool               is_level_enabled(log_level level) override;
+            virtual log_level          get_level() override;
+            virtual void               log (log_level level, const char*    message, const char* file_name, int line_number, const char* function_name) override;
+            virtual void               logw(log_level level, const wchar_t* message, const char* file_name, int line_number, const char* function_name) override;
+            virtual logger_type        get_logger_type() override;
+
+            /**
+            * @brief Blocks until the messages logged before the call are written by the wrapped logging service.
+            */
+            void flush();
+
+            /**
+            * @brief Returns the number of messages dropped since the creation, with the \c drop overflow policy.
+            */
+            uint64_t query_dropped_count() const;
+
+            /**
+            * @brief Returns the wrapped logging service.
+            */
+            logging_service * get_wrapped_logger() const;
+
+        private:
+            struct record
+            {
+                log_level       level;
+                int             line_number;
+                const char *    file_name;
+                const char *    function_name;
+                bool            is_wide;
+                union
+                {
+                    char        message[max_message_length + 1];
+                    wchar_t     wide_message[max_message_length + 1];
+                };
+            };
+
+            //a ring buffer cell, its sequence tells whether it is free for the producers or ready for the background thread
+            struct cell
+            {
+                std::atomic<size_t>     sequence;
+                record                  data;
+            };
+
+            record * acquire_record(size_t & position);
+            void publish_record(size_t position);
+            void write_loop();
+            size_t write_pending_records();
+
+            logging_service * const     m_logger;
+            const overflow_policy       m_policy;
+            size_t                      m_mask;
+            std::vector<cell>           m_cells;
+
+            std::atomic<size_t>         m_enqueue_position;
+            std::atomic<size_t>         m_dequeue_position;
+            std::atomic<size_t>         m_written_position;     //dequeue position once the overflow report is written too
+            std::atomic<uint64_t>       m_dropped_count;
+            uint64_t                    m_reported_dropped_count;
+
+            //the background thread sleeps on the condition variable when the ring buffer is empty, log calls notify it only then
+            std::atomic<bool>           m_is_writer_waiting;
+            std::atomic<bool>           m_is_closing;
+            std::mutex                  m_writer_lock;
+            std::condition_variable     m_records_ready;
+            std::thread                 m_writer_thread;
+        };
+    }
+}
@@ -0,0 +1,298 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file async_processing_queue.h
+* @brief Describes the \c rs::utils::async_processing_queue class.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <algorithm>
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Counters of an \c async_processing_queue, accumulated since its creation.
+        */
+        struct async_processing_statistics
+        {
+            uint64_t    queued;             /**< Number of inputs pushed to the queue                                  */
+            uint64_t    dropped;            /**< Number of inputs removed before processing, by a full queue or clear  */
+            uint64_t    processed;          /**< Number of inputs processed successfully                               */
+            uint64_t    failed;             /**< Number of inputs which processing returned an error                   */
+            uint32_t    queue_size;         /**< Number of inputs currently waiting in the queue                       */
+            uint32_t    max_queue_size;     /**< Largest number of inputs which waited in the queue                    */
+        };
+
+        /**
+        * @brief Behavior of \c async_processing_queue::push when the queue is full.
+        */
+        enum class full_queue_policy
+        {
+            drop_oldest,    /**< The oldest waiting input is dropped, push doesn't block                */
+            block           /**< Push blocks until a worker takes an input, applying back-pressure      */
+        };
+
+        /**
+        * @brief Bounded input queue served by a pool of worker threads, emitting the outputs in the inputs order.
+        *
+        * Each input is processed by one of the workers, concurrently with the following inputs. The outputs are passed to the
+        * output function one at a time, in the order the inputs were pushed, the output of a failed input is skipped.
+        * When the queue is full, pushing a new input either drops the oldest waiting input, so a slow consumer sees the latest data,
+        * or blocks the producer until there is room, according to the queue policy.
+        * This container requires the input and output types to be default constructible and movable.
+        */
+        template <typename input_type, typename output_type>
+        class async_processing_queue
+        {
+        public:
+            /**
+            * @brief Processes a single input, called concurrently from the worker threads.
+            *
+            * The worker index is in the range [0, workers count), it allows the function to use per worker resources.
+            */
+            typedef std::function<rs::core::status(uint32_t worker_index, input_type & input, output_type & output)> process_function;
+
+            /**
+            * @brief Receives the output of a processed input, calls are serialized and follow the inputs order.
+            */
+            typedef std::function<void(output_type & output)> output_function;
+
+            /**
+            * @brief Constructor: starts the worker threads.
+            * @param[in] workers_count    Number of worker threads, zero uses the number of hardware threads
+            * @param[in] capacity         Maximal number of inputs waiting to be processed, at least 1
+            * @param[in] process          Processing function
+            * @param[in] output           Output function
+            * @param[in] policy           Behavior of push when the queue is full
+            */
+            async_processing_queue(uint32_t workers_count, uint32_t capacity, process_function process, output_function output,
+                                   full_queue_policy policy = full_queue_policy::drop_oldest) :
+                m_capacity(std::max<uint32_t>(capacity, 1)),
+                m_policy(policy),
+                m_process(process),
+                m_output(output),
+                m_statistics({}),
+                m_next_sequence(0),
+                m_next_output_sequence(0),
+                m_processing_count(0),
+                m_is_emitting(false),
+                m_is_closing(false)
+            {
+                if(workers_count == 0)
+                    workers_count = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+                for(uint32_t worker_index = 0; worker_index < workers_count; worker_index++)
+                    m_workers.push_back(std::thread(&async_processing_queue::worker_loop, this, worker_index));
+            }
+
+            async_processing_queue(const async_processing_queue &) = delete;
+            async_processing_queue & operator=(const async_processing_queue &) = delete;
+
+            /**
+            * @brief Pushes an input to the queue, blocks only with the \c block policy when the queue is full.
+            * @param[in] input    Input to process
+            * @return bool        False if the queue was full and its oldest input was dropped, or if the queue is closing
+            */
+            bool push(input_type input)
+            {
+                bool is_dropped = false;
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    if(m_is_closing)
+                        return false;
+                    if(m_policy == full_queue_policy::block)
+                    {
+                        m_space_available.wait(lock, [this]() { return m_is_closing || m_queue.size() < m_capacity; });
+                        if(m_is_closing)
+                            return false;
+                    }
+                    if(m_queue.size() >= m_capacity)
+                    {
+                        m_queue.pop_front();
+                        m_statistics.dropped++;
+                        is_dropped = true;
+                    }
+                    m_queue.push_back(std::move(input));
+                    m_statistics.queued++;
+                    m_statistics.max_queue_size = std::max(m_statistics.max_queue_size, static_cast<uint32_t>(m_queue.size()));
+                }
+                m_input_ready.notify_one();
+                return !is_dropped;
+            }
+
+            /**
+            * @brief Drops the inputs waiting in the queue, inputs already being processed are completed.
+            */
+            void clear()
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_statistics.dropped += m_queue.size();
+                m_queue.clear();
+                m_idle.notify_all();
+                m_space_available.notify_all();
+            }
+
+            /**
+            * @brief Blocks until all the pushed inputs are processed and their outputs are emitted.
+            *
+            * Must not be called from the output function.
+            */
+            void flush()
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                m_idle.wait(lock, [this]() { return m_queue.empty() && m_processing_count == 0 && m_results.empty() && !m_is_emitting; });
+            }
+
+            /**
+            * @brief Returns the queue counters.
+            */
+            async_processing_statistics query_statistics()
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                async_processing_statistics statistics = m_statistics;
+                statistics.queue_size = static_cast<uint32_t>(m_queue.size());
+                return statistics;
+            }
+
+            uint32_t workers_count() const { return static_cast<uint32_t>(m_workers.size()); }
+            uint32_t capacity() const { return m_capacity; }
+
+            /**
+            * @brief Stops the workers, waiting inputs are discarded and inputs being processed are completed. The following pushes are rejected.
+            *
+            * Must not be called concurrently with itself or from the output function.
+            */
+            void close()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_lock);
+                    m_is_closing = true;
+                    m_queue.clear();
+                }
+                m_input_ready.notify_all();
+                m_space_available.notify_all();
+                for(auto & worker : m_workers)
+                {
+                    if(worker.joinable())
+                        worker.join();
+                }
+            }
+
+            /**
+            * @brief Destructor: closes the queue if it wasn't closed.
+            */
+            ~async_processing_queue()
+            {
+                close();
+            }
+
+        private:
+            //an output waiting for the outputs of earlier inputs
+            struct result
+            {
+                bool            is_done;
+                bool            is_valid;
+                output_type     output;
+            };
+
+            void worker_loop(uint32_t worker_index)
+            {
+                std::unique_lock<std::mutex> lock(m_lock);
+                while(true)
+                {
+                    m_input_ready.wait(lock, [this]() { return m_is_closing || !m_queue.empty(); });
+                    if(m_is_closing)
+                        return;
+
+                    //the sequence number is assigned on dequeue, so dropped inputs don't leave gaps in the outputs order
+                    input_type input = std::move(m_queue.front());
+                    m_queue.pop_front();
+                    const uint64_t sequence = m_next_sequence++;
+                    m_processing_count++;
+                    lock.unlock();
+                    m_space_available.notify_one();
+
+                    output_type output = {};
+                    rs::core::status sts = rs::core::status_exec_aborted;
+                    try
+                    {
+                        sts = m_process(worker_index, input, output);
+                    }
+                    catch(...) {}
+                    input = input_type();
+
+                    lock.lock();
+                    if(sts < rs::core::status_no_error)
+                        m_statistics.failed++;
+                    else
+                        m_statistics.processed++;
+
+                    const size_t result_index = static_cast<size_t>(sequence - m_next_output_sequence);
+                    if(m_results.size() <= result_index)
+                        m_results.resize(result_index + 1);
+                    m_results[result_index].is_done = true;
+                    m_results[result_index].is_valid = sts >= rs::core::status_no_error;
+                    m_results[result_index].output = std::move(output);
+
+                    emit_ready_outputs(lock);
+                    m_processing_count--;
+                    m_idle.notify_all();
+                }
+            }
+
+            //a single thread emits at a time, it keeps emitting the outputs which became ready while the lock was released
+            void emit_ready_outputs(std::unique_lock<std::mutex> & lock)
+            {
+                if(m_is_emitting)
+                    return;
+                m_is_emitting = true;
+                while(!m_results.empty() && m_results.front().is_done)
+                {
+                    result ready_result = std::move(m_results.front());
+                    m_results.pop_front();
+                    m_next_output_sequence++;
+                    if(!ready_result.is_valid)
+                        continue;
+
+                    lock.unlock();
+                    try
+                    {
+                        m_output(ready_result.output);
+                    }
+                    catch(...) {}
+                    lock.lock();
+                }
+                m_is_emitting = false;
+            }
+
+            const uint32_t                  m_capacity;
+            const full_queue_policy         m_policy;
+            const process_function          m_process;
+            const output_function           m_output;
+
+            std::mutex                      m_lock;
+            std::condition_variable         m_input_ready;
+            std::condition_variable         m_idle;
+            std::condition_variable         m_space_available;
+            std::deque<input_type>          m_queue;
+            std::deque<result>              m_results;
+            async_processing_statistics     m_statistics;
+            uint64_t                        m_next_sequence;
+            uint64_t                        m_next_output_sequence;
+            uint32_t                        m_processing_count;
+            bool                            m_is_emitting;
+            bool                            m_is_closing;
+            std::vector<std::thread>        m_workers;
+        };
+    }
+}
@@ -0,0 +1,356 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file async_video_module_base.h
+* @brief Describes the \c rs::utils::async_video_module_base class template.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <memory>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include "rs/core/video_module_interface.h"
+#include "rs/utils/async_processing_queue.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Timing of the samples processed by an \c async_video_module_base, accumulated since its creation.
+        *
+        * The latency of a sample is the time from \c process_sample_set until its output is ready, including the time in the
+        * input queue and the wait for the outputs of earlier samples.
+        */
+        struct async_video_module_timing
+        {
+            uint64_t    samples_count;                  /**< Number of samples which output was ready   */
+            double      average_processing_time_ms;     /**< Average time of \c process_sample          */
+            double      max_processing_time_ms;         /**< Maximal time of \c process_sample          */
+            double      average_latency_ms;             /**< Average sample latency                     */
+            double      max_latency_ms;                 /**< Maximal sample latency                     */
+        };
+
+        /**
+        * @brief Base implementation of the async processing flow of a computer vision module.
+        *
+        * The base class implements \c process_sample_set, the event handler registration and \c flush_resources. In async mode,
+        * the sample sets are queued to a bounded \c async_processing_queue and processed by a pool of worker threads, and the
+        * outputs are passed to \c on_output and to the registered event handler in the sample sets order. In sync mode, the
+        * sample set is processed on the calling thread, and the output is passed to \c on_output before \c process_sample_set returns.
+        *
+        * The derived module implements the per sample computation in \c process_sample, and the rest of \c video_module_interface.
+        *
+        * The destructor of every derived class which is instantiated must call \c stop_processing as its first statement. The workers
+        * call \c process_sample and \c on_output of the derived class, and the base destructor only runs after the derived part of the
+        * object, with its virtual functions and members, was destroyed. A worker still running then calls into a destroyed object.
+        * @tparam output_type   Module output, default constructible and movable
+        */
+        template <typename output_type>
+        class async_video_module_base : public rs::core::video_module_interface
+        {
+        public:
+            rs::core::status process_sample_set(const rs::core::correlated_sample_set & sample_set) override
+            {
+                rs::core::status sts = check_sample_set(sample_set);
+                if(sts < rs::core::status_no_error)
+                {
+                    return sts;
+                }
+
+                if(m_async_processing)
+                {
+                    //the copy keeps the queue alive while a concurrent stop_processing closes it, which rejects the push
+                    std::shared_ptr<processing_queue> processing_queue = query_processing_queue();
+                    if(!processing_queue)
+                    {
+                        return rs::core::status_invalid_state;
+                    }
+                    queued_sample sample;
+                    sample.sample_set = sample_set_reference(sample_set);
+                    sample.arrival_time = std::chrono::steady_clock::now();
+                    processing_queue->push(std::move(sample));
+                    return rs::core::status_no_error;
+                }
+
+                processed_sample output = {};
+                output.arrival_time = std::chrono::steady_clock::now();
+                sts = process_timed_sample(0, sample_set, output);
+                if(sts < rs::core::status_no_error)
+                {
+                    return sts;
+                }
+                update_timing(output);
+                on_output(output.output);
+                return rs::core::status_no_error;
+            }
+
+            rs::core::status register_event_handler(rs::core::video_module_interface::processing_event_handler * handler) override
+            {
+                std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+                if(m_processing_handler != nullptr)
+                {
+                    return rs::core::status_handle_invalid;
+                }
+                m_processing_handler = handler;
+                return rs::core::status_no_error;
+            }
+
+            rs::core::status unregister_event_handler(rs::core::video_module_interface::processing_event_handler * handler) override
+            {
+                std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+                if(m_processing_handler != handler)
+                {
+                    return rs::core::status_handle_invalid;
+                }
+                m_processing_handler = nullptr;
+                return rs::core::status_no_error;
+            }
+
+            rs::core::status flush_resources() override
+            {
+                std::lock_guard<std::mutex> lock(m_queue_lock);
+                if(m_processing_queue)
+                {
+                    m_processing_queue->clear();
+                }
+                return rs::core::status_no_error;
+            }
+
+            /**
+            * @brief Returns the counters of the async processing queue: queued, dropped, processed and failed samples.
+            */
+            async_processing_statistics query_processing_statistics()
+            {
+                std::lock_guard<std::mutex> lock(m_queue_lock);
+                return m_processing_queue ? m_processing_queue->query_statistics() : async_processing_statistics();
+            }
+
+            /**
+            * @brief Returns the processing time and the latency of the processed samples.
+            */
+            async_video_module_timing query_processing_timing()
+            {
+                std::lock_guard<std::mutex> lock(m_timing_lock);
+                async_video_module_timing timing = m_timing;
+                if(timing.samples_count)
+                {
+                    timing.average_processing_time_ms /= timing.samples_count;
+                    timing.average_latency_ms /= timing.samples_count;
+                }
+                return timing;
+            }
+
+            virtual ~async_video_module_base()
+            {
+                stop_processing();
+            }
+
+        protected:
+            /**
+            * @brief Constructor, the workers are started on the first async sample set.
+            * @param[in] is_async_processing  Configures the module in sync or async processing mode
+            * @param[in] workers_count        Number of async processing threads, zero uses the number of hardware threads
+            * @param[in] input_queue_size     Maximal number of sample sets waiting for async processing
+            * @param[in] policy               Behavior of \c process_sample_set when the input queue is full
+            */
+            async_video_module_base(bool is_async_processing, uint32_t workers_count, uint32_t input_queue_size,
+                                    full_queue_policy policy = full_queue_policy::drop_oldest) :
+                m_async_processing(is_async_processing),
+                m_workers_count(workers_count ? workers_count : std::max<uint32_t>(std::thread::hardware_concurrency(), 1)),
+                m_input_queue_size(std::max<uint32_t>(input_queue_size, 1)),
+                m_policy(policy),
+                m_processing_handler(nullptr),
+                m_timing({}),
+                m_is_processing_stopped(false)
+            {}
+
+            /**
+            * @brief Processes a single sample set, called concurrently from the worker threads in async mode.
+            * @param[in]  worker_index    Index of the calling worker in the range [0, workers count), zero in sync mode
+            * @param[in]  sample_set      Sample set to process, its images are valid during the call
+            * @param[out] output          Module output of the sample set
+            * @return status_no_error     Successful execution, a failed sample set has no output
+            */
+            virtual rs::core::status process_sample(uint32_t worker_index, const rs::core::correlated_sample_set & sample_set, output_type & output) = 0;
+
+            /**
+            * @brief Receives the module output of each processed sample set, calls are serialized and follow the sample sets order.
+            */
+            virtual void on_output(output_type & output) = 0;
+
+            /**
+            * @brief Checks a sample set before it is queued, a failure is returned by \c process_sample_set.
+            */
+            virtual rs::core::status check_sample_set(const rs::core::correlated_sample_set & /*sample_set*/)
+            {
+                return rs::core::status_no_error;
+            }
+
+            /**
+            * @brief Stops the workers, the queued sample sets are discarded. Must be the first statement of the derived class destructor,
+            * see the class description. The following async sample sets are rejected with \c status_invalid_state, and calling it again
+            * has no effect.
+            */
+            void stop_processing()
+            {
+                std::shared_ptr<processing_queue> processing_queue;
+                {
+                    std::lock_guard<std::mutex> lock(m_queue_lock);
+                    m_is_processing_stopped = true;
+                    processing_queue = std::move(m_processing_queue);
+                }
+                //the workers are joined here even when a concurrent process_sample_set still holds the queue
+                if(processing_queue)
+                {
+                    processing_queue->close();
+                }
+            }
+
+            uint32_t query_workers_count() const { return m_workers_count; }
+            uint32_t query_input_queue_size() const { return m_input_queue_size; }
+
+            bool m_async_processing;
+
+        private:
+            //owns a reference to each image of a sample set while it is queued
+            class sample_set_reference
+            {
+            public:
+                sample_set_reference() {}
+
+                explicit sample_set_reference(const rs::core::correlated_sample_set & sample_set) : m_sample_set(sample_set)
+                {
+                    for(auto image : m_sample_set.images)
+                    {
+                        if(image)
+                        {
+                            image->add_ref();
+                        }
+                    }
+                }
+
+                sample_set_reference(sample_set_reference && other) : m_sample_set(other.m_sample_set)
+                {
+                    other.m_sample_set = rs::core::correlated_sample_set();
+                }
+
+                sample_set_reference & operator=(sample_set_reference && other)
+                {
+                    if(this != &other)
+                    {
+                        release();
+                        m_sample_set = other.m_sample_set;
+                        other.m_sample_set = rs::core::correlated_sample_set();
+                    }
+                    return *this;
+                }
+
+                sample_set_reference(const sample_set_reference &) = delete;
+                sample_set_reference & operator=(const sample_set_reference &) = delete;
+
+                const rs::core::correlated_sample_set & get() const { return m_sample_set; }
+
+                ~sample_set_reference()
+                {
+                    release();
+                }
+
+            private:
+                void release()
+                {
+                    for(auto & image : m_sample_set.images)
+                    {
+                        if(image)
+                        {
+                            image->release();
+                            image = nullptr;
+                        }
+                    }
+                }
+
+                rs::core::correlated_sample_set m_sample_set;
+            };
+
+            struct queued_sample
+            {
+                sample_set_reference                                sample_set;
+                std::chrono::steady_clock::time_point               arrival_time;
+            };
+
+            struct processed_sample
+            {
+                output_type                                         output;
+                std::chrono::steady_clock::time_point               arrival_time;
+                double                                              processing_time_ms;
+            };
+
+            typedef async_processing_queue<queued_sample, processed_sample> processing_queue;
+
+            //the workers are created on first use, so they never call a partially constructed derived class. null after stop_processing.
+            std::shared_ptr<processing_queue> query_processing_queue()
+            {
+                std::lock_guard<std::mutex> lock(m_queue_lock);
+                if(!m_processing_queue && !m_is_processing_stopped)
+                {
+                    m_processing_queue.reset(new processing_queue(m_workers_count, m_input_queue_size,
+                        [this](uint32_t worker_index, queued_sample & sample, processed_sample & output)
+                        {
+                            output.arrival_time = sample.arrival_time;
+                            return process_timed_sample(worker_index, sample.sample_set.get(), output);
+                        },
+                        [this](processed_sample & output)
+                        {
+                            update_timing(output);
+                            on_output(output.output);
+
+                            std::lock_guard<std::mutex> lock(m_processing_handler_lock);
+                            if(m_processing_handler)
+                            {
+                                m_processing_handler->module_output_ready(this, nullptr);
+                            }
+                        },
+                        m_policy));
+                }
+                return m_processing_queue;
+            }
+
+            rs::core::status process_timed_sample(uint32_t worker_index, const rs::core::correlated_sample_set & sample_set, processed_sample & output)
+            {
+                auto start_time = std::chrono::steady_clock::now();
+                rs::core::status sts = process_sample(worker_index, sample_set, output.output);
+                output.processing_time_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_time).count();
+                return sts;
+            }
+
+            void update_timing(const processed_sample & output)
+            {
+                const double latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - output.arrival_time).count();
+                std::lock_guard<std::mutex> lock(m_timing_lock);
+                m_timing.samples_count++;
+                m_timing.average_processing_time_ms += output.processing_time_ms;
+                m_timing.max_processing_time_ms = std::max(m_timing.max_processing_time_ms, output.processing_time_ms);
+                m_timing.average_latency_ms += latency_ms;
+                m_timing.max_latency_ms = std::max(m_timing.max_latency_ms, latency_ms);
+            }
+
+            const uint32_t                                                      m_workers_count;
+            const uint32_t                                                      m_input_queue_size;
+            const full_queue_policy                                             m_policy;
+
+            std::mutex                                                          m_processing_handler_lock;
+            rs::core::video_module_interface::processing_event_handler *        m_processing_handler;
+
+            //the timing sums are divided by the samples count on query
+            std::mutex                                                          m_timing_lock;
+            async_video_module_timing                                           m_timing;
+
+            std::mutex                                                          m_queue_lock;
+            std::shared_ptr<processing_queue>                                   m_processing_queue;
+            bool                                                                m_is_processing_stopped;
+        };
+    }
+}
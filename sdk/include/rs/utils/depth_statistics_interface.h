@@ -0,0 +1,125 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file depth_statistics_interface.h
+* @brief Describes the \c rs::utils::depth_statistics_interface class.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "rs/core/status.h"
+#include "rs/core/types.h"
+#include "rs/core/image_interface.h"
+#include "rs/core/release_interface.h"
+
+#ifdef WIN32
+#ifdef realsense_depth_statistics_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_depth_statistics_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Reduction of the pixels of a depth image region.
+        *
+        * A pixel with zero depth has no valid depth, it is counted in \c pixels_count only.
+        */
+        struct depth_statistics
+        {
+            uint16_t    min_depth;      /**< Minimal valid depth, zero when the region has no valid pixel */
+            uint16_t    max_depth;      /**< Maximal depth, zero when the region has no valid pixel       */
+            double      mean_depth;     /**< Mean of the valid depth values                               */
+            uint64_t    valid_count;    /**< Number of pixels with valid depth                            */
+            uint64_t    pixels_count;   /**< Number of pixels in the region                               */
+        };
+
+        /**
+        * @brief Depth image statistics: min, max, mean, valid pixels count, histogram and percentiles.
+        *
+        * The methods accept \c z16 depth images, on the full frame or on a region of interest. The rows of the region are split
+        * between the instance threads, and each row is reduced with SIMD instructions when available. Internal buffers are
+        * allocated once, so steady state processing doesn't allocate memory.
+        * The instance is not thread safe, calls should not be made concurrently.
+        */
+        class DLL_EXPORT depth_statistics_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Creates a depth statistics instance.
+            * @param[in]  threads_count   Number of threads used by the methods, including the calling thread.
+            *                             Zero uses the number of hardware threads.
+            * @return depth_statistics_interface *   Instance, to be released with \c release
+            */
+            static depth_statistics_interface * create_instance(uint32_t threads_count = 0);
+
+            /**
+            * @brief Computes the statistics of a depth image region.
+            * @param[in]  depth           Depth image, in \c z16 format
+            * @param[in]  roi             Region of interest, null for the full image
+            * @param[out] statistics      Statistics of the region
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null depth image or image data
+            * @return status_param_unsupported  The image format isn't \c z16, or the region is empty or outside of the image
+            */
+            virtual rs::core::status query_statistics(rs::core::image_interface * depth, const rs::core::rect * roi, depth_statistics & statistics) = 0;
+
+            /**
+            * @brief Computes the statistics of several regions of a depth image.
+            * @param[in]  depth           Depth image, in \c z16 format
+            * @param[in]  rois            Regions of interest
+            * @param[in]  rois_count      Number of regions
+            * @param[out] statistics      Statistics array, one element per region
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null depth image, image data, regions or statistics
+            * @return status_param_unsupported  The image format isn't \c z16, or one of the regions is empty or outside of the image
+            */
+            virtual rs::core::status query_roi_statistics(rs::core::image_interface * depth, const rs::core::rect * rois, int32_t rois_count,
+                                                          depth_statistics * statistics) = 0;
+
+            /**
+            * @brief Computes the histogram of the valid depth values of a depth image region.
+            *
+            * The range [\c min_depth, \c max_depth] is split to \c bins_count equal bins, values outside of the range are not counted.
+            * @param[in]  depth           Depth image, in \c z16 format
+            * @param[in]  roi             Region of interest, null for the full image
+            * @param[in]  min_depth       First depth value of the first bin, at least 1
+            * @param[in]  max_depth       Last depth value of the last bin
+            * @param[in]  bins_count      Number of bins
+            * @param[out] histogram       Histogram array, \c bins_count elements
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null depth image, image data or histogram
+            * @return status_param_unsupported  Invalid image format, region, range or bins count
+            */
+            virtual rs::core::status query_histogram(rs::core::image_interface * depth, const rs::core::rect * roi, uint16_t min_depth, uint16_t max_depth,
+                                                     int32_t bins_count, uint32_t * histogram) = 0;
+
+            /**
+            * @brief Computes percentiles of the valid depth values of a depth image region.
+            *
+            * The percentile p is the smallest depth value which is larger or equal to p percents of the valid depth values.
+            * @param[in]  depth             Depth image, in \c z16 format
+            * @param[in]  roi               Region of interest, null for the full image
+            * @param[in]  percentiles       Requested percentiles, in the range [0, 100]
+            * @param[in]  percentiles_count Number of requested percentiles
+            * @param[out] values            Depth value of each requested percentile, zero when the region has no valid pixel
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null depth image, image data, percentiles or values
+            * @return status_param_unsupported  Invalid image format, region or percentile
+            */
+            virtual rs::core::status query_percentiles(rs::core::image_interface * depth, const rs::core::rect * roi, const float * percentiles,
+                                                       int32_t percentiles_count, uint16_t * values) = 0;
+
+        protected:
+            virtual ~depth_statistics_interface() {}
+        };
+    }
+}
@@ -0,0 +1,168 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file event_tracer.h
+* @brief Describes the \c rs::utils::event_tracer and \c rs::utils::scope_trace classes, and the \c TRACE_* macros.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "rs/core/status.h"
+
+#ifdef WIN32
+#ifdef realsense_log_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_log_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        struct trace_thread_buffer;
+
+        /**
+        * @brief Records timed events of the SDK threads, and writes them as a Chrome trace file.
+        *
+        * Tracing is disabled by default, and a disabled trace point costs a single relaxed atomic load. When enabled, each thread
+        * writes its events with nanosecond timestamps into its own preallocated buffer, without taking a lock. The events of a full
+        * buffer are dropped and counted. The trace file is in the Chrome trace event JSON format, which is loaded by chrome://tracing
+        * and by the Perfetto UI, and shows the spans of each thread on its own track.
+        *
+        * Setting the environment variable \c REALSENSE_SDK_TRACE to a file path enables tracing on startup, and writes the trace file
+        * to this path on exit. The event names and categories must be static strings, as provided by the \c TRACE_* macros.
+        */
+        class DLL_EXPORT event_tracer
+        {
+        public:
+            /**
+            * @brief Type of a trace event.
+            */
+            enum class event_type : uint8_t
+            {
+                span,       /**< Time interval of a thread, such as the processing of a frame   */
+                instant,    /**< Point in time of a thread, such as a frame drop                */
+                counter     /**< Value at a point in time, such as a queue size                 */
+            };
+
+            event_tracer();
+            virtual ~event_tracer();
+
+            event_tracer(const event_tracer &) = delete;
+            event_tracer & operator=(const event_tracer &) = delete;
+
+            /**
+            * @brief Starts a trace session, the events of the previous session are discarded.
+            * @param[in] events_per_thread    Number of events each thread buffer holds
+            */
+            void enable(uint32_t events_per_thread = 65536);
+
+            /**
+            * @brief Stops recording events, the recorded events are kept until the next session.
+            */
+            void disable();
+
+            /**
+            * @brief Returns true if events are recorded.
+            */
+            bool is_enabled() const { return m_is_enabled.load(std::memory_order_relaxed); }
+
+            /**
+            * @brief Writes the events of the current session to a Chrome trace JSON file.
+            *
+            * May be called while tracing is enabled, the events recorded during the call may be missing from the file.
+            * @param[in] file_path            Path of the trace file, overwritten if exists
+            * @return status_no_error         Successful execution
+            * @return status_file_open_failed The file could not be created
+            * @return status_file_write_failed Failed writing to the file
+            */
+            rs::core::status dump(const char * file_path);
+
+            /**
+            * @brief Returns the number of events dropped by full thread buffers in the current session.
+            */
+            uint64_t query_dropped_count();
+
+            /**
+            * @brief Names the calling thread in the trace file, may be called before tracing is enabled.
+            */
+            void set_thread_name(const char * name);
+
+            /**
+            * @brief Returns the trace clock time, in nanoseconds.
+            */
+            static uint64_t now();
+
+            void add_span(const char * category, const char * name, uint64_t begin_time, uint64_t end_time);
+            void add_instant(const char * category, const char * name);
+            void add_counter(const char * category, const char * name, int64_t value);
+
+        private:
+            void add_event(event_type type, const char * category, const char * name, uint64_t time, int64_t value);
+            trace_thread_buffer * query_thread_buffer();
+
+            std::atomic<bool>                                   m_is_enabled;
+            std::atomic<uint32_t>                               m_session;
+            std::atomic<uint64_t>                               m_session_start_time;
+            uint32_t                                            m_events_per_thread;
+
+            //the thread buffers are kept until destruction, so the events of finished threads are dumped too
+            std::mutex                                          m_buffers_lock;
+            std::vector<std::unique_ptr<trace_thread_buffer>>   m_buffers;
+        };
+    }
+}
+
+extern DLL_EXPORT rs::utils::event_tracer tracer;
+
+#define TRACE_TRACER  tracer // default tracer
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Class for scoped trace objects. The object records a span from its creation to its destruction.
+        *
+        * A span which begins while tracing is disabled isn't recorded.
+        */
+        class scope_trace
+        {
+        public:
+            /**
+            * @brief Constructs a scope trace object, the category and the name must be static strings.
+            */
+            scope_trace(const char * category, const char * name) :
+                m_category(category), m_name(name), m_begin_time(TRACE_TRACER.is_enabled() ? event_tracer::now() : 0) {}
+
+            ~scope_trace()
+            {
+                if(m_begin_time)
+                {
+                    TRACE_TRACER.add_span(m_category, m_name, m_begin_time, event_tracer::now());
+                }
+            }
+        private:
+            const char * m_category;
+            const char * m_name;
+            const uint64_t m_begin_time;
+        };
+    }
+}
+
+#define TRACE_CONCAT_IMPL(_a, _b)           _a##_b
+#define TRACE_CONCAT(_a, _b)                TRACE_CONCAT_IMPL(_a, _b)
+
+#define TRACE_SCOPE(_category, _name)       rs::utils::scope_trace TRACE_CONCAT(trace_scope_, __LINE__)(_category, _name)
+#define TRACE_INSTANT(_category, _name)     { if (TRACE_TRACER.is_enabled()) TRACE_TRACER.add_instant(_category, _name); }
+#define TRACE_COUNTER(_category, _name, _value) { if (TRACE_TRACER.is_enabled()) TRACE_TRACER.add_counter(_category, _name, _value); }
+#define TRACE_THREAD_NAME(_name)            TRACE_TRACER.set_thread_name(_name)
@@ -2,154 +2,324 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 
-/** 
+/**
 * \file fps_counter.h
 * @brief Describes the \c rs::utils::fps_counter class.
 */
 
 #pragma once
-#include <mutex>
-#include <deque>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
 
 namespace rs
 {
     namespace utils
     {
+        /**
+         * @brief Statistics of the intervals between the ticks of the \c fps_counter rolling window.
+         */
+        struct frame_interval_statistics
+        {
+            uint64_t    intervals_count;    /**< Number of intervals in the window, the other values are zero when no interval is available */
+            double      min_ms;             /**< Shortest interval                                                                  */
+            double      max_ms;             /**< Longest interval                                                                   */
+            double      average_ms;         /**< Average interval                                                                   */
+            double      jitter_ms;          /**< Standard deviation of the intervals                                                */
+            double      median_ms;          /**< 50th percentile of the intervals                                                   */
+            double      percentile_90_ms;   /**< 90th percentile of the intervals                                                   */
+            double      percentile_99_ms;   /**< 99th percentile of the intervals                                                   */
+            uint64_t    dropped_frames;     /**< Estimated frames missing in the window, from intervals longer than the expected frame period */
+        };
+
         /**
          * @brief Provides a common way to measure FPS, regardless of the context it is used in.
          *
-         * The \c fps_counter uses a fixed size buffer to store time values so there should not be any impactful memory allocations (for example, buffer resize)
-         * after approximately 2 seconds of streaming.
-		 *
-         * Try to refrain from using time consuming operations (for example, using output stream or allocating large memory chunks) unless it is required,
-         * as they can reduce the general performance of the code block which can impact the FPS counting.
-		 *
+         * The \c fps_counter stores the time values of the last ticks in a fixed size rolling window, allocated on creation, so
+         * \c tick() never allocates memory or takes a lock. It is wait-free, and may be called concurrently from several stream
+         * callbacks, while the queries run on another thread.
+         *
+         * Besides the average FPS, the counter reports the statistics of the intervals between the ticks of the window: minimum,
+         * maximum, jitter and percentiles, and estimates the dropped frames against the expected frame rate.
+         *
          * The \c fps_counter uses a monotonic clock (with its features) to store time values,
          * however, this clock may have different precision that depends on system, STL implementation.
-		 * 
+         *
          * Time values stored have nanoseconds precision by default.
          */
         class fps_counter
         {
         public:
+            typedef std::chrono::steady_clock::time_point time_point;
+
             /**
              * @brief Creates an instance of \c fps_counter.
              *
              * Creates an instance with a device stream frame rate specified (that can be acquired by using \c get_framerate() or similar).
-             * The frame rate value is used to define the internal buffer size. The frame rate is multiplied by some magic number which helps to
-             * lessen the impact of small delays (for example, system-specific delays, intermittent rendering overheads).
-			 
+             * The frame rate value is used to define the default window size and to estimate the dropped frames. The frame rate is multiplied
+             * by some magic number which helps to lessen the impact of small delays (for example, system-specific delays, intermittent rendering overheads).
+             *
              * To count FPS for each stream separately, create one instance per stream and stream from device independently.
-			 
+             *
              * To count FPS for the whole streaming, regardless of stream amount, create only one instance and specify the stream highest frame rate
-             * to have proper FPS counting.
-             * @param[in] frame_rate Frame rate value requested for stream (for example, color stream frame rate)
+             * to have proper FPS counting. The dropped frames estimation is only meaningful for a single stream.
+             * @param[in] frame_rate    Frame rate value requested for stream (for example, color stream frame rate)
+             * @param[in] window_size   Number of the last ticks kept for the current FPS and the interval statistics, zero for 1.3 seconds of ticks
              */
-            fps_counter(unsigned int frame_rate) :
-                m_time_buffer_max_size(static_cast<size_t>(1.3 * frame_rate))
+            fps_counter(unsigned int frame_rate, size_t window_size = 0) :
+                m_frame_rate(frame_rate),
                 // Coefficient is a magic number to balance between better measurement and smaller time interval of getting proper results
                 // as valid value of fps will be counted approx. after [1 sec * coefficient] seconds
-            {}
+                m_window_size(std::max<size_t>(window_size ? window_size : static_cast<size_t>(1.3 * frame_rate), 2)),
+                m_slots_mask(round_up_to_power_of_two(m_window_size) - 1),
+                m_window(new slot[m_slots_mask + 1]),
+                m_skipped_frames(0),
+                m_frames(0),
+                m_first_time_value(no_time_value)
+            {
+                for(size_t i = 0; i <= m_slots_mask; i++)
+                {
+                    m_window[i].index.store(0, std::memory_order_relaxed);
+                    m_window[i].time_value.store(0, std::memory_order_relaxed);
+                }
+            }
 
             /**
              * @brief Captures an event of frame arrival.
              *
              * Call \c tick() on frame arrival during processing (for example, rendering).
-			 *
+             *
              * The calculated FPS reflects the ticks per second which were indicated by the user through this method.
-             * The buffer is used later to provide time values to count current or total FPS.
              * The method is the main method for the whole FPS counting and it is mandatory to call it for proper calculations.
              * The first few frames are skipped to avoid jitters of the streams at the beginning of the streaming.
-             * The method processing is guaranteed to be short to prevent FPS changes due to measurement.
+             * The method is wait-free: it reads the clock, stores the time value and publishes it with atomic operations.
              */
             void tick()
             {
-                if (m_skip_first_frames != 0) m_skip_first_frames--; // skip first frames as they may be incorrectly processed(for example, assume some buffer allocations)
-                else
+                tick(std::chrono::steady_clock::now());
+            }
+
+            /**
+             * @brief Captures an event of frame arrival at the given time, for example the time the frame was captured.
+             */
+            void tick(time_point time)
+            {
+                // skip first frames as they may be incorrectly processed(for example, assume some buffer allocations)
+                if (m_skipped_frames.load(std::memory_order_relaxed) < skip_first_frames &&
+                    m_skipped_frames.fetch_add(1, std::memory_order_relaxed) < skip_first_frames)
                 {
-                    std::lock_guard<std::mutex> lock(m_time_values_mutex);
-                    time_point time_value = std::chrono::steady_clock::now();
-                    if (m_time_buffer.size() == (m_time_buffer_max_size))
-                        m_time_buffer.pop_front();
-                    m_time_buffer.push_back(time_value);
-                    m_frames++;
-
-                    if (!m_first_time_value_set)
-                    {
-                        m_first_time_value = time_value;
-                        m_first_time_value_set = true;
-                    }
+                    return;
                 }
+
+                const int64_t time_value = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+                // the first time value is stored before the tick is counted, a reader which loads a count with acquire sees it.
+                // with concurrent first ticks, the tick which stores it first is the first one
+                if (m_first_time_value.load(std::memory_order_acquire) == no_time_value)
+                {
+                    int64_t expected_time_value = no_time_value;
+                    m_first_time_value.compare_exchange_strong(expected_time_value, time_value, std::memory_order_acq_rel, std::memory_order_acquire);
+                }
+                const uint64_t index = m_frames.fetch_add(1, std::memory_order_acq_rel);
+
+                // the slot index tells the readers which tick the time value belongs to, it is cleared while the slot is written
+                slot & current_slot = m_window[index & m_slots_mask];
+                current_slot.index.store(0, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                current_slot.time_value.store(time_value, std::memory_order_relaxed);
+                current_slot.index.store(index + 1, std::memory_order_release);
             }
 
             /**
              * @brief Calculates average FPS throughout the entire streaming session between first and last ticks.
              *
-             * The returned value is the total average FPS for some process (for example, streaming, rendering) based on 
-			 * frames count and elapsed time between first and last \c tick() calls.
+             * The returned value is the total average FPS for some process (for example, streaming, rendering) based on
+             * frames count and elapsed time between first and last \c tick() calls.
              * The method is the main method to get total FPS.
-			 *
-             * A valid FPS is expected to be available after <tt>[1 sec * buffer_size / stream frame rate]</tt> seconds. 
-			 * Before that period elapses, the average FPS is unpredictable.
-             * The method processing is guaranteed to be short to prevent FPS changes due to measurement.
+             *
+             * A valid FPS is expected to be available after <tt>[1 sec * buffer_size / stream frame rate]</tt> seconds.
+             * Before that period elapses, the average FPS is unpredictable.
              * @return const double Total average FPS
              */
             const double total_average_fps()
             {
-                std::lock_guard<std::mutex> lock(m_time_values_mutex);
-                if (!m_first_time_value_set)
+                const uint64_t frames = m_frames.load(std::memory_order_acquire);
+                if (!frames)
                 {
                     throw std::out_of_range("No time values were stored with tick()");
                 }
-                const long billion = 1000000000;
-                const double time_delta = static_cast<double>(
-                        (long double)(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                          m_time_buffer.back() - m_first_time_value).count()) / billion);
-                return (static_cast<double>(m_frames - 1) / time_delta);
+                std::vector<int64_t> time_values = query_window_time_values();
+                if (time_values.empty()) return 0;
+                const double time_delta = nanoseconds_to_seconds(time_values.back() - m_first_time_value.load(std::memory_order_acquire));
+                if (time_delta <= 0) return 0;
+                return (static_cast<double>(frames - 1) / time_delta);
             }
 
             /**
              * @brief Returns the last second average FPS.
              *
-             * The returned value is the last second average FPS for the utility user based on the ticks data that was provided.
+             * The returned value is the average FPS of the rolling window, which holds the last second of ticks by default.
              * The method is the main method to get last second FPS.
-             * A valid FPS is expected to be available after <tt>[1 sec * buffer_size / stream frame rate]</tt> seconds. 
-			 * Before that period elapses, the average FPS is unpredictable.
-             * The method processing is guaranteed to be short to prevent FPS changes due to measurement.
+             * A valid FPS is expected to be available after <tt>[1 sec * buffer_size / stream frame rate]</tt> seconds.
+             * Before that period elapses, the average FPS is unpredictable.
              * @return const double Current average FPS
              */
             const double current_fps()
             {
-                std::lock_guard<std::mutex> lock(m_time_values_mutex);
-                const size_t time_buffer_size = m_time_buffer.size();
-                if (!time_buffer_size) return 0;
-                const long billion = 1000000000;
-                const double time_delta = static_cast<double>(
-                        (long double)(std::chrono::duration_cast<std::chrono::nanoseconds>(
-                                          m_time_buffer.back() - m_time_buffer.front()).count()) / billion);
+                std::vector<int64_t> time_values = query_window_time_values();
+                if (time_values.size() < 2) return 0;
+                const double time_delta = nanoseconds_to_seconds(time_values.back() - time_values.front());
                 if (time_delta == 0) return 0;
-                return (static_cast<double>(time_buffer_size - 1) / time_delta);
+                return (static_cast<double>(time_values.size() - 1) / time_delta);
+            }
+
+            /**
+             * @brief Returns the statistics of the intervals between the ticks of the rolling window.
+             */
+            frame_interval_statistics query_interval_statistics()
+            {
+                frame_interval_statistics statistics = {};
+                std::vector<int64_t> time_values = query_window_time_values();
+                if (time_values.size() < 2) return statistics;
+
+                std::vector<double> intervals(time_values.size() - 1);
+                double sum = 0, squares_sum = 0;
+                const double frame_period_ms = m_frame_rate ? 1000.0 / m_frame_rate : 0;
+                for (size_t i = 0; i < intervals.size(); i++)
+                {
+                    intervals[i] = static_cast<double>(time_values[i + 1] - time_values[i]) / 1000000.0;
+                    sum += intervals[i];
+                    squares_sum += intervals[i] * intervals[i];
+                    // an interval of n frame periods misses n - 1 frames, half a period is tolerated
+                    if (frame_period_ms > 0)
+                    {
+                        const double missing_frames = std::floor(intervals[i] / frame_period_ms + 0.5) - 1;
+                        statistics.dropped_frames += missing_frames > 0 ? static_cast<uint64_t>(missing_frames) : 0;
+                    }
+                }
+                std::sort(intervals.begin(), intervals.end());
+
+                const double count = static_cast<double>(intervals.size());
+                statistics.intervals_count = intervals.size();
+                statistics.min_ms = intervals.front();
+                statistics.max_ms = intervals.back();
+                statistics.average_ms = sum / count;
+                statistics.jitter_ms = std::sqrt(std::max(squares_sum / count - statistics.average_ms * statistics.average_ms, 0.0));
+                statistics.median_ms = sorted_percentile(intervals, 50);
+                statistics.percentile_90_ms = sorted_percentile(intervals, 90);
+                statistics.percentile_99_ms = sorted_percentile(intervals, 99);
+                return statistics;
+            }
+
+            /**
+             * @brief Returns a percentile of the intervals between the ticks of the rolling window, in milliseconds.
+             * @param[in] percentile    Percentile in the range [0, 100]
+             * @return const double     The interval, zero if less than two ticks are available
+             */
+            const double interval_percentile_ms(double percentile)
+            {
+                std::vector<int64_t> time_values = query_window_time_values();
+                if (time_values.size() < 2) return 0;
+                std::vector<double> intervals(time_values.size() - 1);
+                for (size_t i = 0; i < intervals.size(); i++)
+                {
+                    intervals[i] = static_cast<double>(time_values[i + 1] - time_values[i]) / 1000000.0;
+                }
+                std::sort(intervals.begin(), intervals.end());
+                return sorted_percentile(intervals, percentile);
             }
 
+            /**
+             * @brief Estimates the frames dropped during the entire streaming session, against the expected frame rate.
+             *
+             * The estimation is the number of frame periods between the first and last ticks, less the ticks counted.
+             * @return uint64_t Estimated number of dropped frames, zero if the ticks kept up with the expected frame rate
+             */
+            uint64_t estimated_dropped_frames()
+            {
+                const uint64_t frames = m_frames.load(std::memory_order_acquire);
+                std::vector<int64_t> time_values = query_window_time_values();
+                if (frames < 2 || time_values.empty() || !m_frame_rate) return 0;
+                const double time_delta = nanoseconds_to_seconds(time_values.back() - m_first_time_value.load(std::memory_order_acquire));
+                const double expected_frames = std::floor(time_delta * m_frame_rate + 0.5) + 1;
+                return expected_frames > static_cast<double>(frames) ? static_cast<uint64_t>(expected_frames) - frames : 0;
+            }
+
+            /**
+             * @brief Returns the number of ticks counted, not including the skipped first frames.
+             */
+            uint64_t frames_count() const
+            {
+                return m_frames.load(std::memory_order_acquire);
+            }
 
         private:
             fps_counter() = delete;
             fps_counter(const fps_counter&) = delete;
             const fps_counter& operator=(const fps_counter&) = delete;
 
+            static const int skip_first_frames = 5; /**< number of possibly invalid frames at stream start */
+            static const int64_t no_time_value = std::numeric_limits<int64_t>::min(); /**< first time value before the first tick */
 
-            int                    m_frames = 0; /**< number of frames */
+            struct slot
+            {
+                std::atomic<uint64_t>   index;      /**< tick index + 1 of the time value, zero while it is written */
+                std::atomic<int64_t>    time_value; /**< time value in nanoseconds */
+            };
 
-            //typedef for shorter usage
-            typedef std::chrono::time_point<std::chrono::steady_clock, std::chrono::nanoseconds> time_point;
-            std::deque<time_point> m_time_buffer; /**< time values buffer with nanosecond precision */
-            time_point             m_first_time_value; /**< first time value to calculate total average FPS */
+            static size_t round_up_to_power_of_two(size_t value)
+            {
+                size_t power = 1;
+                while (power < value) power <<= 1;
+                return power;
+            }
+
+            static double nanoseconds_to_seconds(int64_t nanoseconds)
+            {
+                return static_cast<double>(nanoseconds) / 1000000000.0;
+            }
+
+            static double sorted_percentile(const std::vector<double> & sorted_values, double percentile)
+            {
+                const double position = std::min(std::max(percentile, 0.0), 100.0) / 100.0 * static_cast<double>(sorted_values.size() - 1);
+                const size_t lower = static_cast<size_t>(position);
+                const size_t upper = std::min(lower + 1, sorted_values.size() - 1);
+                return sorted_values[lower] + (sorted_values[upper] - sorted_values[lower]) * (position - static_cast<double>(lower));
+            }
+
+            // copies the time values of the window, skipping the slots which are written during the copy, sorted by time
+            std::vector<int64_t> query_window_time_values()
+            {
+                std::vector<int64_t> time_values;
+                const uint64_t frames = m_frames.load(std::memory_order_acquire);
+                const uint64_t first_index = frames > m_window_size ? frames - m_window_size : 0;
+                time_values.reserve(static_cast<size_t>(frames - first_index));
+                for (uint64_t index = first_index; index < frames; index++)
+                {
+                    slot & current_slot = m_window[index & m_slots_mask];
+                    if (current_slot.index.load(std::memory_order_acquire) != index + 1) continue;
+                    const int64_t time_value = current_slot.time_value.load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (current_slot.index.load(std::memory_order_relaxed) != index + 1) continue;
+                    time_values.push_back(time_value);
+                }
+                // concurrent ticks may publish their time values out of order
+                std::sort(time_values.begin(), time_values.end());
+                return time_values;
+            }
 
-            const size_t           m_time_buffer_max_size; /**< max supposed size of time values buffer */
-            bool                   m_first_time_value_set = false; /**< flag for the first time value */
-            int                    m_skip_first_frames = 5; /**< number of possibly invalid frames at stream start */
-            std::mutex             m_time_values_mutex; /**< mutex for time values */
+            const unsigned int          m_frame_rate; /**< expected frame rate */
+            const size_t                m_window_size; /**< number of ticks in the rolling window */
+            const size_t                m_slots_mask; /**< the slots count is a power of two, at least the window size */
+            std::unique_ptr<slot[]>     m_window; /**< time values of the last ticks, indexed by the masked tick index */
+            std::atomic<int>            m_skipped_frames; /**< number of first frames skipped */
+            std::atomic<uint64_t>       m_frames; /**< number of frames */
+            std::atomic<int64_t>        m_first_time_value; /**< first time value to calculate total average FPS */
         };
     }
 }
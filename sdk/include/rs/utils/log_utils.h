@@ -8,10 +8,13 @@
 
 #pragma once
 #include "rs/utils/logging_service.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string>
 #include <sstream>
+#include <atomic>
+#include <mutex>
 
 #ifdef WIN32 
 #ifdef realsense_log_utils_EXPORTS
@@ -27,8 +30,12 @@ namespace rs
 {
     namespace utils
     {
+        class async_logging_service;
+
         /**
         * @brief Creates and holds a logger to be used for logging messages
+        *
+        * Setting the environment variable \c REALSENSE_SDK_LOG_ASYNC to a number of records enables the async logging mode on creation.
         */
 		class DLL_EXPORT log_util
         {
@@ -40,15 +47,76 @@ namespace rs
             log_util(wchar_t* name = NULL);
             virtual ~log_util();
 
+            /**
+            * @brief Writes the log messages from a background thread, so the log calls only copy the message to a ring buffer.
+            *
+            * The \c LOG_* macros still format the message on the calling thread, the background thread takes the layout and the write
+            * of the logging service. May be called while other threads log, has no effect when the logger is the empty logger.
+            * The async logging service wraps the current \c m_logger. It is created by the first call and deleted with the \c log_util,
+            * since a thread may still be using it after async mode is disabled, so its capacity and overflow policy are set by the first call.
+            * @param[in] capacity         Number of messages the ring buffer holds
+            * @param[in] block_on_overflow  Log calls wait when the ring buffer is full, otherwise the messages are dropped and counted
+            * @return status_no_error           Successful execution
+            * @return status_feature_unsupported  The logger is the empty logger
+            * @return status_param_unsupported    The capacity or the overflow policy differ from those of the first call
+            */
+            rs::core::status enable_async_mode(uint32_t capacity = 4096, bool block_on_overflow = false);
+
+            /**
+            * @brief Writes the pending log messages and returns to logging on the calling thread.
+            *
+            * A message logged concurrently by a thread which still uses the async logging service is written by its background thread.
+            */
+            void disable_async_mode();
+
+            /**
+            * @brief Returns the logger the log macros use: the async logging service in async mode, \c m_logger otherwise.
+            */
+            logging_service* get_active_logger()
+            {
+                logging_service* async_logger = m_active_async_logger.load(std::memory_order_acquire);
+                return async_logger ? async_logger : m_logger;
+            }
+
+            /**
+            * @brief Sets the logger level and refreshes the level cached for \c scope_log.
+            * @param[in] level Minimal logging level
+            * @return status of the logger \c set_level call
+            */
+            rs::core::status set_level(logging_service::log_level level);
+
+            /**
+            * @brief Caches the minimal level the active logger may log at, so a disabled \c scope_log doesn't call the logger.
+            *
+            * Called by \c set_level and by the async mode switches, should be called after replacing \c m_logger or changing its level
+            * directly through the logger.
+            */
+            void refresh_level();
+
+            /**
+            * @brief Returns false when the cached level rules out logging at the given level, without calling the logger.
+            */
+            bool may_log(logging_service::log_level level) const
+            {
+                return level >= m_min_level.load(std::memory_order_relaxed);
+            }
+
             logging_service* m_logger;      /**< Pointer to an object implementing the \c logging_service interface */
             empty_logger m_empty_logger;    /**< Default (empty) logger, with empty implementation of all log functions. Logs to /dev/null. */
+        private:
+            std::atomic<logging_service*> m_active_async_logger;  //published while async mode is enabled
+            std::atomic<logging_service::log_level> m_min_level;  //the levels below it are disabled, 0 when unknown
+            std::mutex m_async_mode_lock;
+            async_logging_service* m_async_logger;  //kept after async mode is disabled, deleted with the log util
+            uint32_t m_async_capacity;
+            bool m_async_block_on_overflow;
         };
     }
 }
 
 extern DLL_EXPORT rs::utils::log_util logger;
 
-#define LOG_LOGGER  logger.m_logger // default logger
+#define LOG_LOGGER  logger.get_active_logger() // default logger
 
 #define LOG_LEVEL_FATAL_ERROR	rs::utils::logging_service::level_fatal
 #define LOG_LEVEL_ERROR			rs::utils::logging_service::level_error
@@ -62,6 +130,26 @@ extern DLL_EXPORT rs::utils::log_util logger;
 #define __FUNCSIG__   __FUNCTION__
 #endif
 
+/**
+* @brief Minimal level of the compiled log statements.
+*
+* Log statements with a lower level are compiled out and cost nothing at runtime, while the statements at the minimal level or
+* above are filtered by the logger level at runtime. The value is one of the \c logging_service::log_level_values, for example
+* 10000 compiles out the verbose and trace statements. Defined by the \c LOG_MIN_LEVEL CMake option, zero keeps all the statements.
+*/
+#ifndef RS_LOG_MIN_LEVEL
+#define RS_LOG_MIN_LEVEL 0
+#endif
+
+/**
+* @brief True if log statements of the given level are compiled, a constant expression for constant levels.
+*/
+#if RS_LOG_MIN_LEVEL > 0
+#define LOG_LEVEL_COMPILED(_level)  (static_cast<unsigned int>(_level) >= static_cast<unsigned int>(RS_LOG_MIN_LEVEL))
+#else
+#define LOG_LEVEL_COMPILED(_level)  true
+#endif
+
 /* _TRUNCATE */
 #if !defined(_TRUNCATE)
 #define _TRUNCATE ((size_t)-1)
@@ -74,7 +162,7 @@ extern DLL_EXPORT rs::utils::log_util logger;
 */
 #define LOG(_level, ...)            												\
 {                                                       							\
-if (LOG_LOGGER->is_level_enabled(_level))               							\
+if (LOG_LEVEL_COMPILED(_level) && LOG_LOGGER->is_level_enabled(_level))             \
     {                                                   							\
         char szBuffer[1024];                            							\
         snprintf(szBuffer, 1024, __VA_ARGS__); 										\
@@ -89,7 +177,7 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
 */
 #define LOG_CFORMAT(_logger, _level, ...)            						\
 {                                                       					\
-    if (_logger->is_level_enabled(_level))                					\
+    if (LOG_LEVEL_COMPILED(_level) && _logger->is_level_enabled(_level))    \
     {                                                   					\
         char szBuffer[1024] = "";                       					\
         szBuffer[sizeof(szBuffer) - 1] = 0;             					\
@@ -106,7 +194,7 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
 */
 #define LOG_STREAM(_logger, _level, _message)        									\
 {                                                       								\
-    if (_logger->is_level_enabled(_level))                								\
+    if (LOG_LEVEL_COMPILED(_level) && _logger->is_level_enabled(_level))                \
     {                                                   								\
         std::basic_ostringstream<wchar_t> _stream;      								\
         _stream << _message;                            								\
@@ -114,26 +202,48 @@ if (LOG_LOGGER->is_level_enabled(_level))               							\
     }                                                   								\
 }
 
+/* the statements below RS_LOG_MIN_LEVEL expand to an empty block, so their arguments aren't even compiled */
+#if RS_LOG_MIN_LEVEL > 2500
+#define LOG_VERBOSE(_message)        {}
+#define LOG_TRACE(_message)          {}
+#define LOG_VERBOSE_VAR(_var)        {}
+#define LOG_VERBOSE_CFORMAT(...)     {}
+#else
 #define LOG_VERBOSE(_message)        LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, _message)
 #define LOG_TRACE(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, _message)
+#define LOG_VERBOSE_VAR(_var)        LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, #_var " = " << _var)
+#define LOG_VERBOSE_CFORMAT(...)     LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_VERBOSE, __VA_ARGS__)
+#endif
+
+#if RS_LOG_MIN_LEVEL > 5000
+#define LOG_TRACE_VAR(_var)          {}
+#define LOG_TRACE_CFORMAT(...)       {}
+#else
+#define LOG_TRACE_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_TRACE, #_var " = " << _var)
+#define LOG_TRACE_CFORMAT(...)       LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_TRACE, __VA_ARGS__)
+#endif
+
+#if RS_LOG_MIN_LEVEL > 10000
+#define LOG_DEBUG(_message)          {}
+#define LOG_DEBUG_VAR(_var)          {}
+#define LOG_DEBUG_CFORMAT(...)       {}
+#else
 #define LOG_DEBUG(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_DEBUG, _message)
+#define LOG_DEBUG_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_DEBUG, #_var " = " << _var)
+#define LOG_DEBUG_CFORMAT(...)       LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_DEBUG, __VA_ARGS__)
+#endif
+
 #define LOG_INFO(_message)           LOG_STREAM(LOG_LOGGER, LOG_LEVEL_INFO,  _message)
 #define LOG_WARN(_message)           LOG_STREAM(LOG_LOGGER, LOG_LEVEL_WARNING,  _message)
 #define LOG_ERROR(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_ERROR, _message)
 #define LOG_FATAL(_message)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_FATAL_ERROR, _message)
 
-#define LOG_VERBOSE_VAR(_var)        LOG_STREAM(LOG_LOGGER, LOG_LEVEL_VERBOSE, #_var " = " << _var)
-#define LOG_TRACE_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_TRACE, #_var " = " << _var)
-#define LOG_DEBUG_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_DEBUG, #_var " = " << _var)
 #define LOG_INFO_VAR(_var)           LOG_STREAM(LOG_LOGGER, LOG_LEVEL_INFO,  #_var " = " << _var)
 #define LOG_WARN_VAR(_var)           LOG_STREAM(LOG_LOGGER, LOG_LEVEL_WARNING,  #_var " = " << _var)
 #define LOG_ERROR_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_ERROR, #_var " = " << _var)
 #define LOG_FATAL_VAR(_var)          LOG_STREAM(LOG_LOGGER, LOG_LEVEL_FATAL_ERROR, #_var " = " << _var)
 #define LOG_LEVEL_VAR(_level, _var)  LOG_STREAM(LOG_LOGGER, _level, #_var " = " << _var)
 
-#define LOG_VERBOSE_CFORMAT(...)     LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_VERBOSE, __VA_ARGS__)
-#define LOG_TRACE_CFORMAT(...)       LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_TRACE, __VA_ARGS__)
-#define LOG_DEBUG_CFORMAT(...)       LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_DEBUG, __VA_ARGS__)
 #define LOG_INFO_CFORMAT(...)        LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_INFO,  __VA_ARGS__)
 #define LOG_WARN_CFORMAT(...)        LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_WARNING,  __VA_ARGS__)
 #define LOG_ERROR_CFORMAT(...)       LOG_CFORMAT(LOG_LOGGER, LOG_LEVEL_ERROR, __VA_ARGS__)
@@ -151,27 +261,45 @@ namespace rs
     {
         /**
         * @brief Class for scoped log objects. The object will log at the creation and destruction moments only.
+        *
+        * The logger level is checked once, on creation, against the level cached by \c log_util::refresh_level, so a disabled scope log
+        * doesn't call the logger.
         */
         class scope_log
         {
         public:
             /**
             * @brief Constructs a scope log object. The object will log at the creation and destruction moments only.
-            * @param[in] msg Message to be logged when the object is created and destructed
+            * @param[in] msg Message to be logged when the object is created and destructed, a static string
+            * @param[in] level Logging level of the messages
             */
-            scope_log(const char* msg): _msg(msg)
+            scope_log(const char* msg, logging_service::log_level level = LOG_LEVEL_TRACE):
+                _msg(msg), _level(level), _is_enabled(logger.may_log(level) && LOG_LOGGER->is_level_enabled(level))
             {
-                LOG_TRACE_CFORMAT("%s - begin", _msg);
+                if (_is_enabled)
+                {
+                    LOG_CFORMAT(LOG_LOGGER, _level, "%s - begin", _msg);
+                }
             }
 
             ~scope_log()
             {
-                LOG_TRACE_CFORMAT("%s - end", _msg);
+                if (_is_enabled)
+                {
+                    LOG_CFORMAT(LOG_LOGGER, _level, "%s - end", _msg);
+                }
             }
         private:
             const char* _msg;
+            const logging_service::log_level _level;
+            const bool _is_enabled;
         };
     }
 }
 
+/* the function scope logs at the trace level, it is compiled out with the trace statements */
+#if RS_LOG_MIN_LEVEL > 5000
+#define LOG_FUNC_SCOPE()
+#else
 #define LOG_FUNC_SCOPE()      rs::utils::scope_log log(__FUNCTION__)
+#endif
@@ -0,0 +1,103 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file organized_point_cloud_interface.h
+* @brief Describes the \c rs::utils::organized_point_cloud_interface class.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "rs/core/status.h"
+#include "rs/core/types.h"
+#include "rs/core/release_interface.h"
+
+#ifdef WIN32
+#ifdef realsense_point_cloud_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_point_cloud_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Processing utilities for organized point clouds.
+        *
+        * An organized point cloud is the output of \c projection_interface::query_vertices: a \c point3dF32 array of depth
+        * \c width*height, where a vertex with a zero Z value has no valid depth.
+        * All the methods write to caller provided buffers. Internal buffers are allocated on the first call for a given
+        * resolution and reused by the next calls, so steady state processing doesn't allocate memory.
+        * The instance is not thread safe, calls should not be made concurrently.
+        */
+        class DLL_EXPORT organized_point_cloud_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Creates an organized point cloud utility instance.
+            * @param[in]  threads_count   Number of threads used by the per pixel methods, including the calling thread.
+            *                             Zero uses the number of hardware threads.
+            * @return organized_point_cloud_interface *   Instance, to be released with \c release
+            */
+            static organized_point_cloud_interface * create_instance(uint32_t threads_count = 0);
+
+            /**
+            * @brief Computes the validity mask of the vertices.
+            * @param[in]  vertices        Depth sized vertices array
+            * @param[in]  size            Depth image size
+            * @param[out] mask            Depth sized mask, 255 for valid vertices and 0 for invalid ones
+            * @param[out] valid_count     Optional, number of valid vertices
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null vertices or mask
+            * @return status_param_unsupported  Invalid size
+            */
+            virtual rs::core::status query_validity_mask(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size,
+                                                         uint8_t * mask, int32_t * valid_count = nullptr) = 0;
+
+            /**
+            * @brief Computes per pixel surface normals.
+            *
+            * The normal of each vertex is the normalized cross product of the vectors between its vertical and horizontal neighbors,
+            * oriented towards the camera. A missing neighbor is replaced by the vertex itself. The normal is set to zero when the
+            * vertex is invalid, or when no valid neighbor exists in one of the directions.
+            * @param[in]  vertices               Depth sized vertices array
+            * @param[in]  size                   Depth image size
+            * @param[out] normals                Depth sized unit normals array
+            * @param[in]  max_depth_difference   Neighbors which depth differs from the vertex depth by more than this value, in millimeters,
+            *                                    are considered missing, to avoid normals across depth discontinuities. Zero disables the check.
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null vertices or normals
+            * @return status_param_unsupported  Invalid size
+            */
+            virtual rs::core::status query_normals(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size,
+                                                   rs::core::point3dF32 * normals, float max_depth_difference = 0) = 0;
+
+            /**
+            * @brief Downsamples the valid vertices with a voxel grid.
+            *
+            * Each occupied voxel is replaced by the centroid of the vertices it contains. Up to \c width*height points are returned.
+            * @param[in]  vertices        Depth sized vertices array
+            * @param[in]  size            Depth image size
+            * @param[in]  voxel_size      Voxel edge length, in millimeters
+            * @param[out] points          Output centroids array
+            * @param[in]  points_capacity Number of elements in the points array
+            * @param[out] points_count    Number of centroids written
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null vertices, points or points_count
+            * @return status_param_unsupported  Invalid size or voxel size
+            * @return status_value_out_of_range The points array is too small, only the first \c points_capacity centroids are written
+            */
+            virtual rs::core::status voxel_grid_downsample(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size, float voxel_size,
+                                                           rs::core::point3dF32 * points, int32_t points_capacity, int32_t * points_count) = 0;
+
+        protected:
+            virtual ~organized_point_cloud_interface() {}
+        };
+    }
+}
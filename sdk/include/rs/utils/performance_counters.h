@@ -0,0 +1,303 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* \file performance_counters.h
+* @brief Describes the \c rs::utils::performance_counters registry and its counter, gauge and histogram classes.
+*/
+
+#pragma once
+#include <stdint.h>
+#include <stdio.h>
+#include <atomic>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rs/core/status.h"
+
+#ifdef WIN32
+#ifdef realsense_log_utils_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_log_utils_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Monotonic counter, for example of written bytes or dropped frames. Updates are relaxed atomic additions.
+        */
+        class performance_counter
+        {
+        public:
+            performance_counter() : m_value(0) {}
+            performance_counter(const performance_counter &) = delete;
+            performance_counter & operator=(const performance_counter &) = delete;
+
+            void add(int64_t value = 1) { m_value.fetch_add(value, std::memory_order_relaxed); }
+            int64_t query() const { return m_value.load(std::memory_order_relaxed); }
+            void reset() { m_value.store(0, std::memory_order_relaxed); }
+        private:
+            std::atomic<int64_t> m_value;
+        };
+
+        /**
+        * @brief Current value of a level, for example a queue size, with the maximal value it reached.
+        */
+        class performance_gauge
+        {
+        public:
+            performance_gauge() : m_value(0), m_max(0) {}
+            performance_gauge(const performance_gauge &) = delete;
+            performance_gauge & operator=(const performance_gauge &) = delete;
+
+            void set(int64_t value)
+            {
+                m_value.store(value, std::memory_order_relaxed);
+                update_max(value);
+            }
+
+            void add(int64_t delta) { update_max(m_value.fetch_add(delta, std::memory_order_relaxed) + delta); }
+            int64_t query() const { return m_value.load(std::memory_order_relaxed); }
+            int64_t query_max() const { return m_max.load(std::memory_order_relaxed); }
+            void reset() { m_max.store(m_value.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+        private:
+            void update_max(int64_t value)
+            {
+                int64_t max = m_max.load(std::memory_order_relaxed);
+                while(value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+            }
+
+            std::atomic<int64_t> m_value;
+            std::atomic<int64_t> m_max;
+        };
+
+        /**
+        * @brief Distribution of a measured value, for example a processing time, in power of two buckets.
+        *
+        * Bucket i counts the values in the range [2^(i-1), 2^i), the percentiles are interpolated within their bucket.
+        */
+        class performance_histogram
+        {
+        public:
+            static const uint32_t buckets_count = 64;
+
+            performance_histogram() { reset(); }
+            performance_histogram(const performance_histogram &) = delete;
+            performance_histogram & operator=(const performance_histogram &) = delete;
+
+            void record(int64_t value)
+            {
+                const uint64_t positive_value = value > 0 ? static_cast<uint64_t>(value) : 0;
+                m_buckets[bucket_index(positive_value)].fetch_add(1, std::memory_order_relaxed);
+                m_count.fetch_add(1, std::memory_order_relaxed);
+                m_sum.fetch_add(value, std::memory_order_relaxed);
+                int64_t min = m_min.load(std::memory_order_relaxed);
+                while(value < min && !m_min.compare_exchange_weak(min, value, std::memory_order_relaxed)) {}
+                int64_t max = m_max.load(std::memory_order_relaxed);
+                while(value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+            }
+
+            uint64_t query_count() const { return m_count.load(std::memory_order_relaxed); }
+            int64_t query_sum() const { return m_sum.load(std::memory_order_relaxed); }
+            int64_t query_min() const { return query_count() ? m_min.load(std::memory_order_relaxed) : 0; }
+            int64_t query_max() const { return query_count() ? m_max.load(std::memory_order_relaxed) : 0; }
+
+            /**
+            * @brief Estimates a percentile of the recorded values.
+            * @param[in] percentile   Percentile in the range [0, 100]
+            * @return double          The estimated value, zero when no value was recorded
+            */
+            double query_percentile(double percentile) const
+            {
+                uint64_t counts[buckets_count];
+                uint64_t total = 0;
+                for(uint32_t i = 0; i < buckets_count; i++)
+                {
+                    counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+                    total += counts[i];
+                }
+                if(!total)
+                {
+                    return 0;
+                }
+
+                const double rank = (percentile < 0 ? 0 : percentile > 100 ? 100 : percentile) / 100.0 * static_cast<double>(total);
+                uint64_t cumulative = 0;
+                for(uint32_t i = 0; i < buckets_count; i++)
+                {
+                    if(counts[i] && static_cast<double>(cumulative + counts[i]) >= rank)
+                    {
+                        const double lower = i ? static_cast<double>(uint64_t(1) << (i - 1)) : 0;
+                        const double upper = i ? lower * 2 : 1;
+                        const double estimate = lower + (upper - lower) * (rank - static_cast<double>(cumulative)) / static_cast<double>(counts[i]);
+                        const double min = static_cast<double>(query_min()), max = static_cast<double>(query_max());
+                        return estimate < min ? min : estimate > max ? max : estimate;
+                    }
+                    cumulative += counts[i];
+                }
+                return static_cast<double>(query_max());
+            }
+
+            void reset()
+            {
+                for(uint32_t i = 0; i < buckets_count; i++)
+                {
+                    m_buckets[i].store(0, std::memory_order_relaxed);
+                }
+                m_count.store(0, std::memory_order_relaxed);
+                m_sum.store(0, std::memory_order_relaxed);
+                m_min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+                m_max.store(std::numeric_limits<int64_t>::min(), std::memory_order_relaxed);
+            }
+        private:
+            static uint32_t bucket_index(uint64_t value)
+            {
+                uint32_t index = 0;
+                while(value && index < buckets_count - 1)
+                {
+                    value >>= 1;
+                    index++;
+                }
+                return index;
+            }
+
+            std::atomic<uint64_t> m_buckets[buckets_count];
+            std::atomic<uint64_t> m_count;
+            std::atomic<int64_t> m_sum;
+            std::atomic<int64_t> m_min;
+            std::atomic<int64_t> m_max;
+        };
+
+        /**
+        * @brief Type of a registered performance counter.
+        */
+        enum class performance_counter_type
+        {
+            counter,
+            gauge,
+            histogram
+        };
+
+        /**
+        * @brief Snapshot of a registered performance counter.
+        */
+        struct performance_counter_value
+        {
+            std::string                 name;
+            performance_counter_type    type;
+            int64_t                     value;          /**< Counter value, gauge current value, or number of histogram values */
+            int64_t                     min;            /**< Minimal histogram value                                            */
+            int64_t                     max;            /**< Maximal gauge or histogram value                                   */
+            double                      average;        /**< Average histogram value                                            */
+            double                      percentile_50;  /**< Estimated histogram median                                         */
+            double                      percentile_90;  /**< Estimated histogram 90th percentile                                */
+            double                      percentile_99;  /**< Estimated histogram 99th percentile                                */
+        };
+
+        /**
+        * @brief Process wide registry of named performance counters, gauges and histograms.
+        *
+        * The SDK components register their counters by name on creation and keep a reference to them, which stays valid for the
+        * registry lifetime, so an update on a hot path is a single relaxed atomic operation. The names are dot separated, starting
+        * with the component, for example \c record.bytes_written. Components of the same kind, such as two recorders, share their counters.
+        *
+        * The counters are read with \c query_values, and may be dumped periodically to a file as one JSON object per line.
+        * Setting the environment variable \c REALSENSE_SDK_PERF_COUNTERS to a file path starts a periodic dump of \c PERF_COUNTERS every second on startup.
+        */
+        class DLL_EXPORT performance_counters
+        {
+        public:
+            performance_counters();
+            virtual ~performance_counters();
+
+            performance_counters(const performance_counters &) = delete;
+            performance_counters & operator=(const performance_counters &) = delete;
+
+            /**
+            * @brief Returns the counter with the given name, registering it on first use.
+            *
+            * Throws \c std::invalid_argument if the name is registered with another type.
+            */
+            performance_counter & query_counter(const std::string & name);
+
+            /**
+            * @brief Returns the gauge with the given name, registering it on first use.
+            */
+            performance_gauge & query_gauge(const std::string & name);
+
+            /**
+            * @brief Returns the histogram with the given name, registering it on first use.
+            */
+            performance_histogram & query_histogram(const std::string & name);
+
+            /**
+            * @brief Returns a snapshot of all the registered counters, sorted by name.
+            */
+            std::vector<performance_counter_value> query_values();
+
+            /**
+            * @brief Returns a snapshot of a registered counter.
+            * @param[in]  name                  Counter name
+            * @param[out] value                 Counter snapshot
+            * @return status_no_error           Successful execution
+            * @return status_item_unavailable   No counter is registered with this name
+            */
+            rs::core::status query_value(const std::string & name, performance_counter_value & value);
+
+            /**
+            * @brief Resets the counters and the histograms, and the gauges maximal values to their current values.
+            */
+            void reset();
+
+            /**
+            * @brief Starts writing all the counters to a file periodically, one JSON object per line, replacing a running dump.
+            * @param[in] file_path              Path of the file, overwritten if exists
+            * @param[in] period_ms              Time between two writes
+            * @return status_no_error           Successful execution
+            * @return status_file_open_failed   The file could not be created
+            */
+            rs::core::status start_periodic_dump(const std::string & file_path, uint32_t period_ms = 1000);
+
+            /**
+            * @brief Writes the counters a last time and stops the periodic dump.
+            */
+            void stop_periodic_dump();
+
+        private:
+            struct entry
+            {
+                performance_counter_type                    type;
+                std::unique_ptr<performance_counter>        counter;
+                std::unique_ptr<performance_gauge>          gauge;
+                std::unique_ptr<performance_histogram>      histogram;
+            };
+
+            entry & query_entry(const std::string & name, performance_counter_type type);
+            static performance_counter_value make_value(const std::string & name, const entry & counter_entry);
+            void dump_loop(FILE * file, uint32_t period_ms);
+
+            std::mutex                      m_entries_lock;
+            std::map<std::string, entry>    m_entries;
+
+            std::mutex                      m_dump_lock;
+            std::condition_variable         m_dump_stop;
+            bool                            m_is_dump_stopping;
+            std::thread                     m_dump_thread;
+        };
+    }
+}
+
+extern DLL_EXPORT rs::utils::performance_counters perf_counters;
+
+#define PERF_COUNTERS  perf_counters // default performance counters registry
@@ -0,0 +1,127 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file point_cloud_writer_interface.h
+* @brief Describes the \c rs::utils::point_cloud_writer_interface class.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "rs/core/status.h"
+#include "rs/core/types.h"
+#include "rs/core/image_interface.h"
+
+#ifdef WIN32
+#ifdef realsense_point_cloud_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_point_cloud_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Point cloud file formats supported by the writer.
+        */
+        enum class point_cloud_format
+        {
+            ply,    /**< Stanford PLY, binary little endian                       */
+            pcd     /**< Point Cloud Library PCD v0.7, binary unorganized data    */
+        };
+
+        /**
+        * @brief Single point cloud to be written.
+        *
+        * The vertices buffer is the output of \c projection_interface::query_vertices, a \c point3dF32 array of depth
+        * \c width*height, in millimeters. Vertices with a zero or non finite Z value are filtered out.
+        * To add color, provide the color image and the uvmap returned by \c projection_interface::query_uvmap for the same
+        * depth image. Vertices which have no valid color mapping are written in black.
+        */
+        struct point_cloud_frame
+        {
+            const rs::core::point3dF32 *     vertices;   /**< Depth sized vertices array                                       */
+            rs::core::sizeI32                size;       /**< Depth image size                                                 */
+            rs::core::image_interface *      color;      /**< Optional color image - rgb8, bgr8, rgba8 or bgra8 formats        */
+            const rs::core::pointF32 *       uvmap;      /**< Optional uvmap, depth sized. Required when color is set          */
+        };
+
+        /**
+        * @brief Writes point clouds in binary PLY or PCD format directly from the vertices buffer.
+        *
+        * Frames can be written synchronously with \c write or queued with \c write_async, in which case they are serialized
+        * and written to disk by a pool of worker threads, which allows to export all frames of a recording at full speed.
+        */
+        class DLL_EXPORT point_cloud_writer_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Writer throughput counters.
+            */
+            struct statistics
+            {
+                uint64_t    frames_written;     /**< Number of point cloud files written                              */
+                uint64_t    frames_failed;      /**< Number of frames which could not be written                      */
+                uint64_t    points_written;     /**< Number of valid points written to all files                      */
+                uint64_t    bytes_written;      /**< Number of bytes written to all files                             */
+                double      frames_per_second;  /**< Written frames per second, from the first write to the last one  */
+            };
+
+            /**
+            * @brief Creates a point cloud writer.
+            * @param[in]  format          Output file format
+            * @param[in]  workers_count   Number of worker threads used by \c write_async. Zero uses the number of hardware threads.
+            * @return point_cloud_writer_interface *   Writer instance, to be released with \c release
+            */
+            static point_cloud_writer_interface * create_instance(point_cloud_format format, uint32_t workers_count = 0);
+
+            /**
+            * @brief Writes a single point cloud file in the calling thread.
+            * @param[in]  file_path       Output file path
+            * @param[in]  frame           Point cloud to write
+            * @return status_no_error           Successful execution
+            * @return status_handle_invalid     Null file path, vertices or uvmap with color
+            * @return status_param_unsupported  Invalid size or unsupported color format
+            * @return status_data_unavailable   Color image has no data
+            * @return status_file_open_failed   Failed to create the file
+            * @return status_file_write_failed  Failed to write the file
+            */
+            virtual rs::core::status write(const char * file_path, const point_cloud_frame & frame) = 0;
+
+            /**
+            * @brief Queues a point cloud for writing by the worker threads.
+            *
+            * The vertices, uvmap and color pixels are copied, so the caller buffers and images can be reused when the function returns. The call blocks while the queue is full, to bound the memory consumption.
+            * @param[in]  file_path       Output file path
+            * @param[in]  frame           Point cloud to write
+            * @return status_no_error           Frame was queued
+            * @return status_handle_invalid     Null file path, vertices or uvmap with color
+            * @return status_param_unsupported  Invalid size or unsupported color format
+            * @return status_data_unavailable   Color image has no data
+            */
+            virtual rs::core::status write_async(const char * file_path, const point_cloud_frame & frame) = 0;
+
+            /**
+            * @brief Waits for all queued frames to be written.
+            * @return status_no_error           All the frames queued since the last flush were written
+            * @return status_file_write_failed  At least one queued frame failed to be written
+            */
+            virtual rs::core::status flush() = 0;
+
+            /**
+            * @brief Returns the writer throughput counters.
+            * @return statistics          Counters accumulated since the writer was created
+            */
+            virtual statistics query_statistics() const = 0;
+
+        protected:
+            virtual ~point_cloud_writer_interface() {}
+        };
+    }
+}
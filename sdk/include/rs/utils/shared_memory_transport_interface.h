@@ -0,0 +1,112 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+/**
+* @file shared_memory_transport_interface.h
+* @brief Describes the \c rs::utils::shared_memory_publisher_interface and \c rs::utils::shared_memory_subscriber_interface classes.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include "rs/core/status.h"
+#include "rs/core/correlated_sample_set.h"
+#include "rs/core/release_interface.h"
+
+#ifdef WIN32
+#ifdef realsense_shared_memory_transport_EXPORTS
+#define  DLL_EXPORT __declspec(dllexport)
+#else
+#define  DLL_EXPORT __declspec(dllimport)
+#endif /* realsense_shared_memory_transport_EXPORTS */
+#else /* defined (WIN32) */
+#define DLL_EXPORT
+#endif
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Publishes sample sets to the processes of the same machine through a POSIX shared memory region.
+        *
+        * The region holds a ring of preallocated slots, each slot holds a whole sample set: the images of the set and its
+        * motion samples. Publishing copies the set into a slot which none of the subscribers holds, so the publisher never
+        * waits for the subscribers. When all the slots are held, the slots held by the subscriber processes which terminated
+        * without releasing their images are reclaimed, and the set is dropped if none was. A subscriber process is found
+        * terminated by its process ID, so the publisher and its subscribers should run in the same PID namespace.
+        * The region is removed from the namespace of the shared memory objects when the publisher is released, the subscribers
+        * which are already attached keep their images valid until they release them.
+        * Image metadata is not published. The instance is not thread safe, calls should not be made concurrently.
+        */
+        class DLL_EXPORT shared_memory_publisher_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Creates the shared memory region and its publisher.
+            *
+            * A region left with the same name by a publisher which terminated without releasing it is replaced.
+            * @param[in]  name            Name of the region, shared by the publisher and its subscribers
+            * @param[in]  slots_count     Number of slots, at least 2. Each subscriber holds up to the slots of the sets it didn't release yet.
+            * @param[in]  slot_size       Size in bytes of the images data of a slot, at least the sum of pitch * height of the published images, each rounded up to 64 bytes
+            * @return shared_memory_publisher_interface *   Instance, to be released with \c release, null when the region can't be created
+            */
+            static shared_memory_publisher_interface * create_instance(const char * name, uint32_t slots_count, uint64_t slot_size);
+
+            /**
+            * @brief Publishes a sample set. The images data is copied, the images are not referenced after the call.
+            * @param[in]  sample_set      Sample set, with at least one image or motion sample
+            * @return status_no_error          Successful execution
+            * @return status_invalid_argument  The images of the set don't fit into a slot, or the set is empty
+            * @return status_item_unavailable  All the slots are held by the subscribers, the set was dropped
+            */
+            virtual rs::core::status publish(const rs::core::correlated_sample_set & sample_set) = 0;
+
+            /**
+            * @brief Gets the number of sample sets that were dropped since the publisher was created.
+            * @return uint64_t            Dropped sets count
+            */
+            virtual uint64_t query_dropped_count() const = 0;
+
+            virtual ~shared_memory_publisher_interface() {}
+        };
+
+        /**
+        * @brief Receives the sample sets of a \c shared_memory_publisher_interface in another process.
+        *
+        * The received images reference the data in the shared memory slot, no copy is made. The slot is held until all the
+        * received images of the set are released, so the subscriber should release the images once it is done with them.
+        * Each call receives the latest published set, the sets which were published while the subscriber was busy are skipped.
+        * The instance is not thread safe, calls should not be made concurrently. The received images may be released from any thread.
+        */
+        class DLL_EXPORT shared_memory_subscriber_interface : public rs::core::release_interface
+        {
+        public:
+            /**
+            * @brief Attaches to the shared memory region of a publisher.
+            * @param[in]  name            Name of the region, as given to the publisher
+            * @return shared_memory_subscriber_interface *   Instance, to be released with \c release, null when there is no such region, or
+            *                                               when 32 subscribers are attached to it
+            */
+            static shared_memory_subscriber_interface * create_instance(const char * name);
+
+            /**
+            * @brief Waits for a sample set which was published after the last received one.
+            * @param[out] sample_set      Received sample set. Reference counted resources in the sample set must be released by the caller.
+            * @param[in]  timeout_ms      Maximal wait in milliseconds
+            * @return status_no_error          Successful execution
+            * @return status_exec_timeout      No set was published during the wait
+            * @return status_device_lost       The publisher was released, no more sets will be published
+            */
+            virtual rs::core::status receive(rs::core::correlated_sample_set & sample_set, uint32_t timeout_ms) = 0;
+
+            /**
+            * @brief Gets the number of the published sample sets which this subscriber skipped.
+            * @return uint64_t            Skipped sets count
+            */
+            virtual uint64_t query_skipped_count() const = 0;
+
+            virtual ~shared_memory_subscriber_interface() {}
+        };
+    }
+}
@@ -6,6 +6,9 @@
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/log_utils.h"
 #include "rs/utils/samples_time_sync_interface.h"
+#include "rs/utils/point_cloud_writer_interface.h"
+#include "rs/utils/organized_point_cloud_interface.h"
+#include "rs/utils/depth_statistics_interface.h"
 #include "rs/utils/fps_counter.h"
 #include "rs/utils/ref_count_base.h"
 #include "rs/utils/release_self_base.h"
@@ -1,9 +1,11 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <chrono>
 #include "decoder.h"
 #include "lz4_codec.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
 #include "rs_sdk_version.h"
 
 namespace rs
@@ -13,7 +15,8 @@ namespace rs
         namespace compression
         {
 
-            decoder::decoder(std::map<rs_stream,file_types::compression_type> configuration)
+            decoder::decoder(std::map<rs_stream,file_types::compression_type> configuration) :
+                m_decode_time_histogram(PERF_COUNTERS.query_histogram("playback.decode_time_us"))
             {
                 for(auto config : configuration)
                 {
@@ -40,10 +43,16 @@ namespace rs
             std::shared_ptr<file_types::frame_sample> decoder::decode_frame(std::shared_ptr<file_types::frame_sample> frame, uint8_t *input, uint32_t input_size)
             {
                 LOG_FUNC_SCOPE();
+                TRACE_SCOPE("compression", "decode_frame");
                 if(!frame)
                     return nullptr;
                 auto codec = m_codecs.at(frame->finfo.stream);
-                return codec ? m_codecs[frame->finfo.stream]->decode(frame, input, input_size) : nullptr;
+                if(!codec)
+                    return nullptr;
+                auto start_time = std::chrono::steady_clock::now();
+                auto decoded_frame = codec->decode(frame, input, input_size);
+                m_decode_time_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count());
+                return decoded_frame;
             }
         }
     }
@@ -6,6 +6,7 @@
 #include <memory>
 #include <librealsense/rs.hpp>
 #include "codec_interface.h"
+#include "rs/utils/performance_counters.h"
 
 #ifdef WIN32 
 #ifdef realsense_compression_EXPORTS
@@ -34,6 +35,7 @@ namespace rs
             private:
                 void add_codec(rs_stream stream_type, file_types::compression_type compression_type);
                 std::map<rs_stream,std::shared_ptr<codec_interface>> m_codecs;
+                rs::utils::performance_histogram & m_decode_time_histogram;
             };
         }
     }
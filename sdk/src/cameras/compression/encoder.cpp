@@ -1,9 +1,11 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <chrono>
 #include "encoder.h"
 #include "lz4_codec.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
 
 namespace rs
 {
@@ -12,7 +14,8 @@ namespace rs
         namespace compression
         {
 
-            encoder::encoder()
+            encoder::encoder() :
+                m_encode_time_histogram(PERF_COUNTERS.query_histogram("record.encode_time_us"))
             {
 
             }
@@ -51,8 +54,14 @@ namespace rs
             status encoder::encode_frame(file_types::frame_info &info, const uint8_t *input, uint8_t * output, uint32_t &output_size)
             {
                 LOG_FUNC_SCOPE();
+                TRACE_SCOPE("compression", "encode_frame");
                 auto codec = m_codecs.at(info.stream);
-                return codec ? m_codecs[info.stream]->encode(info, input, output, output_size) : status::status_feature_unsupported;
+                if(!codec)
+                    return status::status_feature_unsupported;
+                auto start_time = std::chrono::steady_clock::now();
+                auto sts = codec->encode(info, input, output, output_size);
+                m_encode_time_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count());
+                return sts;
             }
         }
     }
@@ -7,6 +7,7 @@
 #include <tuple>
 #include <librealsense/rs.hpp>
 #include "codec_interface.h"
+#include "rs/utils/performance_counters.h"
 #include "rs/record/record_device.h"
 
 #ifdef WIN32 
@@ -38,6 +39,7 @@ namespace rs
             private:
                 file_types::compression_type compression_policy(rs_stream stream, rs_format format);
                 std::map<rs_stream,std::shared_ptr<codec_interface>> m_codecs;
+                rs::utils::performance_histogram & m_encode_time_histogram;
             };
         }
     }
@@ -4,9 +4,17 @@
 #pragma once
 #include <string>
 #include <fstream>
+#include <algorithm>
+#include <vector>
 #include <stdint.h>
 #include "status.h"
 
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
 namespace rs
 {
     namespace core
@@ -27,6 +35,29 @@ namespace rs
         class file
         {
         public:
+            file() : m_preallocation_size(0), m_preallocated_end(0), m_write_position(0), m_preallocation_fd(-1) {}
+
+            /**
+            * @brief Reserves the disk space of a file opened for writing ahead of its write position, to avoid its fragmentation
+            * and the stalls of the file system on extent allocation while recording.
+            *
+            * The expected size is reserved on open, then the space is extended by preallocation_extent_size bytes whenever the write
+            * position gets closer than that to the end of the reserved space. The reserved space is not part of the file size,
+            * and its unused part is released on close, so the file content is identical to a file written without preallocation.
+            * Must be called before opening the file, a zero size disables the preallocation.
+            * @param[in] expected_size     Expected file size in bytes
+            * @return status_feature_unsupported   The platform doesn't support preallocation
+            */
+            virtual status set_preallocation(uint64_t expected_size)
+            {
+#ifdef __linux__
+                m_preallocation_size = expected_size;
+                return status_no_error;
+#else
+                return expected_size ? status_feature_unsupported : status_no_error;
+#endif
+            }
+
             virtual status open(const std::string& filename, open_file_option mode)
             {
                 switch(mode)
@@ -37,6 +68,8 @@ namespace rs
                         break;
 
                 }
+                if(m_file.is_open() && mode == open_file_option::write && m_preallocation_size > 0)
+                    start_preallocation(filename);
                 return m_file.is_open() ? status_no_error : status_file_open_failed;
             }
 
@@ -44,6 +77,7 @@ namespace rs
             {
                 if(m_file.is_open())
                     m_file.close();
+                stop_preallocation();
                 return m_file.is_open() ? status_file_close_failed : status_no_error;
             }
 
@@ -96,6 +130,11 @@ namespace rs
                 number_of_bytes_written = 0;
                 m_file.write((char*)data, number_of_bytes_to_write);
                 if(m_file) number_of_bytes_written = number_of_bytes_to_write;
+                if(m_preallocation_fd >= 0)
+                {
+                    m_write_position += number_of_bytes_written;
+                    extend_preallocation();
+                }
                 return m_file ? status_no_error : status_file_write_failed;
             }
 
@@ -107,6 +146,8 @@ namespace rs
                     case move_method::current: m_file.seekp(distance_to_move, std::ios::cur); break;
                     case move_method::end: m_file.seekp(distance_to_move, std::ios::end); break;
                 }
+                if(m_preallocation_fd >= 0 && m_file)
+                    m_write_position = static_cast<uint64_t>(m_file.tellp());
                 if(new_file_pointer != NULL) *new_file_pointer = m_file.tellp();
                 return m_file ? status_no_error : status_file_read_failed;
             }
@@ -123,13 +164,78 @@ namespace rs
                 m_file.seekp(0, std::ios::beg);
             }
 
-            ~file()
+            /**
+            * @brief Marks the data written so far as complete. A live stream sends it and can't rewrite it afterwards, a file
+            * writes on its own schedule and ignores it.
+            */
+            virtual status commit() { return status_no_error; }
+
+            //waits until data past the read position arrived or the stream ended, returns false on timeout. The data of a file is always available.
+            virtual bool wait_for_data(uint32_t /*timeout_ms*/) { return true; }
+
+            virtual ~file()
             {
                 m_file.close();
+                stop_preallocation();
+            }
+
+        protected:
+            static const uint64_t preallocation_extent_size = 64 * 1024 * 1024;
+
+            void start_preallocation(const std::string& filename)
+            {
+#ifdef __linux__
+                //the stream doesn't expose its descriptor, the space is reserved through a second descriptor of the same file
+                m_preallocation_fd = ::open(filename.c_str(), O_WRONLY | O_CLOEXEC);
+                m_write_position = 0;
+                m_preallocated_end = 0;
+                if(m_preallocation_fd >= 0 && !allocate(0, m_preallocation_size > preallocation_extent_size ? m_preallocation_size : preallocation_extent_size))
+                    stop_preallocation();
+#endif
+            }
+
+            void extend_preallocation()
+            {
+                if(m_write_position + preallocation_extent_size <= m_preallocated_end)
+                    return;
+                if(!allocate(m_preallocated_end, preallocation_extent_size))
+                    stop_preallocation();
             }
 
+            bool allocate(uint64_t offset, uint64_t size)
+            {
+#ifdef __linux__
+                //keeping the file size makes the reserved space invisible to the readers and to the seeks from the end
+                if(::fallocate(m_preallocation_fd, FALLOC_FL_KEEP_SIZE, static_cast<off_t>(offset), static_cast<off_t>(size)) != 0)
+                    return false;
+                m_preallocated_end = offset + size;
+                return true;
+#else
+                return false;
+#endif
+            }
+
+            void stop_preallocation()
+            {
+#ifdef __linux__
+                if(m_preallocation_fd < 0)
+                    return;
+                //truncating to the current size releases the reserved space beyond it
+                struct stat file_status = {};
+                if(::fstat(m_preallocation_fd, &file_status) == 0)
+                    (void)::ftruncate(m_preallocation_fd, file_status.st_size);
+                ::close(m_preallocation_fd);
+                m_preallocation_fd = -1;
+#endif
+            }
+
+            uint64_t        m_preallocation_size;
+            uint64_t        m_preallocated_end;
+            uint64_t        m_write_position;
+            int             m_preallocation_fd;
+
         private:
-            std::fstream m_file;
+            std::fstream    m_file;
         };
     }
 }
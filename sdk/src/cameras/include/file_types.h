@@ -6,6 +6,7 @@
 #include <memory>
 #include <librealsense/rs.hpp>
 #include "rs/playback/playback_device.h"
+#include "rs/core/types.h"
 
 /** This macro constructs a UID given four byte values.  The arguments will
 be evaluated exactly once, cast to unsigned int and shifted into one of the
@@ -73,9 +74,28 @@ namespace rs
                 chunk_sample_info       = 11,//sample type, capture time, offset
                 chunk_capabilities      = 12,
                 chunk_motion_intrinsics = 13,
-                chunk_camera_info       = 14
+                chunk_camera_info       = 14,
+                chunk_device_section    = 15 //device index, the device info chunks which follow describe that device
             };
 
+            //the streams of the devices recorded into a single file are stored in per device namespaces, device 0 keeps the rs_stream values
+            static const int32_t device_stream_namespace_size = 256;
+
+            inline rs_stream to_file_stream(rs_stream stream, uint32_t device_index)
+            {
+                return static_cast<rs_stream>(static_cast<int32_t>(stream) + static_cast<int32_t>(device_index) * device_stream_namespace_size);
+            }
+
+            inline rs_stream to_device_stream(rs_stream file_stream)
+            {
+                return static_cast<rs_stream>(static_cast<int32_t>(file_stream) % device_stream_namespace_size);
+            }
+
+            inline uint32_t to_device_index(rs_stream file_stream)
+            {
+                return static_cast<uint32_t>(static_cast<int32_t>(file_stream) / device_stream_namespace_size);
+            }
+
             struct device_cap
             {
                 rs_option   label;       /* option type */
@@ -124,6 +144,7 @@ namespace rs
                 uint64_t    capture_time;
                 uint64_t    offset;
                 time_unit   capture_time_unit;
+                uint32_t    device_index;       //valid only in files of more than one device, older files have garbage in this padding
             };
 
             struct sample
@@ -135,6 +156,7 @@ namespace rs
                     info.capture_time = capture_time;
                     info.offset = offset;
                     info.capture_time_unit = time_unit::microseconds;
+                    info.device_index = 0;
                 }
                 sample_info info;
                 virtual ~sample() {}
@@ -269,6 +291,20 @@ namespace rs
                     rv->data = data_clone;
                     return rv;
                 }
+                //copies a region of the frame, the rows of the copy are packed
+                frame_sample * copy(const core::rect & region, int pixel_size)
+                {
+                    auto rv = new frame_sample(this);
+                    rv->metadata = metadata;
+                    rv->finfo.width = region.width;
+                    rv->finfo.height = region.height;
+                    rv->finfo.stride = region.width * pixel_size;
+                    auto data_clone = new uint8_t[rv->finfo.stride * rv->finfo.height];
+                    for(int y = 0; y < region.height; y++)
+                        memcpy(data_clone + y * rv->finfo.stride, data + (region.y + y) * finfo.stride + region.x * pixel_size, rv->finfo.stride);
+                    rv->data = data_clone;
+                    return rv;
+                }
                 virtual ~frame_sample() {}
                 frame_info      finfo;
                 const uint8_t * data;
@@ -284,6 +320,8 @@ namespace rs
                 rs_extrinsics   extrinsics;
                 float           depth_scale;
                 rs_extrinsics   motion_extrinsics;
+                core::rect      roi;    // The recorded region of the camera frames, the info and the intrinsics describe the region.
+                                        // Zero size when the whole frames were recorded.
             };
 
             struct stream_info
@@ -302,6 +340,7 @@ namespace rs
                 int32_t                         nstreams;               // Number of streams
                 file_types::coordinate_system   coordinate_system;
                 playback::capture_mode          capture_mode;           // The capture mode of the file (synced or asynced).
+                int32_t                         device_count;           // Number of recorded devices, 0 in files of a single device.
             };
 
             class disk_format
@@ -322,7 +361,7 @@ namespace rs
                 struct stream_info
                 {
                     file_types::stream_info data;
-                    int32_t                 reserved[10];
+                    int32_t                 reserved[6];
 
                 };
 
@@ -353,7 +392,7 @@ namespace rs
                 struct file_header
                 {
                     file_types::file_header data;
-                    int32_t                 reserved[24];
+                    int32_t                 reserved[23];
                 };
 
                 struct motion_intrinsics
@@ -0,0 +1,174 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <string>
+#include <algorithm>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <stdint.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+namespace rs
+{
+    namespace core
+    {
+        /**
+        * @brief Endpoints of a live recording stream, given instead of a file path to the record and the playback contexts.
+        *
+        * unix:<path>          Unix domain socket at path
+        * tcp:<host>:<port>    TCP socket, for example tcp:127.0.0.1:5000 for the loopback
+        * fd:<descriptor>      Open descriptor of a connected socket or of a pipe end, owned by the stream and closed with it
+        *
+        * The playback side listens on a socket endpoint and accepts a single recorder, the record side connects to it.
+        */
+        namespace stream_endpoint
+        {
+            //the recorder retries connecting for this long, so it may start before the playback side listens
+            static const uint32_t connect_timeout_ms = 3000;
+
+            inline bool starts_with(const std::string & endpoint, const char * prefix)
+            {
+                return endpoint.compare(0, std::string(prefix).size(), prefix) == 0;
+            }
+
+            inline bool is_stream_endpoint(const std::string & endpoint)
+            {
+                return starts_with(endpoint, "unix:") || starts_with(endpoint, "tcp:") || starts_with(endpoint, "fd:");
+            }
+
+#ifdef __linux__
+            //fills the address of a unix or tcp endpoint, returns false for other endpoints or an unresolved host
+            inline bool get_address(const std::string & endpoint, sockaddr_storage & address, socklen_t & address_length)
+            {
+                address = {};
+                if(starts_with(endpoint, "unix:"))
+                {
+                    const std::string path = endpoint.substr(5);
+                    sockaddr_un & unix_address = reinterpret_cast<sockaddr_un &>(address);
+                    if(path.empty() || path.size() >= sizeof(unix_address.sun_path))
+                        return false;
+                    unix_address.sun_family = AF_UNIX;
+                    path.copy(unix_address.sun_path, path.size());
+                    address_length = static_cast<socklen_t>(sizeof(sockaddr_un));
+                    return true;
+                }
+                if(starts_with(endpoint, "tcp:"))
+                {
+                    const std::string host_port = endpoint.substr(4);
+                    const size_t separator = host_port.rfind(':');
+                    if(separator == std::string::npos)
+                        return false;
+                    addrinfo hints = {};
+                    hints.ai_family = AF_INET;
+                    hints.ai_socktype = SOCK_STREAM;
+                    addrinfo * result = nullptr;
+                    if(getaddrinfo(host_port.substr(0, separator).c_str(), host_port.substr(separator + 1).c_str(), &hints, &result) != 0 || !result)
+                        return false;
+                    address_length = result->ai_addrlen;
+                    std::copy(reinterpret_cast<const uint8_t *>(result->ai_addr), reinterpret_cast<const uint8_t *>(result->ai_addr) + result->ai_addrlen,
+                              reinterpret_cast<uint8_t *>(&address));
+                    freeaddrinfo(result);
+                    return true;
+                }
+                return false;
+            }
+
+            inline int get_descriptor(const std::string & endpoint)
+            {
+                if(!starts_with(endpoint, "fd:") || endpoint.size() == 3)
+                    return -1;
+                char * end = nullptr;
+                const long descriptor = std::strtol(endpoint.c_str() + 3, &end, 10);
+                return *end == '\0' && descriptor >= 0 ? static_cast<int>(descriptor) : -1;
+            }
+
+            inline void set_socket_options(int fd, int family)
+            {
+                //samples are sent whole, they shouldn't wait for more data to fill a segment
+                int enable = 1;
+                if(family == AF_INET)
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+            }
+
+            //connects the record side, returns the connected descriptor or -1
+            inline int connect(const std::string & endpoint)
+            {
+                if(starts_with(endpoint, "fd:"))
+                    return get_descriptor(endpoint);
+                sockaddr_storage address;
+                socklen_t address_length = 0;
+                if(!get_address(endpoint, address, address_length))
+                    return -1;
+
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(connect_timeout_ms);
+                while(true)
+                {
+                    int fd = ::socket(address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                    if(fd < 0)
+                        return -1;
+                    if(::connect(fd, reinterpret_cast<sockaddr *>(&address), address_length) == 0)
+                    {
+                        set_socket_options(fd, address.ss_family);
+                        return fd;
+                    }
+                    const int connect_error = errno;
+                    ::close(fd);
+                    const bool is_listener_missing = connect_error == ECONNREFUSED || connect_error == ENOENT;
+                    if(!is_listener_missing || std::chrono::steady_clock::now() > deadline)
+                        return -1;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                }
+            }
+
+            //listens on the endpoint of the playback side and waits for a recorder to connect, returns the connected descriptor or -1
+            inline int accept(const std::string & endpoint)
+            {
+                if(starts_with(endpoint, "fd:"))
+                    return get_descriptor(endpoint);
+                sockaddr_storage address;
+                socklen_t address_length = 0;
+                if(!get_address(endpoint, address, address_length))
+                    return -1;
+
+                int listen_fd = ::socket(address.ss_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+                if(listen_fd < 0)
+                    return -1;
+                int enable = 1;
+                if(address.ss_family == AF_INET)
+                    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+                else
+                    ::unlink(reinterpret_cast<sockaddr_un &>(address).sun_path); //a socket file left by a previous run
+                int fd = -1;
+                if(::bind(listen_fd, reinterpret_cast<sockaddr *>(&address), address_length) == 0 && ::listen(listen_fd, 1) == 0)
+                {
+                    do
+                    {
+                        fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+                    }
+                    while(fd < 0 && errno == EINTR);
+                }
+                ::close(listen_fd);
+                if(address.ss_family == AF_UNIX)
+                    ::unlink(reinterpret_cast<sockaddr_un &>(address).sun_path);
+                if(fd >= 0)
+                    set_socket_options(fd, address.ss_family);
+                return fd;
+            }
+#else
+            inline int connect(const std::string &) { return -1; }
+            inline int accept(const std::string &) { return -1; }
+#endif
+        }
+    }
+}
@@ -28,7 +28,8 @@ namespace rs
                 return core::status_item_unavailable;
             m_file_header = file_header.data;
 
-            /* Get all chunks */
+            /* Get all chunks, the chunks which follow a device section describe the device of that section */
+            uint32_t device_index = 0;
             while (data_read_status == status::status_no_error)
             {
                 chunk_info chunk = {};
@@ -60,9 +61,10 @@ namespace rs
                         data_read_status = m_file_data_read->read_to_object_array(devcaps);
                         if(data_read_status == status::status_no_error)
                         {
+                            auto & properties = device_index == 0 ? m_properties : m_additional_devices_headers[device_index].m_properties;
                             for(auto & caps : devcaps)
                             {
-                                m_properties[caps.label] = caps.value;
+                                properties[caps.label] = caps.value;
                             }
                         }
                         LOG_INFO("read properties chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
@@ -88,7 +90,7 @@ namespace rs
                         disk_format::motion_intrinsics mi = {};
                         data_read_status = m_file_data_read->read_to_object(mi, chunk.size);
                         if(data_read_status == status::status_no_error)
-                            m_motion_intrinsics = mi.data;
+                            (device_index == 0 ? m_motion_intrinsics : m_additional_devices_headers[device_index].m_motion_intrinsics) = mi.data;
                         LOG_INFO("read motion intrinsics chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
                     }
                     break;
@@ -104,8 +106,9 @@ namespace rs
                     case chunk_id::chunk_capabilities:
                     {
                         uint32_t caps_count = static_cast<uint32_t>(chunk.size / sizeof(rs_capabilities));
-                        m_capabilities.resize(caps_count);
-                        data_read_status = m_file_data_read->read_to_object_array(m_capabilities);
+                        auto & capabilities = device_index == 0 ? m_capabilities : m_additional_devices_headers[device_index].m_capabilities;
+                        capabilities.resize(caps_count);
+                        data_read_status = m_file_data_read->read_to_object_array(capabilities);
                         LOG_INFO("read capabilities chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
                     }
                     break;
@@ -116,6 +119,7 @@ namespace rs
                         data_read_status = m_file_data_read->read_to_object_array(info);
                         if(data_read_status == status::status_no_error)
                         {
+                            auto & camera_info = device_index == 0 ? m_camera_info : m_additional_devices_headers[device_index].m_camera_info;
                             for(uint8_t* it = info.data(); it < info.data() + num_bytes_to_read; )
                             {
                                 rs_camera_info id = *(reinterpret_cast<rs_camera_info*>(it));
@@ -127,12 +131,18 @@ namespace rs
                                 char* cam_info = reinterpret_cast<char*>(it);
                                 it += cam_info_size;
 
-                                m_camera_info.emplace(id, std::string(cam_info));
+                                camera_info.emplace(id, std::string(cam_info));
                             }
                         }
                         LOG_INFO("read device info chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed"));
                     }
                     break;
+                    case chunk_id::chunk_device_section:
+                    {
+                        data_read_status = m_file_data_read->read_to_object(device_index, chunk.size);
+                        LOG_INFO("read device section chunk " << (data_read_status == status::status_no_error ? "succeeded" : "failed") << ", device index - " << device_index);
+                    }
+                    break;
                     default:
                     {
                         m_file_data_read->set_position(chunk.size, core::move_method::current);
@@ -152,6 +162,9 @@ namespace rs
 
             for (uint32_t index = 0; index < number_of_samples;)
             {
+                //a live stream is indexed as far as it arrived, the indexing doesn't hold the lock while waiting for more samples
+                if (index > 0 && !m_file_indexing->wait_for_data(0))
+                    break;
                 chunk_info chunk = {};
                 status data_read_status = m_file_indexing->read_to_object(chunk);
                 if (data_read_status != status::status_no_error)
@@ -172,6 +185,9 @@ namespace rs
                         //old files of version 2 were recorded with milliseconds capture time unit
                         if(sample_info.capture_time_unit == time_unit::milliseconds)
                             sample_info.capture_time *= 1000;
+                        //the device index was not written by older versions
+                        if(query_device_count() == 1)
+                            sample_info.device_index = 0;
                         chunk_info chunk2 = {};
                         data_read_status = m_file_indexing->read_to_object(chunk2);
                         if (data_read_status != core::status_no_error)
@@ -7,14 +7,18 @@
 #include "rs/core/metadata_interface.h"
 #include "include/file.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
 #include "rs_sdk_version.h"
 
 using namespace rs::core;
 using namespace rs::playback;
 
-disk_read_base::disk_read_base(const char * file_path) : m_file_path(file_path), m_file_header(), m_pause(true),
+disk_read_base::disk_read_base(const char * file_path, std::shared_ptr<live_stream> stream) : m_file_path(file_path), m_live_stream(stream), m_file_header(), m_pause(true),
     m_realtime(true), m_streams_infos(), m_base_ts(0), m_is_index_complete(false),
-    m_samples_desc_index(0), m_is_motion_tracking_enabled(false)
+    m_samples_desc_index(0), m_is_motion_tracking_enabled(false),
+    m_bytes_read_counter(PERF_COUNTERS.query_counter("playback.bytes_read")),
+    m_frames_dropped_counter(PERF_COUNTERS.query_counter("playback.frames_dropped")),
+    m_prefetched_samples_gauge(PERF_COUNTERS.query_gauge("playback.prefetched_samples"))
 {
 
 }
@@ -46,6 +50,18 @@ rs::playback::file_info disk_read_base::query_file_info()
     return file_info;
 }
 
+device_headers disk_read_base::get_device_headers(uint32_t device_index)
+{
+    if(device_index > 0)
+        return m_additional_devices_headers[device_index];
+    device_headers headers = {};
+    headers.m_camera_info = m_camera_info;
+    headers.m_properties = m_properties;
+    headers.m_capabilities = m_capabilities;
+    headers.m_motion_intrinsics = m_motion_intrinsics;
+    return headers;
+}
+
 capture_mode disk_read_base::get_capture_mode()
 {
     if(m_streams_infos.size() == 1)
@@ -99,7 +115,7 @@ status disk_read_base::init()
 {
     if (m_file_path.empty()) return status_file_open_failed;
 
-    m_file_data_read = std::unique_ptr<file>(new file());
+    m_file_data_read = create_file();
     status init_status = m_file_data_read->open(m_file_path.c_str(), (open_file_option)(open_file_option::read));
     if (init_status < status_no_error)
     {
@@ -108,7 +124,7 @@ status disk_read_base::init()
 
     init_status = read_headers();
 
-    m_file_indexing = std::unique_ptr<file>(new file());
+    m_file_indexing = create_file();
     init_status = m_file_indexing->open(m_file_path.c_str(), (open_file_option)(open_file_option::read));
     if (init_status < status_no_error) return init_status;
 
@@ -119,9 +135,18 @@ status disk_read_base::init()
     if(m_file_header.capture_mode == 0)
         m_file_header.capture_mode = get_capture_mode();
 
+    //a live stream is played as its samples arrive, real time playback would delay them by the time the recorder started earlier
+    if(m_live_stream)
+        m_realtime = false;
+
     return init_status;
 }
 
+std::unique_ptr<file> disk_read_base::create_file()
+{
+    return m_live_stream ? std::unique_ptr<file>(new live_stream_file(m_live_stream)) : std::unique_ptr<file>(new file());
+}
+
 void disk_read_base::resume()
 {
     LOG_FUNC_SCOPE();
@@ -150,6 +175,7 @@ void disk_read_base::pause()
 void disk_read_base::read_thread()
 {
     LOG_FUNC_SCOPE();
+    TRACE_THREAD_NAME("playback_reader");
     m_base_sys_time = std::chrono::high_resolution_clock::now();
     auto eof = false;
     while (!m_pause && !eof)
@@ -192,6 +218,7 @@ void disk_read_base::update_frame_drop_count(rs_stream stream, uint32_t frame_dr
 {
     m_frame_drop_count[stream] += frame_drop;
     m_properties[rs_option::RS_OPTION_TOTAL_FRAME_DROPS] += frame_drop;
+    m_frames_dropped_counter.add(frame_drop);
 }
 
 void disk_read_base::update_imu_drop_count(uint32_t drop_count)
@@ -205,7 +232,8 @@ void disk_read_base::reset()
     pause();
     std::lock_guard<std::mutex> guard(m_mutex);
     m_file_data_read->reset();
-    m_samples_desc_index = 0;
+    //the samples of a live stream which were already played are not kept, playing continues from the latest sample
+    m_samples_desc_index = m_live_stream ? static_cast<uint32_t>(m_samples_desc.size()) : 0;
     std::queue<std::shared_ptr<core::file_types::sample>> empty_queue;
     std::swap(m_prefetched_samples, empty_queue);
     for(auto it = m_active_streams_info.begin(); it != m_active_streams_info.end(); ++it)
@@ -235,6 +263,8 @@ void disk_read_base::enable_stream(rs_stream stream, bool state)
         if(m_active_streams_info.find(stream) != m_active_streams_info.end())
             m_active_streams_info.erase(m_active_streams_info.find(stream));
     }
+    //the decoder is created for the active streams, it is recreated on the next read
+    m_decoder.reset();
 }
 
 void disk_read_base::enable_motions_callback(bool state)
@@ -256,16 +286,20 @@ void disk_read_base::notify_available_samples()
         if(m_prefetched_samples.front()->info.type == file_types::sample_type::st_image)
         {
             auto frame = std::dynamic_pointer_cast<file_types::frame_sample>(m_prefetched_samples.front());
-            if (frame)
+            //the stream may have been disabled or enabled again since the frame was prefetched
+            auto active_stream = frame ? m_active_streams_info.find(frame->finfo.stream) : m_active_streams_info.end();
+            if (active_stream != m_active_streams_info.end() && active_stream->second.m_prefetched_samples_count > 0)
             {
-                m_active_streams_info[frame->finfo.stream].m_prefetched_samples_count--;
+                active_stream->second.m_prefetched_samples_count--;
                 LOG_VERBOSE("calling callback, frame stream type - " << frame->finfo.stream);
             }
         }
         LOG_VERBOSE("calling callback, sample type - " << m_prefetched_samples.front()->info.type);
         LOG_VERBOSE("calling callback, sample capture time - " << m_prefetched_samples.front()->info.capture_time);
+        TRACE_SCOPE("playback", "sample_callback");
         m_sample_callback(m_prefetched_samples.front());
         m_prefetched_samples.pop();
+        m_prefetched_samples_gauge.set(static_cast<int64_t>(m_prefetched_samples.size()));
     }
 }
 
@@ -273,6 +307,7 @@ void disk_read_base::prefetch_sample()
 {
     if(m_samples_desc_index >= m_samples_desc.size() || all_samples_bufferd())
         return;
+    TRACE_SCOPE("playback", "prefetch_sample");
     LOG_VERBOSE("process sample - " << m_samples_desc_index);
     auto sample = m_samples_desc[m_samples_desc_index];
     m_samples_desc_index++;
@@ -307,7 +342,7 @@ void disk_read_base::prefetch_sample()
         default:
             throw std::runtime_error("undefind sample type");
     }
-
+    m_prefetched_samples_gauge.set(static_cast<int64_t>(m_prefetched_samples.size()));
 
     LOG_VERBOSE("sample prefetched, sample type - " << sample->info.type);
     LOG_VERBOSE("sample prefetched, sample capture time - " << sample->info.capture_time);
@@ -318,7 +353,16 @@ bool disk_read_base::read_next_sample()
     //indicate to device all samples which time elapsed (timestamp is in the past of the playback clock)
     notify_available_samples();
     while(m_samples_desc_index >= m_samples_desc.size() && !m_is_index_complete)
+    {
+        //the next sample of a live stream may not have arrived yet, the wait is bounded to notice a pause
+        if(!m_file_indexing->wait_for_data(LIVE_STREAM_WAIT_TIME_MS))
+        {
+            if(m_pause)
+                return true;
+            continue;
+        }
         index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
+    }
     if(m_samples_desc_index >= m_samples_desc.size() && m_prefetched_samples.size() == 0)
         return false;
     //optimize next reads - prefetch a single sample.
@@ -333,7 +377,7 @@ bool disk_read_base::read_next_sample()
         {
             if(m_is_index_complete)
                 std::this_thread::sleep_for(std::chrono::microseconds(time_to_next_sample));
-            else
+            else if(m_file_indexing->wait_for_data(static_cast<uint32_t>(time_to_next_sample / 1000)))
                index_next_samples(NUMBER_OF_SAMPLES_TO_INDEX);
         }
     }
@@ -518,6 +562,10 @@ uint32_t disk_read_base::query_number_of_frames(rs_stream stream_type)
 
     if (nframes > 0) return nframes;
 
+    //the frames of a live stream are counted as they arrive
+    if(m_live_stream)
+        return static_cast<uint32_t>(m_image_indices[stream_type].size());
+
     /* If not able to get from the header, let's count */
     while (!m_is_index_complete) index_next_samples(std::numeric_limits<uint32_t>::max());
 
@@ -616,6 +664,7 @@ std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std:
                         auto data = new uint8_t[num_bytes_to_read];
                         m_file_data_read->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
                         num_bytes_to_read -= num_bytes_read;
+                        m_bytes_read_counter.add(num_bytes_read);
                         rv->data = data;
                         return rv;
                     }
@@ -625,6 +674,7 @@ std::shared_ptr<file_types::frame_sample> disk_read_base::read_image_buffer(std:
                         uint8_t * data = m_encoded_data.data();
                         m_file_data_read->read_bytes(data, static_cast<uint32_t>(num_bytes_to_read), num_bytes_read);
                         num_bytes_to_read -= num_bytes_read;
+                        m_bytes_read_counter.add(num_bytes_read);
                         auto rv = m_decoder->decode_frame(frame, data, num_bytes_read);
                         return rv;
                     }
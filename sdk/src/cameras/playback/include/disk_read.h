@@ -12,6 +12,7 @@ namespace rs
         {
         public:
             disk_read(const char *file_name) : disk_read_base(file_name) {}
+            disk_read(const char *file_name, std::shared_ptr<live_stream> stream) : disk_read_base(file_name, stream) {}
             virtual ~disk_read(void);
         protected:
             virtual rs::core::status read_headers() override;
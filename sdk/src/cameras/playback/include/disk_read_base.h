@@ -14,6 +14,8 @@
 #include "status.h"
 #include "disk_read_interface.h"
 #include "include/file.h"
+#include "live_stream.h"
+#include "rs/utils/performance_counters.h"
 
 namespace rs
 {
@@ -29,7 +31,8 @@ namespace rs
             };
 
         public:
-            disk_read_base(const char *file_path);
+            //a live stream is read instead of the file when given, the file path then names its endpoint
+            disk_read_base(const char *file_path, std::shared_ptr<live_stream> stream = nullptr);
             virtual ~disk_read_base(void);
             virtual core::status init() override;
             virtual void reset() override;
@@ -50,6 +53,8 @@ namespace rs
             virtual rs_motion_intrinsics get_motion_intrinsics() { return m_motion_intrinsics; }
             virtual std::map<rs_option, double> get_properties() override { return m_properties; }
             virtual std::vector<rs_capabilities> get_capabilities() { return m_capabilities; }
+            virtual uint32_t query_device_count() override { return m_file_header.device_count > 1 ? static_cast<uint32_t>(m_file_header.device_count) : 1; }
+            virtual device_headers get_device_headers(uint32_t device_index) override;
             virtual playback::capture_mode query_capture_mode() override { return m_file_header.capture_mode; }
             virtual file_info query_file_info() override ;
             virtual uint64_t query_run_time() override;
@@ -77,6 +82,7 @@ namespace rs
             void init_decoder();
             virtual uint32_t read_frame_metadata(const std::shared_ptr<core::file_types::frame_sample>& frame, unsigned long num_bytes_to_read) = 0;
             int64_t calc_sleep_time(std::shared_ptr<core::file_types::sample> sample);
+            std::unique_ptr<core::file> create_file();
 
             playback::capture_mode get_capture_mode();
 
@@ -85,7 +91,11 @@ namespace rs
             //if IMU and video streams are enabled no more than 4 images will be bufferd per stream
             static const int                                                NUMBER_OF_REQUIRED_PREFETCHED_SAMPLES = 20;
 
+            //the reader thread waits for the samples of a live stream in steps of this length, to notice a pause
+            static const uint32_t                                           LIVE_STREAM_WAIT_TIME_MS = 100;
+
             std::string                                                     m_file_path;
+            std::shared_ptr<live_stream>                                    m_live_stream;
             //file pointers
             std::unique_ptr<core::file>                                     m_file_indexing;//use only for samples indexing
             std::unique_ptr<core::file>                                     m_file_data_read;//use both for file header read and image data read
@@ -112,6 +122,7 @@ namespace rs
             rs_motion_intrinsics                                            m_motion_intrinsics;
             std::map<rs_stream, active_stream_info>                         m_active_streams_info;
             std::map<rs_camera_info, std::string>                           m_camera_info;
+            std::map<uint32_t, device_headers>                              m_additional_devices_headers; //the headers of device 0 are the members above
             bool                                                            m_is_motion_tracking_enabled;
 
             //sticky variables, calculated once in objects lifetime
@@ -125,6 +136,10 @@ namespace rs
 
             std::map<rs_stream,uint32_t>                                    m_frame_drop_count;
             uint64_t                                                        m_motion_drop_count;
+
+            rs::utils::performance_counter &                                m_bytes_read_counter;
+            rs::utils::performance_counter &                                m_frames_dropped_counter;
+            rs::utils::performance_gauge &                                  m_prefetched_samples_gauge;
         };
     }
 }
@@ -4,6 +4,8 @@
 #pragma once
 #include <memory>
 #include "include/file.h"
+#include "include/stream_endpoint.h"
+#include "live_stream.h"
 #include "disk_read.h"
 #include "linux/v1/disk_read.h"
 #include "windows/v10/disk_read.h"
@@ -19,6 +21,9 @@ namespace rs
         public:
             static rs::core::status create_disk_read(const char *file_name, std::unique_ptr<disk_read_interface> &disk_read)
             {
+                if (rs::core::stream_endpoint::is_stream_endpoint(file_name))
+                    return create_live_disk_read(file_name, disk_read);
+
                 std::unique_ptr<rs::core::file> file_ = std::unique_ptr<rs::core::file>(new rs::core::file());
 
                 rs::core::status status = file_->open(file_name, rs::core::open_file_option::read);
@@ -60,6 +65,30 @@ namespace rs
                 LOG_ERROR("failed to create disk read")
                 return rs::core::status_file_read_failed;
             }
+
+        private:
+            //waits for a recorder to connect to the endpoint, the stream is recorded in the latest file format
+            static rs::core::status create_live_disk_read(const char *endpoint, std::unique_ptr<disk_read_interface> &disk_read)
+            {
+                auto stream = live_stream::open(endpoint);
+                if (!stream)
+                    return rs::core::status_file_open_failed;
+
+                live_stream_file stream_file(stream);
+                uint32_t nbytesRead = 0;
+                int32_t file_type_id = 0;
+                rs::core::status status = stream_file.read_bytes(&file_type_id, sizeof(file_type_id), nbytesRead);
+                if (status != rs::core::status_no_error) return status;
+                if (file_type_id != UID('R', 'S', 'L', '2'))
+                {
+                    LOG_ERROR("live stream is not of the Linux file format version 2")
+                    return rs::core::status_file_read_failed;
+                }
+
+                LOG_INFO("create disk read for a live stream")
+                disk_read = std::unique_ptr<disk_read_interface>(new playback::disk_read(endpoint, stream));
+                return disk_read->init();
+            }
         };
     }
 }
@@ -13,6 +13,15 @@ namespace rs
 {
     namespace playback
     {
+        //the static info of a single device of the file
+        struct device_headers
+        {
+            std::map<rs_camera_info, std::string>   m_camera_info;
+            std::map<rs_option, double>             m_properties;
+            std::vector<rs_capabilities>            m_capabilities;
+            rs_motion_intrinsics                    m_motion_intrinsics;
+        };
+
         class disk_read_interface
         {
         public:
@@ -30,6 +39,9 @@ namespace rs
             virtual rs_motion_intrinsics get_motion_intrinsics() = 0;
             virtual std::vector<rs_capabilities> get_capabilities() = 0;
             virtual std::map<rs_option, double> get_properties() = 0;
+            //files of more than one device keep the streams of each device in its own namespace, see file_types::to_file_stream
+            virtual uint32_t query_device_count() = 0;
+            virtual device_headers get_device_headers(uint32_t device_index) = 0;
             virtual void set_realtime(bool realtime) = 0;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_index(uint32_t index, rs_stream stream_type) = 0;
             virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_time_stamp(uint64_t ts) = 0;
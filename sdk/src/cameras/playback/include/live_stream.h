@@ -0,0 +1,76 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "include/file.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        /**
+        * @brief Receives a live recording stream, see core::stream_endpoint, and keeps its recent data for the readers of the stream.
+        *
+        * The data is received when a reader asks for data which didn't arrive yet, so a reader which doesn't keep up slows
+        * the recorder down instead of buffering without a bound. The last retained_size bytes are kept for the reads behind
+        * the indexing position, the frame data reads, the reads of older data fail.
+        */
+        class live_stream
+        {
+        public:
+            //waits for a recorder to connect to the endpoint, returns null on failure
+            static std::shared_ptr<live_stream> open(const std::string & endpoint);
+            ~live_stream();
+
+            //copies size bytes at offset, waiting for them to arrive. Returns false when the stream ended before them, or when they are no longer kept
+            bool read(uint64_t offset, uint8_t * data, uint32_t size);
+
+            //waits until the data at offset arrived or the stream ended, returns false on timeout
+            bool wait_for_data(uint64_t offset, uint32_t timeout_ms);
+
+        private:
+            static const uint32_t block_size = 1024 * 1024;
+            static const uint64_t retained_size = 256 * 1024 * 1024;
+
+            live_stream(int fd);
+            //receives until the stream reaches end_offset or ends, returns false on timeout, a negative timeout waits without a limit
+            bool receive(uint64_t end_offset, int timeout_ms);
+
+            std::mutex                          m_mutex;
+            int                                 m_fd;
+            bool                                m_is_ended;
+            uint64_t                            m_base_offset;  //offset of the first kept block
+            uint64_t                            m_size;         //bytes received since the stream started
+            std::deque<std::vector<uint8_t>>    m_blocks;
+        };
+
+        /**
+        * @brief Reads a live stream as a file, each reader of the stream has its own position.
+        *
+        * The position can't be set from the end of a live stream, and the stream can't be written.
+        */
+        class live_stream_file : public core::file
+        {
+        public:
+            live_stream_file(std::shared_ptr<live_stream> stream) : m_stream(stream), m_position(0) {}
+            virtual ~live_stream_file() {}
+
+            virtual core::status open(const std::string& endpoint, core::open_file_option mode) override;
+            virtual core::status close() override { return core::status_no_error; }
+            virtual core::status read_bytes(void* data, unsigned int number_of_bytes_to_read, unsigned int& number_of_bytes_read) override;
+            virtual core::status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override;
+            virtual core::status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override;
+            virtual core::status get_position(uint64_t* new_file_pointer) override;
+            virtual void reset() override { m_position = 0; }
+            virtual bool wait_for_data(uint32_t timeout_ms) override { return m_stream->wait_for_data(m_position, timeout_ms); }
+
+        private:
+            std::shared_ptr<live_stream>    m_stream;
+            uint64_t                        m_position;
+        };
+    }
+}
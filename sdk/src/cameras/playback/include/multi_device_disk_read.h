@@ -0,0 +1,116 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <map>
+#include <set>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include "disk_read_interface.h"
+
+namespace rs
+{
+    namespace playback
+    {
+        class device_disk_read;
+
+        /**
+        * @brief Shares the reader of a file of several devices between the playback devices of that file.
+        *
+        * A single reader thread reads the samples of all the devices in the order of their capture and dispatches each sample to
+        * the view of its device. The reader reads the streams enabled on the started views and runs while any of the views is
+        * streaming. The reader thread reads the views without locking, so the reader is paused while the views are added, removed
+        * or changed, and resumed after. The position and the realtime mode of the reader are shared by all the views.
+        */
+        class multi_device_disk_read
+        {
+        public:
+            multi_device_disk_read(std::unique_ptr<disk_read_interface> reader);
+            ~multi_device_disk_read();
+
+        private:
+            friend class device_disk_read;
+
+            void add_view(device_disk_read * view);
+            void remove_view(device_disk_read * view);
+            void resume(device_disk_read * view);
+            void pause(device_disk_read * view);
+            void reset(device_disk_read * view);
+            void update_view(device_disk_read * view, std::function<void()> update);
+            std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> seek(
+                    std::function<std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>>()> seek_reader);
+            //applies the streams and the motions of the views to the reader and resumes it when a view is streaming,
+            //must be called with the mutex held and the reader paused
+            bool update_reader();
+            void handle_sample(std::shared_ptr<core::file_types::sample> sample);
+            void handle_end_of_file();
+
+            std::unique_ptr<disk_read_interface>            m_reader;
+            std::mutex                                      m_mutex;
+            std::map<uint32_t, device_disk_read *>          m_views;
+            std::set<rs_stream>                             m_reader_streams;
+        };
+
+        /**
+        * @brief The disk read of a single device of a file of several devices.
+        *
+        * Exposes the streams of its device with their rs_stream values, and forwards the reading to the shared reader.
+        */
+        class device_disk_read : public disk_read_interface
+        {
+        public:
+            device_disk_read(std::shared_ptr<multi_device_disk_read> shared_reader, uint32_t device_index);
+            virtual ~device_disk_read();
+            virtual core::status init() override { return core::status_no_error; }
+            virtual void reset() override;
+            virtual void resume() override;
+            virtual void pause() override;
+            virtual void enable_stream(rs_stream stream, bool state) override;
+            virtual void enable_motions_callback(bool state) override;
+            virtual bool is_motion_tracking_enabled() override { return m_is_motion_tracking_enabled; }
+            virtual const std::map<rs_camera_info, std::string>& get_camera_info() override { return m_headers.m_camera_info; }
+            virtual std::map<rs_stream, core::file_types::stream_info> get_streams_infos() override;
+            virtual rs_motion_intrinsics get_motion_intrinsics() override { return m_headers.m_motion_intrinsics; }
+            virtual std::vector<rs_capabilities> get_capabilities() override { return m_headers.m_capabilities; }
+            virtual std::map<rs_option, double> get_properties() override { return m_headers.m_properties; }
+            virtual uint32_t query_device_count() override { return 1; }
+            virtual device_headers get_device_headers(uint32_t device_index) override { return device_index == 0 ? m_headers : device_headers(); }
+            virtual void set_realtime(bool realtime) override { reader().set_realtime(realtime); }
+            virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_index(uint32_t index, rs_stream stream_type) override;
+            virtual std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> set_frame_by_time_stamp(uint64_t ts) override;
+            virtual bool query_realtime() override { return reader().query_realtime(); }
+            virtual uint32_t query_number_of_frames(rs_stream stream_type) override { return reader().query_number_of_frames(to_file_stream(stream_type)); }
+            virtual int32_t query_coordinate_system() override { return reader().query_coordinate_system(); }
+            virtual core::file_types::version query_sdk_version() override { return reader().query_sdk_version(); }
+            virtual core::file_types::version query_librealsense_version() override { return reader().query_librealsense_version(); }
+            virtual playback::capture_mode query_capture_mode() override { return reader().query_capture_mode(); }
+            virtual playback::file_info query_file_info() override { return reader().query_file_info(); }
+            virtual uint64_t query_run_time() override { return reader().query_run_time(); }
+            virtual bool is_stream_profile_available(rs_stream stream, int width, int height, rs_format format, int framerate) override;
+            virtual void set_callback(std::function<void(std::shared_ptr<core::file_types::sample>)> handler) override;
+            virtual void set_callback(std::function<void()> handler) override;
+            virtual void set_total_frame_drop_count(double value) override;
+            virtual void update_frame_drop_count(rs_stream stream, uint32_t frame_drop) override;
+            virtual void update_imu_drop_count(uint32_t frame_drop) override { reader().update_imu_drop_count(frame_drop); }
+
+        private:
+            friend class multi_device_disk_read;
+
+            disk_read_interface & reader() { return *m_shared_reader->m_reader; }
+            rs_stream to_file_stream(rs_stream stream) { return core::file_types::to_file_stream(stream, m_device_index); }
+            std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> to_device_frames(
+                    const std::map<rs_stream, std::shared_ptr<core::file_types::frame_sample>> & frames);
+
+            std::shared_ptr<multi_device_disk_read>                             m_shared_reader;
+            uint32_t                                                            m_device_index;
+            device_headers                                                      m_headers;
+            std::set<rs_stream>                                                 m_enabled_streams;
+            bool                                                                m_is_motion_tracking_enabled;
+            bool                                                                m_is_started;   //resumed since the last reset
+            bool                                                                m_is_streaming; //resumed since the last pause
+            std::function<void(std::shared_ptr<core::file_types::sample>)>      m_sample_callback;
+            std::function<void()>                                               m_eof_callback;
+        };
+    }
+}
@@ -91,6 +91,8 @@ namespace rs
         {
         public:
             rs_device_ex(const std::string &file_path);
+            //plays the given disk read, which was already initialized, instead of creating one for the file
+            rs_device_ex(const std::string &file_path, std::unique_ptr<disk_read_interface> disk_read);
             virtual ~rs_device_ex();
             virtual const rs_stream_interface &     get_stream_interface(rs_stream stream) const override;
             virtual const char *                    get_name() const override;
@@ -142,6 +144,7 @@ namespace rs
             virtual int                             get_frame_count(rs_stream stream) override;
             virtual int                             get_frame_count() override;
             virtual playback::file_info             get_file_info() override;
+            virtual core::rect                      get_region_of_interest(rs_stream stream) override;
 
         private:
             bool                                    all_streams_available();
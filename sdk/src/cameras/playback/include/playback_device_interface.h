@@ -35,6 +35,7 @@ namespace rs
             virtual int get_frame_count(rs_stream stream) = 0;
             virtual int get_frame_count() = 0;
             virtual playback::file_info get_file_info() = 0;
+            virtual core::rect get_region_of_interest(rs_stream stream) = 0;
         };
     }
 }
@@ -0,0 +1,171 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <algorithm>
+#include "live_stream.h"
+#include "include/stream_endpoint.h"
+#include "rs/utils/log_utils.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+        std::shared_ptr<live_stream> live_stream::open(const std::string & endpoint)
+        {
+            int fd = stream_endpoint::accept(endpoint);
+            if(fd < 0)
+            {
+                LOG_ERROR("failed to accept a recorder on the live stream endpoint " << endpoint.c_str());
+                return nullptr;
+            }
+            return std::shared_ptr<live_stream>(new live_stream(fd));
+        }
+
+        live_stream::live_stream(int fd) : m_fd(fd), m_is_ended(false), m_base_offset(0), m_size(0)
+        {
+
+        }
+
+        live_stream::~live_stream()
+        {
+#ifdef __linux__
+            ::close(m_fd);
+#endif
+        }
+
+        bool live_stream::read(uint64_t offset, uint8_t * data, uint32_t size)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(offset + size > m_size)
+                receive(offset + size, -1);
+            if(offset < m_base_offset || offset + size > m_size)
+            {
+                if(offset < m_base_offset)
+                    LOG_WARN("live stream data at offset " << offset << " is no longer kept, the reader fell behind");
+                return false;
+            }
+
+            while(size > 0)
+            {
+                const uint64_t block_index = (offset - m_base_offset) / block_size;
+                const uint32_t block_offset = static_cast<uint32_t>((offset - m_base_offset) % block_size);
+                const uint32_t copy_size = std::min(size, block_size - block_offset);
+                memcpy(data, m_blocks[static_cast<size_t>(block_index)].data() + block_offset, copy_size);
+                data += copy_size;
+                offset += copy_size;
+                size -= copy_size;
+            }
+            return true;
+        }
+
+        bool live_stream::wait_for_data(uint64_t offset, uint32_t timeout_ms)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(offset >= m_size && !m_is_ended)
+                receive(offset + 1, static_cast<int>(timeout_ms));
+            return offset < m_size || m_is_ended;
+        }
+
+        bool live_stream::receive(uint64_t end_offset, int timeout_ms)
+        {
+#ifdef __linux__
+            while(m_size < end_offset && !m_is_ended)
+            {
+                pollfd poll_fd = { m_fd, POLLIN, 0 };
+                int poll_sts = ::poll(&poll_fd, 1, timeout_ms);
+                if(poll_sts < 0 && errno == EINTR)
+                    continue;
+                if(poll_sts == 0)
+                    return false;
+
+                //the data is received straight into the kept blocks
+                const uint32_t block_offset = static_cast<uint32_t>((m_size - m_base_offset) % block_size);
+                if(block_offset == 0)
+                {
+                    std::vector<uint8_t> block;
+                    if(m_size - m_base_offset >= retained_size)
+                    {
+                        block.swap(m_blocks.front());
+                        m_blocks.pop_front();
+                        m_base_offset += block_size;
+                    }
+                    block.resize(block_size);
+                    m_blocks.push_back(std::move(block));
+                }
+                ssize_t received = poll_sts < 0 ? -1 : ::read(m_fd, m_blocks.back().data() + block_offset, block_size - block_offset);
+                if(received < 0 && errno == EINTR)
+                    continue;
+                if(received <= 0)
+                {
+                    if(received < 0)
+                        LOG_ERROR("live stream receive failed, errno - " << errno);
+                    LOG_INFO("live stream ended, received " << m_size << " bytes");
+                    m_is_ended = true;
+                    break;
+                }
+                m_size += static_cast<uint64_t>(received);
+            }
+            return true;
+#else
+            m_is_ended = true;
+            return true;
+#endif
+        }
+
+        status live_stream_file::open(const std::string& /*endpoint*/, open_file_option mode)
+        {
+            //the stream is connected by the live stream, the name only identifies it
+            m_position = 0;
+            return mode == open_file_option::read ? status_no_error : status_file_open_failed;
+        }
+
+        status live_stream_file::read_bytes(void* data, unsigned int number_of_bytes_to_read, unsigned int& number_of_bytes_read)
+        {
+            number_of_bytes_read = 0;
+            if(!m_stream->read(m_position, static_cast<uint8_t *>(data), number_of_bytes_to_read))
+                return status_file_read_failed;
+            m_position += number_of_bytes_to_read;
+            number_of_bytes_read = number_of_bytes_to_read;
+            return status_no_error;
+        }
+
+        status live_stream_file::write_bytes(const void* /*data*/, unsigned int /*number_of_bytes_to_write*/, unsigned int& number_of_bytes_written)
+        {
+            number_of_bytes_written = 0;
+            return status_file_write_failed;
+        }
+
+        status live_stream_file::set_position(int64_t distance_to_move, move_method method, uint64_t* new_file_pointer)
+        {
+            int64_t position = distance_to_move;
+            switch(method)
+            {
+                case move_method::begin: break;
+                case move_method::current: position += static_cast<int64_t>(m_position); break;
+                case move_method::end: return status_file_read_failed; //the end of a live stream isn't known
+            }
+            if(position < 0)
+                return status_file_read_failed;
+            m_position = static_cast<uint64_t>(position);
+            if(new_file_pointer != NULL) *new_file_pointer = m_position;
+            return status_no_error;
+        }
+
+        status live_stream_file::get_position(uint64_t* new_file_pointer)
+        {
+            if(new_file_pointer == NULL)
+                return status_file_read_failed;
+            *new_file_pointer = m_position;
+            return status_no_error;
+        }
+    }
+}
@@ -0,0 +1,276 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "multi_device_disk_read.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace playback
+    {
+        multi_device_disk_read::multi_device_disk_read(std::unique_ptr<disk_read_interface> reader) : m_reader(std::move(reader))
+        {
+            m_reader->set_callback((std::function<void()>)([this]() { handle_end_of_file(); }));
+            m_reader->set_callback((std::function<void(std::shared_ptr<file_types::sample>)>)([this](std::shared_ptr<file_types::sample> sample)
+            {
+                handle_sample(sample);
+            }));
+        }
+
+        multi_device_disk_read::~multi_device_disk_read()
+        {
+            m_reader->pause();
+        }
+
+        //the reader thread iterates the views, so the reader is paused, which joins its thread, before any change to the views
+        void multi_device_disk_read::add_view(device_disk_read * view)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_reader->pause();
+            m_views[view->m_device_index] = view;
+            update_reader();
+        }
+
+        void multi_device_disk_read::remove_view(device_disk_read * view)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_reader->pause();
+            m_views.erase(view->m_device_index);
+            update_reader();
+        }
+
+        void multi_device_disk_read::resume(device_disk_read * view)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_reader->pause();
+            view->m_is_started = true;
+            view->m_is_streaming = true;
+            update_reader();
+        }
+
+        void multi_device_disk_read::pause(device_disk_read * view)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_reader->pause();
+            view->m_is_streaming = false;
+            update_reader();
+        }
+
+        void multi_device_disk_read::reset(device_disk_read * view)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_reader->pause();
+            view->m_is_started = false;
+            view->m_is_streaming = false;
+            update_reader();
+            //the position is shared, it is rewound only when no other device is started
+            for(auto & other : m_views)
+            {
+                if(other.second->m_is_started)
+                    return;
+            }
+            m_reader->reset();
+        }
+
+        void multi_device_disk_read::update_view(device_disk_read * view, std::function<void()> update)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            //a view which isn't started isn't read nor called by the reader thread
+            if(!view->m_is_started)
+            {
+                update();
+                return;
+            }
+            m_reader->pause();
+            update();
+            update_reader();
+        }
+
+        std::map<rs_stream, std::shared_ptr<file_types::frame_sample>> multi_device_disk_read::seek(
+                std::function<std::map<rs_stream, std::shared_ptr<file_types::frame_sample>>()> seek_reader)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            return seek_reader();
+        }
+
+        bool multi_device_disk_read::update_reader()
+        {
+            bool is_streaming = false;
+            bool is_motion_tracking_enabled = false;
+            std::set<rs_stream> streams;
+            for(auto & view : m_views)
+            {
+                auto device = view.second;
+                if(!device->m_is_started)
+                    continue;
+                for(auto stream : device->m_enabled_streams)
+                    streams.insert(file_types::to_file_stream(stream, device->m_device_index));
+                is_motion_tracking_enabled |= device->m_is_motion_tracking_enabled;
+                is_streaming |= device->m_is_streaming;
+            }
+            //a stream which stays enabled keeps its prefetched frames
+            for(auto stream : m_reader_streams)
+            {
+                if(streams.find(stream) == streams.end())
+                    m_reader->enable_stream(stream, false);
+            }
+            for(auto stream : streams)
+            {
+                if(m_reader_streams.find(stream) == m_reader_streams.end())
+                    m_reader->enable_stream(stream, true);
+            }
+            m_reader_streams = streams;
+            m_reader->enable_motions_callback(is_motion_tracking_enabled);
+
+            if(is_streaming)
+                m_reader->resume();
+            LOG_INFO("shared reader updated, streams count - " << streams.size() << (is_streaming ? ", streaming" : ", paused"));
+            return is_streaming;
+        }
+
+        //called from the reader thread without the mutex, the views and their streaming state and callbacks change only while the
+        //reader is paused, and pausing joins the reader thread
+        void multi_device_disk_read::handle_sample(std::shared_ptr<file_types::sample> sample)
+        {
+            uint32_t device_index = sample->info.device_index;
+            if(sample->info.type == file_types::sample_type::st_image)
+            {
+                //read frames are copies of the indexed samples, the stream is translated in place
+                auto frame = std::static_pointer_cast<file_types::frame_sample>(sample);
+                device_index = file_types::to_device_index(frame->finfo.stream);
+                frame->finfo.stream = file_types::to_device_stream(frame->finfo.stream);
+            }
+            auto view = m_views.find(device_index);
+            if(view == m_views.end() || !view->second->m_is_streaming || !view->second->m_sample_callback)
+                return;
+            view->second->m_sample_callback(sample);
+        }
+
+        void multi_device_disk_read::handle_end_of_file()
+        {
+            for(auto & view : m_views)
+            {
+                if(view.second->m_is_streaming && view.second->m_eof_callback)
+                    view.second->m_eof_callback();
+            }
+        }
+
+        device_disk_read::device_disk_read(std::shared_ptr<multi_device_disk_read> shared_reader, uint32_t device_index) :
+            m_shared_reader(shared_reader),
+            m_device_index(device_index),
+            m_headers(shared_reader->m_reader->get_device_headers(device_index)),
+            m_is_motion_tracking_enabled(false),
+            m_is_started(false),
+            m_is_streaming(false)
+        {
+            m_shared_reader->add_view(this);
+        }
+
+        device_disk_read::~device_disk_read()
+        {
+            m_shared_reader->remove_view(this);
+        }
+
+        void device_disk_read::reset()
+        {
+            m_shared_reader->reset(this);
+        }
+
+        void device_disk_read::resume()
+        {
+            m_shared_reader->resume(this);
+        }
+
+        void device_disk_read::pause()
+        {
+            m_shared_reader->pause(this);
+        }
+
+        void device_disk_read::enable_stream(rs_stream stream, bool state)
+        {
+            auto streams_infos = reader().get_streams_infos();
+            if(streams_infos.find(to_file_stream(stream)) == streams_infos.end())
+                throw std::runtime_error("unsupported stream");
+            m_shared_reader->update_view(this, [this, stream, state]()
+            {
+                if(state)
+                    m_enabled_streams.insert(stream);
+                else
+                    m_enabled_streams.erase(stream);
+            });
+        }
+
+        void device_disk_read::enable_motions_callback(bool state)
+        {
+            m_shared_reader->update_view(this, [this, state]() { m_is_motion_tracking_enabled = state; });
+        }
+
+        void device_disk_read::set_callback(std::function<void(std::shared_ptr<file_types::sample>)> handler)
+        {
+            m_shared_reader->update_view(this, [this, handler]() { m_sample_callback = handler; });
+        }
+
+        void device_disk_read::set_callback(std::function<void()> handler)
+        {
+            m_shared_reader->update_view(this, [this, handler]() { m_eof_callback = handler; });
+        }
+
+        std::map<rs_stream, file_types::stream_info> device_disk_read::get_streams_infos()
+        {
+            std::map<rs_stream, file_types::stream_info> rv;
+            for(auto & info : reader().get_streams_infos())
+            {
+                if(file_types::to_device_index(info.first) != m_device_index)
+                    continue;
+                auto stream_info = info.second;
+                stream_info.stream = file_types::to_device_stream(stream_info.stream);
+                stream_info.profile.info.stream = file_types::to_device_stream(stream_info.profile.info.stream);
+                rv[file_types::to_device_stream(info.first)] = stream_info;
+            }
+            return rv;
+        }
+
+        std::map<rs_stream, std::shared_ptr<file_types::frame_sample>> device_disk_read::set_frame_by_index(uint32_t index, rs_stream stream_type)
+        {
+            auto file_stream = to_file_stream(stream_type);
+            return to_device_frames(m_shared_reader->seek([this, index, file_stream]() { return reader().set_frame_by_index(index, file_stream); }));
+        }
+
+        std::map<rs_stream, std::shared_ptr<file_types::frame_sample>> device_disk_read::set_frame_by_time_stamp(uint64_t ts)
+        {
+            return to_device_frames(m_shared_reader->seek([this, ts]() { return reader().set_frame_by_time_stamp(ts); }));
+        }
+
+        bool device_disk_read::is_stream_profile_available(rs_stream stream, int width, int height, rs_format format, int framerate)
+        {
+            return reader().is_stream_profile_available(to_file_stream(stream), width, height, format, framerate);
+        }
+
+        void device_disk_read::set_total_frame_drop_count(double value)
+        {
+            m_headers.m_properties[rs_option::RS_OPTION_TOTAL_FRAME_DROPS] = value;
+        }
+
+        void device_disk_read::update_frame_drop_count(rs_stream stream, uint32_t frame_drop)
+        {
+            m_headers.m_properties[rs_option::RS_OPTION_TOTAL_FRAME_DROPS] += frame_drop;
+            reader().update_frame_drop_count(to_file_stream(stream), frame_drop);
+        }
+
+        std::map<rs_stream, std::shared_ptr<file_types::frame_sample>> device_disk_read::to_device_frames(
+                const std::map<rs_stream, std::shared_ptr<file_types::frame_sample>> & frames)
+        {
+            std::map<rs_stream, std::shared_ptr<file_types::frame_sample>> rv;
+            for(auto & frame : frames)
+            {
+                if(file_types::to_device_index(frame.first) != m_device_index)
+                    continue;
+                frame.second->finfo.stream = file_types::to_device_stream(frame.second->finfo.stream);
+                rv[file_types::to_device_stream(frame.first)] = frame.second;
+            }
+            return rv;
+        }
+    }
+}
@@ -4,21 +4,45 @@
 #include <memory>
 #include "rs/playback/playback_context.h"
 #include "playback_device_impl.h"
+#include "disk_read_factory.h"
+#include "multi_device_disk_read.h"
 
 namespace rs
 {
     namespace playback
     {
-        context::context(const char *file_path) : m_init_status(false)
+        context::context(const char *file_path) : m_init_status(false), m_device_count(1)
         {
-            m_devices = new rs_device*[1];
-            m_devices[0] = new rs_device_ex(file_path);
-            m_init_status = ((rs_device_ex*)m_devices[0])->init();
+            std::unique_ptr<disk_read_interface> disk_read;
+            if(disk_read_factory::create_disk_read(file_path, disk_read) != core::status_no_error)
+                disk_read.reset();
+
+            if(disk_read && disk_read->query_device_count() > 1)
+            {
+                //the devices of the file are played by a single reader
+                m_device_count = static_cast<int>(disk_read->query_device_count());
+                auto shared_disk_read = std::make_shared<multi_device_disk_read>(std::move(disk_read));
+                m_devices = new rs_device*[m_device_count];
+                for(auto i = 0; i < m_device_count; i++)
+                {
+                    std::unique_ptr<disk_read_interface> device_read(new device_disk_read(shared_disk_read, static_cast<uint32_t>(i)));
+                    m_devices[i] = new rs_device_ex(file_path, std::move(device_read));
+                }
+            }
+            else
+            {
+                m_devices = new rs_device*[1];
+                m_devices[0] = disk_read ? new rs_device_ex(file_path, std::move(disk_read)) : new rs_device_ex(file_path);
+            }
+
+            m_init_status = true;
+            for(auto i = 0; i < m_device_count; i++)
+                m_init_status &= ((rs_device_ex*)m_devices[i])->init();
         }
 
         context::~context()
         {
-            for(auto i = 0; i < 1; i++)
+            for(auto i = 0; i < m_device_count; i++)
             {
                 if(m_devices[i])
                     delete m_devices[i];
@@ -28,17 +52,22 @@ namespace rs
 
         int context::get_device_count() const
         {
-            return m_init_status ? 1 : 0;
+            return m_init_status ? m_device_count : 0;
         }
 
         rs::device * context::get_device(int index)
         {
-            return (rs::device*)get_playback_device();
+            return (rs::device*)get_playback_device(index);
         }
 
         device * context::get_playback_device()
         {
-            return m_init_status ? (device*)m_devices[0] : nullptr;
+            return get_playback_device(0);
+        }
+
+        device * context::get_playback_device(int index)
+        {
+            return m_init_status && index >= 0 && index < m_device_count ? (device*)m_devices[index] : nullptr;
         }
     }
 }
@@ -9,6 +9,7 @@
 #include "playback_device_impl.h"
 #include "disk_read_factory.h"
 #include "rs/playback/playback_device.h"
+#include "rs/utils/event_tracer.h"
 
 using namespace rs::core;
 
@@ -97,6 +98,15 @@ namespace rs
 
         }
 
+        rs_device_ex::rs_device_ex(const std::string &file_path, std::unique_ptr<disk_read_interface> disk_read) :
+            m_file_path(file_path),
+            m_is_streaming(false),
+            m_wait_streams_request(false),
+            m_enabled_streams_count(0)
+        {
+            m_disk_read = std::move(disk_read);
+        }
+
         rs_device_ex::~rs_device_ex()
         {
             stop(rs_source::RS_SOURCE_ALL)            ;
@@ -563,6 +573,14 @@ namespace rs
             return m_disk_read->query_file_info();
         }
 
+        core::rect rs_device_ex::get_region_of_interest(rs_stream stream)
+        {
+            auto it = m_available_streams.find(stream);
+            if(it == m_available_streams.end())
+                return {};
+            return it->second->get_stream_info().profile.roi;
+        }
+
         void rs_device_ex::handle_frame_callback(std::shared_ptr<file_types::sample> sample)
         {
             if(!sample)
@@ -582,13 +600,17 @@ namespace rs
                 {
                     std::unique_lock<std::mutex> guard(m_frame_thread[stream].mutex);
                     if(m_frame_thread[stream].sample != nullptr)
+                    {
+                        TRACE_INSTANT("playback", "frame_drop");
                         m_disk_read->update_frame_drop_count(stream, 1);
+                    }
                     m_frame_thread[stream].sample = frame;
                     guard.unlock();
                     m_frame_thread[stream].sample_ready_cv.notify_one();
                 }
                 else//asynced reader non realtime mode
                 {
+                    TRACE_SCOPE("playback", "frame_callback");
                     m_frame_thread[stream].active_samples_count++;
                     m_frame_thread[stream].callback->on_frame(this, new rs_frame_ref_impl(m_curr_frames[stream]));
                 }
@@ -628,6 +650,8 @@ namespace rs
 
         void rs_device_ex::frame_callback_thread(rs_stream stream)
         {
+            //a track per stream, the streams are called back on their own threads
+            TRACE_THREAD_NAME(("playback_frame_callback_" + std::to_string(static_cast<int32_t>(stream))).c_str());
             auto pred = [this, stream]()->bool{ return (m_frame_thread[stream].sample != nullptr) || (m_is_streaming == false);};
 
             while(m_is_streaming)
@@ -644,6 +668,7 @@ namespace rs
                 guard.unlock();
                 if(frame_ref)
                 {
+                    TRACE_SCOPE("playback", "frame_callback");
                     m_frame_thread[stream].callback->on_frame(this, frame_ref);
                 }
             }
@@ -656,6 +681,7 @@ namespace rs
                 std::unique_lock<std::mutex> guard(m_imu_thread.mutex);
                 if(m_imu_thread.samples.size() >= m_imu_thread.max_queue_size)
                 {
+                    TRACE_INSTANT("playback", "motion_drop");
                     m_imu_thread.samples.pop();
                     m_disk_read->update_imu_drop_count(1);
                 }
@@ -665,12 +691,14 @@ namespace rs
             }
             else
             {
+                TRACE_SCOPE("playback", "motion_callback");
                 m_imu_thread.push_sample_to_user(sample);
             }
         }
 
         void rs_device_ex::motion_callback_thread()
         {
+            TRACE_THREAD_NAME("playback_motion_callback");
             auto pred = [this]()->bool{ return (m_imu_thread.samples.empty() == false) || (m_is_streaming == false);};
 
             while(m_is_streaming || !m_imu_thread.samples.empty())
@@ -680,6 +708,7 @@ namespace rs
                 std::queue<std::shared_ptr<core::file_types::sample>> data;
                 std::swap(m_imu_thread.samples, data);
                 guard.unlock();
+                TRACE_SCOPE("playback", "motion_callback");
                 while (!data.empty())
                 {
                     m_imu_thread.push_sample_to_user(data.front());
@@ -690,7 +719,9 @@ namespace rs
 
         bool rs_device_ex::init()
         {
-            if(disk_read_factory::create_disk_read(m_file_path.c_str(), m_disk_read) != status::status_no_error)
+            //a live stream endpoint accepts a single recorder, it isn't opened again when the context failed to open it
+            if(!m_disk_read && (stream_endpoint::is_stream_endpoint(m_file_path) ||
+                                disk_read_factory::create_disk_read(m_file_path.c_str(), m_disk_read) != status::status_no_error))
             {
                 return false;
             }
@@ -881,5 +912,10 @@ namespace rs
         {
             return ((rs_device_ex*)this)->get_file_info();
         }
+
+        rs::core::rect device::get_region_of_interest(rs::stream stream)
+        {
+            return ((rs_device_ex*)this)->get_region_of_interest((rs_stream)stream);
+        }
     }
 }
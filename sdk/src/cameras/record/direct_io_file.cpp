@@ -0,0 +1,313 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+#include "direct_io_file.h"
+#include "rs/utils/log_utils.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace rs::core;
+
+namespace
+{
+    //writes the whole range, a file system rejecting the direct I/O of a block switches the descriptor to buffered I/O
+    bool write_all(int fd, const uint8_t * data, uint64_t offset, uint32_t size)
+    {
+#ifdef __linux__
+        while(size > 0)
+        {
+            auto written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if(written < 0 && errno == EINTR)
+                continue;
+            if(written < 0 && errno == EINVAL)
+            {
+                int flags = ::fcntl(fd, F_GETFL);
+                if(flags < 0 || (flags & O_DIRECT) == 0 || ::fcntl(fd, F_SETFL, flags & ~O_DIRECT) != 0)
+                    return false;
+                LOG_WARN("direct I/O write rejected, switching to buffered I/O");
+                continue;
+            }
+            if(written <= 0)
+                return false;
+            data += written;
+            offset += static_cast<uint64_t>(written);
+            size -= static_cast<uint32_t>(written);
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+}
+
+namespace rs
+{
+    namespace record
+    {
+        direct_io_file::direct_io_file() :
+            m_direct_fd(-1),
+            m_buffered_fd(-1),
+            m_position(0),
+            m_size(0),
+            m_block(),
+            m_write_failed(false),
+            m_stop_writers(false) {}
+
+        direct_io_file::~direct_io_file()
+        {
+            close();
+        }
+
+        status direct_io_file::open(const std::string& filename, open_file_option mode)
+        {
+            if(is_direct())
+                return status_file_open_failed;
+            if(mode != open_file_option::write)
+                return file::open(filename, mode);
+#ifdef __linux__
+            m_direct_fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT | O_CLOEXEC, 0644);
+            if(m_direct_fd >= 0)
+                m_buffered_fd = ::open(filename.c_str(), O_WRONLY | O_CLOEXEC);
+            if(m_direct_fd >= 0 && m_buffered_fd < 0)
+            {
+                ::close(m_direct_fd);
+                m_direct_fd = -1;
+            }
+            if(!is_direct())
+            {
+                LOG_WARN("direct I/O is not supported, writing " << filename.c_str() << " with buffered I/O");
+                return file::open(filename, mode);
+            }
+
+            for(uint32_t i = 0; i < buffers_count; i++)
+            {
+                void * buffer = nullptr;
+                if(posix_memalign(&buffer, alignment, block_size) != 0)
+                {
+                    close();
+                    return status_file_open_failed;
+                }
+                m_buffers.push_back(static_cast<uint8_t *>(buffer));
+            }
+            m_free_buffers.assign(m_buffers.begin() + 1, m_buffers.end());
+            m_block.data = m_buffers[0];
+            m_block.offset = 0;
+            m_block.size = 0;
+            m_position = 0;
+            m_size = 0;
+            m_write_failed = false;
+
+            for(uint32_t i = 0; i < writer_threads_count; i++)
+                m_writers.push_back(std::thread(&direct_io_file::writer_thread, this));
+
+            if(m_preallocation_size > 0)
+                start_preallocation(filename);
+            return status_no_error;
+#else
+            return file::open(filename, mode);
+#endif
+        }
+
+        status direct_io_file::close()
+        {
+            if(!is_direct())
+                return file::close();
+
+            wait_for_writes();
+            bool succeeded = !m_write_failed;
+            //the last block is written padded to the alignment, the padding is truncated below
+            if(succeeded && m_block.size > 0)
+            {
+                uint32_t padded_size = (m_block.size + alignment - 1) / alignment * alignment;
+                std::memset(m_block.data + m_block.size, 0, padded_size - m_block.size);
+                succeeded = write_all(m_direct_fd, m_block.data, m_block.offset, padded_size);
+            }
+            stop_writers();
+#ifdef __linux__
+            if(::ftruncate(m_buffered_fd, static_cast<off_t>(m_size)) != 0)
+                succeeded = false;
+            ::close(m_buffered_fd);
+            ::close(m_direct_fd);
+#endif
+            m_buffered_fd = -1;
+            m_direct_fd = -1;
+            stop_preallocation();
+
+            for(auto buffer : m_buffers)
+                free(buffer);
+            m_buffers.clear();
+            m_free_buffers.clear();
+            m_block = block();
+            return succeeded ? status_no_error : status_file_close_failed;
+        }
+
+        status direct_io_file::write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written)
+        {
+            if(!is_direct())
+                return file::write_bytes(data, number_of_bytes_to_write, number_of_bytes_written);
+
+            number_of_bytes_written = 0;
+            auto source = static_cast<const uint8_t *>(data);
+            uint32_t remaining = number_of_bytes_to_write;
+            while(remaining > 0)
+            {
+                uint32_t size = 0;
+                if(m_position < m_block.offset)
+                {
+                    //the range before the gathered block was already submitted
+                    size = static_cast<uint32_t>(std::min<uint64_t>(remaining, m_block.offset - m_position));
+                    if(!write_buffered(source, m_position, size))
+                        return status_file_write_failed;
+                }
+                else
+                {
+                    uint32_t offset_in_block = static_cast<uint32_t>(m_position - m_block.offset);
+                    size = std::min<uint32_t>(remaining, block_size - offset_in_block);
+                    std::memcpy(m_block.data + offset_in_block, source, size);
+                    m_block.size = std::max<uint32_t>(m_block.size, offset_in_block + size);
+                }
+                source += size;
+                remaining -= size;
+                m_position += size;
+                m_size = std::max<uint64_t>(m_size, m_position);
+                if(m_block.size == block_size && !submit_block(block_size))
+                    return status_file_write_failed;
+            }
+
+            if(m_preallocation_fd >= 0)
+            {
+                m_write_position = m_size;
+                extend_preallocation();
+            }
+            number_of_bytes_written = number_of_bytes_to_write;
+            return status_no_error;
+        }
+
+        status direct_io_file::set_position(int64_t distance_to_move, move_method method, uint64_t* new_file_pointer)
+        {
+            if(!is_direct())
+                return file::set_position(distance_to_move, method, new_file_pointer);
+
+            int64_t origin = 0;
+            switch(method)
+            {
+                case move_method::begin: origin = 0; break;
+                case move_method::current: origin = static_cast<int64_t>(m_position); break;
+                case move_method::end: origin = static_cast<int64_t>(m_size); break;
+            }
+            //the recorder never leaves gaps, seeking beyond the end of the file is not supported
+            int64_t position = origin + distance_to_move;
+            if(position < 0 || static_cast<uint64_t>(position) > m_size)
+                return status_file_read_failed;
+            m_position = static_cast<uint64_t>(position);
+            if(new_file_pointer != NULL) *new_file_pointer = m_position;
+            return status_no_error;
+        }
+
+        status direct_io_file::get_position(uint64_t* new_file_pointer)
+        {
+            if(!is_direct())
+                return file::get_position(new_file_pointer);
+            if(new_file_pointer == NULL)
+                return status_file_read_failed;
+            *new_file_pointer = m_position;
+            return status_no_error;
+        }
+
+        void direct_io_file::reset()
+        {
+            if(!is_direct())
+                return file::reset();
+            m_position = 0;
+        }
+
+        void direct_io_file::writer_thread()
+        {
+            while(true)
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [this]() { return m_stop_writers || !m_pending_blocks.empty(); });
+                if(m_pending_blocks.empty())
+                    return;
+                block pending_block = m_pending_blocks.front();
+                m_pending_blocks.pop_front();
+                lock.unlock();
+
+                bool succeeded = write_all(m_direct_fd, pending_block.data, pending_block.offset, pending_block.size);
+
+                lock.lock();
+                m_outstanding_offsets.erase(m_outstanding_offsets.find(pending_block.offset));
+                m_free_buffers.push_back(pending_block.data);
+                if(!succeeded)
+                {
+                    LOG_ERROR("failed writing block at offset " << pending_block.offset);
+                    m_write_failed = true;
+                }
+                m_cv.notify_all();
+            }
+        }
+
+        bool direct_io_file::submit_block(uint32_t size)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if(m_write_failed)
+                return false;
+            block submitted_block = { m_block.data, m_block.offset, size };
+            m_pending_blocks.push_back(submitted_block);
+            m_outstanding_offsets.insert(submitted_block.offset);
+            m_cv.notify_all();
+
+            //blocks while all the buffers are outstanding, which is the back pressure on the recorder write thread
+            m_cv.wait(lock, [this]() { return m_write_failed || !m_free_buffers.empty(); });
+            if(m_write_failed)
+                return false;
+            m_block.data = m_free_buffers.back();
+            m_free_buffers.pop_back();
+            m_block.offset += block_size;
+            m_block.size = 0;
+            return true;
+        }
+
+        bool direct_io_file::write_buffered(const uint8_t * data, uint64_t offset, uint32_t size)
+        {
+            //a buffered write must not race with an outstanding direct write of the same block
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_cv.wait(lock, [&]()
+                {
+                    auto first = m_outstanding_offsets.lower_bound(offset >= block_size ? offset - block_size + 1 : 0);
+                    return m_write_failed || first == m_outstanding_offsets.end() || *first >= offset + size;
+                });
+                if(m_write_failed)
+                    return false;
+            }
+            return write_all(m_buffered_fd, data, offset, size);
+        }
+
+        void direct_io_file::wait_for_writes()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock, [this]() { return m_pending_blocks.empty() && m_outstanding_offsets.empty(); });
+        }
+
+        void direct_io_file::stop_writers()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop_writers = true;
+                m_cv.notify_all();
+            }
+            for(auto & writer : m_writers)
+                writer.join();
+            m_writers.clear();
+            m_stop_writers = false;
+        }
+    }
+}
@@ -6,8 +6,12 @@
 #include <tuple>
 #include "disk_write.h"
 #include "include/file.h"
+#include "direct_io_file.h"
+#include "stream_write_file.h"
+#include "include/stream_endpoint.h"
 #include "rs_sdk_version.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
 
 using namespace rs::core;
 
@@ -19,9 +23,14 @@ namespace rs
 
         disk_write::disk_write(void):
             m_is_configured(false),
+            m_write_failed(false),
             m_paused(false),
             m_stop_writing(true),
-            m_min_fps(0)
+            m_min_fps(0),
+            m_bytes_written_counter(PERF_COUNTERS.query_counter("record.bytes_written")),
+            m_frames_dropped_counter(PERF_COUNTERS.query_counter("record.frames_dropped")),
+            m_frames_skipped_counter(PERF_COUNTERS.query_counter("record.frames_skipped")),
+            m_samples_queue_size_gauge(PERF_COUNTERS.query_gauge("record.samples_queue_size"))
         {
 
         }
@@ -70,6 +79,7 @@ namespace rs
             if(m_samples_count[stream] > max_samples)
             {
                 m_curr_recorder_frame_drop_count[frame->finfo.stream]++;
+                m_frames_dropped_counter.add();
                 return false;
             }
 
@@ -88,10 +98,15 @@ namespace rs
         void disk_write::record_sample(std::shared_ptr<file_types::sample> &sample)
         {
             LOG_FUNC_SCOPE();
+            TRACE_SCOPE("record", "record_sample");
             if (m_paused)
             {
                 return;//device is still streaming but samples are not recorded
             }
+            if (m_write_failed)
+            {
+                return;//the recording stopped writing, see write_thread
+            }
             bool insert_samples = false;
             {
                 std::lock_guard<std::mutex> guard(m_main_mutex);
@@ -99,9 +114,12 @@ namespace rs
                 if (insert_samples)//it is ok that sample queue size may exceed MAX_CACHED_SAMPLES by few samples
                 {
                     m_samples_queue.push(sample);
+                    TRACE_COUNTER("record", "samples_queue_size", static_cast<int64_t>(m_samples_queue.size()));
+                    m_samples_queue_size_gauge.set(static_cast<int64_t>(m_samples_queue.size()));
                 }
                 else
                 {
+                    TRACE_INSTANT("record", "sample_drop");
                     LOG_WARN("sample drop, sample type - " << sample->info.type << " ,capture time - " << sample->info.capture_time);
                 }
             }
@@ -113,6 +131,17 @@ namespace rs
             }
         }
 
+        void disk_write::skip_frame(rs_stream stream, uint64_t frame_number)
+        {
+            if (m_paused)
+                return;
+            {
+                std::lock_guard<std::mutex> guard(m_main_mutex);
+                m_last_frame_number[stream] = frame_number;
+            }
+            m_frames_skipped_counter.add();
+        }
+
         bool disk_write::start()
         {
             LOG_FUNC_SCOPE();
@@ -131,7 +160,10 @@ namespace rs
             m_stop_writing = true;
             guard.unlock();
 
-            m_notify_write_thread_cv.notify_one();
+            {
+                std::lock_guard<std::mutex> notify_guard(m_notify_write_thread_mutex);
+                m_notify_write_thread_cv.notify_one();
+            }
 
             if (m_thread.joinable())
             {
@@ -159,22 +191,34 @@ namespace rs
         {
             std::lock_guard<std::mutex> guard(m_main_mutex);
             if(m_is_configured) return status::status_exec_aborted;
-            m_file = std::unique_ptr<rs::core::file>(new rs::core::file());
+            if(stream_endpoint::is_stream_endpoint(config.m_file_path))
+                m_file = std::unique_ptr<rs::core::file>(new stream_write_file());
+            else
+                m_file = config.m_direct_io ? std::unique_ptr<rs::core::file>(new direct_io_file()) : std::unique_ptr<rs::core::file>(new rs::core::file());
+            if(config.m_preallocation_size > 0 && m_file->set_preallocation(config.m_preallocation_size) != status::status_no_error)
+                LOG_WARN("file preallocation is not supported, recording without preallocation");
             status sts = m_file->open(config.m_file_path, (open_file_option)(open_file_option::write));
 
             if (sts != status::status_no_error)
                 throw std::runtime_error("failed to open file for recording, file path - " + config.m_file_path);
 
             init_encoder(config);
-            m_min_fps = get_min_fps(config.m_stream_profiles);
-            write_header(static_cast<uint8_t>(config.m_stream_profiles.size()), config.m_coordinate_system, config.m_capture_mode);
+            auto all_profiles = get_all_profiles(config);
+            m_min_fps = get_min_fps(all_profiles);
+            auto device_count = static_cast<uint32_t>(config.m_additional_devices.size() + 1);
+            write_header(static_cast<uint8_t>(all_profiles.size()), config.m_coordinate_system, config.m_capture_mode, device_count);
             write_camera_info(config.m_camera_info);
             write_sw_info();
             write_capabilities(config.m_capabilities);
             write_motion_intrinsics(config.m_motion_intrinsics);
             write_stream_info(config.m_stream_profiles);
             write_properties(config.m_options);
+            for(uint32_t i = 1; i < device_count; i++)
+                write_device_section(i, config.m_additional_devices[i - 1]);
             write_first_frame_offset();
+            //a live stream sends the header once its first frame offset is set
+            if(m_file->commit() != status::status_no_error)
+                throw std::runtime_error("failed to send the header of the live stream, endpoint - " + config.m_file_path);
             m_is_configured = true;
             return sts;
         }
@@ -183,7 +227,7 @@ namespace rs
         {
             uint32_t buffer_size = 0;
             m_encoder.reset(new compression::encoder());
-            for(auto profile : config.m_stream_profiles)
+            for(auto profile : get_all_profiles(config))
             {
                 rs_stream stream = profile.second.info.stream;
                 rs_format format = profile.second.info.format;
@@ -203,6 +247,14 @@ namespace rs
             m_encoded_data = std::vector<uint8_t>(buffer_size * 4);//stride is not available, taking worst case.
         }
 
+        std::map<rs_stream, core::file_types::stream_profile> disk_write::get_all_profiles(const configuration& config)
+        {
+            auto profiles = config.m_stream_profiles;
+            for(auto & device : config.m_additional_devices)
+                profiles.insert(device.m_stream_profiles.begin(), device.m_stream_profiles.end());
+            return profiles;
+        }
+
         void disk_write::write_to_file(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written)
         {
             auto sts = m_file->write_bytes(data, number_of_bytes_to_write, number_of_bytes_written);
@@ -212,15 +264,22 @@ namespace rs
                 LOG_ERROR("failed writing to file");
                 throw std::runtime_error("failed writing to file");
             }
+            m_bytes_written_counter.add(number_of_bytes_written);
         }
 
         void disk_write::write_thread(void)
         {
             LOG_FUNC_SCOPE();
+            TRACE_THREAD_NAME("disk_write");
             while (!m_stop_writing)
             {
+                //the predicate keeps a sample recorded while the queue was being written from waiting for the next notification
                 std::unique_lock<std::mutex> guard(m_notify_write_thread_mutex);
-                m_notify_write_thread_cv.wait(guard);
+                m_notify_write_thread_cv.wait(guard, [this]()
+                {
+                    std::lock_guard<std::mutex> queue_guard(m_main_mutex);
+                    return m_stop_writing || !m_samples_queue.empty();
+                });
                 guard.unlock();
 
                 LOG_VERBOSE("queue contains " << m_samples_queue.size() << " samples")
@@ -233,15 +292,35 @@ namespace rs
                         if(m_samples_queue.empty() || m_stop_writing == true) break;
                         sample = m_samples_queue.front();
                         m_samples_queue.pop();
+                        m_samples_queue_size_gauge.set(static_cast<int64_t>(m_samples_queue.size()));
                         if(!sample) continue;
                     }
-                    write_sample_info(sample);
-                    write_sample(sample);
+                    TRACE_SCOPE("record", "write_sample");
+                    if(m_write_failed)
+                        continue;
+                    try
+                    {
+                        write_sample_info(sample);
+                        write_sample(sample);
+                        //a live stream sends every sample once it is written
+                        if(m_file->commit() != status::status_no_error)
+                            throw std::runtime_error("failed to send a sample of the live stream");
+                    }
+                    catch(const std::runtime_error & error)
+                    {
+                        //a full disk or a live reader which went away doesn't end the streaming, the recording stops and the failure is
+                        //reported by the record device status. record_sample rejects the following samples and the queued ones are released.
+                        LOG_ERROR("recording stopped writing, " << error.what());
+                        m_write_failed = true;
+                        std::lock_guard<std::mutex> guard(m_main_mutex);
+                        m_samples_queue = std::queue<std::shared_ptr<core::file_types::sample>>();
+                        m_samples_queue_size_gauge.set(0);
+                    }
                 }
             }
             for(auto & pair : m_curr_recorder_frame_drop_count)
             {
-                if(pair.second == 0)
+                if(pair.second == 0 || m_write_failed)
                     continue;
                 file_types::debug_data dd { m_curr_recorder_frame_drop_count[pair.first], pair.first };
                 std::shared_ptr<file_types::sample> sample = std::make_shared<file_types::debug_event_sample>(
@@ -252,7 +331,7 @@ namespace rs
             m_curr_recorder_frame_drop_count.clear();
         }
 
-        void disk_write::write_header(uint8_t stream_count, file_types::coordinate_system cs, playback::capture_mode capture_mode)
+        void disk_write::write_header(uint8_t stream_count, file_types::coordinate_system cs, playback::capture_mode capture_mode, uint32_t device_count)
         {
             file_types::disk_format::file_header header = {};
             header.data.version = 2;
@@ -262,6 +341,8 @@ namespace rs
 
             /* calculate the number of streams */
             header.data.nstreams = stream_count;
+            //a file of a single device keeps the header of the older versions
+            header.data.device_count = device_count > 1 ? static_cast<int32_t>(device_count) : 0;
 
             uint32_t bytes_written = 0;
             m_file->set_position(0, move_method::begin);
@@ -269,6 +350,24 @@ namespace rs
             LOG_INFO("write header chunk, chunk size - " << sizeof(header))
         }
 
+        void disk_write::write_device_section(uint32_t device_index, const device_configuration &device)
+        {
+            file_types::chunk_info chunk = {};
+            chunk.id = file_types::chunk_id::chunk_device_section;
+            chunk.size = sizeof(device_index);
+
+            uint32_t bytes_written = 0;
+            write_to_file(&chunk, sizeof(chunk), bytes_written);
+            write_to_file(&device_index, sizeof(device_index), bytes_written);
+            LOG_INFO("write device section chunk, device index - " << device_index)
+
+            write_camera_info(device.m_camera_info);
+            write_capabilities(device.m_capabilities);
+            write_motion_intrinsics(device.m_motion_intrinsics);
+            write_stream_info(device.m_stream_profiles);
+            write_properties(device.m_options);
+        }
+
         void disk_write::write_camera_info(const std::map<rs_camera_info, std::pair<uint32_t, const char*>>& camera_info)
         {
             file_types::chunk_info chunk = {};
@@ -426,7 +525,7 @@ namespace rs
             file_types::chunk_info chunk = {};
             chunk.id = file_types::chunk_id::chunk_sample_info;
             chunk.size = sizeof(file_types::disk_format::sample_info);
-            file_types::disk_format::sample_info sample_info;
+            file_types::disk_format::sample_info sample_info = {};
 
             uint64_t pos = 0;
             m_file->get_position(&pos);
@@ -584,7 +683,9 @@ namespace rs
 
             uint32_t bytes_written = 0;
             m_file->write_bytes(&chunk, sizeof(chunk), bytes_written);
+            m_bytes_written_counter.add(bytes_written);
             m_file->write_bytes(data, chunk.size, bytes_written);
+            m_bytes_written_counter.add(bytes_written);
 
             m_number_of_frames[frame_info.stream]++;
             write_stream_num_of_frames(frame_info.stream, m_number_of_frames[frame_info.stream]);
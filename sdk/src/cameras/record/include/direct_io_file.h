@@ -0,0 +1,79 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <deque>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include "include/file.h"
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Recording file written with direct I/O, bypassing the page cache.
+        *
+        * The appended data is gathered in aligned blocks, which are written by a pool of writer threads while the next blocks
+        * are filled, so several writes are outstanding at any time. Writes before the gathered block, such as the updates of the
+        * file header, are written through a second, buffered, file descriptor. The last block is padded to the alignment and
+        * the file is truncated to its size on close.
+        * Where the platform or the file system doesn't support direct I/O, the file falls back to the buffered rs::core::file.
+        * Only the write mode is backed by direct I/O, a file opened for reading is always buffered.
+        */
+        class direct_io_file : public core::file
+        {
+        public:
+            direct_io_file();
+            virtual ~direct_io_file();
+
+            virtual core::status open(const std::string& filename, core::open_file_option mode) override;
+            virtual core::status close() override;
+            virtual core::status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override;
+            virtual core::status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override;
+            virtual core::status get_position(uint64_t* new_file_pointer) override;
+            virtual void reset() override;
+
+            //true when the opened file is written with direct I/O
+            bool is_direct() const { return m_direct_fd >= 0; }
+
+        private:
+            static const uint32_t block_size = 1024 * 1024;
+            static const uint32_t alignment = 4096;
+            static const uint32_t buffers_count = 8;
+            static const uint32_t writer_threads_count = 4;
+
+            struct block
+            {
+                uint8_t *   data;
+                uint64_t    offset;
+                uint32_t    size;
+            };
+
+            void writer_thread();
+            bool submit_block(uint32_t size);
+            bool write_buffered(const uint8_t * data, uint64_t offset, uint32_t size);
+            void wait_for_writes();
+            void stop_writers();
+
+            int                             m_direct_fd;
+            int                             m_buffered_fd;
+            uint64_t                        m_position;
+            uint64_t                        m_size;
+            block                           m_block;
+            std::vector<uint8_t *>          m_buffers;
+
+            std::mutex                      m_mutex;
+            std::condition_variable         m_cv;
+            std::deque<block>               m_pending_blocks;
+            std::vector<uint8_t *>          m_free_buffers;
+            std::multiset<uint64_t>         m_outstanding_offsets;
+            bool                            m_write_failed;
+            bool                            m_stop_writers;
+            std::vector<std::thread>        m_writers;
+        };
+    }
+}
@@ -11,17 +11,29 @@
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <atomic>
 #include <condition_variable>
 #include "compression/encoder.h"
 #include "include/file_types.h"
 #include "rs/core/image_interface.h"
 #include "rs/record/record_device.h"
 #include "include/file.h"
+#include "rs/utils/performance_counters.h"
 
 namespace rs
 {
     namespace record
     {
+        //the static info of a device which is recorded after the first device of the file
+        struct device_configuration
+        {
+            std::map<rs_camera_info, std::pair<uint32_t, const char*>>      m_camera_info;
+            std::vector<core::file_types::device_cap>                       m_options;
+            std::map<rs_stream, core::file_types::stream_profile>           m_stream_profiles;
+            std::vector<rs_capabilities>                                    m_capabilities;
+            rs_motion_intrinsics                                            m_motion_intrinsics;
+        };
+
         struct configuration
         {
             std::string                                                     m_file_path;
@@ -33,6 +45,10 @@ namespace rs
             rs_motion_intrinsics                                            m_motion_intrinsics;
             playback::capture_mode                                          m_capture_mode;
             std::map<rs_stream,record::compression_level>                   m_compression_config;
+            uint64_t                                                        m_preallocation_size;
+            bool                                                            m_direct_io;
+            //stream profiles and compression of these devices are keyed by their file streams, see file_types::to_file_stream
+            std::vector<device_configuration>                               m_additional_devices;
         };
 
         class disk_write
@@ -44,12 +60,17 @@ namespace rs
             void stop();
             void set_pause(bool pause, uint64_t capture_time = 0);
             bool is_configured() {return m_is_configured;}
+            //set when a write fails, the following samples are not recorded
+            bool is_write_failed() {return m_write_failed;}
             core::status configure(const configuration &config);
             void record_sample(std::shared_ptr<core::file_types::sample> &sample);
+            //notifies of a frame which isn't recorded by the recording rate of its stream, so it isn't reported as a frame drop
+            void skip_frame(rs_stream stream, uint64_t frame_number);
 
         private:
             void write_thread();
-            void write_header(uint8_t stream_count, core::file_types::coordinate_system cs, playback::capture_mode capture_mode);
+            void write_header(uint8_t stream_count, core::file_types::coordinate_system cs, playback::capture_mode capture_mode, uint32_t device_count);
+            void write_device_section(uint32_t device_index, const device_configuration &device);
             void write_camera_info(const std::map<rs_camera_info, std::pair<uint32_t, const char *> > &camera_info);
             void write_sw_info();
             //report which images and motions streams were captured
@@ -68,6 +89,7 @@ namespace rs
             void write_to_file(const void* data, unsigned int number_of_bytes_to_write, unsigned int& numberOfBytesWritten);
             bool allow_sample(std::shared_ptr<rs::core::file_types::sample> &sample);
             uint32_t get_min_fps(const std::map<rs_stream, core::file_types::stream_profile>& stream_profiles);
+            std::map<rs_stream, core::file_types::stream_profile> get_all_profiles(const configuration& config);
             void init_encoder(const configuration& config);
 
             std::mutex                                                      m_main_mutex; //protect m_samples_queue, m_stop_thred
@@ -83,10 +105,15 @@ namespace rs
             std::map<rs_stream, int64_t>                                    m_offsets;
             std::map<rs_stream, int32_t>                                    m_number_of_frames;
             bool                                                            m_is_configured;
+            std::atomic<bool>                                               m_write_failed;
             std::map<rs_stream, uint32_t>                                   m_samples_count;
             uint32_t                                                        m_min_fps;
             std::map<rs_stream, uint64_t>                                   m_last_frame_number;
             std::map<rs_stream, uint64_t>                                   m_curr_recorder_frame_drop_count;
+            rs::utils::performance_counter &                                m_bytes_written_counter;
+            rs::utils::performance_counter &                                m_frames_dropped_counter;
+            rs::utils::performance_counter &                                m_frames_skipped_counter;
+            rs::utils::performance_gauge &                                  m_samples_queue_size_gauge;
         };
     }
 }
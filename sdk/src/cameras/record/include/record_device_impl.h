@@ -3,21 +3,37 @@
 
 #pragma once
 #include <mutex>
+#include <memory>
+#include <chrono>
 #include "record_device_interface.h"
 #include "disk_write.h"
+#include "sample_rate_limiter.h"
 
 namespace rs
 {
     namespace record
     {
         class frame_callback;
+        class rs_device_ex;
+
+        //the devices of a record context share a single writer, which records all of them into the same file with a common capture time base
+        struct recording_session
+        {
+            recording_session() : m_streaming_devices_count(0) {}
+            std::mutex                                                              m_mutex;
+            disk_write                                                              m_disk_write;
+            std::vector<rs_device_ex *>                                             m_devices;
+            uint32_t                                                                m_streaming_devices_count;
+            std::chrono::high_resolution_clock::time_point                          m_capture_time_base;
+        };
+
         class rs_device_ex : public device_interface
         {
             friend class frame_callback;
             friend class motion_events_callback;
             friend class timestamp_events_callback;
         public:
-            rs_device_ex(const std::string& file_path, rs_device *device);
+            rs_device_ex(const std::string& file_path, rs_device *device, std::shared_ptr<recording_session> session = nullptr);
             virtual ~rs_device_ex();
             virtual const rs_stream_interface &     get_stream_interface(rs_stream stream) const override;
             virtual const char *                    get_name() const override;
@@ -60,34 +76,55 @@ namespace rs
 
             virtual void                            pause_record() override;
             virtual void                            resume_record() override;
+            virtual core::status                    query_record_status() override;
             virtual bool                            set_compression(rs_stream stream, record::compression_level compression_level) override;
             virtual record::compression_level       get_compression(rs_stream stream) override;
+            virtual bool                            set_preallocation_size(uint64_t expected_file_size) override;
+            virtual bool                            set_preallocation_duration(uint32_t expected_duration_seconds) override;
+            virtual bool                            set_direct_io(bool enable) override;
+            virtual core::status                    set_frame_decimation(rs_stream stream, uint32_t decimation) override;
+            virtual core::status                    set_recorded_frame_rate(rs_stream stream, double framerate) override;
+            virtual core::status                    set_motion_decimation(rs_event_source source, uint32_t decimation) override;
+            virtual core::status                    set_region_of_interest(rs_stream stream, const core::rect & roi) override;
 
         private:
             void write_samples();
-            void write_frame(rs_stream stream, rs_frame_ref *ref);
+            void write_frame(rs_stream stream, rs_frame_ref *frame_ref);
+            void write_frame_region(core::file_types::frame_sample & frame, const core::rect & region);
+            //checked before the frame is cloned or copied, notifies the writer of the skipped frames
+            bool is_frame_recorded(rs_stream stream, unsigned long long frame_number, double time_stamp);
+            bool is_motion_recorded(rs_event_source source, double time_stamp);
             void write_frameset(rs_frameset * frameset);
+            void record_sample(std::shared_ptr<core::file_types::sample> &sample);
             core::status configure_disk_write();
+            device_configuration get_device_configuration();
             std::vector<rs_capabilities> get_capabilities();
             std::map<rs_stream, core::file_types::stream_profile> get_profiles();
             std::vector<core::file_types::device_cap> read_all_options();
             std::map<rs_camera_info, std::pair<uint32_t, const char *> > get_all_camera_info();
             uint64_t get_capture_time();
+            uint64_t get_preallocation_size(const std::map<rs_stream, core::file_types::stream_profile> & profiles);
             void update_active_streams(rs_stream stream, bool state);
 
             bool                                                                    m_is_streaming;
             std::mutex                                                              m_is_streaming_mutex;
             rs_device *                                                             m_device;
-            disk_write                                                              m_disk_write;
+            std::shared_ptr<recording_session>                                      m_session;
+            uint32_t                                                                m_device_index;
             std::vector<rs_stream>                                                  m_active_streams;
             std::string                                                             m_file_path;
             std::vector<core::file_types::device_cap>                               m_modifyied_options;
-            std::chrono::high_resolution_clock::time_point                          m_capture_time_base;
             std::vector<rs_capabilities>                                            m_capabilities;
             rs_source                                                               m_source;
             bool                                                                    m_is_motion_tracking_enabled;
             playback::capture_mode                                                  m_capture_mode;
             std::map<rs_stream, compression_level>                                  m_compression_config;
+            uint64_t                                                                m_preallocation_size;
+            uint32_t                                                                m_preallocation_duration;
+            bool                                                                    m_direct_io;
+            std::map<rs_stream, sample_rate_limiter>                                m_frame_rate_limiters;
+            std::map<rs_event_source, sample_rate_limiter>                          m_motion_rate_limiters;
+            std::map<rs_stream, core::rect>                                         m_regions_of_interest;
         };
     }
 }
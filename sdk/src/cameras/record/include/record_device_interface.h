@@ -16,8 +16,16 @@ namespace rs
             virtual ~device_interface() {}
             virtual void pause_record() = 0;
             virtual void resume_record() = 0;
+            virtual core::status query_record_status() = 0;
             virtual bool set_compression(rs_stream stream, record::compression_level compression_level) = 0;
             virtual record::compression_level get_compression(rs_stream stream) = 0;
+            virtual bool set_preallocation_size(uint64_t expected_file_size) = 0;
+            virtual bool set_preallocation_duration(uint32_t expected_duration_seconds) = 0;
+            virtual bool set_direct_io(bool enable) = 0;
+            virtual core::status set_frame_decimation(rs_stream stream, uint32_t decimation) = 0;
+            virtual core::status set_recorded_frame_rate(rs_stream stream, double framerate) = 0;
+            virtual core::status set_motion_decimation(rs_event_source source, uint32_t decimation) = 0;
+            virtual core::status set_region_of_interest(rs_stream stream, const core::rect & roi) = 0;
         };
     }
 }
@@ -0,0 +1,43 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Selects the samples of a single stream which are recorded.
+        *
+        * The decimation keeps every Nth sample of the stream. The rate limit keeps the samples spaced by the period of the
+        * requested rate, according to their time stamps. Both are checked before the sample is copied, so the skipped samples
+        * cost no memory or disk bandwidth. The limiter isn't thread safe, each stream is expected to be checked from a single thread.
+        */
+        class sample_rate_limiter
+        {
+        public:
+            sample_rate_limiter();
+
+            //keeps every decimation-th sample, 1 keeps all the samples
+            void set_decimation(uint32_t decimation);
+            uint32_t get_decimation() const { return m_decimation; }
+            //keeps at most rate samples per second, evenly spaced, 0 removes the limit
+            void set_rate(double rate);
+            double get_rate() const { return m_period_ms > 0 ? 1000.0 / m_period_ms : 0; }
+            bool is_limited() const { return m_decimation > 1 || m_period_ms > 0; }
+
+            //returns true when the sample should be recorded, time stamp in milliseconds
+            bool sample(double time_stamp);
+            void reset();
+
+        private:
+            uint32_t    m_decimation;
+            double      m_period_ms;
+            uint64_t    m_samples_count;
+            double      m_next_time_stamp;
+            bool        m_has_next_time_stamp;
+        };
+    }
+}
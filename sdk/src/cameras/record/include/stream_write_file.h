@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include "include/file.h"
+
+namespace rs
+{
+    namespace record
+    {
+        /**
+        * @brief Recording written to a live stream endpoint, see core::stream_endpoint, instead of a file.
+        *
+        * The stream carries the same chunks as a recorded file. The written data is held until it is committed, and can be
+        * rewritten until then, so the file header is sent once its first frame offset is set. The later rewrites of the header,
+        * the frame counts of the streams, are not sent, the live reader counts the frames it receives.
+        * Small writes are gathered, and a large write, such as the data of a frame, is sent together with the gathered data
+        * in a single gather write straight from the frame buffer, without a copy.
+        * A write blocks while the reader doesn't keep up, so the samples queue of the recorder drops frames as it does on a slow disk.
+        * A socket whose reader went away fails the write, a pipe raises SIGPIPE unless the application ignores it.
+        */
+        class stream_write_file : public core::file
+        {
+        public:
+            stream_write_file();
+            virtual ~stream_write_file();
+
+            virtual core::status set_preallocation(uint64_t expected_size) override;
+            virtual core::status open(const std::string& endpoint, core::open_file_option mode) override;
+            virtual core::status close() override;
+            virtual core::status write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written) override;
+            virtual core::status set_position(int64_t distance_to_move, core::move_method method, uint64_t* new_file_pointer = NULL) override;
+            virtual core::status get_position(uint64_t* new_file_pointer) override;
+            virtual void reset() override;
+            virtual core::status commit() override;
+
+        private:
+            //writes of this size and above are sent from the caller buffer
+            static const uint32_t direct_send_size = 64 * 1024;
+
+            //sends the pending data followed by size bytes of data
+            bool send(const uint8_t * data, size_t size);
+
+            int                     m_fd;
+            bool                    m_is_socket;
+            bool                    m_send_failed;
+            uint64_t                m_position;
+            uint64_t                m_size;
+            uint64_t                m_sent_size;
+            std::vector<uint8_t>    m_pending;
+        };
+    }
+}
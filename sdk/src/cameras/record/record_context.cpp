@@ -8,15 +8,32 @@ namespace rs
 {
     namespace record
     {
-        context::context(const char *file_path)
+        context::context(const char *file_path) : m_device_count(m_context.get_device_count())
         {
-            m_devices = new rs_device*[get_device_count()];
-            for(auto i = 0; i < get_device_count(); i++)
+            m_devices = new rs_device*[m_device_count];
+            //all the devices are recorded into the same file by a single writer
+            auto session = std::make_shared<recording_session>();
+            for(auto i = 0; i < m_device_count; i++)
             {
-                m_devices[i] = new rs_device_ex(file_path, (rs_device*)(m_context.get_device(i)));//revert casting to cpp wrapper done by librealsense
+                m_devices[i] = new rs_device_ex(file_path, (rs_device*)(m_context.get_device(i)), session);//revert casting to cpp wrapper done by librealsense
             }
         }
 
+        context::context(const char * file_path, rs::core::context_interface & source_context) : m_device_count(source_context.get_device_count())
+        {
+            m_devices = new rs_device*[m_device_count];
+            auto session = std::make_shared<recording_session>();
+            for(auto i = 0; i < m_device_count; i++)
+            {
+                m_devices[i] = new rs_device_ex(file_path, (rs_device*)(source_context.get_device(i)), session);
+            }
+        }
+
+        int context::get_device_count() const
+        {
+            return m_device_count;
+        }
+
         context::~context()
         {
             for(auto i = 0; i < get_device_count(); i++)
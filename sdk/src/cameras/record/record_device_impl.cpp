@@ -4,11 +4,41 @@
 #include <algorithm>
 #include "record_device_impl.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
+#include "rs/utils/librealsense_conversion_utils.h"
 
 using namespace rs::core;
 
 namespace
 {
+    //fits the region into the frame, with the pixel pairs of the packed yuv formats kept whole. returns false when the region
+    //can't be cropped from the frames, or it covers the whole frame
+    static bool fit_region(rs::core::rect & region, int width, int height, rs_format format)
+    {
+        if(rs::core::get_pixel_size(rs::utils::convert_pixel_format(static_cast<rs::format>(format))) == 0)
+            return false;
+        region.width = std::min(region.width, width - region.x);
+        region.height = std::min(region.height, height - region.y);
+        if(format == rs_format::RS_FORMAT_YUYV)
+        {
+            region.x &= ~1;
+            region.width &= ~1;
+        }
+        if(region.width <= 0 || region.height <= 0)
+            return false;
+        return region.width < width || region.height < height;
+    }
+
+    static void crop_intrinsics(rs_intrinsics & intrinsics, const rs::core::rect & region)
+    {
+        if(intrinsics.width == 0 || intrinsics.height == 0)
+            return;
+        intrinsics.ppx -= static_cast<float>(region.x);
+        intrinsics.ppy -= static_cast<float>(region.y);
+        intrinsics.width = region.width;
+        intrinsics.height = region.height;
+    }
+
     static rs_capabilities get_capability(rs_stream stream)
     {
         switch(stream)
@@ -36,8 +66,9 @@ namespace rs
                 m_stream(stream), m_user_callback(user_callback), m_device(device), m_user_callback_ptr(nullptr) {}
             void on_frame (rs_device * device, rs_frame_ref * frame) override
             {
-                auto clone = device->clone_frame(frame);
-                m_device->write_frame(m_stream, clone);
+                TRACE_SCOPE("record", "device_frame_callback");
+                if(m_device->is_frame_recorded(m_stream, frame->get_frame_number(), frame->get_frame_timestamp()))
+                    m_device->write_frame(m_stream, frame);
                 m_user_callback_ptr == nullptr ? m_user_callback->on_frame(m_device, frame) : m_user_callback_ptr(device, frame, m_user);
             }
             void release() override
@@ -63,9 +94,12 @@ namespace rs
                 m_user_callback(user_callback), m_device(device), m_user_callback_ptr(nullptr) {}
             void on_event (rs_motion_data data) override
             {
-                std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(
-                new file_types::motion_sample(data, m_device->get_capture_time()),[](file_types::sample* s) {});
-                m_device->m_disk_write.record_sample(sample);
+                if(m_device->is_motion_recorded(data.timestamp_data.source_id, data.timestamp_data.timestamp))
+                {
+                    std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(
+                    new file_types::motion_sample(data, m_device->get_capture_time()),[](file_types::sample* s) {});
+                    m_device->record_sample(sample);
+                }
                 m_user_callback_ptr == nullptr ? m_user_callback->on_event(data) : m_user_callback_ptr(m_device, data, m_user);
             }
             void release() override
@@ -90,9 +124,12 @@ namespace rs
                 m_user_callback(user_callback), m_device(device), m_user_callback_ptr(nullptr) {}
             void on_event (rs_timestamp_data data) override
             {
-                std::shared_ptr<file_types::sample> sample  = std::shared_ptr<file_types::sample>(
-                new file_types::time_stamp_sample(data, m_device->get_capture_time()),[](file_types::sample* s) {});
-                m_device->m_disk_write.record_sample(sample);
+                if(m_device->is_motion_recorded(data.source_id, data.timestamp))
+                {
+                    std::shared_ptr<file_types::sample> sample  = std::shared_ptr<file_types::sample>(
+                    new file_types::time_stamp_sample(data, m_device->get_capture_time()),[](file_types::sample* s) {});
+                    m_device->record_sample(sample);
+                }
                 m_user_callback_ptr == nullptr ? m_user_callback->on_event(data) : m_user_callback_ptr(m_device, data, m_user);
             }
             void release() override
@@ -108,12 +145,23 @@ namespace rs
             rs_device_ex * m_device;
         };
 
-        rs_device_ex::rs_device_ex(const std::string &file_path, rs_device *device) :
+        rs_device_ex::rs_device_ex(const std::string &file_path, rs_device *device, std::shared_ptr<recording_session> session) :
             m_device(device),
+            m_session(session ? session : std::make_shared<recording_session>()),
             m_file_path(file_path),
             m_is_streaming(false),
-            m_capture_mode(playback::capture_mode::synced)
+            m_source(rs_source::RS_SOURCE_ALL),
+            m_is_motion_tracking_enabled(false),
+            m_capture_mode(playback::capture_mode::synced),
+            m_preallocation_size(0),
+            m_preallocation_duration(0),
+            m_direct_io(false)
         {
+            {
+                std::lock_guard<std::mutex> guard(m_session->m_mutex);
+                m_device_index = static_cast<uint32_t>(m_session->m_devices.size());
+                m_session->m_devices.push_back(this);
+            }
             rs_option opt = rs_option::RS_OPTION_FRAMES_QUEUE_SIZE;
             double value = 60.0;
             try
@@ -127,7 +175,16 @@ namespace rs
 
         rs_device_ex::~rs_device_ex()
         {
-            m_disk_write.stop();
+            bool last_device = false;
+            {
+                std::lock_guard<std::mutex> guard(m_session->m_mutex);
+                auto & devices = m_session->m_devices;
+                devices.erase(std::remove(devices.begin(), devices.end(), this), devices.end());
+                last_device = devices.empty();
+            }
+            //the writer of a shared session keeps recording the other devices
+            if(last_device)
+                m_session->m_disk_write.stop();
             stop(m_source);
         }
 
@@ -263,18 +320,35 @@ namespace rs
             LOG_FUNC_SCOPE();
             LOG_INFO("start");
             m_source = source;
-            if(m_disk_write.is_configured())
+            for(auto & limiter : m_frame_rate_limiters)
+                limiter.second.reset();
+            for(auto & limiter : m_motion_rate_limiters)
+                limiter.second.reset();
+            bool was_streaming = false;
             {
-                resume_record();
+                std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
+                was_streaming = m_is_streaming;
             }
-            else
             {
-                status sts = configure_disk_write();
-                if (sts == status::status_no_error)
+                std::lock_guard<std::mutex> guard(m_session->m_mutex);
+                if(m_session->m_disk_write.is_configured())
+                {
+                    //a shared recording is paused only while none of its devices is streaming
+                    if(m_session->m_streaming_devices_count == 0)
+                        resume_record();
+                }
+                else
                 {
-                    m_capture_time_base = std::chrono::high_resolution_clock::now();
-                    m_disk_write.start();
+                    //the first started device configures the file with the streams of all the session devices
+                    status sts = configure_disk_write();
+                    if (sts == status::status_no_error)
+                    {
+                        m_session->m_capture_time_base = std::chrono::high_resolution_clock::now();
+                        m_session->m_disk_write.start();
+                    }
                 }
+                if(!was_streaming)
+                    m_session->m_streaming_devices_count++;
             }
             m_device->start(source);
             std::lock_guard<std::mutex> guard(m_is_streaming_mutex);
@@ -288,7 +362,11 @@ namespace rs
             if(!m_is_streaming) return;
             LOG_INFO("stop");
             m_device->stop(source);
-            pause_record();
+            {
+                std::lock_guard<std::mutex> session_guard(m_session->m_mutex);
+                if(m_session->m_streaming_devices_count > 0 && --m_session->m_streaming_devices_count == 0)
+                    pause_record();
+            }
             m_is_streaming = false;
         }
 
@@ -429,13 +507,18 @@ namespace rs
         void rs_device_ex::pause_record()
         {
             LOG_INFO("pause record")
-            m_disk_write.set_pause(true, get_capture_time());
+            m_session->m_disk_write.set_pause(true, get_capture_time());
         }
 
         void rs_device_ex::resume_record()
         {
             LOG_INFO("resume record")
-            m_disk_write.set_pause(false, get_capture_time());
+            m_session->m_disk_write.set_pause(false, get_capture_time());
+        }
+
+        core::status rs_device_ex::query_record_status()
+        {
+            return m_session->m_disk_write.is_write_failed() ? status::status_file_write_failed : status::status_no_error;
         }
 
         bool rs_device_ex::set_compression(rs_stream stream, record::compression_level compression_level)
@@ -457,11 +540,100 @@ namespace rs
             return m_compression_config[stream];
         }
 
+        bool rs_device_ex::set_preallocation_size(uint64_t expected_file_size)
+        {
+            if(m_session->m_disk_write.is_configured()) return false;
+            m_preallocation_size = expected_file_size;
+            m_preallocation_duration = 0;
+            return true;
+        }
+
+        bool rs_device_ex::set_preallocation_duration(uint32_t expected_duration_seconds)
+        {
+            if(m_session->m_disk_write.is_configured()) return false;
+            m_preallocation_duration = expected_duration_seconds;
+            m_preallocation_size = 0;
+            return true;
+        }
+
+        bool rs_device_ex::set_direct_io(bool enable)
+        {
+            if(m_session->m_disk_write.is_configured()) return false;
+            m_direct_io = enable;
+            return true;
+        }
+
+        status rs_device_ex::set_frame_decimation(rs_stream stream, uint32_t decimation)
+        {
+            if(decimation == 0) return status::status_invalid_argument;
+            if(m_session->m_disk_write.is_configured()) return status::status_invalid_state;
+            m_frame_rate_limiters[stream].set_decimation(decimation);
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_recorded_frame_rate(rs_stream stream, double framerate)
+        {
+            if(framerate < 0) return status::status_invalid_argument;
+            if(m_session->m_disk_write.is_configured()) return status::status_invalid_state;
+            m_frame_rate_limiters[stream].set_rate(framerate);
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_motion_decimation(rs_event_source source, uint32_t decimation)
+        {
+            if(decimation == 0 || source >= rs_event_source::RS_EVENT_SOURCE_COUNT) return status::status_invalid_argument;
+            if(m_session->m_disk_write.is_configured()) return status::status_invalid_state;
+            m_motion_rate_limiters[source].set_decimation(decimation);
+            return status::status_no_error;
+        }
+
+        status rs_device_ex::set_region_of_interest(rs_stream stream, const rect & roi)
+        {
+            if(roi.x < 0 || roi.y < 0 || roi.width < 0 || roi.height < 0) return status::status_invalid_argument;
+            if(m_session->m_disk_write.is_configured()) return status::status_invalid_state;
+            if(roi.width == 0 || roi.height == 0)
+                m_regions_of_interest.erase(stream);
+            else
+                m_regions_of_interest[stream] = roi;
+            return status::status_no_error;
+        }
+
+        bool rs_device_ex::is_frame_recorded(rs_stream stream, unsigned long long frame_number, double time_stamp)
+        {
+            //the limiters are added before start, so the lookup is safe from the frame callbacks of the different streams
+            auto it = m_frame_rate_limiters.find(stream);
+            if(it == m_frame_rate_limiters.end() || it->second.sample(time_stamp))
+                return true;
+            m_session->m_disk_write.skip_frame(file_types::to_file_stream(stream, m_device_index), frame_number);
+            return false;
+        }
+
+        bool rs_device_ex::is_motion_recorded(rs_event_source source, double time_stamp)
+        {
+            auto it = m_motion_rate_limiters.find(source);
+            return it == m_motion_rate_limiters.end() || it->second.sample(time_stamp);
+        }
+
+        uint64_t rs_device_ex::get_preallocation_size(const std::map<rs_stream, file_types::stream_profile> & profiles)
+        {
+            if(m_preallocation_duration == 0)
+                return m_preallocation_size;
+            //the uncompressed size is an upper bound, the unused space is released when the file is closed
+            uint64_t size_per_second = 0;
+            for(auto & profile : profiles)
+            {
+                auto & info = profile.second.info;
+                auto pixel_size = get_pixel_size(rs::utils::convert_pixel_format(static_cast<rs::format>(info.format)));
+                size_per_second += static_cast<uint64_t>(info.width) * info.height * pixel_size * profile.second.frame_rate;
+            }
+            return size_per_second * m_preallocation_duration;
+        }
+
         uint64_t rs_device_ex::get_capture_time()
         {
             LOG_FUNC_SCOPE();
             auto now = std::chrono::high_resolution_clock::now();
-            return std::chrono::duration_cast<std::chrono::microseconds>(now - m_capture_time_base).count();
+            return std::chrono::duration_cast<std::chrono::microseconds>(now - m_session->m_capture_time_base).count();
         }
 
         std::vector<rs::core::file_types::device_cap> rs_device_ex::read_all_options()
@@ -509,15 +681,26 @@ namespace rs
             return info_map;
         }
 
-        void rs_device_ex::write_frame(rs_stream stream, rs_frame_ref * ref)
+        void rs_device_ex::write_frame(rs_stream stream, rs_frame_ref * frame_ref)
         {
-            auto frame = new file_types::frame_sample(stream, ref, get_capture_time());
+            auto region = m_regions_of_interest.find(stream);
+            if(region != m_regions_of_interest.end())
+            {
+                //only the region is copied, the camera frame isn't held until it is written
+                file_types::frame_sample frame(file_types::to_file_stream(stream, m_device_index), frame_ref, get_capture_time());
+                write_frame_region(frame, region->second);
+                return;
+            }
+            auto ref = m_device->clone_frame(frame_ref);
+            auto frame = new file_types::frame_sample(file_types::to_file_stream(stream, m_device_index), ref, get_capture_time());
+            //the frame may be written after this device was destroyed, while the writer records the other devices of the session
+            auto device = m_device;
             std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(frame,
-                    [this, ref](file_types::sample* f)
+                    [device, ref](file_types::sample* f)
             {
-                m_device->release_frame(ref);
+                device->release_frame(ref);
             });
-            m_disk_write.record_sample(sample);
+            record_sample(sample);
         }
 
         void rs_device_ex::write_samples()
@@ -528,26 +711,78 @@ namespace rs
 #ifndef lrs_empty_first_frames_workaround
                 if(m_device->get_stream_interface(*it).get_frame_number() == 0) continue;
 #endif
-                file_types::frame_sample frame(*it, m_device->get_stream_interface(*it), capture_time);
+                auto & stream_interface = m_device->get_stream_interface(*it);
+                if(!is_frame_recorded(*it, stream_interface.get_frame_number(), stream_interface.get_frame_timestamp())) continue;
+                file_types::frame_sample frame(file_types::to_file_stream(*it, m_device_index), stream_interface, capture_time);
+                auto region = m_regions_of_interest.find(*it);
+                if(region != m_regions_of_interest.end())
+                {
+                    write_frame_region(frame, region->second);
+                    continue;
+                }
                 std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(frame.copy(),
                 [](file_types::sample* f) { delete[] (static_cast<file_types::frame_sample*>(f))->data; delete f;});
-                m_disk_write.record_sample(sample);
+                record_sample(sample);
             }
         }
 
+        void rs_device_ex::write_frame_region(file_types::frame_sample & frame, const rect & region)
+        {
+            TRACE_SCOPE("record", "copy_frame_region");
+            auto pixel_size = get_pixel_size(rs::utils::convert_pixel_format(static_cast<rs::format>(frame.finfo.format)));
+            std::shared_ptr<file_types::sample> sample = std::shared_ptr<file_types::sample>(frame.copy(region, pixel_size),
+            [](file_types::sample* f) { delete[] (static_cast<file_types::frame_sample*>(f))->data; delete f;});
+            record_sample(sample);
+        }
+
+        void rs_device_ex::record_sample(std::shared_ptr<file_types::sample> &sample)
+        {
+            sample->info.device_index = m_device_index;
+            m_session->m_disk_write.record_sample(sample);
+        }
+
         core::status rs_device_ex::configure_disk_write()
         {
             configuration config = {};
-            config.m_capabilities = get_capabilities();
             config.m_coordinate_system = file_types::coordinate_system::rear_default;
             config.m_file_path = m_file_path;
+            config.m_capture_mode = m_capture_mode;
+            config.m_direct_io = m_direct_io;
+            std::map<rs_stream, file_types::stream_profile> all_profiles;
+            for(auto device : m_session->m_devices)
+            {
+                auto device_config = device->get_device_configuration();
+                if(device->m_device_index == 0)
+                {
+                    config.m_capabilities = device_config.m_capabilities;
+                    config.m_options = device_config.m_options;
+                    config.m_stream_profiles = device_config.m_stream_profiles;
+                    config.m_motion_intrinsics = device_config.m_motion_intrinsics;
+                    config.m_camera_info = device_config.m_camera_info;
+                }
+                else
+                {
+                    config.m_additional_devices.push_back(device_config);
+                }
+                all_profiles.insert(device_config.m_stream_profiles.begin(), device_config.m_stream_profiles.end());
+                for(auto & compression : device->m_compression_config)
+                    config.m_compression_config[file_types::to_file_stream(compression.first, device->m_device_index)] = compression.second;
+                if(device->m_capture_mode == playback::capture_mode::asynced)
+                    config.m_capture_mode = playback::capture_mode::asynced;
+            }
+            config.m_preallocation_size = get_preallocation_size(all_profiles);
+            return m_session->m_disk_write.configure(config);
+        }
+
+        device_configuration rs_device_ex::get_device_configuration()
+        {
+            device_configuration config = {};
+            config.m_capabilities = get_capabilities();
             config.m_options = read_all_options();
             config.m_stream_profiles = get_profiles();
             config.m_motion_intrinsics = get_motion_intrinsics();
-            config.m_capture_mode = m_capture_mode;
             config.m_camera_info = get_all_camera_info();
-            config.m_compression_config = m_compression_config;
-            return m_disk_write.configure(config);
+            return config;
         }
 
         std::vector<rs_capabilities> rs_device_ex::get_capabilities()
@@ -572,8 +807,9 @@ namespace rs
             {
                 auto& si = m_device->get_stream_interface(*it);
                 auto intr = si.get_intrinsics();
+                auto file_stream = file_types::to_file_stream(*it, m_device_index);
                 file_types::frame_info fi = {intr.width, intr.height, si.get_format()};
-                fi.stream = *it;
+                fi.stream = file_stream;
                 fi.framerate = si.get_framerate();
                 rs_intrinsics intrinsics = intr;
                 rs_intrinsics rect_intrinsics = {0};
@@ -587,16 +823,37 @@ namespace rs
                 try {extrinsics = si.get_extrinsics_to(m_device->get_stream_interface(rs_stream::RS_STREAM_DEPTH));}
                 catch(...) {LOG_WARN("failed to read extrinsics of stream - " << *it);}
 
+                rect roi = {};
+                auto region = m_regions_of_interest.find(*it);
+                if(region != m_regions_of_interest.end())
+                {
+                    if(fit_region(region->second, fi.width, fi.height, fi.format))
+                    {
+                        //the recorded intrinsics describe the region, as if it was captured by a camera of the region size
+                        roi = region->second;
+                        fi.width = roi.width;
+                        fi.height = roi.height;
+                        crop_intrinsics(intrinsics, roi);
+                        crop_intrinsics(rect_intrinsics, roi);
+                    }
+                    else
+                    {
+                        LOG_WARN("region of interest of stream - " << *it << " is not recorded, recording the whole frames");
+                        m_regions_of_interest.erase(region);
+                    }
+                }
+
                 auto depth_scale = *it == rs_stream::RS_STREAM_DEPTH ? m_device->get_depth_scale() : 0;
-                profiles[*it] = {fi, si.get_framerate(), intrinsics, rect_intrinsics, extrinsics, depth_scale};
+                profiles[file_stream] = {fi, si.get_framerate(), intrinsics, rect_intrinsics, extrinsics, depth_scale};
+                profiles[file_stream].roi = roi;
 
                 //save empty calibration data in case motion calibration data is not valid
-                try { profiles[*it].motion_extrinsics = m_device->get_motion_extrinsics_from(*it); }
+                try { profiles[file_stream].motion_extrinsics = m_device->get_motion_extrinsics_from(*it); }
                 catch(...)
                 {
                     LOG_WARN("failed to read motion extrinsics of stream - " << *it)
                     rs_extrinsics ext = {0};
-                    profiles[*it].motion_extrinsics = ext;
+                    profiles[file_stream].motion_extrinsics = ext;
                 }
             }
             return profiles;
@@ -628,6 +885,11 @@ namespace rs
             ((rs_device_ex*)this)->resume_record();
         }
 
+        status device::query_record_status()
+        {
+            return ((rs_device_ex*)this)->query_record_status();
+        }
+
         status device::set_compression(rs::stream stream, rs::record::compression_level compression_level)
         {
             return ((rs_device_ex*)this)->set_compression((rs_stream)stream, compression_level) ? status::status_no_error : status::status_invalid_argument;
@@ -637,5 +899,40 @@ namespace rs
         {
             return ((rs_device_ex*)this)->get_compression((rs_stream)stream);
         }
+
+        status device::set_preallocation_size(uint64_t expected_file_size)
+        {
+            return ((rs_device_ex*)this)->set_preallocation_size(expected_file_size) ? status::status_no_error : status::status_invalid_state;
+        }
+
+        status device::set_preallocation_duration(uint32_t expected_duration_seconds)
+        {
+            return ((rs_device_ex*)this)->set_preallocation_duration(expected_duration_seconds) ? status::status_no_error : status::status_invalid_state;
+        }
+
+        status device::set_direct_io(bool enable)
+        {
+            return ((rs_device_ex*)this)->set_direct_io(enable) ? status::status_no_error : status::status_invalid_state;
+        }
+
+        status device::set_frame_decimation(rs::stream stream, uint32_t decimation)
+        {
+            return ((rs_device_ex*)this)->set_frame_decimation((rs_stream)stream, decimation);
+        }
+
+        status device::set_recorded_frame_rate(rs::stream stream, double framerate)
+        {
+            return ((rs_device_ex*)this)->set_recorded_frame_rate((rs_stream)stream, framerate);
+        }
+
+        status device::set_region_of_interest(rs::stream stream, const rect & roi)
+        {
+            return ((rs_device_ex*)this)->set_region_of_interest((rs_stream)stream, roi);
+        }
+
+        status device::set_motion_decimation(rs::event motion_event, uint32_t decimation)
+        {
+            return ((rs_device_ex*)this)->set_motion_decimation((rs_event_source)motion_event, decimation);
+        }
     }
 }
@@ -0,0 +1,60 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "sample_rate_limiter.h"
+
+namespace rs
+{
+    namespace record
+    {
+        sample_rate_limiter::sample_rate_limiter() :
+            m_decimation(1),
+            m_period_ms(0),
+            m_samples_count(0),
+            m_next_time_stamp(0),
+            m_has_next_time_stamp(false)
+        {
+
+        }
+
+        void sample_rate_limiter::set_decimation(uint32_t decimation)
+        {
+            m_decimation = decimation > 0 ? decimation : 1;
+            reset();
+        }
+
+        void sample_rate_limiter::set_rate(double rate)
+        {
+            m_period_ms = rate > 0 ? 1000.0 / rate : 0;
+            reset();
+        }
+
+        bool sample_rate_limiter::sample(double time_stamp)
+        {
+            if(m_decimation > 1 && (m_samples_count++ % m_decimation) != 0)
+                return false;
+
+            if(m_period_ms <= 0)
+                return true;
+
+            //a quarter of the period tolerates the jitter of the time stamps of a source which is an exact multiple of the rate
+            const double tolerance = m_period_ms / 4;
+            if(m_has_next_time_stamp && time_stamp < m_next_time_stamp - tolerance && time_stamp >= m_next_time_stamp - m_period_ms)
+                return false;
+
+            //the next sample is due a period after the due time of this one, which keeps the spacing even. after a gap, or when
+            //the time stamps restart, the schedule restarts from this sample
+            bool on_schedule = m_has_next_time_stamp && time_stamp >= m_next_time_stamp - m_period_ms && time_stamp < m_next_time_stamp + m_period_ms;
+            m_next_time_stamp = (on_schedule ? m_next_time_stamp : time_stamp) + m_period_ms;
+            m_has_next_time_stamp = true;
+            return true;
+        }
+
+        void sample_rate_limiter::reset()
+        {
+            m_samples_count = 0;
+            m_next_time_stamp = 0;
+            m_has_next_time_stamp = false;
+        }
+    }
+}
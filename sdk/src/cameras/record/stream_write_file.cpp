@@ -0,0 +1,204 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include <algorithm>
+#include "stream_write_file.h"
+#include "include/stream_endpoint.h"
+#include "rs/utils/log_utils.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#endif
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace record
+    {
+        stream_write_file::stream_write_file() :
+            m_fd(-1),
+            m_is_socket(true),
+            m_send_failed(false),
+            m_position(0),
+            m_size(0),
+            m_sent_size(0)
+        {
+
+        }
+
+        stream_write_file::~stream_write_file()
+        {
+            close();
+        }
+
+        status stream_write_file::set_preallocation(uint64_t expected_size)
+        {
+            return expected_size ? status_feature_unsupported : status_no_error;
+        }
+
+        status stream_write_file::open(const std::string& endpoint, open_file_option mode)
+        {
+            if(mode != open_file_option::write || m_fd >= 0)
+                return status_file_open_failed;
+            m_fd = stream_endpoint::connect(endpoint);
+            if(m_fd < 0)
+            {
+                LOG_ERROR("failed to connect to the live stream endpoint " << endpoint.c_str());
+                return status_file_open_failed;
+            }
+            m_is_socket = true;
+            m_send_failed = false;
+            m_position = m_size = m_sent_size = 0;
+            m_pending.clear();
+            return status_no_error;
+        }
+
+        status stream_write_file::close()
+        {
+            if(m_fd < 0)
+                return status_no_error;
+            auto sts = commit();
+#ifdef __linux__
+            ::close(m_fd);
+#endif
+            m_fd = -1;
+            return sts == status_no_error ? status_no_error : status_file_close_failed;
+        }
+
+        status stream_write_file::write_bytes(const void* data, unsigned int number_of_bytes_to_write, unsigned int& number_of_bytes_written)
+        {
+            number_of_bytes_written = 0;
+            if(m_fd < 0 || m_send_failed)
+                return status_file_write_failed;
+
+            const uint8_t * bytes = static_cast<const uint8_t *>(data);
+            uint64_t size = number_of_bytes_to_write;
+            if(m_position < m_size)
+            {
+                //a rewrite of data which was already sent is dropped, only the pending data can be rewritten
+                const uint64_t rewrite_end = std::min(m_position + size, m_size);
+                if(rewrite_end > m_sent_size)
+                {
+                    const uint64_t begin = std::max(m_position, m_sent_size);
+                    memcpy(m_pending.data() + (begin - m_sent_size), bytes + (begin - m_position), static_cast<size_t>(rewrite_end - begin));
+                }
+                bytes += rewrite_end - m_position;
+                size -= rewrite_end - m_position;
+                m_position = rewrite_end;
+            }
+
+            if(size >= direct_send_size)
+            {
+                if(!send(bytes, static_cast<size_t>(size)))
+                    return status_file_write_failed;
+                m_sent_size += size;
+            }
+            else if(size > 0)
+            {
+                m_pending.insert(m_pending.end(), bytes, bytes + size);
+            }
+            m_size += size;
+            m_position += size;
+            number_of_bytes_written = number_of_bytes_to_write;
+            return status_no_error;
+        }
+
+        status stream_write_file::set_position(int64_t distance_to_move, move_method method, uint64_t* new_file_pointer)
+        {
+            int64_t position = distance_to_move;
+            switch(method)
+            {
+                case move_method::begin: break;
+                case move_method::current: position += static_cast<int64_t>(m_position); break;
+                case move_method::end: position += static_cast<int64_t>(m_size); break;
+            }
+            //the stream has no holes, the position can't move past the written data
+            if(position < 0 || static_cast<uint64_t>(position) > m_size)
+                return status_file_read_failed;
+            m_position = static_cast<uint64_t>(position);
+            if(new_file_pointer != NULL) *new_file_pointer = m_position;
+            return status_no_error;
+        }
+
+        status stream_write_file::get_position(uint64_t* new_file_pointer)
+        {
+            if(new_file_pointer == NULL)
+                return status_file_read_failed;
+            *new_file_pointer = m_position;
+            return status_no_error;
+        }
+
+        void stream_write_file::reset()
+        {
+            m_position = 0;
+        }
+
+        status stream_write_file::commit()
+        {
+            if(m_fd < 0 || m_send_failed)
+                return status_file_write_failed;
+            if(m_pending.empty())
+                return status_no_error;
+            if(!send(nullptr, 0))
+                return status_file_write_failed;
+            return status_no_error;
+        }
+
+        bool stream_write_file::send(const uint8_t * data, size_t size)
+        {
+#ifdef __linux__
+            iovec buffers[2] = { { m_pending.data(), m_pending.size() }, { const_cast<uint8_t *>(data), size } };
+            int first = m_pending.empty() ? 1 : 0;
+            const int last = size > 0 ? 2 : 1;
+            while(first < last)
+            {
+                ssize_t sent = -1;
+                if(m_is_socket)
+                {
+                    //a reader which went away fails the send, rather than raising SIGPIPE in the recording process
+                    msghdr message = {};
+                    message.msg_iov = buffers + first;
+                    message.msg_iovlen = static_cast<size_t>(last - first);
+                    sent = ::sendmsg(m_fd, &message, MSG_NOSIGNAL);
+                    if(sent < 0 && errno == ENOTSOCK)
+                    {
+                        m_is_socket = false;
+                        continue;
+                    }
+                }
+                else
+                {
+                    sent = ::writev(m_fd, buffers + first, last - first);
+                }
+                if(sent < 0 && errno == EINTR)
+                    continue;
+                if(sent <= 0)
+                {
+                    LOG_ERROR("live stream send failed, errno - " << errno);
+                    m_send_failed = true;
+                    return false;
+                }
+                size_t remaining = static_cast<size_t>(sent);
+                while(first < last && remaining >= buffers[first].iov_len)
+                    remaining -= buffers[first++].iov_len;
+                if(first < last)
+                {
+                    buffers[first].iov_base = static_cast<uint8_t *>(buffers[first].iov_base) + remaining;
+                    buffers[first].iov_len -= remaining;
+                }
+            }
+            m_sent_size += m_pending.size();
+            m_pending.clear();
+            return true;
+#else
+            m_send_failed = true;
+            return false;
+#endif
+        }
+    }
+}
@@ -0,0 +1,91 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include <stdexcept>
+#include <librealsense/rscore.hpp>
+#include "rs/synthetic/synthetic_context.h"
+
+namespace rs
+{
+    namespace synthetic
+    {
+        struct frame
+        {
+            rs_stream                   stream;
+            int                         width;
+            int                         height;
+            int                         stride;
+            int                         bpp;
+            rs_format                   format;
+            int                         framerate;
+            unsigned long long          number;
+            double                      time_stamp;
+            long long                   system_time;
+            std::shared_ptr<uint8_t>    data;
+        };
+
+        class rs_frame_ref_impl : public rs_frame_ref
+        {
+        public:
+            rs_frame_ref_impl(std::shared_ptr<const frame> frame) : m_frame(frame) {}
+            std::shared_ptr<const frame> get_frame() const { return m_frame; }
+            virtual const uint8_t *get_frame_data() const override { return m_frame->data.get(); }
+            virtual double get_frame_timestamp() const override { return m_frame->time_stamp; }
+            virtual unsigned long long get_frame_number() const override { return m_frame->number; }
+            virtual long long get_frame_system_time() const override { return m_frame->system_time; }
+            virtual int get_frame_width() const override { return m_frame->width; }
+            virtual int get_frame_height() const override { return m_frame->height; }
+            virtual int get_frame_framerate() const override { return m_frame->framerate; }
+            virtual int get_frame_stride() const override { return m_frame->stride; }
+            virtual int get_frame_bpp() const override { return m_frame->bpp; }
+            virtual rs_format get_frame_format() const override { return m_frame->format; }
+            virtual rs_stream get_stream_type() const override { return m_frame->stream; }
+            virtual rs_timestamp_domain get_frame_timestamp_domain() const { return rs_timestamp_domain::RS_TIMESTAMP_DOMAIN_CAMERA; }
+            virtual double get_frame_metadata(rs_frame_metadata frame_metadata) const override { throw std::runtime_error("synthetic frames have no metadata"); }
+            virtual bool supports_frame_metadata(rs_frame_metadata frame_metadata) const override { return false; }
+        private:
+            std::shared_ptr<const frame> m_frame;
+        };
+
+        class rs_stream_impl : public rs_stream_interface
+        {
+        public:
+            rs_stream_impl(rs_stream stream);
+            rs_stream_impl(const stream_config & config);
+            void set_frame(std::shared_ptr<const frame> frame) { m_frame = frame; }
+            std::shared_ptr<const frame> get_frame() const { return m_frame; }
+            void clear_data() { m_frame.reset(); }
+            void set_is_enabled(bool state) { m_is_enabled = state; }
+            bool is_mode_available(int width, int height, rs_format format, int fps) const;
+            int get_bpp() const { return m_bpp; }
+            const stream_config & get_config() const { return m_config; }
+            virtual rs_extrinsics get_extrinsics_to(const rs_stream_interface &r) const override;
+            virtual float get_depth_scale() const override { return m_config.stream == rs::stream::depth ? 0.001f : 0; }
+            virtual rs_intrinsics get_intrinsics() const override { return m_intrinsics; }
+            virtual rs_intrinsics get_rectified_intrinsics() const override { return m_intrinsics; }
+            virtual rs_format get_format() const override { return static_cast<rs_format>(m_config.format); }
+            virtual int get_framerate() const override { return m_config.framerate; }
+            virtual double get_frame_metadata(rs_frame_metadata frame_metadata) const override { throw std::runtime_error("synthetic frames have no metadata"); }
+            virtual bool supports_frame_metadata(rs_frame_metadata frame_metadata) const override { return false; }
+            virtual unsigned long long get_frame_number() const override { return m_frame ? m_frame->number : 0; }
+            virtual long long get_frame_system_time() const override { return m_frame ? m_frame->system_time : 0; }
+            virtual const uint8_t *get_frame_data() const override { return m_frame ? m_frame->data.get() : nullptr; }
+            virtual int get_mode_count() const override { return get_format() == rs_format::RS_FORMAT_ANY ? 0 : 1; }
+            virtual double get_frame_timestamp() const override { return m_frame ? m_frame->time_stamp : 0; }
+            virtual void get_mode(int mode, int *w, int *h, rs_format *f, int *fps) const override;
+            virtual bool is_enabled() const override { return m_is_enabled; }
+            virtual bool has_data() const { return m_frame ? true : false; }
+            virtual rs_stream get_stream_type() const { return static_cast<rs_stream>(m_config.stream); }
+            virtual int get_frame_stride() const { return m_frame ? m_frame->stride : 0; }
+            virtual int get_frame_bpp() const { return m_frame ? m_frame->bpp : 0; }
+        private:
+            bool                            m_is_enabled;
+            stream_config                   m_config;
+            int                             m_bpp;
+            rs_intrinsics                   m_intrinsics;
+            std::shared_ptr<const frame>    m_frame;
+        };
+    }
+}
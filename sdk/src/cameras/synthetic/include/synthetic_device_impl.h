@@ -0,0 +1,130 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <librealsense/rscore.hpp>
+#include "rs_stream_impl.h"
+
+namespace rs
+{
+    namespace synthetic
+    {
+        /**
+        * @brief Recycles the frame buffers of a stream, the buffers are returned when the last frame referencing them is released.
+        */
+        class buffer_pool : public std::enable_shared_from_this<buffer_pool>
+        {
+        public:
+            buffer_pool(size_t buffer_size) : m_buffer_size(buffer_size) {}
+            ~buffer_pool();
+            std::shared_ptr<uint8_t> acquire();
+        private:
+            void release(uint8_t * buffer);
+
+            size_t                  m_buffer_size;
+            std::mutex              m_mutex;
+            std::vector<uint8_t*>   m_free_buffers;
+        };
+
+        struct stream_thread
+        {
+            stream_thread() : active_frames_count(0) {}
+
+            std::thread                         thread;
+            std::shared_ptr<rs_frame_callback>  callback;
+            std::shared_ptr<buffer_pool>        buffers;
+            std::vector<uint8_t>                pattern;
+            std::mutex                          mutex;
+            std::condition_variable             frame_released_cv;
+            uint32_t                            active_frames_count;
+        };
+
+        class rs_device_ex : public rs_device
+        {
+        public:
+            rs_device_ex(const device_config & config);
+            virtual ~rs_device_ex();
+            virtual const rs_stream_interface &     get_stream_interface(rs_stream stream) const override;
+            virtual const char *                    get_name() const override;
+            virtual const char *                    get_serial() const override;
+            virtual const char *                    get_firmware_version() const override;
+            virtual float                           get_depth_scale() const override;
+            virtual void                            enable_stream(rs_stream stream, int width, int height, rs_format format, int fps, rs_output_buffer_format output) override;
+            virtual void                            enable_stream_preset(rs_stream stream, rs_preset preset) override;
+            virtual void                            disable_stream(rs_stream stream) override;
+            virtual void                            enable_motion_tracking() override;
+            virtual void                            set_stream_callback(rs_stream stream, void(*on_frame)(rs_device * device, rs_frame_ref * frame, void * user), void * user) override;
+            virtual void                            set_stream_callback(rs_stream stream, rs_frame_callback * callback) override;
+            virtual void                            disable_motion_tracking() override;
+            virtual void                            set_motion_callback(void(*on_event)(rs_device * device, rs_motion_data data, void * user), void * user) override;
+            virtual void                            set_motion_callback(rs_motion_callback * callback) override;
+            virtual void                            set_timestamp_callback(void(*on_event)(rs_device * device, rs_timestamp_data data, void * user), void * user) override;
+            virtual void                            set_timestamp_callback(rs_timestamp_callback * callback) override;
+            virtual void                            start(rs_source source) override;
+            virtual void                            stop(rs_source source) override;
+            virtual bool                            is_capturing() const override;
+            virtual int                             is_motion_tracking_active() const override;
+            virtual void                            wait_all_streams() override;
+            virtual bool                            poll_all_streams() override;
+            virtual bool                            supports(rs_capabilities capability) const override;
+            virtual bool                            supports(rs_camera_info info_param) const override;
+            virtual bool                            supports_option(rs_option option) const override;
+            virtual void                            get_option_range(rs_option option, double & min, double & max, double & step, double & def) override;
+            virtual void                            set_options(const rs_option options[], size_t count, const double values[]) override;
+            virtual void                            get_options(const rs_option options[], size_t count, double values[]) override;
+            virtual void                            release_frame(rs_frame_ref * ref) override;
+            virtual rs_frame_ref *                  clone_frame(rs_frame_ref * frame) override;
+            virtual const char *                    get_usb_port_id() const;
+
+            virtual const char *                    get_camera_info(rs_camera_info info_type) const;
+            virtual rs_motion_intrinsics            get_motion_intrinsics() const;
+            virtual rs_extrinsics                   get_motion_extrinsics_from(rs_stream from) const;
+            virtual void                            start_fw_logger(char fw_log_op_code, int grab_rate_in_ms, std::timed_mutex &mutex);
+            virtual void                            stop_fw_logger();
+            virtual const char *                    get_option_description(rs_option option) const;
+
+        private:
+            void                                    stream_thread_loop(rs_stream stream, unsigned long long first_number);
+            void                                    motion_thread_loop(unsigned long long first_number);
+            std::shared_ptr<const frame>            generate_frame(rs_stream stream, unsigned long long number, double time_stamp);
+            void                                    deliver_frame(rs_stream stream, std::shared_ptr<const frame> frame);
+            void                                    deliver_time_stamp(rs_stream stream, const frame & frame);
+            bool                                    all_streams_updated() const;
+            void                                    publish_frames();
+            bool                                    wait_until(const std::atomic<bool> & is_running, std::chrono::steady_clock::time_point time);
+            unsigned long long                      query_first_number(double period_us) const;
+            bool                                    wait_for_active_frames();
+
+            std::map<rs_stream, std::unique_ptr<rs_stream_impl>>                m_streams;
+            std::map<rs_camera_info, std::string>                               m_camera_info;
+            motion_config                                                       m_motion_config;
+
+            std::map<rs_stream, stream_thread>                                  m_stream_threads;
+            std::thread                                                         m_motion_thread;
+            std::shared_ptr<rs_motion_callback>                                 m_motion_callback;
+            std::shared_ptr<rs_timestamp_callback>                              m_timestamp_callback;
+            std::mutex                                                          m_timestamp_callback_mutex;
+            bool                                                                m_is_motion_tracking_enabled;
+
+            std::atomic<bool>                                                   m_is_streaming;
+            std::atomic<bool>                                                   m_is_motion_streaming;
+            std::mutex                                                          m_stop_mutex;
+            std::condition_variable                                             m_stop_cv;
+            std::chrono::steady_clock::time_point                               m_start_time;
+            std::atomic<uint64_t>                                               m_total_frame_drops;
+
+            std::mutex                                                          m_frames_mutex;
+            std::condition_variable                                             m_frames_cv;
+            std::vector<rs_stream>                                              m_polled_streams;
+            std::map<rs_stream, std::shared_ptr<const frame>>                   m_latest_frames;
+        };
+    }
+}
@@ -0,0 +1,63 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "rs/utils/librealsense_conversion_utils.h"
+#include "rs_stream_impl.h"
+
+namespace rs
+{
+    namespace synthetic
+    {
+        rs_stream_impl::rs_stream_impl(rs_stream stream) : rs_stream_impl(stream_config{static_cast<rs::stream>(stream), 0, 0, rs::format::any, 0, 0, 0})
+        {
+
+        }
+
+        rs_stream_impl::rs_stream_impl(const stream_config & config) :
+            m_is_enabled(false),
+            m_config(config),
+            m_bpp(rs::core::get_pixel_size(rs::utils::convert_pixel_format(config.format)))
+        {
+            //a pinhole camera with a ~53 degrees horizontal field of view and no distortion
+            memset(&m_intrinsics, 0, sizeof(m_intrinsics));
+            m_intrinsics.width = config.width;
+            m_intrinsics.height = config.height;
+            m_intrinsics.ppx = config.width / 2.0f;
+            m_intrinsics.ppy = config.height / 2.0f;
+            m_intrinsics.fx = static_cast<float>(config.width);
+            m_intrinsics.fy = static_cast<float>(config.width);
+            m_intrinsics.model = rs_distortion::RS_DISTORTION_NONE;
+        }
+
+        bool rs_stream_impl::is_mode_available(int width, int height, rs_format format, int fps) const
+        {
+            //zero values and any format match the single mode, as with a camera
+            return get_mode_count() > 0 &&
+                   (width == 0 || width == m_config.width) &&
+                   (height == 0 || height == m_config.height) &&
+                   (format == rs_format::RS_FORMAT_ANY || format == get_format()) &&
+                   (fps == 0 || fps == m_config.framerate);
+        }
+
+        rs_extrinsics rs_stream_impl::get_extrinsics_to(const rs_stream_interface &r) const
+        {
+            //all the synthetic streams share the same view point
+            return { 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 };
+        }
+
+        void rs_stream_impl::get_mode(int mode, int *w, int *h, rs_format *f, int *fps) const
+        {
+            if(mode != 0 || get_mode_count() == 0)
+            {
+                *w = *h = *fps = 0;
+                *f = rs_format::RS_FORMAT_ANY;
+                return;
+            }
+            *w = m_config.width;
+            *h = m_config.height;
+            *f = get_format();
+            *fps = m_config.framerate;
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include "synthetic_device_impl.h"
+#include "rs/synthetic/synthetic_context.h"
+
+namespace rs
+{
+    namespace synthetic
+    {
+        context::context(const device_config & config) : m_devices(1, new rs_device_ex(config))
+        {
+
+        }
+
+        context::context(const std::vector<device_config> & configs)
+        {
+            for(auto & config : configs)
+                m_devices.push_back(new rs_device_ex(config));
+        }
+
+        context::~context()
+        {
+            for(auto device : m_devices)
+                delete device;
+        }
+
+        int context::get_device_count() const
+        {
+            return static_cast<int>(m_devices.size());
+        }
+
+        rs::device * context::get_device(int index)
+        {
+            return index >= 0 && index < get_device_count() ? (rs::device*)m_devices[index] : nullptr;
+        }
+    }
+}
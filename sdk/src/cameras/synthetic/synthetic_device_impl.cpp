@@ -0,0 +1,730 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include "synthetic_device_impl.h"
+#include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
+
+namespace
+{
+    static rs_capabilities get_capability(rs_stream stream)
+    {
+        switch(stream)
+        {
+            case rs_stream::RS_STREAM_COLOR: return rs_capabilities::RS_CAPABILITIES_COLOR;
+            case rs_stream::RS_STREAM_DEPTH: return rs_capabilities::RS_CAPABILITIES_DEPTH;
+            case rs_stream::RS_STREAM_INFRARED: return rs_capabilities::RS_CAPABILITIES_INFRARED;
+            case rs_stream::RS_STREAM_INFRARED2: return rs_capabilities::RS_CAPABILITIES_INFRARED2;
+            case rs_stream::RS_STREAM_FISHEYE: return rs_capabilities::RS_CAPABILITIES_FISH_EYE;
+            default: return rs_capabilities::RS_CAPABILITIES_COUNT;
+        }
+    }
+
+    static bool is_16_bit_format(rs_format format)
+    {
+        return format == rs_format::RS_FORMAT_Z16 || format == rs_format::RS_FORMAT_DISPARITY16 ||
+               format == rs_format::RS_FORMAT_Y16 || format == rs_format::RS_FORMAT_RAW16;
+    }
+}
+
+namespace rs
+{
+    namespace synthetic
+    {
+        class frame_callback : public rs_frame_callback
+        {
+            void(*fptr)(rs_device * dev, rs_frame_ref * frame, void * user);
+            void * user;
+            rs_device * device;
+        public:
+            frame_callback(rs_device * dev, void(*on_frame)(rs_device *, rs_frame_ref *, void *), void * user) : fptr(on_frame), user(user), device(dev) {}
+
+            void on_frame (rs_device * device, rs_frame_ref * frame) override
+            {
+                if (fptr)
+                {
+                    try { fptr(device, frame, user); }
+                    catch (...) {}
+                }
+            }
+            void release() override { delete this; }
+        };
+
+        class motion_events_callback : public rs_motion_callback
+        {
+            void(*fptr)(rs_device * dev, rs_motion_data data, void * user);
+            void        * user;
+            rs_device   * device;
+        public:
+            motion_events_callback(rs_device * dev, void(*fptr)(rs_device *, rs_motion_data, void *), void * user) : fptr(fptr), user(user), device(dev) {}
+
+            void on_event(rs_motion_data data) override
+            {
+                if (fptr)
+                {
+                    try { fptr(device, data, user); }
+                    catch (...) {}
+                }
+            }
+            void release() override { delete this; }
+        };
+
+        class timestamp_events_callback : public rs_timestamp_callback
+        {
+            void(*fptr)(rs_device * dev, rs_timestamp_data data, void * user);
+            void        * user;
+            rs_device   * device;
+        public:
+            timestamp_events_callback(rs_device * dev, void(*fptr)(rs_device *, rs_timestamp_data, void *), void * user) : fptr(fptr), user(user), device(dev) {}
+
+            void on_event(rs_timestamp_data data) override
+            {
+                if (fptr)
+                {
+                    try { fptr(device, data, user); }
+                    catch (...) {}
+                }
+            }
+            void release() override { delete this; }
+        };
+
+        buffer_pool::~buffer_pool()
+        {
+            for(auto buffer : m_free_buffers)
+                delete[] buffer;
+        }
+
+        std::shared_ptr<uint8_t> buffer_pool::acquire()
+        {
+            uint8_t * buffer = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                if(!m_free_buffers.empty())
+                {
+                    buffer = m_free_buffers.back();
+                    m_free_buffers.pop_back();
+                }
+            }
+            if(!buffer)
+                buffer = new uint8_t[m_buffer_size];
+            //the frames keep the pool alive, so a frame may be released after its device
+            auto pool = shared_from_this();
+            return std::shared_ptr<uint8_t>(buffer, [pool](uint8_t * released_buffer) { pool->release(released_buffer); });
+        }
+
+        void buffer_pool::release(uint8_t * buffer)
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_free_buffers.push_back(buffer);
+        }
+
+        rs_device_ex::rs_device_ex(const device_config & config) :
+            m_motion_config(config.motion),
+            m_is_motion_tracking_enabled(false),
+            m_is_streaming(false),
+            m_is_motion_streaming(false),
+            m_total_frame_drops(0)
+        {
+            for(auto & stream_config : config.streams)
+            {
+                m_streams[static_cast<rs_stream>(stream_config.stream)].reset(new rs_stream_impl(stream_config));
+            }
+            m_streams[rs_stream::RS_STREAM_COUNT].reset(new rs_stream_impl(rs_stream::RS_STREAM_COUNT));
+
+            m_camera_info[rs_camera_info::RS_CAMERA_INFO_DEVICE_NAME] = "Intel RealSense Synthetic Device";
+            m_camera_info[rs_camera_info::RS_CAMERA_INFO_DEVICE_SERIAL_NUMBER] = "0000000000";
+            m_camera_info[rs_camera_info::RS_CAMERA_INFO_CAMERA_FIRMWARE_VERSION] = "0.0.0.0";
+        }
+
+        rs_device_ex::~rs_device_ex()
+        {
+            try
+            {
+                stop(rs_source::RS_SOURCE_ALL);
+            }
+            catch(const std::exception & ex)
+            {
+                LOG_ERROR("failed to stop the synthetic device - " << ex.what());
+            }
+        }
+
+        const rs_stream_interface & rs_device_ex::get_stream_interface(rs_stream stream) const
+        {
+            if(m_streams.find(stream) != m_streams.end())
+            {
+                return *m_streams.at(stream).get();
+            }
+            else
+            {
+                LOG_ERROR("requsted stream is not generated by the synthetic device, stream - " << stream)
+                return *m_streams.at(rs_stream::RS_STREAM_COUNT).get();
+            }
+        }
+
+        const char * rs_device_ex::get_name() const
+        {
+            return get_camera_info(rs_camera_info::RS_CAMERA_INFO_DEVICE_NAME);
+        }
+
+        const char * rs_device_ex::get_serial() const
+        {
+            return get_camera_info(rs_camera_info::RS_CAMERA_INFO_DEVICE_SERIAL_NUMBER);
+        }
+
+        const char * rs_device_ex::get_firmware_version() const
+        {
+            return get_camera_info(rs_camera_info::RS_CAMERA_INFO_CAMERA_FIRMWARE_VERSION);
+        }
+
+        float rs_device_ex::get_depth_scale() const
+        {
+            return get_stream_interface(rs_stream::RS_STREAM_DEPTH).get_depth_scale();
+        }
+
+        void rs_device_ex::enable_stream(rs_stream stream, int width, int height, rs_format format, int fps, rs_output_buffer_format output)
+        {
+            LOG_INFO("enable stream - " << stream << " ,width - " << width << " ,height - " << height << " ,format - " << format << " ,fps -" << fps);
+
+            if(stream == rs_stream::RS_STREAM_COUNT || m_streams.find(stream) == m_streams.end())
+            {
+                LOG_ERROR("unsupported stream");
+                throw std::runtime_error("unsupported stream");
+            }
+            if(!m_streams[stream]->is_mode_available(width, height, format, fps))
+            {
+                LOG_ERROR("configuration mode is unavailable");
+                std::stringstream ss;
+                ss << "configuration mode of " << width << "X" << height << "X" <<  fps << " is unavailable";
+                throw std::runtime_error(ss.str());
+            }
+            if(m_streams[stream]->get_bpp() == 0)
+            {
+                LOG_ERROR("unsupported format");
+                throw std::runtime_error("unsupported format");
+            }
+            m_streams[stream]->set_is_enabled(true);
+        }
+
+        void rs_device_ex::enable_stream_preset(rs_stream stream, rs_preset preset)//enables the single available configuration
+        {
+            LOG_INFO("enable stream - " << stream << " ,preset - " << preset)
+            enable_stream(stream, 0, 0, rs_format::RS_FORMAT_ANY, 0, rs_output_buffer_format::RS_OUTPUT_BUFFER_FORMAT_CONTINUOUS);
+        }
+
+        void rs_device_ex::disable_stream(rs_stream stream)
+        {
+            LOG_INFO("disable stream - " << stream)
+            if(stream != rs_stream::RS_STREAM_COUNT && m_streams.find(stream) != m_streams.end())
+            {
+                m_streams[stream]->set_is_enabled(false);
+            }
+        }
+
+        void rs_device_ex::enable_motion_tracking()
+        {
+            LOG_INFO("enable motion tracking")
+            if(m_motion_config.rate == 0)
+            {
+                LOG_ERROR("motion tracking is not configured");
+                throw std::runtime_error("motion tracking is not supported by this device");
+            }
+            m_is_motion_tracking_enabled = true;
+        }
+
+        void rs_device_ex::set_stream_callback(rs_stream stream, void(*on_frame)(rs_device * device, rs_frame_ref * frame, void * user), void * user)
+        {
+            rs_device_ex::set_stream_callback(stream, new frame_callback(this, on_frame, user));
+        }
+
+        void rs_device_ex::set_stream_callback(rs_stream stream, rs_frame_callback * callback)
+        {
+            LOG_INFO("stream - " << stream)
+            m_stream_threads[stream].callback = std::shared_ptr<rs_frame_callback>(callback, [](rs_frame_callback* cb)
+            {cb->release();});
+        }
+
+        void rs_device_ex::disable_motion_tracking()
+        {
+            LOG_INFO("disable motion tracking")
+            m_is_motion_tracking_enabled = false;
+        }
+
+        void rs_device_ex::set_motion_callback(void(*on_event)(rs_device * device, rs_motion_data data, void * user), void * user)
+        {
+            set_motion_callback(new motion_events_callback(this, on_event, user));
+        }
+
+        void rs_device_ex::set_motion_callback(rs_motion_callback * callback)
+        {
+            LOG_INFO("set motion callback")
+            m_motion_callback = std::shared_ptr<rs_motion_callback>(callback, [](rs_motion_callback* cb)
+            { cb->release(); });
+        }
+
+        void rs_device_ex::set_timestamp_callback(void(*on_event)(rs_device * device, rs_timestamp_data data, void * user), void * user)
+        {
+            set_timestamp_callback(new timestamp_events_callback(this, on_event, user));
+        }
+
+        void rs_device_ex::set_timestamp_callback(rs_timestamp_callback * callback)
+        {
+            LOG_INFO("set time stamp callback")
+            std::lock_guard<std::mutex> guard(m_timestamp_callback_mutex);
+            m_timestamp_callback = std::shared_ptr<rs_timestamp_callback>(callback, [](rs_timestamp_callback* cb)
+            { cb->release(); });
+        }
+
+        void rs_device_ex::start(rs_source source)
+        {
+            LOG_INFO("start");
+            const bool start_video = (source == rs_source::RS_SOURCE_VIDEO || source == rs_source::RS_SOURCE_ALL) && !m_is_streaming;
+            const bool start_motion = (source == rs_source::RS_SOURCE_MOTION_TRACKING || source == rs_source::RS_SOURCE_ALL) &&
+                                      m_is_motion_tracking_enabled && m_motion_callback && !m_is_motion_streaming;
+
+            if(start_video)
+            {
+                m_polled_streams.clear();
+                m_latest_frames.clear();
+                for(auto it = m_streams.begin(); it != m_streams.end(); ++it)
+                {
+                    if(it->first == rs_stream::RS_STREAM_COUNT || !it->second->is_enabled()) continue;
+                    it->second->clear_data();
+
+                    //the frames scroll over a pattern generated once per start
+                    const stream_config & config = it->second->get_config();
+                    const int bpp = it->second->get_bpp();
+                    const size_t stride = config.width * bpp;
+                    const bool is_16_bit = is_16_bit_format(it->second->get_format());
+                    stream_thread & thread = m_stream_threads[it->first];
+                    thread.pattern.resize(stride * config.height);
+                    for(int y = 0; y < config.height; y++)
+                    {
+                        uint8_t * row = thread.pattern.data() + y * stride;
+                        for(int x = 0; x < config.width; x++)
+                        {
+                            if(is_16_bit)
+                            {
+                                const uint16_t value = static_cast<uint16_t>(256 + (x + y) % 4096);
+                                memcpy(row + x * bpp, &value, sizeof(value));
+                                continue;
+                            }
+                            for(int channel = 0; channel < bpp; channel++)
+                                row[x * bpp + channel] = static_cast<uint8_t>(x + y + channel * 64);
+                        }
+                    }
+                    thread.buffers = std::make_shared<buffer_pool>(thread.pattern.size());
+                    thread.active_frames_count = 0;
+                    if(!thread.callback)
+                        m_polled_streams.push_back(it->first);
+                }
+            }
+
+            //the sources started together share the time base of their time stamps
+            if(!m_is_streaming && !m_is_motion_streaming)
+                m_start_time = std::chrono::steady_clock::now();
+
+            if(start_video)
+            {
+                m_is_streaming = true;
+                for(auto it = m_stream_threads.begin(); it != m_stream_threads.end(); ++it)
+                {
+                    if(m_streams.find(it->first) == m_streams.end() || !m_streams[it->first]->is_enabled()) continue;
+                    const int framerate = m_streams[it->first]->get_config().framerate;
+                    const unsigned long long first_number = query_first_number(framerate > 0 ? 1000000.0 / framerate : 0);
+                    it->second.thread = std::thread(&rs_device_ex::stream_thread_loop, this, it->first, first_number);
+                }
+            }
+
+            if(start_motion)
+            {
+                m_is_motion_streaming = true;
+                m_motion_thread = std::thread(&rs_device_ex::motion_thread_loop, this, query_first_number(1000000.0 / m_motion_config.rate));
+            }
+        }
+
+        void rs_device_ex::stop(rs_source source)
+        {
+            LOG_INFO("stop");
+            const bool stop_video = source == rs_source::RS_SOURCE_VIDEO || source == rs_source::RS_SOURCE_ALL;
+            const bool stop_motion = source == rs_source::RS_SOURCE_MOTION_TRACKING || source == rs_source::RS_SOURCE_ALL;
+            {
+                std::lock_guard<std::mutex> guard(m_stop_mutex);
+                if(stop_video) m_is_streaming = false;
+                if(stop_motion) m_is_motion_streaming = false;
+            }
+            m_stop_cv.notify_all();
+
+            if(stop_motion && m_motion_thread.joinable())
+                m_motion_thread.join();
+
+            if(!stop_video)
+                return;
+
+            {
+                //release a "wait_for_frames" call
+                std::lock_guard<std::mutex> guard(m_frames_mutex);
+            }
+            m_frames_cv.notify_all();
+            for(auto it = m_stream_threads.begin(); it != m_stream_threads.end(); ++it)
+            {
+                if(it->second.thread.joinable())
+                    it->second.thread.join();
+            }
+            if(!wait_for_active_frames())
+                throw std::runtime_error("failed to stop synthetic device, not all frames returned within the time limit");
+        }
+
+        bool rs_device_ex::is_capturing() const
+        {
+            return m_is_streaming;
+        }
+
+        int rs_device_ex::is_motion_tracking_active() const
+        {
+            return (int)(m_is_motion_streaming.load());
+        }
+
+        void rs_device_ex::wait_all_streams()
+        {
+            LOG_FUNC_SCOPE();
+            std::unique_lock<std::mutex> guard(m_frames_mutex);
+            if(m_is_streaming && m_polled_streams.empty())
+                throw std::runtime_error("calling to \"wait_for_frames\" (synchronous mode) is not allowed if \"set_frame_callback\" was called for all the streams (asynchronous mode)");
+
+            m_frames_cv.wait(guard, [this]() -> bool { return !m_is_streaming || all_streams_updated(); });
+            if(m_is_streaming)
+                publish_frames();
+        }
+
+        bool rs_device_ex::poll_all_streams()
+        {
+            LOG_FUNC_SCOPE();
+            std::lock_guard<std::mutex> guard(m_frames_mutex);
+            if(!m_is_streaming || !all_streams_updated())
+                return false;
+            publish_frames();
+            return true;
+        }
+
+        bool rs_device_ex::supports(rs_capabilities capability) const
+        {
+            if(capability == rs_capabilities::RS_CAPABILITIES_MOTION_EVENTS)
+                return m_motion_config.rate > 0;
+            for(auto it = m_streams.begin(); it != m_streams.end(); ++it)
+            {
+                if(get_capability(it->first) == capability)
+                    return true;
+            }
+            return false;
+        }
+
+        bool rs_device_ex::supports(rs_camera_info info_param) const
+        {
+            return m_camera_info.find(info_param) != m_camera_info.end();
+        }
+
+        bool rs_device_ex::supports_option(rs_option option) const
+        {
+            return option == rs_option::RS_OPTION_TOTAL_FRAME_DROPS;
+        }
+
+        void rs_device_ex::get_option_range(rs_option option, double & min, double & max, double & step, double & def)
+        {
+            if(option == rs_option::RS_OPTION_TOTAL_FRAME_DROPS)
+            {
+                min = 0;
+                max = std::numeric_limits<double>::max();
+                step = 1;
+                def = 0;
+            }
+        }
+
+        void rs_device_ex::set_options(const rs_option options[], size_t count, const double values[])
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                switch(options[i])
+                {
+                    case rs_option::RS_OPTION_TOTAL_FRAME_DROPS: m_total_frame_drops = static_cast<uint64_t>(values[i]); break;
+                    default: break;
+                }
+            }
+        }
+
+        void rs_device_ex::get_options(const rs_option options[], size_t count, double values[])
+        {
+            for(size_t i = 0; i < count; i++)
+            {
+                switch(options[i])
+                {
+                    case rs_option::RS_OPTION_TOTAL_FRAME_DROPS: values[i] = static_cast<double>(m_total_frame_drops.load()); break;
+                    default: break;
+                }
+            }
+        }
+
+        void rs_device_ex::release_frame(rs_frame_ref * ref)
+        {
+            LOG_VERBOSE("release frame");
+            auto stream_type = ref->get_stream_type();
+            delete static_cast<rs_frame_ref_impl*>(ref);
+            stream_thread & thread = m_stream_threads.at(stream_type);
+            std::lock_guard<std::mutex> guard(thread.mutex);
+            thread.active_frames_count--;
+            thread.frame_released_cv.notify_one();
+        }
+
+        rs_frame_ref * rs_device_ex::clone_frame(rs_frame_ref * frame)
+        {
+            auto stream_type = frame->get_stream_type();
+            auto clone = new rs_frame_ref_impl(static_cast<rs_frame_ref_impl*>(frame)->get_frame());
+            stream_thread & thread = m_stream_threads.at(stream_type);
+            std::lock_guard<std::mutex> guard(thread.mutex);
+            thread.active_frames_count++;
+            return clone;
+        }
+
+        const char * rs_device_ex::get_usb_port_id() const
+        {
+            return "Synthetic";
+        }
+
+        const char * rs_device_ex::get_camera_info(rs_camera_info info_type) const
+        {
+            try{
+                return m_camera_info.at(info_type).c_str();
+            }catch(const std::out_of_range& e)
+            {
+                std::ostringstream oss;
+                oss << "camera info " << info_type << "is not supported for this device";
+                throw std::runtime_error(oss.str());
+            }
+        }
+
+        rs_motion_intrinsics rs_device_ex::get_motion_intrinsics() const
+        {
+            if(m_motion_config.rate == 0)
+                throw std::runtime_error("No motion intrinsics available");
+            //unit scale and no bias
+            rs_motion_intrinsics intrinsics = {};
+            for(int i = 0; i < 3; i++)
+            {
+                intrinsics.acc.data[i][i] = 1;
+                intrinsics.gyro.data[i][i] = 1;
+            }
+            return intrinsics;
+        }
+
+        rs_extrinsics rs_device_ex::get_motion_extrinsics_from(rs_stream from) const
+        {
+            if(m_motion_config.rate == 0 || from == rs_stream::RS_STREAM_COUNT || m_streams.find(from) == m_streams.end())
+                throw std::runtime_error("No motion extrinsics available");
+            return { 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0 };
+        }
+
+        void rs_device_ex::start_fw_logger(char fw_log_op_code, int grab_rate_in_ms, std::timed_mutex &mutex)
+        {
+            //not available!!!
+        }
+
+        void rs_device_ex::stop_fw_logger()
+        {
+            //not available!!!
+        }
+
+        const char * rs_device_ex::get_option_description(rs_option option) const
+        {
+            return nullptr;
+        }
+
+        void rs_device_ex::stream_thread_loop(rs_stream stream, unsigned long long first_number)
+        {
+            TRACE_THREAD_NAME("synthetic_stream");
+            const stream_config & config = m_streams.at(stream)->get_config();
+            const double period_us = config.framerate > 0 ? 1000000.0 / config.framerate : 0;
+            std::mt19937 random_engine(static_cast<uint32_t>(stream));
+            std::uniform_int_distribution<uint32_t> jitter_distribution(0, config.jitter_us);
+
+            for(unsigned long long number = first_number; m_is_streaming; number++)
+            {
+                //the jitter delays a single frame, the following frames keep the nominal rate
+                const double time_us = period_us * (number - 1) + (config.jitter_us ? jitter_distribution(random_engine) : 0);
+                if(!wait_until(m_is_streaming, m_start_time + std::chrono::microseconds(static_cast<long long>(time_us))))
+                    break;
+                if(config.drop_interval && number % config.drop_interval == 0)
+                {
+                    TRACE_INSTANT("synthetic", "frame_drop");
+                    m_total_frame_drops++;
+                    continue;
+                }
+                auto frame = generate_frame(stream, number, time_us / 1000.0);
+                deliver_frame(stream, frame);
+                deliver_time_stamp(stream, *frame);
+            }
+        }
+
+        void rs_device_ex::motion_thread_loop(unsigned long long first_number)
+        {
+            TRACE_THREAD_NAME("synthetic_motion");
+            const double period_us = 1000000.0 / m_motion_config.rate;
+            const double two_pi = 6.283185307179586;
+
+            for(unsigned long long number = first_number; m_is_motion_streaming; number++)
+            {
+                const double time_us = period_us * (number - 1);
+                if(!wait_until(m_is_motion_streaming, m_start_time + std::chrono::microseconds(static_cast<long long>(time_us))))
+                    break;
+                if(m_motion_config.drop_interval && number % m_motion_config.drop_interval == 0)
+                    continue;
+
+                //a device shaking around the gravity vector once per second
+                const float phase = static_cast<float>(time_us / 1000000.0 * two_pi);
+                rs_motion_data accel = {};
+                accel.timestamp_data.timestamp = time_us / 1000.0;
+                accel.timestamp_data.source_id = rs_event_source::RS_EVENT_IMU_ACCEL;
+                accel.timestamp_data.frame_number = number;
+                accel.is_valid = 1;
+                accel.axes[0] = 0.1f * std::sin(phase);
+                accel.axes[1] = -9.8f;
+                accel.axes[2] = 0.1f * std::cos(phase);
+
+                rs_motion_data gyro = accel;
+                gyro.timestamp_data.source_id = rs_event_source::RS_EVENT_IMU_GYRO;
+                gyro.axes[0] = 0.5f * std::cos(phase);
+                gyro.axes[1] = 0;
+                gyro.axes[2] = -0.5f * std::sin(phase);
+
+                TRACE_SCOPE("synthetic", "motion_callback");
+                m_motion_callback->on_event(accel);
+                m_motion_callback->on_event(gyro);
+            }
+        }
+
+        std::shared_ptr<const frame> rs_device_ex::generate_frame(rs_stream stream, unsigned long long number, double time_stamp)
+        {
+            TRACE_SCOPE("synthetic", "generate_frame");
+            const rs_stream_impl & stream_impl = *m_streams.at(stream);
+            const stream_config & config = stream_impl.get_config();
+            stream_thread & thread = m_stream_threads.at(stream);
+
+            std::shared_ptr<frame> new_frame = std::make_shared<frame>();
+            new_frame->stream = stream;
+            new_frame->width = config.width;
+            new_frame->height = config.height;
+            new_frame->bpp = stream_impl.get_bpp();
+            new_frame->stride = config.width * new_frame->bpp;
+            new_frame->format = stream_impl.get_format();
+            new_frame->framerate = config.framerate;
+            new_frame->number = number;
+            new_frame->time_stamp = time_stamp;
+            new_frame->system_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            new_frame->data = thread.buffers->acquire();
+
+            //scroll the pattern by a row per frame
+            const size_t size = thread.pattern.size();
+            const size_t offset = (number % (config.height > 0 ? config.height : 1)) * new_frame->stride;
+            memcpy(new_frame->data.get(), thread.pattern.data() + offset, size - offset);
+            memcpy(new_frame->data.get() + size - offset, thread.pattern.data(), offset);
+            return new_frame;
+        }
+
+        void rs_device_ex::deliver_frame(rs_stream stream, std::shared_ptr<const frame> frame)
+        {
+            stream_thread & thread = m_stream_threads.at(stream);
+            if(thread.callback)
+            {
+                {
+                    std::lock_guard<std::mutex> guard(thread.mutex);
+                    thread.active_frames_count++;
+                }
+                TRACE_SCOPE("synthetic", "frame_callback");
+                thread.callback->on_frame(this, new rs_frame_ref_impl(frame));
+                return;
+            }
+
+            //the latest frame replaces an unread one, as with a camera
+            {
+                std::lock_guard<std::mutex> guard(m_frames_mutex);
+                m_latest_frames[stream] = frame;
+            }
+            m_frames_cv.notify_all();
+        }
+
+        void rs_device_ex::deliver_time_stamp(rs_stream stream, const frame & frame)
+        {
+            if(!m_is_motion_streaming || (stream != rs_stream::RS_STREAM_DEPTH && stream != rs_stream::RS_STREAM_FISHEYE))
+                return;
+            std::lock_guard<std::mutex> guard(m_timestamp_callback_mutex);
+            if(!m_timestamp_callback)
+                return;
+            rs_timestamp_data data = {};
+            data.timestamp = frame.time_stamp;
+            data.source_id = stream == rs_stream::RS_STREAM_DEPTH ? rs_event_source::RS_EVENT_IMU_DEPTH_CAM : rs_event_source::RS_EVENT_IMU_MOTION_CAM;
+            data.frame_number = frame.number;
+            m_timestamp_callback->on_event(data);
+        }
+
+        bool rs_device_ex::all_streams_updated() const
+        {
+            if(m_polled_streams.empty()) return false;
+            for(auto stream : m_polled_streams)
+            {
+                if(m_latest_frames.find(stream) == m_latest_frames.end()) return false;
+            }
+            return true;
+        }
+
+        void rs_device_ex::publish_frames()
+        {
+            for(auto it = m_latest_frames.begin(); it != m_latest_frames.end(); ++it)
+            {
+                m_streams[it->first]->set_frame(it->second);
+            }
+            m_latest_frames.clear();
+        }
+
+        bool rs_device_ex::wait_until(const std::atomic<bool> & is_running, std::chrono::steady_clock::time_point time)
+        {
+            //a late frame is generated right away, without locking
+            if(std::chrono::steady_clock::now() < time)
+            {
+                std::unique_lock<std::mutex> guard(m_stop_mutex);
+                m_stop_cv.wait_until(guard, time, [&is_running]() -> bool { return !is_running; });
+            }
+            return is_running;
+        }
+
+        unsigned long long rs_device_ex::query_first_number(double period_us) const
+        {
+            //a source started after the other skips the samples it missed, to keep a common time base
+            if(period_us <= 0)
+                return 1;
+            const double elapsed_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start_time).count();
+            return 1 + static_cast<unsigned long long>(elapsed_us / period_us);
+        }
+
+        bool rs_device_ex::wait_for_active_frames()
+        {
+            for(auto it = m_stream_threads.begin(); it != m_stream_threads.end(); ++it)
+            {
+                //wait for all frames to return
+                auto pred = [it]() -> bool
+                {
+                    return it->second.active_frames_count == 0;
+                };
+
+                std::unique_lock<std::mutex> locker(it->second.mutex);
+                auto all_frames_back = it->second.frame_released_cv.wait_for(locker, std::chrono::seconds(5), pred);
+                if(!all_frames_back)
+                    return false;
+            }
+            return true;
+        }
+    }
+}
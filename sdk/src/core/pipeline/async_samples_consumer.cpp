@@ -1,7 +1,9 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <chrono>
 #include "async_samples_consumer.h"
+#include "rs/utils/event_tracer.h"
 
 #include <iostream>
 
@@ -17,14 +19,18 @@ namespace rs
                                                        const video_module_interface::supported_module_config::time_sync_mode time_sync_mode):
             samples_consumer_base(module_config, time_sync_mode),
             m_app_callbacks_handler(app_callbacks_handler),
-            m_cv_module(cv_module)
+            m_cv_module(cv_module),
+            m_process_time_histogram(PERF_COUNTERS.query_histogram("pipeline.cv_module_process_time_us"))
         {
             m_cv_module->register_event_handler(this);
         }
 
         void async_samples_consumer::on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set)
         {
+            TRACE_SCOPE("pipeline", "cv_module_process_sample_set");
+            auto start_time = std::chrono::steady_clock::now();
             status process_sample_set_status = m_cv_module->process_sample_set(*ready_sample_set);
+            m_process_time_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count());
             if(process_sample_set_status < status_no_error)
             {
                 LOG_ERROR("failed async sample process");
@@ -28,6 +28,7 @@ namespace rs
         private:
             pipeline_async_interface::callback_handler * m_app_callbacks_handler;
             video_module_interface * m_cv_module;
+            rs::utils::performance_histogram & m_process_time_histogram;
 
             void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
             void consumer_loop();
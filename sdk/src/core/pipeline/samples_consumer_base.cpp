@@ -11,7 +11,8 @@ namespace rs
     {
         samples_consumer_base::samples_consumer_base(const video_module_interface::actual_module_config &module_config,
                                                      const video_module_interface::supported_module_config::time_sync_mode time_sync_mode) :
-            m_module_config(module_config)
+            m_module_config(module_config),
+            m_sample_sets_counter(PERF_COUNTERS.query_counter("pipeline.sample_sets"))
         {
             m_time_sync_util = get_time_sync_util_from_module_config(m_module_config, time_sync_mode);
         }
@@ -82,11 +83,13 @@ namespace rs
             auto unmatched_frames = get_unmatched_frames(); // empty on no time sync or time sync input only modes
             for(auto unmatched_frame : unmatched_frames)
             {
+                m_sample_sets_counter.add();
                 on_complete_sample_set(unmatched_frame);
             }
 
             if(ready_sample_set)
             {
+                m_sample_sets_counter.add();
                 on_complete_sample_set(ready_sample_set);
             }
         }
@@ -5,6 +5,7 @@
 #include <memory>
 #include <vector>
 #include "rs/utils/samples_time_sync_interface.h"
+#include "rs/utils/performance_counters.h"
 
 namespace rs
 {
@@ -22,6 +23,7 @@ namespace rs
         private:            
             const video_module_interface::actual_module_config m_module_config;
             rs::utils::unique_ptr<rs::utils::samples_time_sync_interface> m_time_sync_util;
+            rs::utils::performance_counter & m_sample_sets_counter;
 
             bool is_sample_set_relevant(const std::shared_ptr<correlated_sample_set> & sample_set) const;
             std::shared_ptr<correlated_sample_set> insert_to_time_sync_util(const std::shared_ptr<correlated_sample_set> & input_sample_set);
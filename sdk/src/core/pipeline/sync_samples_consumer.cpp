@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "rs/utils/log_utils.h"
+#include "rs/utils/event_tracer.h"
 #include "sync_samples_consumer.h"
 
 #include "samples_consumer_base.h"
@@ -17,6 +18,7 @@ namespace rs
             samples_consumer_base(module_config, time_sync_mode),
             m_is_closing(false),
             m_current_sample_set(nullptr),
+            m_dropped_sample_sets_counter(PERF_COUNTERS.query_counter("pipeline.sample_sets_dropped")),
             m_sample_set_ready_handler(sample_set_ready_handler)
         {
             m_samples_consumer_thread = std::thread(&sync_samples_consumer::consumer_loop, this);
@@ -27,6 +29,10 @@ namespace rs
             //update the current object even if no one took it
             {
                 std::unique_lock<std::mutex> lock(m_lock);
+                if(m_current_sample_set)
+                {
+                    m_dropped_sample_sets_counter.add();
+                }
                 m_current_sample_set = std::move(ready_sample_set);
             }
             m_conditional_variable.notify_one();
@@ -34,6 +40,7 @@ namespace rs
 
         void sync_samples_consumer::consumer_loop()
         {
+            TRACE_THREAD_NAME("pipeline_consumer");
             while(!m_is_closing)
             {
                 std::shared_ptr<correlated_sample_set> samples_set;
@@ -50,6 +57,7 @@ namespace rs
 
                 try
                 {
+                    TRACE_SCOPE("pipeline", "sample_set_handler");
                     m_sample_set_ready_handler(samples_set);
                 }
                 catch(const std::exception & ex)
@@ -30,6 +30,7 @@ namespace rs
             std::shared_ptr<correlated_sample_set> m_current_sample_set;
             std::mutex m_lock;
             std::condition_variable m_conditional_variable;
+            rs::utils::performance_counter & m_dropped_sample_sets_counter;
 
             std::function<void(std::shared_ptr<correlated_sample_set>)> m_sample_set_ready_handler;
             void on_complete_sample_set(std::shared_ptr<correlated_sample_set> ready_sample_set) override;
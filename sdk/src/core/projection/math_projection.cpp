@@ -15,8 +15,67 @@ namespace rs
     {
         inline double abs(double a) { return (a < 0) ? (-a) : a; }
 
+        // Applies the color camera distortion model to normalized coordinates
+        static inline void own_distort(double &u, double &v, const float distortion[5])
+        {
+            double r2  = u * u + v * v;
+            double r4  = r2 * r2;
+            double fDist = 1.f + distortion[0] * r2 + distortion[1] * r4 + distortion[4] * r2 * r4;
+            if( distortion[2] != 0 )
+            {
+                r4  = 2.f * u * v;
+                u = u * fDist + distortion[2] * r4 + distortion[3] * (r2 + 2.f * u * u);
+                v = v * fDist + distortion[3] * r4 + distortion[2] * (r2 + 2.f * v * v);
+            }
+            else
+            {
+                u *= fDist;
+                v *= fDist;
+            }
+        }
+
+        // Bilinear interpolation of the distortion grid, returns false if the point is outside of the grid
+        static inline bool own_distort_lut(double &u, double &v, const distortion_lut_32f *plut)
+        {
+            float gx = static_cast<float>((u - plut->origin.x) * plut->inv_step.x);
+            float gy = static_cast<float>((v - plut->origin.y) * plut->inv_step.y);
+            if (gx < 0.f || gy < 0.f) return false;
+            int ix = static_cast<int>(gx);
+            int iy = static_cast<int>(gy);
+            if (ix >= plut->grid_size.width - 1 || iy >= plut->grid_size.height - 1) return false;
+            float ax = gx - static_cast<float>(ix);
+            float ay = gy - static_cast<float>(iy);
+            const pointF32 *top = plut->nodes.data() + iy * plut->grid_size.width + ix;
+            const pointF32 *bottom = top + plut->grid_size.width;
+            float top_x = top[0].x + (top[1].x - top[0].x) * ax;
+            float top_y = top[0].y + (top[1].y - top[0].y) * ax;
+            float bottom_x = bottom[0].x + (bottom[1].x - bottom[0].x) * ax;
+            float bottom_y = bottom[0].y + (bottom[1].y - bottom[0].y) * ax;
+            u = top_x + (bottom_x - top_x) * ay;
+            v = top_y + (bottom_y - top_y) * ay;
+            return true;
+        }
+
+        // Moves the source pointer and the rays to the roi origin and sets the processed size, returns false if the roi is outside of the image.
+        // Without roi the whole image is processed.
+        static inline bool own_select_roi(const unsigned short *&psrc, int src_step, sizeI32 image_size, const rect *psrc_roi,
+                                          const projection_spec_32f *pspec, const pointF32 *&rowUV, sizeI32 &process_size)
+        {
+            rowUV = (const pointF32*)((const unsigned char*)pspec + sizeof(float) * 16);
+            process_size = image_size;
+            if (!psrc_roi) return true;
+            if (psrc_roi->x < 0 || psrc_roi->y < 0 || psrc_roi->width <= 0 || psrc_roi->height <= 0 ||
+                psrc_roi->x + psrc_roi->width > image_size.width || psrc_roi->y + psrc_roi->height > image_size.height) return false;
+            psrc = (const unsigned short*)((const unsigned char*)psrc + psrc_roi->y * src_step) + psrc_roi->x;
+            rowUV += psrc_roi->y * image_size.width + psrc_roi->x;
+            process_size.width = psrc_roi->width;
+            process_size.height = psrc_roi->height;
+            return true;
+        }
+
         static status r_own_iuvmap_invertor(const pointF32 *uvmap, int uvmap_step, sizeI32 uvmap_size, rect uvmap_roi,
-                                            pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold);
+                                            pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold,
+                                            int uvinv_roi_is_compact);
 
 
         math_projection::math_projection() {}
@@ -178,20 +237,7 @@ namespace rs
 
                     if( distortion_dst )
                     {
-                        double r2  = u * u + v * v;
-                        double r4  = r2 * r2;
-                        fDist = 1.f + distortion_dst[0] * r2 + distortion_dst[1] * r4 + distortion_dst[4] * r2 * r4;
-                        if( distortion_dst[2] != 0 )
-                        {
-                            r4  = 2.f * u * v;
-                            u = u * fDist + distortion_dst[2] * r4 + distortion_dst[3] * (r2 + 2.f * u * u);
-                            v = v * fDist + distortion_dst[3] * r4 + distortion_dst[2] * (r2 + 2.f * v * v);
-                        }
-                        else
-                        {
-                            u *= fDist;
-                            v *= fDist;
-                        }
+                        own_distort(u, v, distortion_dst);
                     }
 
                     dst[0] = static_cast<float>(u * camera_dst[0] + camera_dst[1]);
@@ -208,7 +254,8 @@ namespace rs
         //Added
         #pragma vector
         status REFCALL math_projection::rs_projection_16u32f_c1cxr(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
-                float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec)
+                float rotation[9], float translation[3], float distortion_dst[5], float camera_dst[4], const projection_spec_32f *pspec,
+                const distortion_lut_32f *pdistortion_lut, const rect *psrc_roi)
         {
             if(psrc == 0 || pdst == 0 || pspec == 0) return status::status_handle_invalid;
             if (roi_size.width <= 0 || roi_size.height <= 0) return status::status_data_not_initialized;
@@ -217,19 +264,21 @@ namespace rs
             if( roi_size.width != context_roi_size.width || roi_size.height != context_roi_size.height ) return status::status_param_unsupported ;
             status sts = status::status_no_error;
 
+            const pointF32 *rowUV = 0;
+            sizeI32 process_size = roi_size;
+            if (!own_select_roi(psrc, src_step, roi_size, psrc_roi, pspec, rowUV, process_size)) return status::status_param_unsupported;
+            const int rowUV_skip = roi_size.width - process_size.width;
+
             double u, v;
             float zPlane;
             int dstPi_x = 3;
             if(camera_dst) dstPi_x = 2;
 
-            unsigned char* pbuffer = (unsigned char*)pspec + sizeof(float) * 16;
-            pointF32 *rowUV = (pointF32*)pbuffer;
-
-            for (int y = 0; y < roi_size.height; ++y)
+            for (int y = 0; y < process_size.height; ++y, rowUV += rowUV_skip)
             {
                 float* dst = (float*)((unsigned char*)pdst + y * dst_step);
                 unsigned short* src_value = (unsigned short*)psrc;
-                for (int x = 0; x < roi_size.width; ++x, rowUV++, dst += dstPi_x)
+                for (int x = 0; x < process_size.width; ++x, rowUV++, dst += dstPi_x)
                 {
                     if (src_value[x] == 0)
                     {
@@ -282,19 +331,9 @@ namespace rs
 
                         if( distortion_dst )
                         {
-                            double r2  = u * u + v * v;
-                            double r4  = r2 * r2;
-                            double fDist = 1.f + distortion_dst[0] * r2 + distortion_dst[1] * r4 + distortion_dst[4] * r2 * r4;
-                            if( distortion_dst[2] != 0 )
+                            if(!pdistortion_lut || !own_distort_lut(u, v, pdistortion_lut))
                             {
-                                r4  = 2.f * u * v;
-                                u = u * fDist + distortion_dst[2] * r4 + distortion_dst[3] * (r2 + 2.f * u * u);
-                                v = v * fDist + distortion_dst[3] * r4 + distortion_dst[2] * (r2 + 2.f * v * v);
-                            }
-                            else
-                            {
-                                u *= fDist;
-                                v *= fDist;
+                                own_distort(u, v, distortion_dst);
                             }
                         }
 
@@ -311,6 +350,68 @@ namespace rs
             return sts;
         }
 
+        //Added
+        status REFCALL math_projection::rs_vertices_16u32f_c3r(const unsigned short *psrc, sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                const projection_spec_32f *pspec, const rect *psrc_roi)
+        {
+            if(psrc == 0 || pdst == 0 || pspec == 0) return status::status_handle_invalid;
+            if (roi_size.width <= 0 || roi_size.height <= 0) return status::status_data_not_initialized;
+
+            sizeI32 context_roi_size = ((sizeI32*)pspec)[0];
+            if( roi_size.width != context_roi_size.width || roi_size.height != context_roi_size.height ) return status::status_param_unsupported ;
+
+            const pointF32 *rowUV = 0;
+            sizeI32 process_size = roi_size;
+            if (!own_select_roi(psrc, src_step, roi_size, psrc_roi, pspec, rowUV, process_size)) return status::status_param_unsupported;
+
+            // the rays are precomputed at init, so a vertex is the ray scaled by the depth value.
+            // zero depth gives a zero vertex without branching, which keeps the loop vectorizable.
+            for (int y = 0; y < process_size.height; ++y, rowUV += roi_size.width)
+            {
+                const unsigned short* src_value = (const unsigned short*)((const unsigned char*)psrc + y * src_step);
+                float* dst = (float*)((unsigned char*)pdst + y * dst_step);
+                for (int x = 0; x < process_size.width; ++x)
+                {
+                    float zPlane = static_cast<float>(src_value[x]);
+                    dst[3 * x + 0] = rowUV[x].x * zPlane;
+                    dst[3 * x + 1] = rowUV[x].y * zPlane;
+                    dst[3 * x + 2] = zPlane;
+                }
+            }
+            return status::status_no_error;
+        }
+
+        //Added
+        status REFCALL math_projection::rs_distortion_lut_init_32f(pointF32 range_min, pointF32 range_max, sizeI32 grid_size,
+                float distortion[5], distortion_lut_32f *plut)
+        {
+            if(distortion == 0 || plut == 0) return status::status_handle_invalid;
+            if(grid_size.width < 2 || grid_size.height < 2) return status::status_param_unsupported;
+            if(range_max.x <= range_min.x || range_max.y <= range_min.y) return status::status_param_unsupported;
+
+            double step_x = (double)(range_max.x - range_min.x) / (grid_size.width - 1);
+            double step_y = (double)(range_max.y - range_min.y) / (grid_size.height - 1);
+            plut->origin = range_min;
+            plut->inv_step.x = (float)(1. / step_x);
+            plut->inv_step.y = (float)(1. / step_y);
+            plut->grid_size = grid_size;
+            plut->nodes.resize(grid_size.width * grid_size.height);
+
+            pointF32 *node = plut->nodes.data();
+            for (int y = 0; y < grid_size.height; ++y)
+            {
+                for (int x = 0; x < grid_size.width; ++x, node++)
+                {
+                    double u = range_min.x + x * step_x;
+                    double v = range_min.y + y * step_y;
+                    own_distort(u, v, distortion);
+                    node->x = (float)u;
+                    node->y = (float)v;
+                }
+            }
+            return status::status_no_error;
+        }
+
         //Added
         status REFCALL math_projection::rs_projection_get_size_32f(sizeI32 roi_size, int *pspec_size)
         {
@@ -410,7 +511,29 @@ namespace rs
                 }
                 dst = (float*)((unsigned char*)dst + dst_step);
             }
-            return r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step, dst_size, uvinv_roi, units_is_relative, threshold);
+            return r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step, dst_size, uvinv_roi, units_is_relative, threshold, 0);
+        }
+
+        //Added
+        status REFCALL math_projection::rs_uvmap_invertor_roi_32f_c2r(const float *psrc, int src_step, sizeI32 src_size, rect src_roi,
+                float *pdst, int dst_step, sizeI32 dst_size, rect dst_roi, int dst_roi_is_compact, int units_is_relative, pointF32 threshold)
+        {
+            if (psrc == 0 || pdst == 0) return status::status_handle_invalid;
+            if (dst_roi.x < 0 || dst_roi.y < 0 || dst_roi.width <= 0 || dst_roi.height <= 0 ||
+                dst_roi.x + dst_roi.width > dst_size.width || dst_roi.y + dst_roi.height > dst_size.height) return status::status_param_unsupported;
+
+            // only the roi pixels are initialized and filled, the rest of a full size destination is left untouched
+            float *dst = dst_roi_is_compact ? pdst : (float*)((unsigned char*)pdst + dst_roi.y * dst_step) + dst_roi.x * 2;
+            for (int i = 0; i < dst_roi.height; ++i)
+            {
+                for (int j = 0; j < dst_roi.width * 2; ++j)
+                {
+                    dst[j] = -1.f;
+                }
+                dst = (float*)((unsigned char*)dst + dst_step);
+            }
+            return r_own_iuvmap_invertor((pointF32*)psrc, src_step, src_size, src_roi, (pointF32*)pdst, dst_step, dst_size, dst_roi, units_is_relative, threshold,
+                                         dst_roi_is_compact);
         }
 
         status REFCALL math_projection::rs_qr_decomp_m_64f(const double* psrc, int src_stride1, int src_stride2, double* pbuffer,
@@ -623,7 +746,8 @@ namespace rs
         }
 
         status r_own_iuvmap_invertor ( const pointF32 *uvmap, int uvmap_step, sizeI32 uvmap_size, rect uvmap_roi,
-                                       pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold )
+                                       pointF32 *uvInv, int uvinv_step, sizeI32 uvinv_size, rect uvinv_roi, int uvinv_units_is_relative, pointF32 threshold,
+                                       int uvinv_roi_is_compact )
         {
             typedef struct
             {
@@ -644,6 +768,9 @@ namespace rs
             int  ymin_uvinv_roi = uvinv_roi.y;
             int  xmax_uvinv_roi = uvinv_roi.x + uvinv_roi.width  - 1;
             int  ymax_uvinv_roi = uvinv_roi.y + uvinv_roi.height - 1;
+            // a compact destination holds the roi only, its first pixel is the roi origin
+            int  xdst_origin = uvinv_roi_is_compact ? uvinv_roi.x : 0;
+            int  ydst_origin = uvinv_roi_is_compact ? uvinv_roi.y : 0;
             int i_y, i_x;
 
             double x_norming = uvinv_units_is_relative?(1. / (double)uvmap_size.width):1.f;
@@ -766,7 +893,7 @@ namespace rs
                         d0 = dy3 * (p2[0] - xmin + 1) - dx3 * (p2[1] - ymin);
                         e0 = dy4 * (p3[0] - xmin + 1) - dx4 * (p3[1] - ymin);
 
-                        puvinv = ((unsigned char*)uvInv + ymin * uvinv_step);
+                        puvinv = ((unsigned char*)uvInv + (ymin - ydst_origin) * uvinv_step);
                         for (i_y = ymin ; i_y <= ymax ; ++i_y)
                         {
                             a1 = a0;
@@ -783,7 +910,7 @@ namespace rs
                                 c1 -= dy2;
                                 d1 -= dy3;
                                 e1 -= dy4;
-                                if (uvinv_ptr[i_x].x==-1)
+                                if (uvinv_ptr[i_x - xdst_origin].x==-1)
                                 {
                                     if( b1 >= 0 )
                                     {
@@ -791,13 +918,13 @@ namespace rs
                                         {
                                             if( c1 >= 0 )
                                             {
-                                                uvinv_ptr[i_x].x = (float)posC; uvinv_ptr[i_x].y = (float)posR;
+                                                uvinv_ptr[i_x - xdst_origin].x = (float)posC; uvinv_ptr[i_x - xdst_origin].y = (float)posR;
                                                 continue;
                                             }
                                         }
                                         if( d1 >= 0 ) {
                                             if( e1 >= 0 ) {
-                                                uvinv_ptr[i_x].x = (float)posC; uvinv_ptr[i_x].y = (float)posR;
+                                                uvinv_ptr[i_x - xdst_origin].x = (float)posC; uvinv_ptr[i_x - xdst_origin].y = (float)posR;
                                                 continue;
                                             }
                                         }
@@ -806,7 +933,7 @@ namespace rs
                                         {
                                             if( c1 < 0 )
                                             {
-                                                uvinv_ptr[i_x].x = (float)posC; uvinv_ptr[i_x].y = (float)posR;
+                                                uvinv_ptr[i_x - xdst_origin].x = (float)posC; uvinv_ptr[i_x - xdst_origin].y = (float)posR;
                                                 continue;
                                             }
                                         }
@@ -814,7 +941,7 @@ namespace rs
                                         {
                                             if( e1 < 0 )
                                             {
-                                                uvinv_ptr[i_x].x = (float)posC; uvinv_ptr[i_x].y = (float)posR;
+                                                uvinv_ptr[i_x - xdst_origin].x = (float)posC; uvinv_ptr[i_x - xdst_origin].y = (float)posR;
                                                 continue;
                                             }
                                         }
@@ -868,7 +995,7 @@ namespace rs
                         b0 = dy1 * (p1[0] - xmin + 1) - dx1 * (p1[1] - ymin);
                         c0 = dy2 * (p2[0] - xmin + 1) - dx2 * (p2[1] - ymin);
 
-                        puvinv = ((unsigned char*)uvInv + ymin * uvinv_step);
+                        puvinv = ((unsigned char*)uvInv + (ymin - ydst_origin) * uvinv_step);
                         for (i_y = ymin ; i_y <= ymax ; ++i_y)
                         {
                             a1 = a0;
@@ -881,14 +1008,14 @@ namespace rs
                                 a1 -= dy0;
                                 b1 -= dy1;
                                 c1 -= dy2;
-                                if (uvinv_ptr[i_x].x==-1) {
+                                if (uvinv_ptr[i_x - xdst_origin].x==-1) {
                                     if( a1 >= 0 )
                                     {
                                         if( b1 >= 0 )
                                         {
                                             if( c1 >= 0 )
                                             {
-                                                uvinv_ptr[i_x].x = (float)posC; uvinv_ptr[i_x].y = (float)posR;
+                                                uvinv_ptr[i_x - xdst_origin].x = (float)posC; uvinv_ptr[i_x - xdst_origin].y = (float)posR;
                                                 continue;
                                             }
                                         }
@@ -897,7 +1024,7 @@ namespace rs
                                         {
                                             if( c1 < 0 )
                                             {
-                                                uvinv_ptr[i_x].x = (float)posC; uvinv_ptr[i_x].y = (float)posR;
+                                                uvinv_ptr[i_x - xdst_origin].x = (float)posC; uvinv_ptr[i_x - xdst_origin].y = (float)posR;
                                                 continue;
                                             }
                                         }
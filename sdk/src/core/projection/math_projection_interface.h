@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #pragma once
+#include <vector>
 #include "rs/core/status.h"
 #include "rs/core/types.h"
 #include "math.h"
@@ -16,6 +17,16 @@ namespace rs
         struct projection_spec_32f;
         typedef struct projection_spec_32f projection_spec_32f;
 
+        /* Regular grid of distorted normalized coordinates, sampled over a range of undistorted normalized coordinates.
+           Used to replace the per pixel distortion polynomial with a bilinear interpolation. */
+        struct distortion_lut_32f
+        {
+            pointF32              origin;    /* undistorted normalized coordinates of the first grid node */
+            pointF32              inv_step;  /* number of grid steps per normalized unit along the x and y axes */
+            sizeI32               grid_size; /* number of grid nodes along the x and y axes */
+            std::vector<pointF32> nodes;     /* distorted normalized coordinates of the grid nodes, row major */
+        };
+
         class math_projection
         {
         public:
@@ -29,7 +40,14 @@ namespace rs
 
             rs::core::status REFCALL rs_projection_16u32f_c1cxr(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
                     float rotation[9], float translation[3], float distortion_dst[5],
-                    float camera_dst[4], const projection_spec_32f *pspec);
+                    float camera_dst[4], const projection_spec_32f *pspec, const distortion_lut_32f *pdistortion_lut = nullptr,
+                    const rs::core::rect *psrc_roi = nullptr);
+
+            rs::core::status REFCALL rs_vertices_16u32f_c3r(const unsigned short *psrc, rs::core::sizeI32 roi_size, int src_step, float *pdst, int dst_step,
+                    const projection_spec_32f *pspec, const rs::core::rect *psrc_roi = nullptr);
+
+            rs::core::status REFCALL rs_distortion_lut_init_32f(pointF32 range_min, pointF32 range_max, rs::core::sizeI32 grid_size,
+                    float distortion[5], distortion_lut_32f *plut);
 
             rs::core::status REFCALL rs_projection_get_size_32f(rs::core::sizeI32 roi_size, int *pspec_size);
 
@@ -43,6 +61,10 @@ namespace rs
             rs::core::status REFCALL rs_uvmap_invertor_32f_c2r(const float *psrc, int src_step, rs::core::sizeI32 src_size, rs::core::rect src_roi,
                     float *pdst, int dst_step, rs::core::sizeI32 dst_size, int units_is_relative, pointF32  threshold);
 
+            rs::core::status REFCALL rs_uvmap_invertor_roi_32f_c2r(const float *psrc, int src_step, rs::core::sizeI32 src_size, rs::core::rect src_roi,
+                    float *pdst, int dst_step, rs::core::sizeI32 dst_size, rs::core::rect dst_roi, int dst_roi_is_compact,
+                    int units_is_relative, pointF32  threshold);
+
             rs::core::status REFCALL rs_qr_decomp_m_64f(const double*  psrc,  int src_stride1, int src_stride2,
                     double*  pbuffer,
                     double*  pdst,  int dststride1, int dststride2,
@@ -15,6 +15,11 @@ using namespace rs::core;
 static void *aligned_malloc(size_t size);
 static void aligned_free(void *ptr);
 
+static inline bool is_roi_inside(const rect &roi, int width, int height)
+{
+    return roi.x >= 0 && roi.y >= 0 && roi.width > 0 && roi.height > 0 && roi.x + roi.width <= width && roi.y + roi.height <= height;
+}
+
 #define x64_ALIGNMENT(x) (((x)+0x3f)&0xffffffc0)
 
 
@@ -258,6 +263,14 @@ namespace rs
 
         // Query Map/Vertices
         status  ds4_projection::query_uvmap(image_interface *depth, pointF32 *uvmap)
+        {
+            if (!depth) return status::status_handle_invalid;
+            rect full_roi = { 0, 0, depth->query_info().width, depth->query_info().height };
+            return query_uvmap_roi(depth, full_roi, uvmap, true);
+        }
+
+
+        status  ds4_projection::query_uvmap_roi(image_interface *depth, rect roi, pointF32 *uvmap, bool full_frame_output)
         {
             if (!depth) return status::status_handle_invalid;
             if (!uvmap) return status::status_handle_invalid;
@@ -268,15 +281,18 @@ namespace rs
             {
                 return status::status_data_not_initialized;
             }
-            int dst_pitches = info.width * get_pixel_size(pixel_format::bgra8) * 2;
+            if (!is_roi_inside(roi, info.width, info.height)) return status::status_param_unsupported;
+            int dst_pitches = (full_frame_output ? info.width : roi.width) * get_pixel_size(pixel_format::bgra8) * 2;
+            if (full_frame_output) uvmap += roi.y * info.width + roi.x;
             sizeI32 depth_size = { info.width, info.height };
+            sizeI32 roi_size = { roi.width, roi.height };
             float inv_width = 1.f / (float)m_color_size.width;
             float inv_height = 1.f / (float)m_color_size.height;
             float cameraC[4] = { m_camera_color_params[0] * inv_width, m_camera_color_params[1] * inv_width, m_camera_color_params[2] * inv_height, m_camera_color_params[3] * inv_height };
             if (m_is_color_rectified)
             {
-                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)uvmap, dst_pitches,
-                        0, m_translation, 0, cameraC, (const projection_spec_32f*)m_projection_spec))
+                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, info.pitch, (float*)uvmap, dst_pitches,
+                        0, m_translation, 0, cameraC, (const projection_spec_32f*)m_projection_spec, nullptr, &roi))
                 {
                     return status::status_feature_unsupported;
                 }
@@ -284,22 +300,30 @@ namespace rs
             else
             {
                 // if color image is not rectified, we should assume rotation and distorsion of the image
-                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)uvmap, dst_pitches,
-                        m_rotation, m_translation, m_distorsion_color_coeffs, cameraC, (const projection_spec_32f*)m_projection_spec))
+                if (status::status_param_unsupported  == m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, info.pitch, (float*)uvmap, dst_pitches,
+                        m_rotation, m_translation, m_distorsion_color_coeffs, cameraC, (const projection_spec_32f*)m_projection_spec, nullptr, &roi))
                 {
                     return status::status_feature_unsupported;
                 }
             }
-            m_math_projection.rs_uvmap_filter_32f_c2ir((float*)uvmap, dst_pitches, depth_size, 0, 0, 0 );
+            m_math_projection.rs_uvmap_filter_32f_c2ir((float*)uvmap, dst_pitches, roi_size, 0, 0, 0 );
             return status::status_no_error;
         }
 
 
         status  ds4_projection::query_invuvmap(image_interface *depth, pointF32 *inv_uvmap)
+        {
+            rect full_roi = { 0, 0, m_color_size.width, m_color_size.height };
+            return query_invuvmap_roi(depth, full_roi, inv_uvmap, true);
+        }
+
+
+        status  ds4_projection::query_invuvmap_roi(image_interface *depth, rect roi, pointF32 *inv_uvmap, bool full_frame_output)
         {
             if (!inv_uvmap) return status::status_handle_invalid;
             if (!depth) return status::status_handle_invalid;
             if (m_initialize_status != initialize_status::both_initialized) return status::status_data_unavailable;
+            if (!is_roi_inside(roi, m_color_size.width, m_color_size.height)) return status::status_param_unsupported;
             std::vector<pointF32> uvmap(depth->query_info().width * depth->query_info().height);
             if (status::status_no_error > query_uvmap(depth, uvmap.data()))
                 return status::status_data_unavailable;
@@ -309,13 +333,23 @@ namespace rs
             sizeI32 color_size = { m_color_size.width, m_color_size.height };
             rect uvMapRoi = { 0, 0, info.width, info.height };
             pointF32 threshold = {4.f + (float)color_size.width/(float)depth_size.width, 4.f + (float)color_size.height/(float)depth_size.height};
-            if(status::status_no_error != m_math_projection.rs_uvmap_invertor_32f_c2r((float*)uvmap.data(), src_pitches, depth_size, uvMapRoi, (float*)inv_uvmap, color_size.width * static_cast<int>(sizeof(pointF32)), color_size, 1, threshold))
+            int dst_pitches = (full_frame_output ? color_size.width : roi.width) * static_cast<int>(sizeof(pointF32));
+            if(status::status_no_error != m_math_projection.rs_uvmap_invertor_roi_32f_c2r((float*)uvmap.data(), src_pitches, depth_size, uvMapRoi, (float*)inv_uvmap, dst_pitches, color_size,
+                                                                                          roi, full_frame_output ? 0 : 1, 1, threshold))
                 return status::status_feature_unsupported;
             return status::status_no_error;
         }
 
 
         status  ds4_projection::query_vertices(image_interface *depth, point3dF32 *vertices)
+        {
+            if (!depth) return status::status_handle_invalid;
+            rect full_roi = { 0, 0, depth->query_info().width, depth->query_info().height };
+            return query_vertices_roi(depth, full_roi, vertices, true);
+        }
+
+
+        status  ds4_projection::query_vertices_roi(image_interface *depth, rect roi, point3dF32 *vertices, bool full_frame_output)
         {
             if (!depth) return status::status_handle_invalid;
             if (!vertices) return status::status_handle_invalid;
@@ -323,9 +357,13 @@ namespace rs
             image_info info = depth->query_info();
             const void* data = depth->query_data();
             if (!data) return status::status_data_unavailable;
+            if (!is_roi_inside(roi, info.width, info.height)) return status::status_param_unsupported;
             sizeI32 depth_size = { info.width, info.height };
-            m_math_projection.rs_projection_16u32f_c1cxr((const unsigned short*)data, depth_size, depth->query_info().pitch, (float*)vertices, depth_size.width * static_cast<int>(sizeof(point3dF32)),
-                    0, 0, 0, 0, (const projection_spec_32f*)m_projection_spec);
+            int dst_pitches = (full_frame_output ? info.width : roi.width) * static_cast<int>(sizeof(point3dF32));
+            if (full_frame_output) vertices += roi.y * info.width + roi.x;
+            status sts = m_math_projection.rs_vertices_16u32f_c3r((const unsigned short*)data, depth_size, info.pitch, (float*)vertices, dst_pitches,
+                    (const projection_spec_32f*)m_projection_spec, &roi);
+            if (sts != status::status_no_error) return status::status_param_unsupported;
             return status::status_no_error;
         }
 
@@ -77,6 +77,9 @@ namespace rs
             virtual status query_uvmap(image_interface *depth, pointF32 *uvmap);
             virtual status query_invuvmap(image_interface *depth, pointF32 *inv_uvmap);
             virtual status query_vertices(image_interface *depth, point3dF32 *vertices);
+            virtual status query_uvmap_roi(image_interface *depth, rect roi, pointF32 *uvmap, bool full_frame_output);
+            virtual status query_invuvmap_roi(image_interface *depth, rect roi, pointF32 *inv_uvmap, bool full_frame_output);
+            virtual status query_vertices_roi(image_interface *depth, rect roi, point3dF32 *vertices, bool full_frame_output);
             virtual image_interface* create_color_image_mapped_to_depth(image_interface *depth, image_interface *color);
             virtual image_interface* create_depth_image_mapped_to_color(image_interface *depth, image_interface *color);
 
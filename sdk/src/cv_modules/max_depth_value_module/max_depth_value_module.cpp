@@ -12,8 +12,10 @@ namespace rs
 {
     namespace cv_modules
     {
-        max_depth_value_module::max_depth_value_module(uint64_t milliseconds_added_to_simulate_larger_computation_time, bool is_async_processing):
-            m_pimpl(new max_depth_value_module_impl(milliseconds_added_to_simulate_larger_computation_time, is_async_processing))
+        max_depth_value_module::max_depth_value_module(uint64_t milliseconds_added_to_simulate_larger_computation_time, bool is_async_processing,
+                                                       uint32_t workers_count, uint32_t input_queue_size):
+            m_pimpl(new max_depth_value_module_impl(milliseconds_added_to_simulate_larger_computation_time, is_async_processing,
+                                                    workers_count, input_queue_size))
         {}
 
         int32_t max_depth_value_module::query_module_uid()
@@ -66,6 +68,16 @@ namespace rs
             return m_pimpl->get_max_depth_value_data();
         }
 
+        async_processing_statistics max_depth_value_module::query_processing_statistics()
+        {
+            return m_pimpl->query_processing_statistics();
+        }
+
+        async_video_module_timing max_depth_value_module::query_processing_timing()
+        {
+            return m_pimpl->query_processing_timing();
+        }
+
         max_depth_value_module::~max_depth_value_module()
         {
             delete m_pimpl;
@@ -5,6 +5,7 @@
 #include <thread>
 #include <cstring>
 #include <vector>
+#include <algorithm>
 
 #include "max_depth_value_module_impl.h"
 #include "rs/utils/log_utils.h"
@@ -18,21 +19,25 @@ namespace rs
 {
     namespace cv_modules
     {
-        max_depth_value_module_impl::max_depth_value_module_impl(uint64_t milliseconds_added_to_simulate_larger_computation_time, bool is_async_processing):
+        max_depth_value_module_impl::max_depth_value_module_impl(uint64_t milliseconds_added_to_simulate_larger_computation_time, bool is_async_processing,
+                                                                 uint32_t workers_count, uint32_t input_queue_size):
+            async_video_module_base(is_async_processing, workers_count, input_queue_size),
             m_current_module_config({}),
-            m_processing_handler(nullptr),
-            m_is_closing(false),
             m_output_data({}),
-            m_input_depth_image(nullptr),
             m_milliseconds_added_to_simulate_larger_computation_time(milliseconds_added_to_simulate_larger_computation_time)
         {
             m_unique_module_id = CONSTRUCT_UID('M', 'A', 'X', 'D');
-            m_async_processing = is_async_processing;
 
             //this cv module doesn't require any time syncing of samples
             m_time_sync_mode = supported_module_config::time_sync_mode::sync_not_required;
 
-            m_processing_thread = std::thread(&max_depth_value_module_impl::async_processing_loop, this);
+            //the hardware threads are split between the workers, each worker reduces its image with its own statistics instance
+            const uint32_t hardware_threads = std::max<uint32_t>(std::thread::hardware_concurrency(), 1);
+            for(uint32_t worker_index = 0; worker_index < query_workers_count(); worker_index++)
+            {
+                m_depth_statistics.push_back(get_unique_ptr_with_releaser(
+                    rs::utils::depth_statistics_interface::create_instance(std::max<uint32_t>(hardware_threads / query_workers_count(), 1))));
+            }
         }
 
         int32_t max_depth_value_module_impl::query_module_uid()
@@ -51,8 +56,8 @@ namespace rs
             supported_config = {};
 
             //concurrent_samples_count means the max number of concurrent samples this module might handle,
-            //this code sample uses a single image at a time, meaning a maximum of 1 concurrent samples.
-            supported_config.concurrent_samples_count = 1;
+            //this code sample holds the images waiting in the input queue and an image per worker.
+            supported_config.concurrent_samples_count = m_async_processing ? query_input_queue_size() + query_workers_count() : 1;
 
             //the module input configuration for time syncing of incoming samples.
             supported_config.samples_time_sync_mode = m_time_sync_mode;
@@ -92,61 +97,24 @@ namespace rs
             return status_no_error;
         }
 
-        status max_depth_value_module_impl::process_sample_set(const correlated_sample_set & sample_set)
-        {
-            //get a unique managed ownership of the image by calling add_ref and wrapping the it with a unique_ptr
-            //with a custom deleter which calls release.
-            rs::utils::unique_ptr<image_interface> depth_image = sample_set.get_unique(stream_type::depth);
-
-            if(!depth_image)
-            {
-                return status_item_unavailable;
-            }
-
-            if(m_async_processing)
-            {
-                m_input_depth_image.set(std::move(depth_image));
-            }
-            else
-            {
-                max_depth_value_output_interface::max_depth_value_output_data output_data = {};
-                auto status = process_depth_max_value(std::move(depth_image), output_data);
-                if(status < status_no_error)
-                {
-                    return status;
-                }
-                m_output_data.set(output_data);
-            }
-            return status_no_error;
-        }
-
-        status max_depth_value_module_impl::register_event_handler(video_module_interface::processing_event_handler *handler)
+        status max_depth_value_module_impl::check_sample_set(const correlated_sample_set & sample_set)
         {
-            std::unique_lock<std::mutex> lock(m_processing_handler_lock);
-            if(m_processing_handler != nullptr)
-            {
-                return status_handle_invalid;
-            }
-            m_processing_handler = handler;
-            return status_no_error;
+            return sample_set[stream_type::depth] ? status_no_error : status_item_unavailable;
         }
 
-        status max_depth_value_module_impl::unregister_event_handler(video_module_interface::processing_event_handler *handler)
+        status max_depth_value_module_impl::process_sample(uint32_t worker_index, const correlated_sample_set & sample_set,
+                                                           max_depth_value_output_data & output_data)
         {
-            std::unique_lock<std::mutex> lock(m_processing_handler_lock);
-            if(m_processing_handler != handler)
-            {
-                return status_handle_invalid;
-            }
-
-            m_processing_handler = nullptr;
-            return status_no_error;
+            //get a unique managed ownership of the image by calling add_ref and wrapping the it with a unique_ptr
+            //with a custom deleter which calls release.
+            std::shared_ptr<image_interface> depth_image = sample_set.get_unique(stream_type::depth);
+            return process_depth_max_value(depth_image, output_data, worker_index);
         }
 
-        rs::core::status max_depth_value_module_impl::flush_resources()
+        void max_depth_value_module_impl::on_output(max_depth_value_output_data & output_data)
         {
-            m_input_depth_image.set(nullptr);
-            return status_no_error;
+            //the base class emits the outputs one at a time, in the order of the input images
+            m_output_data.set(output_data);
         }
 
         rs::core::status max_depth_value_module_impl::reset_config()
@@ -161,7 +129,8 @@ namespace rs
 
         status max_depth_value_module_impl::process_depth_max_value(
                 std::shared_ptr<core::image_interface> depth_image,
-                max_depth_value_output_interface::max_depth_value_output_data & output_data)
+                max_depth_value_output_interface::max_depth_value_output_data & output_data,
+                uint32_t worker_index)
         {
             if(!depth_image)
             {
@@ -173,23 +142,14 @@ namespace rs
             //protect algorithm exception safety
             try
             {
-                const uint8_t * current_pixel = static_cast<const uint8_t * >(depth_image->query_data());
-                auto depth_image_info = depth_image->query_info();
-
-                for(auto y = 0; y < depth_image_info.height; y++)
+                rs::utils::depth_statistics depth_statistics = {};
+                auto status = m_depth_statistics[worker_index]->query_statistics(depth_image.get(), nullptr, depth_statistics);
+                if(status < status_no_error)
                 {
-                    for(auto x = 0; x < depth_image_info.width; x+=2)
-                    {
-                        auto pixel_with_pitch_allignment = y * depth_image_info.pitch + x;
-                        //combine 2 uint8_t to uint16_t
-                        uint16_t current_pixel_value =  static_cast<uint16_t>(current_pixel[pixel_with_pitch_allignment] | current_pixel[pixel_with_pitch_allignment + 1] << 8);
-
-                        if(current_pixel_value > max_depth_value)
-                        {
-                            max_depth_value = current_pixel_value ;
-                        }
-                    }
+                    LOG_ERROR("failed to compute the depth statistics, error code :" << status);
+                    return status;
                 }
+                max_depth_value = depth_statistics.max_depth;
 
                 //simulate larger computation time
                 std::this_thread::sleep_for(std::chrono::milliseconds(m_milliseconds_added_to_simulate_larger_computation_time));
@@ -204,43 +164,10 @@ namespace rs
             return status_no_error;
         }
 
-        void max_depth_value_module_impl::async_processing_loop()
-        {
-            while(!m_is_closing)
-            {
-                auto current_depth_image = m_input_depth_image.blocking_get();
-
-                if(!current_depth_image)
-                {
-                    LOG_INFO("Got null imput depth image");
-                    continue;
-                }
-
-                max_depth_value_output_interface::max_depth_value_output_data output_data;
-                auto status = process_depth_max_value(std::move(current_depth_image), output_data);
-                if(status < status_no_error)
-                {
-                    LOG_INFO("failed to process max value, error code :" << status);
-                    continue;
-                }
-                m_output_data.set(output_data);
-
-                std::unique_lock<std::mutex> lock(m_processing_handler_lock);
-                if(m_processing_handler)
-                {
-                    m_processing_handler->module_output_ready(this, nullptr);
-                }
-            }
-        }
-
         max_depth_value_module_impl::~max_depth_value_module_impl()
         {
-            m_is_closing = true;
-            m_input_depth_image.set(nullptr);
-            if(m_processing_thread.joinable())
-            {
-                m_processing_thread.join();
-            }
+            //stop the workers before the members they use are destroyed
+            stop_processing();
 
             max_depth_value_output_interface::max_depth_value_output_data empty_output_data = {};
             m_output_data.set(empty_output_data);
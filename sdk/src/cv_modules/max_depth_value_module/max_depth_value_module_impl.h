@@ -5,8 +5,11 @@
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <vector>
+#include <memory>
 
 #include "rs/cv_modules/max_depth_value_module/max_depth_value_output_interface.h"
+#include "rs/utils/async_video_module_base.h"
 #include "rs_core.h"
 #include "rs_utils.h"
 
@@ -27,8 +30,9 @@ namespace rs
         /**
          * @brief The max_depth_value_module_impl class
          * an example computer vision module that calculates the max depth value.
+         * The async processing flow is implemented by the base class, the module implements the per sample computation.
          */
-        class DLL_EXPORT max_depth_value_module_impl : public rs::core::video_module_interface,
+        class DLL_EXPORT max_depth_value_module_impl : public rs::utils::async_video_module_base<max_depth_value_output_interface::max_depth_value_output_data>,
                                                        public max_depth_value_output_interface
         {
         public:
@@ -38,7 +42,9 @@ namespace rs
             max_depth_value_module_impl & operator=(max_depth_value_module_impl && other) = delete;
 
             max_depth_value_module_impl(uint64_t milisenconds_added_to_simulate_larger_computation_time = 0,
-                                        bool is_async_processing = true);
+                                        bool is_async_processing = true,
+                                        uint32_t workers_count = 1,
+                                        uint32_t input_queue_size = 1);
 
             // video_module_interface impl
             int32_t query_module_uid() override;
@@ -46,10 +52,6 @@ namespace rs
                     rs::core::video_module_interface::supported_module_config &supported_config) override;
             rs::core::status query_current_module_config(rs::core::video_module_interface::actual_module_config &module_config) override;
             rs::core::status set_module_config(const rs::core::video_module_interface::actual_module_config &module_config) override;
-            rs::core::status process_sample_set(const rs::core::correlated_sample_set& sample_set) override;
-            rs::core::status register_event_handler(rs::core::video_module_interface::processing_event_handler *handler) override;
-            rs::core::status unregister_event_handler(rs::core::video_module_interface::processing_event_handler *handler) override;
-            rs::core::status flush_resources() override;
             rs::core::status reset_config() override;
 
             // max_depth_value_module_output_interface impl
@@ -59,11 +61,20 @@ namespace rs
 
         protected:
             int32_t m_unique_module_id;
-            bool m_async_processing;
             video_module_interface::supported_module_config::time_sync_mode m_time_sync_mode;
             rs::core::video_module_interface::actual_module_config m_current_module_config;
 
-            rs::core::status process_depth_max_value(std::shared_ptr<core::image_interface> depth_image, max_depth_value_output_data & output_data);
+            // async_video_module_base impl
+            rs::core::status check_sample_set(const rs::core::correlated_sample_set & sample_set) override;
+            rs::core::status process_sample(uint32_t worker_index, const rs::core::correlated_sample_set & sample_set,
+                                            max_depth_value_output_data & output_data) override;
+            void on_output(max_depth_value_output_data & output_data) override;
+
+            rs::core::status process_depth_max_value(std::shared_ptr<core::image_interface> depth_image, max_depth_value_output_data & output_data,
+                                                     uint32_t worker_index = 0);
+
+            //one instance per worker, since the statistics instance isn't thread safe
+            std::vector<rs::utils::unique_ptr<rs::utils::depth_statistics_interface>> m_depth_statistics;
 
             //internal class to handle a single object non blocking set and blocked get.
             template <typename T>
@@ -110,18 +121,10 @@ namespace rs
                 bool m_is_object_ready;
             };
 
-            thread_safe_object<std::shared_ptr<rs::core::image_interface>> m_input_depth_image;
             thread_safe_object<max_depth_value_output_data> m_output_data;
 
         private:
             const uint64_t m_milliseconds_added_to_simulate_larger_computation_time;
-            std::mutex m_processing_handler_lock;
-            rs::core::video_module_interface::processing_event_handler * m_processing_handler;
-
-            //thread for handling inputs throughput in async flow
-            std::thread m_processing_thread;
-            void async_processing_loop();
-            bool m_is_closing;
         };
     }
 }
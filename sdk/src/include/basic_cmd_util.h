@@ -45,7 +45,10 @@ namespace rs
             bool is_real_time();
             bool is_print_file_info();
             bool is_rendering_enabled();
+            uint32_t get_render_rate();
+            uint32_t get_render_decimation_factor();
             bool is_motion_enabled();
+            bool is_benchmark_enabled();
             streaming_mode get_streaming_mode();
             std::string get_file_path(streaming_mode sm);
             std::string get_file_info();
@@ -0,0 +1,133 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <condition_variable>
+
+namespace rs
+{
+    namespace utils
+    {
+        /**
+        * @brief Persistent thread pool for per row image processing.
+        *
+        * The rows range is split to one contiguous band per thread, the calling thread processes the first band and waits
+        * for the other bands. The worker threads are created once and reused by every call, so a call doesn't create threads.
+        * Calls should not be made concurrently.
+        */
+        class parallel_rows
+        {
+        public:
+            typedef std::function<void(int32_t first_row, int32_t last_row, uint32_t band)> task_type;
+
+            explicit parallel_rows(uint32_t threads_count) :
+                m_threads_count(threads_count),
+                m_task(nullptr),
+                m_task_rows(0),
+                m_task_id(0),
+                m_pending_bands(0),
+                m_stop_workers(false)
+            {
+                if(m_threads_count == 0)
+                    m_threads_count = std::max(1u, std::thread::hardware_concurrency());
+                for(uint32_t band = 1; band < m_threads_count; band++)
+                {
+                    m_workers.push_back(std::thread(&parallel_rows::worker_thread, this, band));
+                }
+            }
+
+            parallel_rows(const parallel_rows &) = delete;
+            parallel_rows & operator=(const parallel_rows &) = delete;
+
+            ~parallel_rows()
+            {
+                {
+                    std::lock_guard<std::mutex> guard(m_task_mutex);
+                    m_stop_workers = true;
+                }
+                m_task_cv.notify_all();
+                for(auto & worker : m_workers)
+                {
+                    if(worker.joinable())
+                        worker.join();
+                }
+            }
+
+            uint32_t threads_count() const { return m_threads_count; }
+
+            //runs the task on all the bands and returns when all of them are done
+            void run(int32_t rows, const task_type & task)
+            {
+                if(m_workers.empty())
+                {
+                    task(0, rows, 0);
+                    return;
+                }
+
+                {
+                    std::lock_guard<std::mutex> guard(m_task_mutex);
+                    m_task = &task;
+                    m_task_rows = rows;
+                    m_pending_bands = static_cast<uint32_t>(m_workers.size());
+                    m_task_id++;
+                }
+                m_task_cv.notify_all();
+
+                task(0, band_first_row(rows, 1), 0);
+
+                std::unique_lock<std::mutex> lock(m_task_mutex);
+                m_task_done_cv.wait(lock, [this]() { return m_pending_bands == 0; });
+                m_task = nullptr;
+            }
+
+        private:
+            int32_t band_first_row(int32_t rows, uint32_t band) const
+            {
+                return static_cast<int32_t>(static_cast<int64_t>(rows) * band / m_threads_count);
+            }
+
+            void worker_thread(uint32_t band)
+            {
+                uint64_t last_task_id = 0;
+                while(true)
+                {
+                    const task_type * task = nullptr;
+                    int32_t rows = 0;
+                    {
+                        std::unique_lock<std::mutex> lock(m_task_mutex);
+                        m_task_cv.wait(lock, [this, last_task_id]() { return m_stop_workers || m_task_id != last_task_id; });
+                        if(m_stop_workers)
+                            return;
+                        last_task_id = m_task_id;
+                        task = m_task;
+                        rows = m_task_rows;
+                    }
+
+                    (*task)(band_first_row(rows, band), band_first_row(rows, band + 1), band);
+
+                    {
+                        std::lock_guard<std::mutex> guard(m_task_mutex);
+                        m_pending_bands--;
+                    }
+                    m_task_done_cv.notify_one();
+                }
+            }
+
+            std::vector<std::thread>    m_workers;
+            uint32_t                    m_threads_count;
+            std::mutex                  m_task_mutex; //protects m_task, m_task_rows, m_task_id, m_pending_bands, m_stop_workers
+            std::condition_variable     m_task_cv;
+            std::condition_variable     m_task_done_cv;
+            const task_type *           m_task;
+            int32_t                     m_task_rows;
+            uint64_t                    m_task_id;
+            uint32_t                    m_pending_bands;
+            bool                        m_stop_workers;
+        };
+    }
+}
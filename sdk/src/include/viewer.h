@@ -13,6 +13,8 @@
 #include <tuple>
 #include <functional>
 #include <atomic>
+#include <vector>
+#include "rs/utils/performance_counters.h"
 
 //opengl api
 #define GLFW_INCLUDE_GLU
@@ -41,19 +43,37 @@ namespace rs
 
             ~viewer();
 
+            /**
+            * @brief Queues an image for display and returns without waiting for the rendering.
+            *
+            * Only the latest image of each stream is kept, an image which was not rendered yet is replaced.
+            */
             void show_image(const rs::core::image_interface * image);
             void show_image(std::shared_ptr<rs::core::image_interface> image);
 
+            /**
+            * @brief Limits the rate of the window updates, independently of the streams rates.
+            * @param[in] max_render_rate    Maximal updates per second, 0 renders every image
+            */
+            void set_max_render_rate(uint32_t max_render_rate);
+
+            /**
+            * @brief Downscales the images on the viewer thread before the upload, keeping every factor-th pixel in each dimension.
+            * @param[in] decimation_factor  Factor of the downscale, 1 renders the full resolution
+            */
+            void set_decimation_factor(uint32_t decimation_factor);
+
         private:
             void setup_window(uint32_t width, uint32_t height, std::string window_title);
             void render_image(std::shared_ptr<rs::core::image_interface> image);
-            void draw(const rs::core::image_interface * image, int gl_format, int gl_channel_type);
+            void draw(rs::core::stream_type stream, int width, int height, const void * data, int gl_format, int gl_channel_type);
             void ui_refresh();
             void update_buffer(std::shared_ptr<rs::core::image_interface>& image);
             bool add_window(rs::core::stream_type stream);
+            const uint8_t * decimate(const rs::core::image_interface * image, uint32_t bytes_per_pixel, uint32_t decimation_factor);
 
             int_pair calc_grid(size_t width, size_t height, size_t streams);
-            std::pair<int_pair, int_pair> calc_window_size(const core::image_interface *image);
+            std::pair<int_pair, int_pair> calc_window_size(rs::core::stream_type stream, int image_width, int image_height);
             std::map<rs::core::stream_type, std::shared_ptr<rs::core::image_interface>> m_render_buffer;
             uint32_t m_width;
             uint32_t m_height;
@@ -66,6 +86,14 @@ namespace rs
             size_t m_stream_count;
             std::map<rs::core::stream_type, size_t> m_windows_positions;
             std::atomic<bool> m_is_running;
+            std::atomic<uint32_t> m_max_render_rate;
+            std::atomic<uint32_t> m_decimation_factor;
+            std::vector<uint8_t> m_decimated_data; //used by the ui thread only
+
+            rs::utils::performance_histogram & m_show_image_time_histogram;
+            rs::utils::performance_histogram & m_convert_time_histogram;
+            rs::utils::performance_counter & m_replaced_images_counter;
+            rs::utils::performance_counter & m_rendered_images_counter;
         };
     }
 }
@@ -6,9 +6,13 @@
 #include <iostream>
 #include <chrono>
 #include <thread>
+#include <ctime>
 #include <signal.h>
 #include <stdlib.h>
 #include <stdio.h>
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
 #include <librealsense/rs.hpp>
 #include "rs_core.h"
 #include "rs/core/context_interface.h"
@@ -19,6 +23,7 @@
 #include "basic_cmd_util.h"
 #include "viewer.h"
 #include "rs/utils/librealsense_conversion_utils.h"
+#include "rs/utils/performance_counters.h"
 #include "rs_sdk_version.h"
 
 using namespace std;
@@ -54,13 +59,24 @@ auto g_frame_callback = [](rs::frame frame)
 
 auto g_motion_callback = [](rs::motion_data motion){};
 
-std::shared_ptr<context_interface> create_context(basic_cmd_util cl_util)
+std::shared_ptr<context_interface> create_context(basic_cmd_util cl_util, rs::playback::device * &playback_device)
 {
     switch(cl_util.get_streaming_mode())
     {
         case streaming_mode::live: return std::shared_ptr<context_interface>(new context());
         case streaming_mode::record: return std::shared_ptr<context_interface>(new rs::record::context(cl_util.get_file_path(streaming_mode::record).c_str()));
-        case streaming_mode::playback: return std::shared_ptr<context_interface>(new rs::playback::context(cl_util.get_file_path(streaming_mode::playback).c_str()));
+        case streaming_mode::playback:
+        {
+            auto playback_context = std::make_shared<rs::playback::context>(cl_util.get_file_path(streaming_mode::playback).c_str());
+            playback_device = playback_context->get_playback_device();
+            auto record_file_path = cl_util.get_file_path(streaming_mode::record);
+            if(record_file_path.empty())
+                return playback_context;
+
+            //re-record the playback, the deleter releases the playback context after the record context
+            return std::shared_ptr<context_interface>(new rs::record::context(record_file_path.c_str(), *playback_context),
+                                                      [playback_context](context_interface * record_context) { delete record_context; });
+        }
     }
     return nullptr;
 }
@@ -98,13 +114,13 @@ std::string pixel_format_to_string(rs::format format)
     }
 }
 
-void configure_device(rs::device* device, basic_cmd_util cl_util, std::shared_ptr<viewer> &renderer)
+void configure_device(rs::device* device, rs::playback::device* playback_device, basic_cmd_util cl_util, std::shared_ptr<viewer> &renderer)
 {
     const int window_width = 640;
     const int window_height = 480;
     auto streams = cl_util.get_enabled_streams();
     auto is_playback = cl_util.get_streaming_mode() == streaming_mode::playback;
-    auto is_record = cl_util.get_streaming_mode() == streaming_mode::record;
+    auto is_record = !cl_util.get_file_path(streaming_mode::record).empty();
     std::cout << "enabled streams:" << std::endl;
     for(auto stream : streams)
     {
@@ -142,9 +158,9 @@ void configure_device(rs::device* device, basic_cmd_util cl_util, std::shared_pt
 
     }
 
-    if(is_playback)
+    if(is_playback && playback_device)
     {
-        static_cast<rs::playback::device*>(device)->set_real_time(g_cmd.is_real_time());
+        playback_device->set_real_time(g_cmd.is_real_time());
     }
 
     if(g_cmd.is_motion_enabled())
@@ -167,6 +183,45 @@ void configure_device(rs::device* device, basic_cmd_util cl_util, std::shared_pt
 
             g_streaming_cv.notify_one();
         });
+        renderer->set_max_render_rate(cl_util.get_render_rate());
+        renderer->set_decimation_factor(cl_util.get_render_decimation_factor());
+    }
+}
+
+void print_benchmark_results(double duration, double cpu_time)
+{
+    std::cout << "benchmark results:" << std::endl;
+    std::cout << "\tduration: " << duration << " seconds" << std::endl;
+    for(auto frame_count : g_frame_count)
+    {
+        std::cout << "\t" << stream_type_to_string(frame_count.first) <<
+                     " - frames: " << frame_count.second <<
+                     ", fps: " << (duration > 0 ? frame_count.second / duration : 0) << std::endl;
+    }
+    std::cout << "\tcpu time: " << cpu_time << " seconds, " << (duration > 0 ? 100 * cpu_time / duration : 0) << "% of a core" << std::endl;
+
+#ifndef WIN32
+    struct rusage usage = {};
+    if(getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        std::cout << "\tpeak memory: " << usage.ru_maxrss / 1024 << " MB" << std::endl; //linux reports the maximum resident set size in kilobytes
+    }
+#endif
+
+    //the record and playback components update these counters, bytes read count the image data only
+    for(auto & value : PERF_COUNTERS.query_values())
+    {
+        if(value.type != performance_counter_type::counter || value.value == 0)
+            continue;
+        if(value.name == "record.bytes_written" || value.name == "playback.bytes_read")
+        {
+            std::cout << "\t" << value.name << ": " << value.value / 1e6 << " MB, " <<
+                         (duration > 0 ? value.value / 1e6 / duration : 0) << " MB/s" << std::endl;
+        }
+        else if(value.name == "record.frames_dropped" || value.name == "playback.frames_dropped")
+        {
+            std::cout << "\t" << value.name << ": " << value.value << std::endl;
+        }
     }
 }
 
@@ -197,7 +252,8 @@ int main(int argc, char* argv[])
         if(g_cmd.get_enabled_streams().size() == 0)
             return 0;
 
-        std::shared_ptr<context_interface> context = create_context(g_cmd);
+        rs::playback::device * playback_device = nullptr;
+        std::shared_ptr<context_interface> context = create_context(g_cmd, playback_device);
 
         if(context->get_device_count() == 0)
         {
@@ -206,10 +262,12 @@ int main(int argc, char* argv[])
 
         rs::device * device = context->get_device(0);
 
-        configure_device(device, g_cmd, g_renderer);
+        configure_device(device, playback_device, g_cmd, g_renderer);
 
         rs::source source = g_cmd.is_motion_enabled() ? rs::source::all_sources : rs::source::video;
 
+        auto start_cpu_time = std::clock();
+
         device->start(source);
 
         auto start_time = std::chrono::high_resolution_clock::now();
@@ -274,6 +332,12 @@ int main(int argc, char* argv[])
 
         cout << "done capturing" << endl;
 
+        if(g_cmd.is_benchmark_enabled())
+        {
+            auto duration = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+            print_benchmark_results(duration, static_cast<double>(std::clock() - start_cpu_time) / CLOCKS_PER_SEC);
+        }
+
         return 0;
     }
     catch(rs::error e)
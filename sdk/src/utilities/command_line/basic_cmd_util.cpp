@@ -122,13 +122,16 @@ namespace rs
                 add_single_arg_option("-fpf", "set fisheye stream pixel format", "raw8", "raw8");
                 add_single_arg_option("-fcl", "set fisheye stream compression level", "d l m h", "h");
 
-                add_single_arg_option("-rec -record", "set recorder file path");
+                add_single_arg_option("-rec -record", "set recorder file path, re-records the playback file when used with -pb");
                 add_single_arg_option("-pb -playback", "set playback file path");
                 add_single_arg_option("-fi -file_info", "print file info");
                 add_single_arg_option("-ct -capture_time", "set capture time");
                 add_single_arg_option("-n", "set minimum number of frames to capture per stream");
                 add_option("-r -render", "enable streaming display");
+                add_single_arg_option("-rr -render_rate", "set maximal display updates per second, 0 displays every frame", "", "30");
+                add_single_arg_option("-rd -render_decimation", "set display downscale factor", "", "1");
                 add_option("-nrt -non_real_time", "playback in non real time mode");
+                add_option("-bench -benchmark", "run without display and without real time pacing, and print the achieved throughput");
 
                 set_usage_example("-c -cconf 640-480-30 -cpf rgba8 -rec rec.rssdk -r\n\n"
                                   "The following command will configure the camera to\n"
@@ -275,7 +278,7 @@ namespace rs
         bool basic_cmd_util::is_real_time()
         {
             rs::utils::cmd_option opt;
-            return !get_cmd_option("-nrt -non_real_time", opt);
+            return !get_cmd_option("-nrt -non_real_time", opt) && !is_benchmark_enabled();
         }
 
         bool basic_cmd_util::is_print_file_info()
@@ -287,7 +290,21 @@ namespace rs
         bool basic_cmd_util::is_rendering_enabled()
         {
             rs::utils::cmd_option opt;
-            return get_cmd_option("-r -render", opt);
+            return get_cmd_option("-r -render", opt) && !is_benchmark_enabled();
+        }
+
+        uint32_t basic_cmd_util::get_render_rate()
+        {
+            rs::utils::cmd_option opt;
+            std::string val = get_cmd_option("-rr -render_rate", opt) && opt.m_option_args_values.size() > 0 ? opt.m_option_args_values[0] : opt.m_default_value;
+            return is_number(val) ? std::stoi(val) : 30;
+        }
+
+        uint32_t basic_cmd_util::get_render_decimation_factor()
+        {
+            rs::utils::cmd_option opt;
+            std::string val = get_cmd_option("-rd -render_decimation", opt) && opt.m_option_args_values.size() > 0 ? opt.m_option_args_values[0] : opt.m_default_value;
+            return is_number(val) && std::stoi(val) > 0 ? std::stoi(val) : 1;
         }
 
         bool basic_cmd_util::is_motion_enabled()
@@ -297,11 +314,17 @@ namespace rs
             return get_cmd_option(enabled_stream_map[stream_type::fisheye], opt) || get_cmd_option("-m -motion", opt);
         }
 
+        bool basic_cmd_util::is_benchmark_enabled()
+        {
+            rs::utils::cmd_option opt;
+            return get_cmd_option("-bench -benchmark", opt);
+        }
+
         streaming_mode basic_cmd_util::get_streaming_mode()
         {
             rs::utils::cmd_option opt;
+            if(get_cmd_option("-pb -playback", opt)) return streaming_mode::playback; //with a record file path, the playback is re-recorded
             if(get_cmd_option("-rec -record", opt)) return streaming_mode::record;
-            if(get_cmd_option("-pb -playback", opt)) return streaming_mode::playback;
             return streaming_mode::live;
         }
 
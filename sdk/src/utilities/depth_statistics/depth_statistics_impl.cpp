@@ -0,0 +1,303 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include "depth_statistics_impl.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DEPTH_STATISTICS_SSE2
+#endif
+
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace
+{
+    const size_t DEPTH_VALUES_COUNT = 1 << 16;
+    //smaller regions are processed by the calling thread, waking the workers costs more than the reduction itself
+    const int64_t MIN_PARALLEL_PIXELS = 64 * 1024;
+
+    inline void reduce_row_scalar(const uint16_t * row, int32_t width, depth_band_statistics & statistics)
+    {
+        for(int32_t x = 0; x < width; x++)
+        {
+            const uint16_t value = row[x];
+            statistics.sum += value;
+            statistics.valid_count += value != 0;
+            statistics.min_depth_minus_one = std::min(statistics.min_depth_minus_one, static_cast<uint16_t>(value - 1));
+            statistics.max_depth = std::max(statistics.max_depth, value);
+        }
+    }
+
+#ifdef DEPTH_STATISTICS_SSE2
+    //sse2 has signed 16 bit min and max only, the values are biased by 0x8000 to compare them as unsigned
+    inline void reduce_row(const uint16_t * row, int32_t width, depth_band_statistics & statistics)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i ones = _mm_set1_epi16(1);
+        const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+        const __m128i low_byte_mask = _mm_set1_epi16(0x00ff);
+        __m128i min_biased = _mm_set1_epi16(0x7fff);
+        __m128i max_biased = _mm_set1_epi16(static_cast<short>(0x8000));
+        __m128i sum_low = zero, sum_high = zero;
+        __m128i zero_count = zero;
+
+        int32_t x = 0;
+        for(; x + 8 <= width; x += 8)
+        {
+            const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+            min_biased = _mm_min_epi16(min_biased, _mm_xor_si128(_mm_sub_epi16(value, ones), bias));
+            max_biased = _mm_max_epi16(max_biased, _mm_xor_si128(value, bias));
+            //the 16 bit values are summed as two byte planes, psadbw accumulates each plane to 64 bit lanes without overflow
+            sum_low = _mm_add_epi64(sum_low, _mm_sad_epu8(_mm_and_si128(value, low_byte_mask), zero));
+            sum_high = _mm_add_epi64(sum_high, _mm_sad_epu8(_mm_srli_epi16(value, 8), zero));
+            zero_count = _mm_sub_epi16(zero_count, _mm_cmpeq_epi16(value, zero));
+        }
+
+        if(x > 0)
+        {
+            uint16_t lanes[8];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(min_biased, bias));
+            for(auto lane : lanes)
+                statistics.min_depth_minus_one = std::min(statistics.min_depth_minus_one, lane);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), _mm_xor_si128(max_biased, bias));
+            for(auto lane : lanes)
+                statistics.max_depth = std::max(statistics.max_depth, lane);
+
+            uint64_t sums[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(sums), _mm_add_epi64(sum_low, _mm_slli_epi64(sum_high, 8)));
+            statistics.sum += sums[0] + sums[1];
+
+            //each lane counts at most width / 8 zeros, which fits 16 bits for any image width
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), zero_count);
+            uint64_t zeros = 0;
+            for(auto lane : lanes)
+                zeros += lane;
+            statistics.valid_count += static_cast<uint64_t>(x) - zeros;
+        }
+
+        reduce_row_scalar(row + x, width - x, statistics);
+    }
+#else
+    inline void reduce_row(const uint16_t * row, int32_t width, depth_band_statistics & statistics)
+    {
+        reduce_row_scalar(row, width, statistics);
+    }
+#endif
+
+    inline bool is_roi_inside(const rect & roi, int32_t width, int32_t height)
+    {
+        return roi.x >= 0 && roi.y >= 0 && roi.width > 0 && roi.height > 0 && roi.x + roi.width <= width && roi.y + roi.height <= height;
+    }
+}
+
+namespace rs
+{
+    namespace utils
+    {
+        depth_statistics_interface * depth_statistics_interface::create_instance(uint32_t threads_count)
+        {
+            return new depth_statistics_impl(threads_count);
+        }
+
+        depth_statistics_impl::depth_statistics_impl(uint32_t threads_count) :
+            m_parallel_rows(threads_count),
+            m_band_statistics(m_parallel_rows.threads_count()),
+            m_band_histograms(m_parallel_rows.threads_count())
+        {
+        }
+
+        depth_statistics_impl::~depth_statistics_impl()
+        {
+        }
+
+        status depth_statistics_impl::get_region(image_interface * depth, const rect * roi, region & depth_region) const
+        {
+            if(!depth)
+                return status_handle_invalid;
+            const image_info info = depth->query_info();
+            const uint8_t * data = static_cast<const uint8_t *>(depth->query_data());
+            if(!data)
+                return status_handle_invalid;
+            if(info.format != pixel_format::z16)
+                return status_param_unsupported;
+
+            const rect full_frame = { 0, 0, info.width, info.height };
+            const rect & region_rect = roi ? *roi : full_frame;
+            if(!is_roi_inside(region_rect, info.width, info.height))
+                return status_param_unsupported;
+
+            depth_region.data = data + static_cast<size_t>(region_rect.y) * info.pitch + region_rect.x * sizeof(uint16_t);
+            depth_region.pitch = info.pitch;
+            depth_region.width = region_rect.width;
+            depth_region.height = region_rect.height;
+            return status_no_error;
+        }
+
+        void depth_statistics_impl::run_bands(const region & depth_region, const parallel_rows::task_type & task)
+        {
+            if(static_cast<int64_t>(depth_region.width) * depth_region.height < MIN_PARALLEL_PIXELS)
+                task(0, depth_region.height, 0);
+            else
+                m_parallel_rows.run(depth_region.height, task);
+        }
+
+        void depth_statistics_impl::compute_statistics(const region & depth_region, depth_statistics & statistics)
+        {
+            const depth_band_statistics empty_band = { 0, 0, 0xffff, 0 };
+            std::fill(m_band_statistics.begin(), m_band_statistics.end(), empty_band);
+            run_bands(depth_region, [&](int32_t first_row, int32_t last_row, uint32_t band)
+            {
+                depth_band_statistics band_statistics = empty_band;
+                for(int32_t y = first_row; y < last_row; y++)
+                {
+                    const uint16_t * row = reinterpret_cast<const uint16_t *>(depth_region.data + static_cast<size_t>(y) * depth_region.pitch);
+                    reduce_row(row, depth_region.width, band_statistics);
+                }
+                m_band_statistics[band] = band_statistics;
+            });
+
+            uint64_t sum = 0;
+            statistics = {};
+            uint16_t min_depth_minus_one = 0xffff;
+            for(const auto & band : m_band_statistics)
+            {
+                sum += band.sum;
+                statistics.valid_count += band.valid_count;
+                min_depth_minus_one = std::min(min_depth_minus_one, band.min_depth_minus_one);
+                statistics.max_depth = std::max(statistics.max_depth, band.max_depth);
+            }
+            statistics.min_depth = static_cast<uint16_t>(min_depth_minus_one + 1);
+            statistics.mean_depth = statistics.valid_count ? static_cast<double>(sum) / statistics.valid_count : 0;
+            statistics.pixels_count = static_cast<uint64_t>(depth_region.width) * depth_region.height;
+        }
+
+        void depth_statistics_impl::compute_full_histogram(const region & depth_region)
+        {
+            run_bands(depth_region, [&](int32_t first_row, int32_t last_row, uint32_t band)
+            {
+                std::vector<uint32_t> & histogram = m_band_histograms[band];
+                histogram.assign(DEPTH_VALUES_COUNT, 0);
+                for(int32_t y = first_row; y < last_row; y++)
+                {
+                    const uint16_t * row = reinterpret_cast<const uint16_t *>(depth_region.data + static_cast<size_t>(y) * depth_region.pitch);
+                    for(int32_t x = 0; x < depth_region.width; x++)
+                        histogram[row[x]]++;
+                }
+            });
+
+            //bands which didn't run on a small region keep the counts of a previous call, only the used bands are merged
+            const uint32_t bands_count = static_cast<int64_t>(depth_region.width) * depth_region.height < MIN_PARALLEL_PIXELS ?
+                                         1 : m_parallel_rows.threads_count();
+            m_histogram.assign(m_band_histograms[0].begin(), m_band_histograms[0].end());
+            for(uint32_t band = 1; band < bands_count; band++)
+            {
+                const std::vector<uint32_t> & histogram = m_band_histograms[band];
+                for(size_t value = 0; value < DEPTH_VALUES_COUNT; value++)
+                    m_histogram[value] += histogram[value];
+            }
+        }
+
+        status depth_statistics_impl::query_statistics(image_interface * depth, const rect * roi, depth_statistics & statistics)
+        {
+            region depth_region;
+            status sts = get_region(depth, roi, depth_region);
+            if(sts < status_no_error)
+                return sts;
+
+            compute_statistics(depth_region, statistics);
+            return status_no_error;
+        }
+
+        status depth_statistics_impl::query_roi_statistics(image_interface * depth, const rect * rois, int32_t rois_count, depth_statistics * statistics)
+        {
+            if(!rois || !statistics)
+                return status_handle_invalid;
+            if(rois_count <= 0)
+                return status_param_unsupported;
+
+            std::vector<region> regions(rois_count);
+            for(int32_t i = 0; i < rois_count; i++)
+            {
+                status sts = get_region(depth, &rois[i], regions[i]);
+                if(sts < status_no_error)
+                    return sts;
+            }
+            for(int32_t i = 0; i < rois_count; i++)
+                compute_statistics(regions[i], statistics[i]);
+            return status_no_error;
+        }
+
+        status depth_statistics_impl::query_histogram(image_interface * depth, const rect * roi, uint16_t min_depth, uint16_t max_depth,
+                                                      int32_t bins_count, uint32_t * histogram)
+        {
+            if(!histogram)
+                return status_handle_invalid;
+            if(min_depth == 0 || max_depth < min_depth || bins_count <= 0 || bins_count > max_depth - min_depth + 1)
+                return status_param_unsupported;
+            region depth_region;
+            status sts = get_region(depth, roi, depth_region);
+            if(sts < status_no_error)
+                return sts;
+
+            compute_full_histogram(depth_region);
+
+            //the per value histogram is folded to the requested bins
+            std::fill(histogram, histogram + bins_count, 0);
+            const uint32_t range = static_cast<uint32_t>(max_depth - min_depth) + 1;
+            for(uint32_t value = min_depth; value <= max_depth; value++)
+            {
+                const uint32_t bin = static_cast<uint32_t>(static_cast<uint64_t>(value - min_depth) * bins_count / range);
+                histogram[bin] += m_histogram[value];
+            }
+            return status_no_error;
+        }
+
+        status depth_statistics_impl::query_percentiles(image_interface * depth, const rect * roi, const float * percentiles,
+                                                        int32_t percentiles_count, uint16_t * values)
+        {
+            if(!percentiles || !values)
+                return status_handle_invalid;
+            if(percentiles_count <= 0)
+                return status_param_unsupported;
+            for(int32_t i = 0; i < percentiles_count; i++)
+            {
+                if(!(percentiles[i] >= 0 && percentiles[i] <= 100))
+                    return status_param_unsupported;
+            }
+            region depth_region;
+            status sts = get_region(depth, roi, depth_region);
+            if(sts < status_no_error)
+                return sts;
+
+            compute_full_histogram(depth_region);
+
+            uint64_t valid_count = 0;
+            for(size_t value = 1; value < DEPTH_VALUES_COUNT; value++)
+                valid_count += m_histogram[value];
+
+            for(int32_t i = 0; i < percentiles_count; i++)
+            {
+                values[i] = 0;
+                if(valid_count == 0)
+                    continue;
+                //nearest rank, the rank of the 0 percentile is the minimal value
+                const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentiles[i] / 100.0 * valid_count)));
+                uint64_t cumulative_count = 0;
+                for(size_t value = 1; value < DEPTH_VALUES_COUNT; value++)
+                {
+                    cumulative_count += m_histogram[value];
+                    if(cumulative_count >= rank)
+                    {
+                        values[i] = static_cast<uint16_t>(value);
+                        break;
+                    }
+                }
+            }
+            return status_no_error;
+        }
+    }
+}
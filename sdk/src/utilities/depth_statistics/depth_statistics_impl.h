@@ -0,0 +1,58 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include "rs/utils/depth_statistics_interface.h"
+#include "rs/utils/release_self_base.h"
+#include "parallel_rows.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        //partial reduction of a rows range
+        struct depth_band_statistics
+        {
+            uint64_t    sum;
+            uint64_t    valid_count;
+            uint16_t    min_depth_minus_one; //zero depth wraps to the maximal value, so the minimum skips the invalid pixels
+            uint16_t    max_depth;
+        };
+
+        class depth_statistics_impl : public release_self_base<depth_statistics_interface>
+        {
+        public:
+            depth_statistics_impl(uint32_t threads_count);
+            virtual ~depth_statistics_impl();
+
+            rs::core::status query_statistics(rs::core::image_interface * depth, const rs::core::rect * roi, depth_statistics & statistics) override;
+            rs::core::status query_roi_statistics(rs::core::image_interface * depth, const rs::core::rect * rois, int32_t rois_count,
+                                                  depth_statistics * statistics) override;
+            rs::core::status query_histogram(rs::core::image_interface * depth, const rs::core::rect * roi, uint16_t min_depth, uint16_t max_depth,
+                                             int32_t bins_count, uint32_t * histogram) override;
+            rs::core::status query_percentiles(rs::core::image_interface * depth, const rs::core::rect * roi, const float * percentiles,
+                                               int32_t percentiles_count, uint16_t * values) override;
+
+        private:
+            struct region
+            {
+                const uint8_t *     data;  //first pixel of the region
+                int32_t             pitch;
+                int32_t             width;
+                int32_t             height;
+            };
+
+            rs::core::status get_region(rs::core::image_interface * depth, const rs::core::rect * roi, region & depth_region) const;
+            void run_bands(const region & depth_region, const parallel_rows::task_type & task);
+            void compute_statistics(const region & depth_region, depth_statistics & statistics);
+            //fills m_histogram with the count of every depth value of the region
+            void compute_full_histogram(const region & depth_region);
+
+            parallel_rows                                   m_parallel_rows;
+            std::vector<depth_band_statistics>              m_band_statistics;
+            std::vector<std::vector<uint32_t>>              m_band_histograms;
+            std::vector<uint32_t>                           m_histogram;
+        };
+    }
+}
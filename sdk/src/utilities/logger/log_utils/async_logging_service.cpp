@@ -0,0 +1,267 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <string.h>
+#include <wchar.h>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include "rs/utils/async_logging_service.h"
+
+using namespace rs::core;
+
+namespace rs
+{
+    namespace utils
+    {
+        const size_t async_logging_service::max_message_length;
+
+        async_logging_service::async_logging_service(logging_service * logger, uint32_t capacity, overflow_policy policy) :
+            m_logger(logger),
+            m_policy(policy),
+            m_enqueue_position(0),
+            m_dequeue_position(0),
+            m_written_position(0),
+            m_dropped_count(0),
+            m_reported_dropped_count(0),
+            m_is_writer_waiting(false),
+            m_is_closing(false)
+        {
+            size_t cells_count = 2;
+            while(cells_count < capacity)
+            {
+                cells_count <<= 1;
+            }
+            m_mask = cells_count - 1;
+            m_cells = std::vector<cell>(cells_count);
+            for(size_t i = 0; i < cells_count; i++)
+            {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+
+            m_writer_thread = std::thread(&async_logging_service::write_loop, this);
+        }
+
+        async_logging_service::~async_logging_service()
+        {
+            m_is_closing = true;
+            {
+                std::lock_guard<std::mutex> lock(m_writer_lock);
+                m_records_ready.notify_one();
+            }
+            if(m_writer_thread.joinable())
+            {
+                m_writer_thread.join();
+            }
+        }
+
+        status async_logging_service::set_logger_name(const wchar_t* name)
+        {
+            return m_logger->set_logger_name(name);
+        }
+
+        status async_logging_service::configure(config_mode config_mode, const wchar_t* config, int file_watch_delay)
+        {
+            return m_logger->configure(config_mode, config, file_watch_delay);
+        }
+
+        bool async_logging_service::is_configured()
+        {
+            return m_logger->is_configured();
+        }
+
+        status async_logging_service::set_level(log_level level)
+        {
+            return m_logger->set_level(level);
+        }
+
+        bool async_logging_service::is_level_enabled(log_level level)
+        {
+            return m_logger->is_level_enabled(level);
+        }
+
+        logging_service::log_level async_logging_service::get_level()
+        {
+            return m_logger->get_level();
+        }
+
+        logging_service::logger_type async_logging_service::get_logger_type()
+        {
+            return m_logger->get_logger_type();
+        }
+
+        void async_logging_service::log(log_level level, const char* message, const char* file_name, int line_number, const char* function_name)
+        {
+            size_t position;
+            record * data = acquire_record(position);
+            if(!data)
+            {
+                return;
+            }
+
+            data->level = level;
+            data->line_number = line_number;
+            data->file_name = file_name;
+            data->function_name = function_name;
+            data->is_wide = false;
+            const size_t length = message ? strnlen(message, max_message_length) : 0;
+            memcpy(data->message, message, length);
+            data->message[length] = 0;
+            publish_record(position);
+        }
+
+        void async_logging_service::logw(log_level level, const wchar_t* message, const char* file_name, int line_number, const char* function_name)
+        {
+            size_t position;
+            record * data = acquire_record(position);
+            if(!data)
+            {
+                return;
+            }
+
+            data->level = level;
+            data->line_number = line_number;
+            data->file_name = file_name;
+            data->function_name = function_name;
+            data->is_wide = true;
+            const size_t length = message ? wcsnlen(message, max_message_length) : 0;
+            wmemcpy(data->wide_message, message, length);
+            data->wide_message[length] = 0;
+            publish_record(position);
+        }
+
+        void async_logging_service::flush()
+        {
+            const size_t last_position = m_enqueue_position.load(std::memory_order_acquire);
+            while(m_written_position.load(std::memory_order_acquire) < last_position)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_writer_lock);
+                    m_records_ready.notify_one();
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        uint64_t async_logging_service::query_dropped_count() const
+        {
+            return m_dropped_count.load(std::memory_order_relaxed);
+        }
+
+        logging_service * async_logging_service::get_wrapped_logger() const
+        {
+            return m_logger;
+        }
+
+        async_logging_service::record * async_logging_service::acquire_record(size_t & position)
+        {
+            //multiple producers claim cells by advancing the enqueue position, a cell is free when its sequence equals the position
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+            while(true)
+            {
+                cell & current_cell = m_cells[position & m_mask];
+                const size_t sequence = current_cell.sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if(difference == 0)
+                {
+                    if(m_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        return &current_cell.data;
+                    }
+                }
+                else if(difference < 0)
+                {
+                    //the ring buffer is full
+                    if(m_policy == overflow_policy::drop || m_is_closing)
+                    {
+                        m_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                        return nullptr;
+                    }
+                    std::this_thread::yield();
+                    position = m_enqueue_position.load(std::memory_order_relaxed);
+                }
+                else
+                {
+                    position = m_enqueue_position.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void async_logging_service::publish_record(size_t position)
+        {
+            m_cells[position & m_mask].sequence.store(position + 1, std::memory_order_seq_cst);
+            if(m_is_writer_waiting.load(std::memory_order_seq_cst))
+            {
+                m_records_ready.notify_one();
+            }
+        }
+
+        size_t async_logging_service::write_pending_records()
+        {
+            size_t written_count = 0;
+            size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+            while(true)
+            {
+                cell & current_cell = m_cells[position & m_mask];
+                if(current_cell.sequence.load(std::memory_order_acquire) != position + 1)
+                {
+                    break;
+                }
+
+                const record & data = current_cell.data;
+                if(data.is_wide)
+                {
+                    m_logger->logw(data.level, data.wide_message, data.file_name, data.line_number, data.function_name);
+                }
+                else
+                {
+                    m_logger->log(data.level, data.message, data.file_name, data.line_number, data.function_name);
+                }
+
+                //free the cell for the next round of the producers
+                current_cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+                m_dequeue_position.store(++position, std::memory_order_release);
+                written_count++;
+            }
+
+            const uint64_t dropped_count = m_dropped_count.load(std::memory_order_relaxed);
+            if(dropped_count != m_reported_dropped_count)
+            {
+                std::ostringstream message;
+                message << "async logging buffer overflow, " << dropped_count - m_reported_dropped_count << " messages were dropped";
+                m_logger->log(level_warn, message.str().c_str(), __FILE__, __LINE__, __FUNCTION__);
+                m_reported_dropped_count = dropped_count;
+            }
+            m_written_position.store(position, std::memory_order_release);
+            return written_count;
+        }
+
+        void async_logging_service::write_loop()
+        {
+            while(true)
+            {
+                if(write_pending_records())
+                {
+                    continue;
+                }
+                if(m_is_closing)
+                {
+                    //write the records published before closing
+                    write_pending_records();
+                    return;
+                }
+
+                //a record published before the waiting flag was raised is found by the second check,
+                //the timeout covers a notification which raced with it
+                std::unique_lock<std::mutex> lock(m_writer_lock);
+                m_is_writer_waiting.store(true, std::memory_order_seq_cst);
+                const size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+                if(m_cells[position & m_mask].sequence.load(std::memory_order_seq_cst) != position + 1 && !m_is_closing)
+                {
+                    m_records_ready.wait_for(lock, std::chrono::milliseconds(10));
+                }
+                m_is_writer_waiting.store(false, std::memory_order_release);
+            }
+        }
+    }
+}
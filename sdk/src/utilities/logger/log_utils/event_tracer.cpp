@@ -0,0 +1,314 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include "rs/utils/event_tracer.h"
+#ifdef WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace rs::core;
+
+DLL_EXPORT rs::utils::event_tracer tracer;
+
+namespace rs
+{
+    namespace utils
+    {
+        struct trace_event
+        {
+            const char *                category;
+            const char *                name;
+            uint64_t                    time;
+            int64_t                     value;      //the duration of a span, the value of a counter
+            event_tracer::event_type    type;
+        };
+
+        //written by its thread only, the dump reads the events below the published count
+        struct trace_thread_buffer
+        {
+            trace_thread_buffer(uint32_t id) : id(id), is_in_use(true), session(0), count(0), dropped_count(0) {}
+
+            const uint32_t              id;
+            bool                        is_in_use;      //protected by the buffers lock
+            std::string                 thread_name;    //protected by the buffers lock
+            std::atomic<uint32_t>       session;
+            std::atomic<size_t>         count;
+            std::atomic<uint64_t>       dropped_count;
+            std::vector<trace_event>    events;
+        };
+
+        namespace
+        {
+            //the buffer of the current thread, released for reuse when the thread exits
+            struct thread_buffer_holder
+            {
+                thread_buffer_holder() : owner(nullptr), buffer(nullptr), lock(nullptr) {}
+                ~thread_buffer_holder()
+                {
+                    if(buffer)
+                    {
+                        std::lock_guard<std::mutex> guard(*lock);
+                        buffer->is_in_use = false;
+                    }
+                }
+
+                const event_tracer *    owner;
+                trace_thread_buffer *   buffer;
+                std::mutex *            lock;
+            };
+
+            thread_local thread_buffer_holder current_thread_buffer;
+
+            //the event names are static strings, escaping keeps the file valid for any name
+            void write_json_string(FILE * file, const char * text)
+            {
+                fputc('"', file);
+                for(const char * character = text ? text : ""; *character; character++)
+                {
+                    if(*character == '"' || *character == '\\')
+                    {
+                        fputc('\\', file);
+                    }
+                    if(static_cast<unsigned char>(*character) >= ' ')
+                    {
+                        fputc(*character, file);
+                    }
+                }
+                fputc('"', file);
+            }
+        }
+
+        event_tracer::event_tracer() :
+            m_is_enabled(false),
+            m_session(0),
+            m_session_start_time(0),
+            m_events_per_thread(0)
+        {
+            if(getenv("REALSENSE_SDK_TRACE"))
+            {
+                enable();
+            }
+        }
+
+        event_tracer::~event_tracer()
+        {
+            const char * trace_file_path = getenv("REALSENSE_SDK_TRACE");
+            if(trace_file_path && m_session.load())
+            {
+                disable();
+                if(dump(trace_file_path) < status_no_error)
+                {
+                    fprintf(stderr, "failed writing the trace file %s\n", trace_file_path);
+                }
+            }
+        }
+
+        void event_tracer::enable(uint32_t events_per_thread)
+        {
+            std::lock_guard<std::mutex> guard(m_buffers_lock);
+            m_events_per_thread = events_per_thread > 0 ? events_per_thread : 1;
+            m_session_start_time.store(now(), std::memory_order_relaxed);
+            m_session.fetch_add(1, std::memory_order_release);
+            m_is_enabled.store(true, std::memory_order_release);
+        }
+
+        void event_tracer::disable()
+        {
+            m_is_enabled.store(false, std::memory_order_release);
+        }
+
+        status event_tracer::dump(const char * file_path)
+        {
+            FILE * file = file_path ? fopen(file_path, "w") : nullptr;
+            if(!file)
+            {
+                return status_file_open_failed;
+            }
+
+            const int process_id = static_cast<int>(getpid());
+            fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+            bool is_first_event = true;
+            {
+                std::lock_guard<std::mutex> guard(m_buffers_lock);
+                const uint32_t session = m_session.load(std::memory_order_acquire);
+                const uint64_t session_start_time = m_session_start_time.load(std::memory_order_relaxed);
+                for(auto & buffer : m_buffers)
+                {
+                    if(!buffer->thread_name.empty())
+                    {
+                        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%u,\"args\":{\"name\":",
+                                is_first_event ? "" : ",\n", process_id, buffer->id);
+                        write_json_string(file, buffer->thread_name.c_str());
+                        fprintf(file, "}}");
+                        is_first_event = false;
+                    }
+                    if(buffer->session.load(std::memory_order_acquire) != session)
+                    {
+                        continue;
+                    }
+
+                    const size_t count = buffer->count.load(std::memory_order_acquire);
+                    for(size_t i = 0; i < count; i++)
+                    {
+                        const trace_event & event = buffer->events[i];
+                        fprintf(file, "%s{\"name\":", is_first_event ? "" : ",\n");
+                        write_json_string(file, event.name);
+                        fprintf(file, ",\"cat\":");
+                        write_json_string(file, event.category);
+                        //the trace event format timestamps are in microseconds
+                        fprintf(file, ",\"pid\":%d,\"tid\":%u,\"ts\":%.3f", process_id, buffer->id, (event.time - session_start_time) / 1000.0);
+                        switch(event.type)
+                        {
+                            case event_type::span:
+                                fprintf(file, ",\"ph\":\"X\",\"dur\":%.3f}", event.value / 1000.0);
+                                break;
+                            case event_type::instant:
+                                fprintf(file, ",\"ph\":\"i\",\"s\":\"t\"}");
+                                break;
+                            case event_type::counter:
+                                fprintf(file, ",\"ph\":\"C\",\"args\":{\"value\":%lld}}", static_cast<long long>(event.value));
+                                break;
+                        }
+                        is_first_event = false;
+                    }
+                }
+            }
+            fprintf(file, "\n]}\n");
+
+            const bool is_write_failed = ferror(file) != 0;
+            if(fclose(file) != 0 || is_write_failed)
+            {
+                return status_file_write_failed;
+            }
+            return status_no_error;
+        }
+
+        uint64_t event_tracer::query_dropped_count()
+        {
+            std::lock_guard<std::mutex> guard(m_buffers_lock);
+            const uint32_t session = m_session.load(std::memory_order_acquire);
+            uint64_t dropped_count = 0;
+            for(auto & buffer : m_buffers)
+            {
+                if(buffer->session.load(std::memory_order_acquire) == session)
+                {
+                    dropped_count += buffer->dropped_count.load(std::memory_order_relaxed);
+                }
+            }
+            return dropped_count;
+        }
+
+        void event_tracer::set_thread_name(const char * name)
+        {
+            trace_thread_buffer * buffer = query_thread_buffer();
+            std::lock_guard<std::mutex> guard(m_buffers_lock);
+            buffer->thread_name = name ? name : "";
+        }
+
+        uint64_t event_tracer::now()
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                             std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        void event_tracer::add_span(const char * category, const char * name, uint64_t begin_time, uint64_t end_time)
+        {
+            add_event(event_type::span, category, name, begin_time, static_cast<int64_t>(end_time - begin_time));
+        }
+
+        void event_tracer::add_instant(const char * category, const char * name)
+        {
+            add_event(event_type::instant, category, name, now(), 0);
+        }
+
+        void event_tracer::add_counter(const char * category, const char * name, int64_t value)
+        {
+            add_event(event_type::counter, category, name, now(), value);
+        }
+
+        void event_tracer::add_event(event_type type, const char * category, const char * name, uint64_t time, int64_t value)
+        {
+            if(!is_enabled())
+            {
+                return;
+            }
+
+            trace_thread_buffer * buffer = query_thread_buffer();
+            const uint32_t session = m_session.load(std::memory_order_acquire);
+            if(buffer->session.load(std::memory_order_relaxed) != session)
+            {
+                //the first event of the thread in this session, the lock keeps the dump from reading the buffer while it is reset
+                std::lock_guard<std::mutex> guard(m_buffers_lock);
+                if(buffer->events.size() != m_events_per_thread)
+                {
+                    buffer->events = std::vector<trace_event>(m_events_per_thread);
+                }
+                buffer->count.store(0, std::memory_order_relaxed);
+                buffer->dropped_count.store(0, std::memory_order_relaxed);
+                buffer->session.store(m_session.load(std::memory_order_relaxed), std::memory_order_release);
+            }
+
+            //a span which began before the session started belongs to the previous session
+            const size_t count = buffer->count.load(std::memory_order_relaxed);
+            if(time < m_session_start_time.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            if(count >= buffer->events.size())
+            {
+                buffer->dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            trace_event & event = buffer->events[count];
+            event.category = category;
+            event.name = name;
+            event.time = time;
+            event.value = value;
+            event.type = type;
+            buffer->count.store(count + 1, std::memory_order_release);
+        }
+
+        trace_thread_buffer * event_tracer::query_thread_buffer()
+        {
+            thread_buffer_holder & holder = current_thread_buffer;
+            if(holder.owner == this)
+            {
+                return holder.buffer;
+            }
+
+            std::lock_guard<std::mutex> guard(m_buffers_lock);
+            trace_thread_buffer * buffer = nullptr;
+            const uint32_t session = m_session.load(std::memory_order_relaxed);
+            //reuse the buffer of a finished thread, unless it holds events of the current session
+            for(auto & candidate : m_buffers)
+            {
+                if(!candidate->is_in_use && (candidate->session.load(std::memory_order_relaxed) != session ||
+                                             candidate->count.load(std::memory_order_relaxed) == 0))
+                {
+                    buffer = candidate.get();
+                    buffer->is_in_use = true;
+                    buffer->thread_name.clear();
+                    break;
+                }
+            }
+            if(!buffer)
+            {
+                m_buffers.push_back(std::unique_ptr<trace_thread_buffer>(new trace_thread_buffer(static_cast<uint32_t>(m_buffers.size() + 1))));
+                buffer = m_buffers.back().get();
+            }
+
+            holder.owner = this;
+            holder.buffer = buffer;
+            holder.lock = &m_buffers_lock;
+            return buffer;
+        }
+    }
+}
@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 #include "rs_sdk_version.h"
 #include "rs/utils/log_utils.h"
+#include "rs/utils/async_logging_service.h"
 #include "rs/core/status.h"
 #include "fstream"
 #include "stdio.h"
@@ -26,7 +27,7 @@ namespace rs
 {
 	namespace utils
 	{
-		log_util::log_util(wchar_t* name)
+		log_util::log_util(wchar_t* name) : m_logger(nullptr), m_active_async_logger(nullptr), m_min_level(0), m_async_logger(nullptr), m_async_capacity(0), m_async_block_on_overflow(false)
 		{
 #ifdef WIN32
 			m_logger = &m_empty_logger;
@@ -242,15 +243,89 @@ namespace rs
 			m_logger->set_logger_name(wc);
 			delete[] wc;
 #endif
+			char* async_capacity = getenv("REALSENSE_SDK_LOG_ASYNC");
+			if (async_capacity && atoi(async_capacity) > 0)
+			{
+				enable_async_mode(static_cast<uint32_t>(atoi(async_capacity)));
+			}
+			refresh_level();
+		}
+
+		status log_util::set_level(logging_service::log_level level)
+		{
+			status sts = get_active_logger()->set_level(level);
+			refresh_level();
+			return sts;
+		}
+
+		void log_util::refresh_level()
+		{
+			//the logger is probed at the known levels, a level between two of them is ruled out only when the lower one is disabled
+			static const logging_service::log_level levels[] = { logging_service::level_verbose, logging_service::level_trace, logging_service::level_debug,
+			                                                     logging_service::level_info, logging_service::level_warn, logging_service::level_error,
+			                                                     logging_service::level_fatal };
+			logging_service* active_logger = get_active_logger();
+			logging_service::log_level min_level = 0;
+			for (auto level : levels)
+			{
+				if (active_logger->is_level_enabled(level))
+				{
+					break;
+				}
+				min_level = level + 1;
+			}
+			m_min_level.store(min_level, std::memory_order_relaxed);
+		}
+
+		status log_util::enable_async_mode(uint32_t capacity, bool block_on_overflow)
+		{
+			std::lock_guard<std::mutex> lock(m_async_mode_lock);
+			if (!m_async_logger)
+			{
+				if (m_logger == &m_empty_logger)
+				{
+					return status_feature_unsupported;
+				}
+				m_async_logger = new async_logging_service(m_logger, capacity, block_on_overflow ? async_logging_service::overflow_policy::block :
+				                                                                                     async_logging_service::overflow_policy::drop);
+				m_async_capacity = capacity;
+				m_async_block_on_overflow = block_on_overflow;
+			}
+			else if (capacity != m_async_capacity || block_on_overflow != m_async_block_on_overflow)
+			{
+				return status_param_unsupported;
+			}
+			//the service is constructed before it is published, get_active_logger loads it with acquire
+			m_active_async_logger.store(m_async_logger, std::memory_order_release);
+			refresh_level();
+			return status_no_error;
+		}
+
+		void log_util::disable_async_mode()
+		{
+			std::lock_guard<std::mutex> lock(m_async_mode_lock);
+			if (!m_async_logger)
+			{
+				return;
+			}
+			//threads which loaded the async logger before the switch may still log into it, it is deleted with the log util
+			m_active_async_logger.store(nullptr, std::memory_order_release);
+			refresh_level();
+			m_async_logger->flush();
 		}
 
 		log_util::~log_util()
 		{
+			//the async logger destructor writes the pending messages and joins its thread
+			disable_async_mode();
+			delete m_async_logger;
+			m_async_logger = nullptr;
 
 			if (m_logger != &m_empty_logger)
 			{
 				m_logger = &m_empty_logger;
 			}
+			refresh_level();
 		}
 	}
 }
@@ -0,0 +1,219 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <stdlib.h>
+#include <chrono>
+#include <stdexcept>
+#include "rs/utils/performance_counters.h"
+
+using namespace rs::core;
+
+DLL_EXPORT rs::utils::performance_counters perf_counters;
+
+namespace
+{
+    //the environment variable applies to the default registry only, constructed above it in this file
+    struct environment_periodic_dump
+    {
+        environment_periodic_dump()
+        {
+            const char * dump_file_path = getenv("REALSENSE_SDK_PERF_COUNTERS");
+            if(dump_file_path && perf_counters.start_periodic_dump(dump_file_path) < status_no_error)
+            {
+                fprintf(stderr, "failed creating the performance counters file %s\n", dump_file_path);
+            }
+        }
+    } start_environment_periodic_dump;
+}
+
+namespace rs
+{
+    namespace utils
+    {
+        const uint32_t performance_histogram::buckets_count;
+
+        performance_counters::performance_counters() : m_is_dump_stopping(false)
+        {
+
+        }
+
+        performance_counters::~performance_counters()
+        {
+            stop_periodic_dump();
+        }
+
+        performance_counter & performance_counters::query_counter(const std::string & name)
+        {
+            return *query_entry(name, performance_counter_type::counter).counter;
+        }
+
+        performance_gauge & performance_counters::query_gauge(const std::string & name)
+        {
+            return *query_entry(name, performance_counter_type::gauge).gauge;
+        }
+
+        performance_histogram & performance_counters::query_histogram(const std::string & name)
+        {
+            return *query_entry(name, performance_counter_type::histogram).histogram;
+        }
+
+        std::vector<performance_counter_value> performance_counters::query_values()
+        {
+            std::lock_guard<std::mutex> lock(m_entries_lock);
+            std::vector<performance_counter_value> values;
+            values.reserve(m_entries.size());
+            for(auto & name_entry : m_entries)
+            {
+                values.push_back(make_value(name_entry.first, name_entry.second));
+            }
+            return values;
+        }
+
+        status performance_counters::query_value(const std::string & name, performance_counter_value & value)
+        {
+            std::lock_guard<std::mutex> lock(m_entries_lock);
+            auto name_entry = m_entries.find(name);
+            if(name_entry == m_entries.end())
+            {
+                return status_item_unavailable;
+            }
+            value = make_value(name_entry->first, name_entry->second);
+            return status_no_error;
+        }
+
+        void performance_counters::reset()
+        {
+            std::lock_guard<std::mutex> lock(m_entries_lock);
+            for(auto & name_entry : m_entries)
+            {
+                entry & counter_entry = name_entry.second;
+                switch(counter_entry.type)
+                {
+                    case performance_counter_type::counter: counter_entry.counter->reset(); break;
+                    case performance_counter_type::gauge: counter_entry.gauge->reset(); break;
+                    case performance_counter_type::histogram: counter_entry.histogram->reset(); break;
+                }
+            }
+        }
+
+        status performance_counters::start_periodic_dump(const std::string & file_path, uint32_t period_ms)
+        {
+            stop_periodic_dump();
+            FILE * file = fopen(file_path.c_str(), "w");
+            if(!file)
+            {
+                return status_file_open_failed;
+            }
+
+            std::lock_guard<std::mutex> lock(m_dump_lock);
+            m_is_dump_stopping = false;
+            m_dump_thread = std::thread(&performance_counters::dump_loop, this, file, period_ms > 0 ? period_ms : 1);
+            return status_no_error;
+        }
+
+        void performance_counters::stop_periodic_dump()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_dump_lock);
+                m_is_dump_stopping = true;
+                m_dump_stop.notify_one();
+            }
+            if(m_dump_thread.joinable())
+            {
+                m_dump_thread.join();
+            }
+        }
+
+        performance_counters::entry & performance_counters::query_entry(const std::string & name, performance_counter_type type)
+        {
+            std::lock_guard<std::mutex> lock(m_entries_lock);
+            auto name_entry = m_entries.find(name);
+            if(name_entry != m_entries.end())
+            {
+                if(name_entry->second.type != type)
+                {
+                    throw std::invalid_argument("performance counter " + name + " is registered with another type");
+                }
+                return name_entry->second;
+            }
+
+            entry & counter_entry = m_entries[name];
+            counter_entry.type = type;
+            switch(type)
+            {
+                case performance_counter_type::counter: counter_entry.counter.reset(new performance_counter()); break;
+                case performance_counter_type::gauge: counter_entry.gauge.reset(new performance_gauge()); break;
+                case performance_counter_type::histogram: counter_entry.histogram.reset(new performance_histogram()); break;
+            }
+            return counter_entry;
+        }
+
+        performance_counter_value performance_counters::make_value(const std::string & name, const entry & counter_entry)
+        {
+            performance_counter_value value = {};
+            value.name = name;
+            value.type = counter_entry.type;
+            switch(counter_entry.type)
+            {
+                case performance_counter_type::counter:
+                    value.value = counter_entry.counter->query();
+                    break;
+                case performance_counter_type::gauge:
+                    value.value = counter_entry.gauge->query();
+                    value.max = counter_entry.gauge->query_max();
+                    break;
+                case performance_counter_type::histogram:
+                {
+                    const performance_histogram & histogram = *counter_entry.histogram;
+                    value.value = static_cast<int64_t>(histogram.query_count());
+                    value.min = histogram.query_min();
+                    value.max = histogram.query_max();
+                    value.average = value.value ? static_cast<double>(histogram.query_sum()) / value.value : 0;
+                    value.percentile_50 = histogram.query_percentile(50);
+                    value.percentile_90 = histogram.query_percentile(90);
+                    value.percentile_99 = histogram.query_percentile(99);
+                    break;
+                }
+            }
+            return value;
+        }
+
+        void performance_counters::dump_loop(FILE * file, uint32_t period_ms)
+        {
+            const auto start_time = std::chrono::steady_clock::now();
+            bool is_stopping = false;
+            while(!is_stopping)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_dump_lock);
+                    is_stopping = m_dump_stop.wait_for(lock, std::chrono::milliseconds(period_ms), [this]() { return m_is_dump_stopping; });
+                }
+
+                //the last line is written on stop, so a short run has a line too
+                const long long time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+                fprintf(file, "{\"time_ms\":%lld", time_ms);
+                for(auto & value : query_values())
+                {
+                    switch(value.type)
+                    {
+                        case performance_counter_type::counter:
+                            fprintf(file, ",\"%s\":%lld", value.name.c_str(), static_cast<long long>(value.value));
+                            break;
+                        case performance_counter_type::gauge:
+                            fprintf(file, ",\"%s\":{\"value\":%lld,\"max\":%lld}", value.name.c_str(),
+                                    static_cast<long long>(value.value), static_cast<long long>(value.max));
+                            break;
+                        case performance_counter_type::histogram:
+                            fprintf(file, ",\"%s\":{\"count\":%lld,\"min\":%lld,\"max\":%lld,\"average\":%.3f,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f}",
+                                    value.name.c_str(), static_cast<long long>(value.value), static_cast<long long>(value.min),
+                                    static_cast<long long>(value.max), value.average, value.percentile_50, value.percentile_90, value.percentile_99);
+                            break;
+                    }
+                }
+                fprintf(file, "}\n");
+                fflush(file);
+            }
+            fclose(file);
+        }
+    }
+}
@@ -0,0 +1,222 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cmath>
+#include <algorithm>
+#include "organized_point_cloud_impl.h"
+
+using namespace rs::core;
+
+namespace
+{
+    const uint64_t EMPTY_VOXEL = ~0ull;
+    //voxel indices are packed to 21 bits per axis
+    const int64_t VOXEL_INDEX_OFFSET = 1 << 20;
+    const int64_t VOXEL_INDEX_MASK = (1 << 21) - 1;
+
+    inline bool is_valid(const point3dF32 & vertex)
+    {
+        return vertex.z > 0;
+    }
+
+    inline point3dF32 sub(const point3dF32 & a, const point3dF32 & b)
+    {
+        return { a.x - b.x, a.y - b.y, a.z - b.z };
+    }
+
+    inline uint64_t voxel_key(const point3dF32 & vertex, float inv_voxel_size)
+    {
+        const int64_t ix = static_cast<int64_t>(std::floor(vertex.x * inv_voxel_size)) + VOXEL_INDEX_OFFSET;
+        const int64_t iy = static_cast<int64_t>(std::floor(vertex.y * inv_voxel_size)) + VOXEL_INDEX_OFFSET;
+        const int64_t iz = static_cast<int64_t>(std::floor(vertex.z * inv_voxel_size)) + VOXEL_INDEX_OFFSET;
+        return (static_cast<uint64_t>(ix & VOXEL_INDEX_MASK) << 42) |
+               (static_cast<uint64_t>(iy & VOXEL_INDEX_MASK) << 21) |
+                static_cast<uint64_t>(iz & VOXEL_INDEX_MASK);
+    }
+
+    inline uint32_t voxel_hash(uint64_t key, uint32_t mask)
+    {
+        key ^= key >> 29;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 32;
+        return static_cast<uint32_t>(key) & mask;
+    }
+}
+
+namespace rs
+{
+    namespace utils
+    {
+        organized_point_cloud_interface * organized_point_cloud_interface::create_instance(uint32_t threads_count)
+        {
+            return new organized_point_cloud_impl(threads_count);
+        }
+
+        organized_point_cloud_impl::organized_point_cloud_impl(uint32_t threads_count) :
+            m_parallel_rows(threads_count),
+            m_band_valid_count(m_parallel_rows.threads_count())
+        {
+        }
+
+        organized_point_cloud_impl::~organized_point_cloud_impl()
+        {
+        }
+
+        status organized_point_cloud_impl::query_validity_mask(const point3dF32 * vertices, sizeI32 size, uint8_t * mask, int32_t * valid_count)
+        {
+            if(!vertices || !mask)
+                return status_handle_invalid;
+            if(size.width <= 0 || size.height <= 0)
+                return status_param_unsupported;
+
+            std::fill(m_band_valid_count.begin(), m_band_valid_count.end(), 0);
+            m_parallel_rows.run(size.height, [&](int32_t first_row, int32_t last_row, uint32_t band)
+            {
+                const size_t first = static_cast<size_t>(first_row) * size.width;
+                const size_t last = static_cast<size_t>(last_row) * size.width;
+                int32_t count = 0;
+                for(size_t i = first; i < last; i++)
+                {
+                    const uint8_t valid = is_valid(vertices[i]) ? 1 : 0;
+                    mask[i] = static_cast<uint8_t>(-valid);
+                    count += valid;
+                }
+                m_band_valid_count[band] = count;
+            });
+
+            if(valid_count)
+            {
+                *valid_count = 0;
+                for(auto count : m_band_valid_count)
+                    *valid_count += count;
+            }
+            return status_no_error;
+        }
+
+        status organized_point_cloud_impl::query_normals(const point3dF32 * vertices, sizeI32 size, point3dF32 * normals, float max_depth_difference)
+        {
+            if(!vertices || !normals)
+                return status_handle_invalid;
+            if(size.width <= 0 || size.height <= 0)
+                return status_param_unsupported;
+
+            const int32_t width = size.width;
+            const int32_t height = size.height;
+            const float max_difference = max_depth_difference > 0 ? max_depth_difference : INFINITY;
+            m_parallel_rows.run(height, [&](int32_t first_row, int32_t last_row, uint32_t)
+            {
+                const point3dF32 zero = { 0, 0, 0 };
+                for(int32_t y = first_row; y < last_row; y++)
+                {
+                    const point3dF32 * row = vertices + static_cast<size_t>(y) * width;
+                    const point3dF32 * up_row = y > 0 ? row - width : nullptr;
+                    const point3dF32 * down_row = y < height - 1 ? row + width : nullptr;
+                    point3dF32 * dst = normals + static_cast<size_t>(y) * width;
+                    for(int32_t x = 0; x < width; x++)
+                    {
+                        const point3dF32 & center = row[x];
+                        dst[x] = zero;
+                        if(!is_valid(center))
+                            continue;
+
+                        //a neighbor is usable when it has depth and is on the same surface as the center
+                        auto usable = [&](const point3dF32 & neighbor)
+                        {
+                            return is_valid(neighbor) && std::fabs(neighbor.z - center.z) <= max_difference;
+                        };
+                        const bool has_left = x > 0 && usable(row[x - 1]);
+                        const bool has_right = x < width - 1 && usable(row[x + 1]);
+                        const bool has_up = up_row && usable(up_row[x]);
+                        const bool has_down = down_row && usable(down_row[x]);
+                        if(!(has_left || has_right) || !(has_up || has_down))
+                            continue;
+                        const point3dF32 & left = has_left ? row[x - 1] : center;
+                        const point3dF32 & right = has_right ? row[x + 1] : center;
+                        const point3dF32 & up = has_up ? up_row[x] : center;
+                        const point3dF32 & down = has_down ? down_row[x] : center;
+
+                        //dy x dx points towards the camera for the x right, y down, z forward coordinate system
+                        const point3dF32 dx = sub(right, left);
+                        const point3dF32 dy = sub(down, up);
+                        const point3dF32 normal = { dy.y * dx.z - dy.z * dx.y,
+                                                    dy.z * dx.x - dy.x * dx.z,
+                                                    dy.x * dx.y - dy.y * dx.x };
+                        const float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+                        if(length > 0)
+                        {
+                            const float inv_length = 1.0f / length;
+                            dst[x] = { normal.x * inv_length, normal.y * inv_length, normal.z * inv_length };
+                        }
+                    }
+                }
+            });
+            return status_no_error;
+        }
+
+        status organized_point_cloud_impl::voxel_grid_downsample(const point3dF32 * vertices, sizeI32 size, float voxel_size,
+                                                                 point3dF32 * points, int32_t points_capacity, int32_t * points_count)
+        {
+            if(!vertices || !points || !points_count)
+                return status_handle_invalid;
+            if(size.width <= 0 || size.height <= 0 || !(voxel_size > 0))
+                return status_param_unsupported;
+
+            //the table is kept at most half full
+            const size_t vertices_count = static_cast<size_t>(size.width) * size.height;
+            size_t table_size = 1;
+            while(table_size < 2 * vertices_count)
+                table_size <<= 1;
+            if(m_voxel_keys.size() != table_size)
+            {
+                m_voxel_keys.assign(table_size, EMPTY_VOXEL);
+                m_voxel_sums.resize(table_size);
+                m_voxel_counts.resize(table_size);
+                m_used_voxels.reserve(vertices_count);
+            }
+            const uint32_t table_mask = static_cast<uint32_t>(table_size - 1);
+            const float inv_voxel_size = 1.0f / voxel_size;
+
+            m_used_voxels.clear();
+            for(size_t i = 0; i < vertices_count; i++)
+            {
+                const point3dF32 & vertex = vertices[i];
+                if(!is_valid(vertex))
+                    continue;
+                const uint64_t key = voxel_key(vertex, inv_voxel_size);
+                uint32_t slot = voxel_hash(key, table_mask);
+                while(m_voxel_keys[slot] != key && m_voxel_keys[slot] != EMPTY_VOXEL)
+                    slot = (slot + 1) & table_mask;
+                if(m_voxel_keys[slot] == EMPTY_VOXEL)
+                {
+                    m_voxel_keys[slot] = key;
+                    m_voxel_sums[slot] = vertex;
+                    m_voxel_counts[slot] = 1;
+                    m_used_voxels.push_back(slot);
+                }
+                else
+                {
+                    m_voxel_sums[slot].x += vertex.x;
+                    m_voxel_sums[slot].y += vertex.y;
+                    m_voxel_sums[slot].z += vertex.z;
+                    m_voxel_counts[slot]++;
+                }
+            }
+
+            //output the centroids in order of first appearance and reset the used slots for the next call
+            const int32_t voxels_count = static_cast<int32_t>(m_used_voxels.size());
+            const int32_t output_count = std::min(voxels_count, std::max(points_capacity, 0));
+            for(int32_t i = 0; i < voxels_count; i++)
+            {
+                const uint32_t slot = m_used_voxels[i];
+                if(i < output_count)
+                {
+                    const float inv_count = 1.0f / m_voxel_counts[slot];
+                    points[i] = { m_voxel_sums[slot].x * inv_count, m_voxel_sums[slot].y * inv_count, m_voxel_sums[slot].z * inv_count };
+                }
+                m_voxel_keys[slot] = EMPTY_VOXEL;
+            }
+            *points_count = output_count;
+            return output_count < voxels_count ? status_value_out_of_range : status_no_error;
+        }
+    }
+}
@@ -0,0 +1,38 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include "rs/utils/organized_point_cloud_interface.h"
+#include "rs/utils/release_self_base.h"
+#include "parallel_rows.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        class organized_point_cloud_impl : public release_self_base<organized_point_cloud_interface>
+        {
+        public:
+            organized_point_cloud_impl(uint32_t threads_count);
+            virtual ~organized_point_cloud_impl();
+
+            rs::core::status query_validity_mask(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size,
+                                                 uint8_t * mask, int32_t * valid_count) override;
+            rs::core::status query_normals(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size,
+                                           rs::core::point3dF32 * normals, float max_depth_difference) override;
+            rs::core::status voxel_grid_downsample(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size, float voxel_size,
+                                                   rs::core::point3dF32 * points, int32_t points_capacity, int32_t * points_count) override;
+
+        private:
+            parallel_rows                                               m_parallel_rows;
+            std::vector<int32_t>                                        m_band_valid_count;
+
+            //open addressing voxel table, only the used slots are reset after each call
+            std::vector<uint64_t>                                       m_voxel_keys;
+            std::vector<rs::core::point3dF32>                           m_voxel_sums;
+            std::vector<int32_t>                                        m_voxel_counts;
+            std::vector<uint32_t>                                       m_used_voxels;
+        };
+    }
+}
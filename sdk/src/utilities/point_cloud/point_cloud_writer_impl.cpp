@@ -0,0 +1,357 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <sstream>
+#include "point_cloud_writer_impl.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+
+namespace
+{
+    const size_t POINT_SIZE = 3 * sizeof(float);
+    const size_t PLY_COLOR_SIZE = 3;
+    const size_t PCD_COLOR_SIZE = sizeof(uint32_t);
+    //file stream buffer, large enough to issue big sequential writes
+    const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+    struct color_layout
+    {
+        int red;
+        int green;
+        int blue;
+        int pixel_size;
+    };
+
+    bool get_color_layout(pixel_format format, color_layout & layout)
+    {
+        switch(format)
+        {
+            case pixel_format::rgb8:  layout = {0, 1, 2, 3}; return true;
+            case pixel_format::bgr8:  layout = {2, 1, 0, 3}; return true;
+            case pixel_format::rgba8: layout = {0, 1, 2, 4}; return true;
+            case pixel_format::bgra8: layout = {2, 1, 0, 4}; return true;
+            default: return false;
+        }
+    }
+
+    status validate_frame(const char * file_path, const rs::utils::point_cloud_frame & frame)
+    {
+        if(!file_path || !frame.vertices)
+            return status_handle_invalid;
+        if(frame.size.width <= 0 || frame.size.height <= 0)
+            return status_param_unsupported;
+        if(frame.color)
+        {
+            if(!frame.uvmap)
+                return status_handle_invalid;
+            color_layout layout;
+            if(!get_color_layout(frame.color->query_info().format, layout))
+                return status_param_unsupported;
+            if(!frame.color->query_data())
+                return status_data_unavailable;
+        }
+        return status_no_error;
+    }
+}
+
+namespace rs
+{
+    namespace utils
+    {
+        point_cloud_writer_interface * point_cloud_writer_interface::create_instance(point_cloud_format format, uint32_t workers_count)
+        {
+            return new point_cloud_writer_impl(format, workers_count);
+        }
+
+        point_cloud_writer_impl::point_cloud_writer_impl(point_cloud_format format, uint32_t workers_count) :
+            m_format(format),
+            m_pending_jobs(0),
+            m_stop_workers(false),
+            m_async_write_failed(false),
+            m_statistics(),
+            m_first_write_done(false)
+        {
+            if(workers_count == 0)
+                workers_count = std::max(1u, std::thread::hardware_concurrency());
+            //two frames per worker keep the workers busy while the producer fills the next frame
+            m_max_pending_jobs = 2 * workers_count;
+            for(uint32_t i = 0; i < workers_count; i++)
+            {
+                m_workers.push_back(std::thread(&point_cloud_writer_impl::worker_thread, this));
+            }
+        }
+
+        point_cloud_writer_impl::~point_cloud_writer_impl()
+        {
+            flush();
+            {
+                std::lock_guard<std::mutex> guard(m_jobs_mutex);
+                m_stop_workers = true;
+            }
+            m_jobs_cv.notify_all();
+            for(auto & worker : m_workers)
+            {
+                if(worker.joinable())
+                    worker.join();
+            }
+        }
+
+        status point_cloud_writer_impl::write(const char * file_path, const point_cloud_frame & frame)
+        {
+            status sts = validate_frame(file_path, frame);
+            if(sts != status_no_error)
+                return sts;
+            image_info color_info = {};
+            const uint8_t * color_data = nullptr;
+            if(frame.color)
+            {
+                color_info = frame.color->query_info();
+                color_data = static_cast<const uint8_t *>(frame.color->query_data());
+            }
+            return write_file(file_path, frame.vertices, frame.size, frame.color ? &color_info : nullptr, color_data, frame.uvmap, m_sync_buffer);
+        }
+
+        status point_cloud_writer_impl::write_async(const char * file_path, const point_cloud_frame & frame)
+        {
+            status sts = validate_frame(file_path, frame);
+            if(sts != status_no_error)
+                return sts;
+
+            std::unique_ptr<job> new_job;
+            {
+                std::unique_lock<std::mutex> lock(m_jobs_mutex);
+                m_jobs_done_cv.wait(lock, [this]() { return m_pending_jobs < m_max_pending_jobs; });
+                m_pending_jobs++;
+                if(!m_free_jobs.empty())
+                {
+                    new_job = std::move(m_free_jobs.back());
+                    m_free_jobs.pop_back();
+                }
+            }
+            if(!new_job)
+                new_job.reset(new job());
+
+            const size_t points_count = static_cast<size_t>(frame.size.width) * frame.size.height;
+            new_job->file_path = file_path;
+            new_job->size = frame.size;
+            new_job->vertices.assign(frame.vertices, frame.vertices + points_count);
+            new_job->has_color = frame.color != nullptr;
+            if(new_job->has_color)
+            {
+                new_job->color_info = frame.color->query_info();
+                const uint8_t * color_data = static_cast<const uint8_t *>(frame.color->query_data());
+                new_job->color_data.assign(color_data, color_data + static_cast<size_t>(new_job->color_info.pitch) * new_job->color_info.height);
+                new_job->uvmap.assign(frame.uvmap, frame.uvmap + points_count);
+            }
+
+            {
+                std::lock_guard<std::mutex> guard(m_jobs_mutex);
+                m_jobs.push_back(std::move(new_job));
+            }
+            m_jobs_cv.notify_one();
+            return status_no_error;
+        }
+
+        status point_cloud_writer_impl::flush()
+        {
+            std::unique_lock<std::mutex> lock(m_jobs_mutex);
+            m_jobs_done_cv.wait(lock, [this]() { return m_pending_jobs == 0; });
+            status sts = m_async_write_failed ? status_file_write_failed : status_no_error;
+            m_async_write_failed = false;
+            return sts;
+        }
+
+        point_cloud_writer_interface::statistics point_cloud_writer_impl::query_statistics() const
+        {
+            std::lock_guard<std::mutex> guard(m_statistics_mutex);
+            statistics stats = m_statistics;
+            if(m_first_write_done)
+            {
+                double seconds = std::chrono::duration<double>(m_last_write_time - m_first_write_time).count();
+                stats.frames_per_second = seconds > 0 ? stats.frames_written / seconds : 0;
+            }
+            return stats;
+        }
+
+        void point_cloud_writer_impl::worker_thread()
+        {
+            //each worker owns its serialization buffer, it grows once to the frame size and is reused
+            std::vector<uint8_t> buffer;
+            while(true)
+            {
+                std::unique_ptr<job> current_job;
+                {
+                    std::unique_lock<std::mutex> lock(m_jobs_mutex);
+                    m_jobs_cv.wait(lock, [this]() { return m_stop_workers || !m_jobs.empty(); });
+                    if(m_jobs.empty())
+                        return;
+                    current_job = std::move(m_jobs.front());
+                    m_jobs.pop_front();
+                }
+
+                const bool has_color = current_job->has_color;
+                status sts = write_file(current_job->file_path.c_str(), current_job->vertices.data(), current_job->size,
+                                        has_color ? &current_job->color_info : nullptr, has_color ? current_job->color_data.data() : nullptr,
+                                        has_color ? current_job->uvmap.data() : nullptr, buffer);
+
+                {
+                    std::lock_guard<std::mutex> guard(m_jobs_mutex);
+                    if(sts != status_no_error)
+                        m_async_write_failed = true;
+                    m_free_jobs.push_back(std::move(current_job));
+                    m_pending_jobs--;
+                }
+                m_jobs_done_cv.notify_all();
+            }
+        }
+
+        status point_cloud_writer_impl::write_file(const char * file_path, const point3dF32 * vertices, sizeI32 size, const image_info * color_info,
+                                                   const uint8_t * color_data, const pointF32 * uvmap, std::vector<uint8_t> & buffer)
+        {
+            {
+                std::lock_guard<std::mutex> guard(m_statistics_mutex);
+                if(!m_first_write_done)
+                {
+                    m_first_write_done = true;
+                    m_first_write_time = std::chrono::steady_clock::now();
+                }
+            }
+
+            const uint32_t points_count = serialize_points(vertices, size, color_info, color_data, uvmap, buffer);
+            const size_t body_size = points_count * (POINT_SIZE + (color_info ? (m_format == point_cloud_format::ply ? PLY_COLOR_SIZE : PCD_COLOR_SIZE) : 0));
+            const std::string header = create_header(points_count, color_info != nullptr);
+
+            FILE * file = fopen(file_path, "wb");
+            if(!file)
+            {
+                LOG_ERROR("failed to open point cloud file " << file_path);
+                update_statistics(status_file_open_failed, 0, 0);
+                return status_file_open_failed;
+            }
+            setvbuf(file, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+            bool succeeded = fwrite(header.data(), 1, header.size(), file) == header.size();
+            succeeded = succeeded && (body_size == 0 || fwrite(buffer.data(), 1, body_size, file) == body_size);
+            succeeded = (fclose(file) == 0) && succeeded;
+
+            if(!succeeded)
+            {
+                LOG_ERROR("failed writing point cloud file " << file_path);
+                update_statistics(status_file_write_failed, 0, 0);
+                return status_file_write_failed;
+            }
+            update_statistics(status_no_error, points_count, header.size() + body_size);
+            return status_no_error;
+        }
+
+        void point_cloud_writer_impl::update_statistics(status sts, uint64_t points, uint64_t bytes)
+        {
+            std::lock_guard<std::mutex> guard(m_statistics_mutex);
+            if(sts != status_no_error)
+            {
+                m_statistics.frames_failed++;
+                return;
+            }
+            m_statistics.frames_written++;
+            m_statistics.points_written += points;
+            m_statistics.bytes_written += bytes;
+            m_last_write_time = std::chrono::steady_clock::now();
+        }
+
+        uint32_t point_cloud_writer_impl::serialize_points(const point3dF32 * vertices, sizeI32 size, const image_info * color_info,
+                                                           const uint8_t * color_data, const pointF32 * uvmap, std::vector<uint8_t> & buffer) const
+        {
+            const bool has_color = color_info != nullptr;
+            const size_t color_size = has_color ? (m_format == point_cloud_format::ply ? PLY_COLOR_SIZE : PCD_COLOR_SIZE) : 0;
+            const size_t record_size = POINT_SIZE + color_size;
+            const size_t max_points = static_cast<size_t>(size.width) * size.height;
+            if(buffer.size() < max_points * record_size)
+                buffer.resize(max_points * record_size);
+
+            color_layout layout = {};
+            if(has_color)
+                get_color_layout(color_info->format, layout);
+
+            uint8_t * dst = buffer.data();
+            uint32_t points_count = 0;
+            for(size_t i = 0; i < max_points; i++)
+            {
+                const point3dF32 & vertex = vertices[i];
+                if(!(vertex.z > 0) || !std::isfinite(vertex.x) || !std::isfinite(vertex.y) || !std::isfinite(vertex.z))
+                    continue;
+
+                memcpy(dst, &vertex, POINT_SIZE);
+                dst += POINT_SIZE;
+
+                if(has_color)
+                {
+                    uint8_t rgb[3] = {0, 0, 0};
+                    //uvmap coordinates are normalized, unmapped pixels are negative
+                    const int x = static_cast<int>(uvmap[i].x * color_info->width);
+                    const int y = static_cast<int>(uvmap[i].y * color_info->height);
+                    if(uvmap[i].x >= 0 && uvmap[i].y >= 0 && x < color_info->width && y < color_info->height)
+                    {
+                        const uint8_t * pixel = color_data + y * color_info->pitch + x * layout.pixel_size;
+                        rgb[0] = pixel[layout.red];
+                        rgb[1] = pixel[layout.green];
+                        rgb[2] = pixel[layout.blue];
+                    }
+                    if(m_format == point_cloud_format::ply)
+                    {
+                        memcpy(dst, rgb, PLY_COLOR_SIZE);
+                    }
+                    else
+                    {
+                        //pcd packs the color as 0x00RRGGBB
+                        const uint32_t packed = (static_cast<uint32_t>(rgb[0]) << 16) | (static_cast<uint32_t>(rgb[1]) << 8) | rgb[2];
+                        memcpy(dst, &packed, PCD_COLOR_SIZE);
+                    }
+                    dst += color_size;
+                }
+                points_count++;
+            }
+            return points_count;
+        }
+
+        std::string point_cloud_writer_impl::create_header(uint32_t points_count, bool has_color) const
+        {
+            std::ostringstream header;
+            if(m_format == point_cloud_format::ply)
+            {
+                header << "ply\n"
+                       << "format binary_little_endian 1.0\n"
+                       << "comment generated by realsense sdk, units are millimeters\n"
+                       << "element vertex " << points_count << "\n"
+                       << "property float x\n"
+                       << "property float y\n"
+                       << "property float z\n";
+                if(has_color)
+                {
+                    header << "property uchar red\n"
+                           << "property uchar green\n"
+                           << "property uchar blue\n";
+                }
+                header << "end_header\n";
+            }
+            else
+            {
+                header << "# .PCD v0.7 - generated by realsense sdk, units are millimeters\n"
+                       << "VERSION 0.7\n"
+                       << (has_color ? "FIELDS x y z rgb\n" : "FIELDS x y z\n")
+                       << (has_color ? "SIZE 4 4 4 4\n" : "SIZE 4 4 4\n")
+                       << (has_color ? "TYPE F F F U\n" : "TYPE F F F\n")
+                       << (has_color ? "COUNT 1 1 1 1\n" : "COUNT 1 1 1\n")
+                       << "WIDTH " << points_count << "\n"
+                       << "HEIGHT 1\n"
+                       << "VIEWPOINT 0 0 0 1 0 0 0\n"
+                       << "POINTS " << points_count << "\n"
+                       << "DATA binary\n";
+            }
+            return header.str();
+        }
+    }
+}
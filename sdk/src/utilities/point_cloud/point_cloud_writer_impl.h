@@ -0,0 +1,78 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <vector>
+#include <deque>
+#include <string>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <condition_variable>
+#include "rs/utils/point_cloud_writer_interface.h"
+#include "rs/utils/release_self_base.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        class point_cloud_writer_impl : public release_self_base<point_cloud_writer_interface>
+        {
+        public:
+            point_cloud_writer_impl(point_cloud_format format, uint32_t workers_count);
+            virtual ~point_cloud_writer_impl();
+
+            rs::core::status write(const char * file_path, const point_cloud_frame & frame) override;
+            rs::core::status write_async(const char * file_path, const point_cloud_frame & frame) override;
+            rs::core::status flush() override;
+            statistics query_statistics() const override;
+
+        private:
+            //a queued frame owns copies of the caller buffers, jobs are recycled to avoid per frame allocations
+            struct job
+            {
+                std::string                             file_path;
+                std::vector<rs::core::point3dF32>       vertices;
+                std::vector<rs::core::pointF32>         uvmap;
+                std::vector<uint8_t>                    color_data;
+                rs::core::image_info                    color_info;
+                bool                                    has_color;
+                rs::core::sizeI32                       size;
+            };
+
+            void worker_thread();
+            //color_info and color_data are null when the point cloud has no color
+            rs::core::status write_file(const char * file_path, const rs::core::point3dF32 * vertices, rs::core::sizeI32 size,
+                                        const rs::core::image_info * color_info, const uint8_t * color_data, const rs::core::pointF32 * uvmap,
+                                        std::vector<uint8_t> & buffer);
+            void update_statistics(rs::core::status sts, uint64_t points, uint64_t bytes);
+
+            //serializes the valid points to buffer, returns the number of points written
+            uint32_t serialize_points(const rs::core::point3dF32 * vertices, rs::core::sizeI32 size, const rs::core::image_info * color_info,
+                                      const uint8_t * color_data, const rs::core::pointF32 * uvmap, std::vector<uint8_t> & buffer) const;
+            std::string create_header(uint32_t points_count, bool has_color) const;
+
+            const point_cloud_format                                    m_format;
+            std::vector<std::thread>                                    m_workers;
+            size_t                                                      m_max_pending_jobs;
+
+            std::mutex                                                  m_jobs_mutex; //protects m_jobs, m_free_jobs, m_pending_jobs, m_stop_workers
+            std::condition_variable                                     m_jobs_cv;
+            std::condition_variable                                     m_jobs_done_cv;
+            std::deque<std::unique_ptr<job>>                            m_jobs;
+            std::vector<std::unique_ptr<job>>                           m_free_jobs;
+            size_t                                                      m_pending_jobs;
+            bool                                                        m_stop_workers;
+            bool                                                        m_async_write_failed;
+
+            std::vector<uint8_t>                                        m_sync_buffer;
+
+            mutable std::mutex                                          m_statistics_mutex;
+            statistics                                                  m_statistics;
+            bool                                                        m_first_write_done;
+            std::chrono::steady_clock::time_point                       m_first_write_time;
+            std::chrono::steady_clock::time_point                       m_last_write_time;
+        };
+    }
+}
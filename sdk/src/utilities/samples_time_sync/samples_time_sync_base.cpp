@@ -2,6 +2,7 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include "samples_time_sync_base.h"
+#include "rs/utils/event_tracer.h"
 #include <algorithm>
 
 
@@ -116,6 +117,7 @@ bool rs::utils::samples_time_sync_base::insert(image_interface * new_image,
     if (!is_stream_registered(stream_type))
         throw std::invalid_argument("Stream was not registered to this sync utility instance!");
 
+    TRACE_SCOPE("time_sync", "insert_image");
     std::lock_guard<std::mutex> lock_guard(m_image_mutex);
 
     m_streams_map[stream_type].push_back(new_unique_image);
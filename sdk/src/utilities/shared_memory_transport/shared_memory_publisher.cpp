@@ -0,0 +1,118 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <cstring>
+#include "shared_memory_publisher.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+using namespace rs::utils::shared_memory;
+
+namespace rs
+{
+    namespace utils
+    {
+        shared_memory_publisher_interface * shared_memory_publisher_interface::create_instance(const char * name, uint32_t slots_count, uint64_t slot_size)
+        {
+            //with a single slot the publisher would wait for the subscribers to release the latest set
+            if(!name || slots_count < 2 || slot_size == 0)
+                return nullptr;
+            auto shared_region = region::create(name, slots_count, slot_size);
+            return shared_region ? new shared_memory_publisher(shared_region) : nullptr;
+        }
+
+        shared_memory_publisher::shared_memory_publisher(std::shared_ptr<region> shared_region) :
+            m_region(shared_region),
+            m_dropped_count(0)
+        {
+
+        }
+
+        shared_memory_publisher::~shared_memory_publisher()
+        {
+            region_lock lock(*m_region);
+            m_region->header().is_publisher_active = 0;
+            pthread_cond_broadcast(&m_region->header().published);
+        }
+
+        status shared_memory_publisher::publish(const correlated_sample_set & sample_set)
+        {
+            auto & header = m_region->header();
+            uint64_t data_size = 0;
+            bool is_empty = true;
+            for(int i = 0; i < static_cast<int>(stream_type::max); i++)
+            {
+                auto image = sample_set.images[i];
+                if(!image || !image->query_data())
+                    continue;
+                auto info = image->query_info();
+                data_size += align(static_cast<uint64_t>(info.pitch) * static_cast<uint64_t>(info.height));
+                is_empty = false;
+            }
+            for(int i = 0; i < static_cast<int>(motion_type::max); i++)
+                is_empty &= sample_set.motion_samples[i].timestamp == 0;
+            if(is_empty || data_size > header.slot_data_size)
+                return status_invalid_argument;
+
+            int32_t slot_index = acquire_slot();
+            if(slot_index < 0)
+            {
+                m_dropped_count++;
+                LOG_VERBOSE("all the shared memory slots are held by the subscribers, sample set dropped");
+                return status_item_unavailable;
+            }
+
+            //the slot is written without the lock, the subscribers don't take a slot while it is being written
+            auto & slot = m_region->slot(slot_index);
+            auto slot_data = m_region->slot_data(slot_index);
+            uint64_t offset = 0;
+            for(int i = 0; i < static_cast<int>(stream_type::max); i++)
+            {
+                auto & record = slot.images[i];
+                auto image = sample_set.images[i];
+                record.is_valid = image && image->query_data();
+                if(!record.is_valid)
+                    continue;
+                record.info = image->query_info();
+                record.flags = static_cast<int32_t>(image->query_flags());
+                record.time_stamp = image->query_time_stamp();
+                record.time_stamp_domain = image->query_time_stamp_domain();
+                record.frame_number = image->query_frame_number();
+                record.data_offset = offset;
+                auto size = static_cast<uint64_t>(record.info.pitch) * static_cast<uint64_t>(record.info.height);
+                memcpy(slot_data + offset, image->query_data(), static_cast<size_t>(size));
+                offset += align(size);
+            }
+            memcpy(slot.motion_samples, sample_set.motion_samples, sizeof(slot.motion_samples));
+
+            region_lock lock(*m_region);
+            slot.is_writing = 0;
+            slot.sequence = ++header.sequence;
+            header.latest_slot = slot_index;
+            pthread_cond_broadcast(&header.published);
+            return status_no_error;
+        }
+
+        int32_t shared_memory_publisher::acquire_slot()
+        {
+            region_lock lock(*m_region);
+            auto & header = m_region->header();
+            const int32_t slots_count = static_cast<int32_t>(header.slots_count);
+            //the slots are taken in a ring order, skipping the held ones, so a slot is reused as late as possible.
+            //when all the slots are held, the holds of the subscribers which terminated without releasing their images are reclaimed
+            do
+            {
+                for(int32_t i = 1; i <= slots_count; i++)
+                {
+                    int32_t index = (header.latest_slot + i) % slots_count;
+                    auto & slot = m_region->slot(index);
+                    if(index == header.latest_slot || slot.readers_count > 0)
+                        continue;
+                    slot.is_writing = 1;
+                    return index;
+                }
+            } while(m_region->reclaim_terminated_subscribers());
+            return -1;
+        }
+    }
+}
@@ -0,0 +1,31 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include "rs/utils/shared_memory_transport_interface.h"
+#include "rs/utils/release_self_base.h"
+#include "shared_memory_region.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        class shared_memory_publisher : public release_self_base<shared_memory_publisher_interface>
+        {
+        public:
+            shared_memory_publisher(std::shared_ptr<shared_memory::region> region);
+            virtual ~shared_memory_publisher();
+
+            rs::core::status publish(const rs::core::correlated_sample_set & sample_set) override;
+            uint64_t query_dropped_count() const override { return m_dropped_count; }
+
+        private:
+            //takes a slot which isn't held by a subscriber and isn't the latest published one, returns -1 when all the slots are held
+            int32_t acquire_slot();
+
+            std::shared_ptr<shared_memory::region>  m_region;
+            uint64_t                                m_dropped_count;
+        };
+    }
+}
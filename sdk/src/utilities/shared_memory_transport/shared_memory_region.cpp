@@ -0,0 +1,197 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <cstring>
+#include "shared_memory_region.h"
+#include "rs/utils/log_utils.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace shared_memory
+        {
+            namespace
+            {
+                //shared memory object names start with a slash
+                std::string to_object_name(const std::string & name)
+                {
+                    return (!name.empty() && name[0] == '/') ? name : "/" + name;
+                }
+
+                bool init_sync_objects(region_header & header)
+                {
+                    pthread_mutexattr_t mutex_attributes;
+                    pthread_mutexattr_init(&mutex_attributes);
+                    pthread_mutexattr_setpshared(&mutex_attributes, PTHREAD_PROCESS_SHARED);
+                    pthread_mutexattr_setrobust(&mutex_attributes, PTHREAD_MUTEX_ROBUST);
+                    int mutex_sts = pthread_mutex_init(&header.mutex, &mutex_attributes);
+                    pthread_mutexattr_destroy(&mutex_attributes);
+
+                    pthread_condattr_t cond_attributes;
+                    pthread_condattr_init(&cond_attributes);
+                    pthread_condattr_setpshared(&cond_attributes, PTHREAD_PROCESS_SHARED);
+                    pthread_condattr_setclock(&cond_attributes, CLOCK_MONOTONIC);
+                    int cond_sts = pthread_cond_init(&header.published, &cond_attributes);
+                    pthread_condattr_destroy(&cond_attributes);
+                    return mutex_sts == 0 && cond_sts == 0;
+                }
+            }
+
+            std::shared_ptr<region> region::create(const std::string & name, uint32_t slots_count, uint64_t slot_data_size)
+            {
+                const std::string object_name = to_object_name(name);
+                const uint64_t slot_stride = align(align(sizeof(slot_header)) + slot_data_size);
+                const uint64_t size = align(sizeof(region_header)) + slot_stride * slots_count;
+
+                //a region left by a terminated publisher is replaced, its subscribers keep their mapping of the old region
+                shm_unlink(object_name.c_str());
+                int fd = shm_open(object_name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+                if(fd < 0)
+                {
+                    LOG_ERROR("failed to create shared memory " << object_name.c_str() << ", errno - " << errno);
+                    return nullptr;
+                }
+                void * data = MAP_FAILED;
+                if(ftruncate(fd, static_cast<off_t>(size)) == 0)
+                    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if(data == MAP_FAILED)
+                {
+                    LOG_ERROR("failed to map shared memory " << object_name.c_str() << " of size " << size << ", errno - " << errno);
+                    shm_unlink(object_name.c_str());
+                    return nullptr;
+                }
+
+                std::shared_ptr<region> rv(new region(object_name, static_cast<uint8_t *>(data), size, true));
+                //the pages of a new object are zero filled, only the non zero fields are set
+                auto & header = rv->header();
+                header.slots_count = slots_count;
+                header.slot_data_size = slot_data_size;
+                header.slot_stride = slot_stride;
+                header.latest_slot = -1;
+                header.is_publisher_active = 1;
+                if(!init_sync_objects(header))
+                {
+                    LOG_ERROR("failed to initialize the synchronization objects of shared memory " << object_name.c_str());
+                    return nullptr;
+                }
+                //the magic is set last, a subscriber doesn't attach to a region which is being initialized
+                header.version = region_version;
+                __atomic_store_n(&header.magic, region_magic, __ATOMIC_RELEASE);
+                return rv;
+            }
+
+            std::shared_ptr<region> region::open(const std::string & name)
+            {
+                const std::string object_name = to_object_name(name);
+                int fd = shm_open(object_name.c_str(), O_RDWR, 0);
+                if(fd < 0)
+                {
+                    LOG_ERROR("failed to open shared memory " << object_name.c_str() << ", errno - " << errno);
+                    return nullptr;
+                }
+                struct stat object_stat = {};
+                void * data = MAP_FAILED;
+                if(fstat(fd, &object_stat) == 0 && static_cast<uint64_t>(object_stat.st_size) >= sizeof(region_header))
+                    data = mmap(nullptr, static_cast<size_t>(object_stat.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                close(fd);
+                if(data == MAP_FAILED)
+                {
+                    LOG_ERROR("failed to map shared memory " << object_name.c_str());
+                    return nullptr;
+                }
+
+                std::shared_ptr<region> rv(new region(object_name, static_cast<uint8_t *>(data), static_cast<size_t>(object_stat.st_size), false));
+                auto & header = rv->header();
+                if(__atomic_load_n(&header.magic, __ATOMIC_ACQUIRE) != region_magic || header.version != region_version ||
+                   rv->slot_offset(header.slots_count) > rv->m_size)
+                {
+                    LOG_ERROR("shared memory " << object_name.c_str() << " is not a transport region of this version");
+                    return nullptr;
+                }
+                return rv;
+            }
+
+            region::region(const std::string & name, uint8_t * data, size_t size, bool is_owner) :
+                m_name(name), m_data(data), m_size(size), m_is_owner(is_owner)
+            {
+
+            }
+
+            region::~region()
+            {
+                munmap(m_data, m_size);
+                if(m_is_owner)
+                    shm_unlink(m_name.c_str());
+            }
+
+            void region::lock()
+            {
+                if(pthread_mutex_lock(&header().mutex) == EOWNERDEAD)
+                {
+                    //the slots state is updated in single steps under the mutex, so it is consistent after any of them
+                    LOG_WARN("a process terminated while holding the lock of shared memory " << m_name.c_str());
+                    pthread_mutex_consistent(&header().mutex);
+                }
+            }
+
+            void region::unlock()
+            {
+                pthread_mutex_unlock(&header().mutex);
+            }
+
+            int32_t region::attach_subscriber()
+            {
+                region_lock lock(*this);
+                auto & region_header = header();
+                do
+                {
+                    for(uint32_t i = 0; i < max_subscribers; i++)
+                    {
+                        if(region_header.subscriber_process_ids[i] != 0)
+                            continue;
+                        region_header.subscriber_process_ids[i] = static_cast<int32_t>(getpid());
+                        return static_cast<int32_t>(i);
+                    }
+                } while(reclaim_terminated_subscribers());
+                return -1;
+            }
+
+            void region::detach_subscriber(int32_t index)
+            {
+                region_lock lock(*this);
+                header().subscriber_process_ids[index] = 0;
+            }
+
+            bool region::reclaim_terminated_subscribers()
+            {
+                auto & region_header = header();
+                bool is_reclaimed = false;
+                for(uint32_t i = 0; i < max_subscribers; i++)
+                {
+                    //a process which can't be signaled for lack of permissions is alive
+                    const pid_t process_id = static_cast<pid_t>(region_header.subscriber_process_ids[i]);
+                    if(process_id == 0 || kill(process_id, 0) == 0 || errno != ESRCH)
+                        continue;
+                    for(uint32_t j = 0; j < region_header.slots_count; j++)
+                    {
+                        auto & held_slot = slot(static_cast<int32_t>(j));
+                        held_slot.readers_count -= held_slot.subscriber_holds[i];
+                        held_slot.subscriber_holds[i] = 0;
+                    }
+                    region_header.subscriber_process_ids[i] = 0;
+                    is_reclaimed = true;
+                    LOG_WARN("reclaimed the slots held by the terminated subscriber process " << process_id << " of shared memory " << m_name.c_str());
+                }
+                return is_reclaimed;
+            }
+        }
+    }
+}
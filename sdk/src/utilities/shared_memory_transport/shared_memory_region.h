@@ -0,0 +1,117 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <memory>
+#include <string>
+#include "rs/core/types.h"
+#include "rs/core/image_interface.h"
+#include "rs/core/motion_sample.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace shared_memory
+        {
+            static const uint32_t region_magic = 0x4d535352; //"RSSM"
+            static const uint32_t region_version = 2;
+            static const uint64_t data_alignment = 64;
+            static const uint32_t max_subscribers = 32;
+
+            inline uint64_t align(uint64_t size) { return (size + data_alignment - 1) & ~(data_alignment - 1); }
+
+            struct image_record
+            {
+                uint32_t                        is_valid;
+                int32_t                         flags;
+                rs::core::image_info            info;
+                rs::core::timestamp_domain      time_stamp_domain;
+                double                          time_stamp;
+                uint64_t                        frame_number;
+                uint64_t                        data_offset;    //from the slot data
+            };
+
+            struct slot_header
+            {
+                uint32_t                        readers_count;  //received images of the slot which were not released yet
+                uint32_t                        subscriber_holds[max_subscribers]; //the readers count of each subscriber entry
+                uint32_t                        is_writing;
+                uint64_t                        sequence;
+                image_record                    images[static_cast<uint8_t>(rs::core::stream_type::max)];
+                rs::core::motion_sample         motion_samples[static_cast<uint8_t>(rs::core::motion_type::max)];
+            };
+
+            //the region starts with the header, followed by the slots, each slot is its header followed by its images data
+            struct region_header
+            {
+                uint32_t                        magic;
+                uint32_t                        version;
+                uint32_t                        slots_count;
+                uint32_t                        is_publisher_active;
+                uint64_t                        slot_data_size;
+                uint64_t                        slot_stride;
+                pthread_mutex_t                 mutex;          //process shared and robust, guards the fields below and the slots state
+                pthread_cond_t                  published;      //process shared, signaled on every published set
+                uint64_t                        sequence;       //of the latest published set, 0 before the first set
+                int32_t                         latest_slot;    //slot of the latest published set, -1 before the first set
+                int32_t                         subscriber_process_ids[max_subscribers]; //process of each subscriber entry, 0 when free
+            };
+
+            /**
+            * @brief A mapped POSIX shared memory object holding a transport region.
+            *
+            * The creating process owns the name, which is unlinked when the owner is destroyed. The mapping of the other processes
+            * stays valid after the name is unlinked.
+            */
+            class region
+            {
+            public:
+                //creates the region with its header initialized, returns null on failure
+                static std::shared_ptr<region> create(const std::string & name, uint32_t slots_count, uint64_t slot_data_size);
+                //maps an existing region, returns null on failure or when the region layout doesn't match
+                static std::shared_ptr<region> open(const std::string & name);
+                ~region();
+
+                region_header & header() { return *reinterpret_cast<region_header *>(m_data); }
+                slot_header & slot(int32_t index) { return *reinterpret_cast<slot_header *>(m_data + slot_offset(index)); }
+                uint8_t * slot_data(int32_t index) { return m_data + slot_offset(index) + align(sizeof(slot_header)); }
+
+                //locks the region mutex, recovers the mutex of a process which terminated while holding it
+                void lock();
+                void unlock();
+
+                //takes a free subscriber entry for the calling process, returns -1 when all the entries are taken by live processes
+                int32_t attach_subscriber();
+                //frees a subscriber entry, once all the received images of the subscriber are released
+                void detach_subscriber(int32_t index);
+                //releases the slot holds of the subscriber entries of terminated processes and frees the entries, must be called with
+                //the lock held, returns whether any entry was reclaimed
+                bool reclaim_terminated_subscribers();
+
+            private:
+                region(const std::string & name, uint8_t * data, size_t size, bool is_owner);
+                region(const region &) = delete;
+                region & operator=(const region &) = delete;
+                uint64_t slot_offset(int32_t index) { return align(sizeof(region_header)) + static_cast<uint64_t>(index) * header().slot_stride; }
+
+                std::string     m_name;
+                uint8_t *       m_data;
+                size_t          m_size;
+                bool            m_is_owner;
+            };
+
+            class region_lock
+            {
+            public:
+                region_lock(region & locked_region) : m_region(locked_region) { m_region.lock(); }
+                ~region_lock() { m_region.unlock(); }
+            private:
+                region & m_region;
+            };
+        }
+    }
+}
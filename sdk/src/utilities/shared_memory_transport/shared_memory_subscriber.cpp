@@ -0,0 +1,141 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <errno.h>
+#include <time.h>
+#include "shared_memory_subscriber.h"
+#include "rs/utils/log_utils.h"
+
+using namespace rs::core;
+using namespace rs::utils::shared_memory;
+
+namespace
+{
+    //releases a received image of a slot, the slot is reused once all the received images of its set are released
+    class slot_releaser : public rs::utils::release_self_base<rs::core::release_interface>
+    {
+    public:
+        slot_releaser(std::shared_ptr<subscriber_entry> entry, int32_t slot_index) : m_entry(entry), m_slot_index(slot_index) {}
+        int release() const override
+        {
+            {
+                auto & shared_region = m_entry->attached_region();
+                region_lock lock(shared_region);
+                auto & slot = shared_region.slot(m_slot_index);
+                slot.readers_count--;
+                slot.subscriber_holds[m_entry->index()]--;
+            }
+            return release_self_base::release(); //object destructed, return immediately
+        }
+    protected:
+        ~slot_releaser() {}
+    private:
+        std::shared_ptr<subscriber_entry>   m_entry; //keeps the entry and the region mapped while its images are used
+        int32_t                             m_slot_index;
+    };
+
+    timespec get_deadline(uint32_t timeout_ms)
+    {
+        timespec deadline = {};
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += static_cast<long>(timeout_ms % 1000) * 1000000;
+        if(deadline.tv_nsec >= 1000000000)
+        {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+        return deadline;
+    }
+}
+
+namespace rs
+{
+    namespace utils
+    {
+        shared_memory_subscriber_interface * shared_memory_subscriber_interface::create_instance(const char * name)
+        {
+            if(!name)
+                return nullptr;
+            auto shared_region = region::open(name);
+            if(!shared_region)
+                return nullptr;
+            const int32_t entry_index = shared_region->attach_subscriber();
+            if(entry_index < 0)
+            {
+                LOG_ERROR("the shared memory " << name << " has no free subscriber entry");
+                return nullptr;
+            }
+            return new shared_memory_subscriber(std::make_shared<subscriber_entry>(shared_region, entry_index));
+        }
+
+        shared_memory_subscriber::shared_memory_subscriber(std::shared_ptr<subscriber_entry> entry) :
+            m_entry(entry),
+            m_last_sequence(0),
+            m_skipped_count(0)
+        {
+            //only the sets published after the subscriber was attached are received
+            region_lock lock(m_entry->attached_region());
+            m_last_sequence = m_entry->attached_region().header().sequence;
+        }
+
+        status shared_memory_subscriber::receive(correlated_sample_set & sample_set, uint32_t timeout_ms)
+        {
+            auto & shared_region = m_entry->attached_region();
+            auto & header = shared_region.header();
+            int32_t slot_index = -1;
+            image_record records[static_cast<uint8_t>(stream_type::max)];
+            {
+                region_lock lock(shared_region);
+                const timespec deadline = get_deadline(timeout_ms);
+                while(header.sequence == m_last_sequence && header.is_publisher_active)
+                {
+                    int wait_sts = pthread_cond_timedwait(&header.published, &header.mutex, &deadline);
+                    if(wait_sts == EOWNERDEAD)
+                        pthread_mutex_consistent(&header.mutex);
+                    if(wait_sts == ETIMEDOUT)
+                        break;
+                }
+                if(header.sequence == m_last_sequence)
+                    return header.is_publisher_active ? status_exec_timeout : status_device_lost;
+
+                slot_index = header.latest_slot;
+                m_skipped_count += header.sequence - m_last_sequence - 1;
+                m_last_sequence = header.sequence;
+                //the slot is held for every received image, until the image is released. the records and the motion samples
+                //are copied with the lock held, since a set without images doesn't hold its slot
+                auto & slot = shared_region.slot(slot_index);
+                for(int i = 0; i < static_cast<int>(stream_type::max); i++)
+                {
+                    records[i] = slot.images[i];
+                    const uint32_t hold = records[i].is_valid ? 1 : 0;
+                    slot.readers_count += hold;
+                    slot.subscriber_holds[m_entry->index()] += hold;
+                }
+                for(int i = 0; i < static_cast<int>(motion_type::max); i++)
+                    sample_set.motion_samples[i] = slot.motion_samples[i];
+            }
+
+            //a held slot isn't written, so the images data is referenced without the lock
+            auto slot_data = shared_region.slot_data(slot_index);
+            for(int i = 0; i < static_cast<int>(stream_type::max); i++)
+            {
+                auto & record = records[i];
+                if(!record.is_valid)
+                {
+                    sample_set.images[i] = nullptr;
+                    continue;
+                }
+                image_info info = record.info;
+                sample_set.images[i] = image_interface::create_instance_from_raw_data(&info,
+                                                                                      { slot_data + record.data_offset, new slot_releaser(m_entry, slot_index) },
+                                                                                      static_cast<stream_type>(i),
+                                                                                      static_cast<image_interface::flag>(record.flags),
+                                                                                      record.time_stamp,
+                                                                                      record.frame_number,
+                                                                                      record.time_stamp_domain);
+            }
+            return status_no_error;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <memory>
+#include "rs/utils/shared_memory_transport_interface.h"
+#include "rs/utils/release_self_base.h"
+#include "shared_memory_region.h"
+
+namespace rs
+{
+    namespace utils
+    {
+        namespace shared_memory
+        {
+            /**
+            * @brief The entry of a subscriber in the region, freed when the subscriber and all its received images are released.
+            *
+            * The entry counts the slot holds of the subscriber, so the holds of a process which terminated can be reclaimed.
+            */
+            class subscriber_entry
+            {
+            public:
+                subscriber_entry(std::shared_ptr<region> attached_region, int32_t index) : m_region(attached_region), m_index(index) {}
+                ~subscriber_entry() { m_region->detach_subscriber(m_index); }
+
+                region & attached_region() { return *m_region; }
+                int32_t index() const { return m_index; }
+
+            private:
+                subscriber_entry(const subscriber_entry &) = delete;
+                subscriber_entry & operator=(const subscriber_entry &) = delete;
+
+                std::shared_ptr<region>     m_region; //keeps the region mapped while the images of the subscriber are used
+                int32_t                     m_index;
+            };
+        }
+
+        class shared_memory_subscriber : public release_self_base<shared_memory_subscriber_interface>
+        {
+        public:
+            shared_memory_subscriber(std::shared_ptr<shared_memory::subscriber_entry> entry);
+            virtual ~shared_memory_subscriber() {}
+
+            rs::core::status receive(rs::core::correlated_sample_set & sample_set, uint32_t timeout_ms) override;
+            uint64_t query_skipped_count() const override { return m_skipped_count; }
+
+        private:
+            std::shared_ptr<shared_memory::subscriber_entry>    m_entry;
+            uint64_t                                            m_last_sequence;
+            uint64_t                                            m_skipped_count;
+        };
+    }
+}
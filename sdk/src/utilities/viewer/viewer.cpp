@@ -1,6 +1,8 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <string.h>
+#include <algorithm>
 #include "viewer.h"
 #include "rs_sdk_version.h"
 
@@ -30,7 +32,13 @@ namespace rs
             m_stream_count(stream_count),
             m_user_on_close_callback(on_close_callback),
             m_title(title),
-            m_is_running(true)
+            m_is_running(true),
+            m_max_render_rate(0),
+            m_decimation_factor(1),
+            m_show_image_time_histogram(PERF_COUNTERS.query_histogram("viewer.show_image_time_ns")),
+            m_convert_time_histogram(PERF_COUNTERS.query_histogram("viewer.convert_time_us")),
+            m_replaced_images_counter(PERF_COUNTERS.query_counter("viewer.images_replaced")),
+            m_rendered_images_counter(PERF_COUNTERS.query_counter("viewer.images_rendered"))
         {
             m_ui_thread = std::thread(&viewer::ui_refresh, this);
         }
@@ -67,16 +75,35 @@ namespace rs
                     return ((m_is_running == false) || (m_render_buffer.size() > 0));
             };
 
+            const auto poll_interval = std::chrono::milliseconds(10);
+            auto next_render_time = std::chrono::steady_clock::now();
+
             while(m_is_running)
             {
                 std::unique_lock<std::mutex> locker(m_render_mutex);
-                bool render =  m_render_thread_cv.wait_for(locker, std::chrono::milliseconds(10), pred);
+                bool render = false;
+                auto now = std::chrono::steady_clock::now();
+                if(now < next_render_time)
+                {
+                    //the render rate is capped, meanwhile newer images replace the buffered ones
+                    m_render_thread_cv.wait_until(locker, std::min(next_render_time, now + poll_interval), [this]() { return m_is_running == false; });
+                }
+                else
+                {
+                    render = m_render_thread_cv.wait_for(locker, poll_interval, pred);
+                }
 
                 if (render == true)
                 {
                     if (m_is_running == false)
                         break;
 
+                    auto max_render_rate = m_max_render_rate.load();
+                    if(max_render_rate > 0)
+                    {
+                        next_render_time = std::chrono::steady_clock::now() + std::chrono::microseconds(1000000 / max_render_rate);
+                    }
+
                     for (auto& image_pair : m_render_buffer)
                     {
                         images.emplace_back(image_pair.second);
@@ -94,6 +121,7 @@ namespace rs
                     for (auto& image : images)
                     {
                         render_image(image);
+                        m_rendered_images_counter.add();
                     }
 
                     images.clear();
@@ -122,6 +150,9 @@ namespace rs
 
         void viewer::update_buffer(std::shared_ptr<rs::core::image_interface>& image)
         {
+            //runs on the caller thread, typically a frame callback, so the conversion and the rendering are left to the ui thread
+            auto start_time = std::chrono::steady_clock::now();
+            std::shared_ptr<rs::core::image_interface> replaced_image;
             std::unique_lock<std::mutex> locker(m_render_mutex);
 
             if (m_is_running)
@@ -129,17 +160,32 @@ namespace rs
                 rs::core::stream_type stream_type = image->query_stream_type();
 
                 bool notify = false;
-                if (m_render_buffer.find(stream_type) == m_render_buffer.end())
+                auto buffered_image = m_render_buffer.find(stream_type);
+                if (buffered_image == m_render_buffer.end())
+                {
                     notify = true;
-
-                m_render_buffer[image->query_stream_type()] =image;
+                    m_render_buffer[stream_type] = image;
+                }
+                else
+                {
+                    //release the replaced image out of the lock
+                    replaced_image.swap(buffered_image->second);
+                    buffered_image->second = image;
+                    m_replaced_images_counter.add();
+                }
 
                 locker.unlock();
 
                 if (notify)
                     m_render_thread_cv.notify_one();
             }
+            else
+            {
+                locker.unlock();
+            }
 
+            replaced_image.reset();
+            m_show_image_time_histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count());
         }
 
         void viewer::show_image(const rs::core::image_interface * image)
@@ -156,6 +202,16 @@ namespace rs
             update_buffer(image);
         }
 
+        void viewer::set_max_render_rate(uint32_t max_render_rate)
+        {
+            m_max_render_rate = max_render_rate;
+        }
+
+        void viewer::set_decimation_factor(uint32_t decimation_factor)
+        {
+            m_decimation_factor = decimation_factor > 0 ? decimation_factor : 1;
+        }
+
         void viewer::render_image(std::shared_ptr<rs::core::image_interface> image)
         {
             auto stream = image->query_stream_type();
@@ -163,45 +219,55 @@ namespace rs
             if(!add_window(stream)) return;
 
             int gl_format, gl_channel_type;
+            uint32_t bytes_per_pixel;
             const core::image_interface * converted_image = nullptr;
             const core::image_interface * image_to_show = image.get();
+            auto start_time = std::chrono::steady_clock::now();
 
             switch(image->query_info().format)
             {
                 case rs::core::pixel_format::rgb8:
                     gl_format = GL_RGB;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 3;
                     break;
                 case rs::core::pixel_format::bgr8:
                     gl_format = GL_BGR_EXT;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 3;
                     break;
                 case rs::core::pixel_format::yuyv:
                     if(image->convert_to(core::pixel_format::rgba8, &converted_image) != core::status_no_error) return;
                     gl_format = GL_RGBA;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 4;
                     break;
                 case rs::core::pixel_format::rgba8:
                     gl_format = GL_RGBA;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 4;
                     break;
                 case rs::core::pixel_format::bgra8:
                     gl_format = GL_BGRA_EXT;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 4;
                     break;
                 case rs::core::pixel_format::raw8:
                 case rs::core::pixel_format::y8:
                     gl_format = GL_LUMINANCE;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 1;
                     break;
                 case rs::core::pixel_format::y16:
                     gl_format = GL_LUMINANCE;
                     gl_channel_type = GL_SHORT;
+                    bytes_per_pixel = 2;
                     break;
                 case rs::core::pixel_format::z16:
                     if(image->convert_to(core::pixel_format::rgba8, &converted_image) != core::status_no_error) return;
                     gl_format = GL_RGBA;
                     gl_channel_type = GL_UNSIGNED_BYTE;
+                    bytes_per_pixel = 4;
                     break;
                 default:
                     throw std::runtime_error("format is not supported");
@@ -214,7 +280,39 @@ namespace rs
                 image_to_show = converted_image;
             }
 
-            draw(image_to_show, gl_format, gl_channel_type);
+            auto info = image_to_show->query_info();
+            auto decimation_factor = m_decimation_factor.load();
+            const void * data = image_to_show->query_data();
+            if(decimation_factor > 1)
+            {
+                data = decimate(image_to_show, bytes_per_pixel, decimation_factor);
+                info.width = (info.width + decimation_factor - 1) / decimation_factor;
+                info.height = (info.height + decimation_factor - 1) / decimation_factor;
+            }
+            m_convert_time_histogram.record(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count());
+
+            draw(stream, info.width, info.height, data, gl_format, gl_channel_type);
+        }
+
+        const uint8_t * viewer::decimate(const rs::core::image_interface * image, uint32_t bytes_per_pixel, uint32_t decimation_factor)
+        {
+            auto info = image->query_info();
+            const uint32_t width = (info.width + decimation_factor - 1) / decimation_factor;
+            const uint32_t height = (info.height + decimation_factor - 1) / decimation_factor;
+            m_decimated_data.resize(width * height * bytes_per_pixel);
+
+            auto source = static_cast<const uint8_t *>(image->query_data());
+            auto destination = m_decimated_data.data();
+            for(uint32_t y = 0; y < height; y++)
+            {
+                auto source_row = source + y * decimation_factor * info.pitch;
+                for(uint32_t x = 0; x < width; x++)
+                {
+                    memcpy(destination, source_row + x * decimation_factor * bytes_per_pixel, bytes_per_pixel);
+                    destination += bytes_per_pixel;
+                }
+            }
+            return m_decimated_data.data();
         }
 
         bool viewer::add_window(rs::core::stream_type stream)
@@ -235,9 +333,9 @@ namespace rs
             return true;
         }
 
-        void viewer::draw(const rs::core::image_interface * image, int gl_format, int gl_channel_type)
+        void viewer::draw(rs::core::stream_type stream, int image_width, int image_height, const void * data, int gl_format, int gl_channel_type)
         {
-            auto rect = calc_window_size(image);
+            auto rect = calc_window_size(stream, image_width, image_height);
 
             auto x_entry = rect.first.first;
             auto y_entry = rect.first.second;
@@ -252,7 +350,8 @@ namespace rs
             glPushMatrix();
             glOrtho(0, width, height, 0, -1, +1);
 
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image->query_info().width, image->query_info().height, 0, gl_format, gl_channel_type, image->query_data());
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1); //the decimated rows are not padded
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image_width, image_height, 0, gl_format, gl_channel_type, data);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
             glBindTexture(GL_TEXTURE_2D, 0);
@@ -268,10 +367,9 @@ namespace rs
             glfwSwapBuffers(m_window);
         }
 
-        std::pair<viewer::int_pair, viewer::int_pair> viewer::calc_window_size(const rs::core::image_interface * image)
+        std::pair<viewer::int_pair, viewer::int_pair> viewer::calc_window_size(rs::core::stream_type stream, int image_width, int image_height)
         {
-            auto info = image->query_info();
-            size_t position = m_windows_positions.at(image->query_stream_type());
+            size_t position = m_windows_positions.at(stream);
 
             int window_width, window_height;
             glfwGetWindowSize(m_window, &window_width, &window_height);
@@ -281,11 +379,11 @@ namespace rs
             double grid_cell_width = window_width / (double)window_grid.first;
             double grid_cell_height = window_height / (double)window_grid.second;
 
-            double scale_width = grid_cell_width / (double)info.width;
-            double scale_height = grid_cell_height / (double)info.height;
+            double scale_width = grid_cell_width / (double)image_width;
+            double scale_height = grid_cell_height / (double)image_height;
 
-            double width = scale_width < scale_height ? grid_cell_width : info.width * scale_height;
-            double height = scale_height < scale_width ? grid_cell_height : info.height * scale_width;
+            double width = scale_width < scale_height ? grid_cell_width : image_width * scale_height;
+            double height = scale_height < scale_width ? grid_cell_height : image_height * scale_width;
 
             int cell_x_postion = (int)((double)(position % window_grid.first)  * grid_cell_width);
             int cell_y_position = (int)((double)(window_grid.second - 1 - (position / window_grid.first)) * grid_cell_height);
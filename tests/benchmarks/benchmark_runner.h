@@ -0,0 +1,124 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include "rs/core/status.h"
+
+namespace rs
+{
+    namespace benchmarks
+    {
+        struct benchmark_options
+        {
+            int             iterations;
+            std::string     output_file;
+            std::string     filter;
+        };
+
+        //parses [-i iterations] [-o output file] [-f benchmark name filter], returns false on invalid arguments
+        inline bool parse_benchmark_options(int argc, char* argv[], benchmark_options & options)
+        {
+            options = { 20, "", "" };
+            for(int i = 1; i < argc; i++)
+            {
+                const std::string arg(argv[i]);
+                if(arg == "-i" && i + 1 < argc)
+                    options.iterations = std::max(1, atoi(argv[++i]));
+                else if(arg == "-o" && i + 1 < argc)
+                    options.output_file = argv[++i];
+                else if(arg == "-f" && i + 1 < argc)
+                    options.filter = argv[++i];
+                else
+                {
+                    std::cerr << "usage: " << argv[0] << " [-i iterations] [-o output file] [-f benchmark name filter]" << std::endl;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+        * @brief Runs benchmarks and prints every measurement as one JSON object per line.
+        *
+        * Each benchmark runs once to warm up the caches and the lazy allocations, then the median and the minimal time of the
+        * iterations are reported, with the time per unit and the throughput in billions of units per second.
+        */
+        class benchmark_runner
+        {
+        public:
+            benchmark_runner(const benchmark_options & options) : m_options(options), m_failures(0)
+            {
+                if(!m_options.output_file.empty())
+                {
+                    m_output_file.open(m_options.output_file.c_str());
+                    if(!m_output_file.is_open())
+                    {
+                        std::cerr << "failed to open " << m_options.output_file << std::endl;
+                        m_failures++;
+                    }
+                }
+                output() << std::fixed << std::setprecision(3);
+            }
+
+            //parameters are preformatted JSON members describing the benchmark input, units is the number of units processed by one call
+            void run(const std::string & name, const std::string & parameters, const char * unit, int64_t units,
+                     const std::function<rs::core::status()> & function)
+            {
+                if(!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos)
+                    return;
+
+                rs::core::status sts = function();
+                std::vector<double> samples;
+                samples.reserve(m_options.iterations);
+                for(int i = 0; i < m_options.iterations && sts >= rs::core::status_no_error; i++)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    sts = function();
+                    samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+                }
+                if(sts < rs::core::status_no_error)
+                {
+                    std::cerr << name << " failed on {" << parameters << "}, status " << sts << std::endl;
+                    m_failures++;
+                    return;
+                }
+
+                std::sort(samples.begin(), samples.end());
+                const double median = samples[samples.size() / 2];
+                output() << "{\"benchmark\":\"" << name << "\"," << parameters
+                         << ",\"" << unit << "s\":" << units
+                         << ",\"iterations\":" << samples.size()
+                         << ",\"median_ns\":" << median
+                         << ",\"min_ns\":" << samples.front()
+                         << ",\"ns_per_" << unit << "\":" << median / units
+                         << ",\"g" << unit << "s_per_s\":" << units / median << "}" << std::endl;
+            }
+
+            //prints a measurement taken outside of run, values are preformatted JSON members
+            void report(const std::string & name, const std::string & parameters, const std::string & values)
+            {
+                if(!m_options.filter.empty() && name.find(m_options.filter) == std::string::npos)
+                    return;
+                output() << "{\"benchmark\":\"" << name << "\"," << parameters << "," << values << "}" << std::endl;
+            }
+
+            int failures() const { return m_failures; }
+
+        private:
+            std::ostream & output() { return m_output_file.is_open() ? m_output_file : std::cout; }
+
+            const benchmark_options     m_options;
+            std::ofstream               m_output_file;
+            int                         m_failures;
+        };
+    }
+}
@@ -0,0 +1,109 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Compression Benchmark
+// Measures the cost of the lz4 codec, used by the recorder on every compressed frame and by the playback on every read frame,
+// on synthetic depth, infrared and color frames, at each compression level.
+// Every measurement is printed as one JSON object per line, with the time per frame and the compressed size ratio.
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include "compression/lz4_codec.h"
+#include "synthetic_frames.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::core::compression;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 16;
+
+    struct frame_input
+    {
+        const char *            name;
+        rs_stream               stream;
+        rs_format               format;
+        int32_t                 bpp;
+        std::vector<uint8_t>    data;
+    };
+
+    void run_codec(benchmark_runner & runner, const frame_input & input, int32_t width, int32_t height, rs::record::compression_level level)
+    {
+        file_types::frame_info info = {};
+        info.width = width;
+        info.height = height;
+        info.format = input.format;
+        info.bpp = input.bpp;
+        info.stride = width * input.bpp;
+        info.stream = input.stream;
+        info.ctype = file_types::compression_type::lz4;
+
+        lz4_codec codec(level);
+        std::vector<uint8_t> encoded(input.data.size());
+        uint32_t encoded_size = 0;
+        const status encode_status = codec.encode(info, input.data.data(), encoded.data(), encoded_size);
+
+        stringstream parameters_stream;
+        parameters_stream << "\"stream\":\"" << input.name << "\",\"resolution\":\"" << width << "x" << height
+                          << "\",\"level\":" << static_cast<int32_t>(level)
+                          << ",\"ratio\":" << static_cast<double>(encoded_size) / static_cast<double>(input.data.size());
+        const string parameters = parameters_stream.str();
+
+        runner.run("lz4_encode", parameters, "frame", batch_size, [&]()
+        {
+            for(int32_t i = 0; i < batch_size; i++)
+            {
+                uint32_t output_size = 0;
+                auto sts = codec.encode(info, input.data.data(), encoded.data(), output_size);
+                if(sts < status_no_error)
+                    return sts;
+            }
+            return status_no_error;
+        });
+
+        //the encode benchmark reports the failure of an incompressible frame
+        if(encode_status < status_no_error)
+            return;
+
+        auto frame = std::make_shared<file_types::frame_sample>(info, 0);
+        runner.run("lz4_decode", parameters, "frame", batch_size, [&]()
+        {
+            for(int32_t i = 0; i < batch_size; i++)
+            {
+                auto decoded = codec.decode(frame, encoded.data(), encoded_size);
+                if(!decoded)
+                    return status_process_failed;
+            }
+            return status_no_error;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const int32_t width = 640, height = 480;
+    vector<frame_input> inputs =
+    {
+        { "depth", rs_stream::RS_STREAM_DEPTH, rs_format::RS_FORMAT_Z16, 2, create_depth_data(width, height) },
+        { "infrared", rs_stream::RS_STREAM_INFRARED, rs_format::RS_FORMAT_Y8, 1, create_image_data(width, height, 1) },
+        { "color", rs_stream::RS_STREAM_COLOR, rs_format::RS_FORMAT_RGB8, 3, create_image_data(width, height, 3) }
+    };
+
+    benchmark_runner runner(options);
+    for(auto & input : inputs)
+    {
+        for(auto level : { rs::record::compression_level::low, rs::record::compression_level::medium, rs::record::compression_level::high })
+            run_codec(runner, input, width, height, level);
+    }
+
+    return runner.failures() ? -1 : 0;
+}
@@ -0,0 +1,112 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Depth Statistics Benchmark
+// Measures the throughput of the depth statistics utility on synthetic depth frames, no camera is required.
+// Every measurement is printed as one JSON object per line, with the time per pixel and the throughput in Gpixels/s.
+// The scalar_max benchmark is a plain per pixel loop, as a reference for the simd reduction.
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include "rs/core/image_interface.h"
+#include "rs/utils/depth_statistics_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const sizeI32 resolutions[] = { { 628, 468 }, { 640, 480 }, { 1280, 720 }, { 1920, 1080 } };
+
+    vector<uint16_t> create_depth(int width, int height)
+    {
+        vector<uint16_t> depth(width * height);
+        for(int y = 0; y < height; y++)
+        {
+            for(int x = 0; x < width; x++)
+            {
+                const bool hole = (x * 7 + y * 13) % 17 == 0;
+                depth[y * width + x] = hole ? 0 : static_cast<uint16_t>(800 + x + 2 * y + (x * y) % 37);
+            }
+        }
+        return depth;
+    }
+
+    void run_resolution(benchmark_runner & runner, sizeI32 size, const vector<uint32_t> & threads_counts)
+    {
+        vector<uint16_t> depth_data = create_depth(size.width, size.height);
+        image_info depth_info = { size.width, size.height, pixel_format::z16, size.width * static_cast<int32_t>(sizeof(uint16_t)) };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depth_info, { depth_data.data(), nullptr },
+                                                                                                stream_type::depth, image_interface::flag::any, 0, 0));
+        const int64_t pixels = static_cast<int64_t>(size.width) * size.height;
+
+        stringstream resolution_stream;
+        resolution_stream << "\"depth\":\"" << size.width << "x" << size.height << "\"";
+        runner.run("scalar_max", resolution_stream.str() + ",\"threads\":1", "pixel", pixels, [&]()
+        {
+            uint16_t max_depth = 0;
+            for(auto value : depth_data)
+                max_depth = value > max_depth ? value : max_depth;
+            return max_depth ? status_no_error : status_process_failed;
+        });
+
+        for(auto threads_count : threads_counts)
+        {
+            auto statistics_utility = get_unique_ptr_with_releaser(depth_statistics_interface::create_instance(threads_count));
+            stringstream parameters_stream;
+            parameters_stream << resolution_stream.str() << ",\"threads\":" << threads_count;
+            const string parameters = parameters_stream.str();
+
+            depth_statistics statistics = {};
+            runner.run("query_statistics", parameters, "pixel", pixels,
+                       [&]() { return statistics_utility->query_statistics(depth.get(), nullptr, statistics); });
+
+            const rect roi = { size.width / 4, size.height / 4, size.width / 2, size.height / 2 };
+            runner.run("query_statistics_roi", parameters, "pixel", static_cast<int64_t>(roi.width) * roi.height,
+                       [&]() { return statistics_utility->query_statistics(depth.get(), &roi, statistics); });
+
+            //a 4x4 grid of regions covering the frame
+            vector<rect> grid;
+            for(int y = 0; y < 4; y++)
+                for(int x = 0; x < 4; x++)
+                    grid.push_back({ x * size.width / 4, y * size.height / 4, size.width / 4, size.height / 4 });
+            vector<depth_statistics> grid_statistics(grid.size());
+            runner.run("query_roi_statistics_4x4", parameters, "pixel", pixels,
+                       [&]() { return statistics_utility->query_roi_statistics(depth.get(), grid.data(), static_cast<int32_t>(grid.size()),
+                                                                             grid_statistics.data()); });
+
+            vector<uint32_t> histogram(256);
+            runner.run("query_histogram", parameters, "pixel", pixels,
+                       [&]() { return statistics_utility->query_histogram(depth.get(), nullptr, 1, 8191, static_cast<int32_t>(histogram.size()),
+                                                                        histogram.data()); });
+
+            const float percentiles[] = { 5.f, 50.f, 95.f };
+            uint16_t percentile_values[3];
+            runner.run("query_percentiles", parameters, "pixel", pixels,
+                       [&]() { return statistics_utility->query_percentiles(depth.get(), nullptr, percentiles, 3, percentile_values); });
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    vector<uint32_t> threads_counts = { 1 };
+    const uint32_t hardware_threads = thread::hardware_concurrency();
+    if(hardware_threads > 1)
+        threads_counts.push_back(hardware_threads);
+
+    benchmark_runner runner(options);
+    for(auto size : resolutions)
+        run_resolution(runner, size, threads_counts);
+    return runner.failures() ? -1 : 0;
+}
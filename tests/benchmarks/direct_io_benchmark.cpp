@@ -0,0 +1,97 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Direct I/O Benchmark
+// Measures the sustained write bandwidth of an uncompressed recording of synthetic 720p depth and color frames, no camera is
+// required, written with the buffered file and with the direct I/O file of the recorder. Every iteration records a batch of
+// frames, so the default iterations write a recording of a few GB per backend. After the last batch, and before the file is
+// closed, the growth of the page cache and of its dirty part since the recording started is read from /proc/meminfo.
+// Every measurement is printed as one JSON object per line, with the time per written byte and the page cache growth.
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "synthetic_frames.h"
+#include "synthetic_recording.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 16;
+    const int32_t width = 1280, height = 720, framerate = 30;
+
+    //returns the value of a /proc/meminfo field in kB, or -1 where it is not available
+    int64_t query_meminfo(const string & field)
+    {
+        ifstream meminfo("/proc/meminfo");
+        string name;
+        int64_t value = 0;
+        while(meminfo >> name >> value)
+        {
+            if(name == field + ":")
+                return value;
+            meminfo.ignore(64, '\n');
+        }
+        return -1;
+    }
+
+    void run_record(benchmark_runner & runner, const vector<stream_input> & inputs, bool direct_io)
+    {
+        const string file_path = direct_io ? "rs_direct_io_benchmark_direct.rssdk" : "rs_direct_io_benchmark_buffered.rssdk";
+        int64_t batch_bytes = 0;
+        for(auto & input : inputs)
+            batch_bytes += static_cast<int64_t>(input.data.size()) * batch_size;
+
+        stringstream parameters_stream;
+        parameters_stream << "\"backend\":\"" << (direct_io ? "direct" : "buffered") << "\",\"streams\":\"depth_color\",\"resolution\":\""
+                          << width << "x" << height << "\"";
+        const string parameters = parameters_stream.str();
+
+        const int64_t cached_before = query_meminfo("Cached");
+        const int64_t dirty_before = query_meminfo("Dirty");
+        int64_t batches = 0;
+        synthetic_recorder recorder(file_path, inputs, rs::record::compression_level::disabled, direct_io);
+        const status start_status = recorder.start();
+        runner.run("record_sustained_write", parameters, "byte", batch_bytes, [&]()
+        {
+            batches++;
+            return start_status < status_no_error ? start_status : recorder.record(batch_size);
+        });
+
+        if(start_status >= status_no_error && cached_before >= 0 && dirty_before >= 0)
+        {
+            stringstream values_stream;
+            values_stream << "\"recorded_mb\":" << batches * batch_bytes / (1024 * 1024)
+                          << ",\"cached_growth_mb\":" << (query_meminfo("Cached") - cached_before) / 1024
+                          << ",\"dirty_growth_mb\":" << (query_meminfo("Dirty") - dirty_before) / 1024;
+            runner.report("record_page_cache_growth", parameters, values_stream.str());
+        }
+        recorder.stop();
+        ::remove(file_path.c_str());
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const vector<stream_input> inputs =
+    {
+        { rs_stream::RS_STREAM_DEPTH, rs_format::RS_FORMAT_Z16, width, height, 2, framerate, create_depth_data(width, height) },
+        { rs_stream::RS_STREAM_COLOR, rs_format::RS_FORMAT_RGB8, width, height, 3, framerate, create_image_data(width, height, 3) }
+    };
+
+    benchmark_runner runner(options);
+    run_record(runner, inputs, false);
+    run_record(runner, inputs, true);
+
+    return runner.failures() ? -1 : 0;
+}
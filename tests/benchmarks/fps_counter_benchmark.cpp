@@ -0,0 +1,93 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// FPS Counter Benchmark
+// Measures the cost of fps_counter::tick, called from every stream callback, and of the interval statistics query.
+// The mutex tick benchmark is the reference for the previous implementation, which locked a mutex and pushed to a deque.
+// Every measurement is printed as one JSON object per line, with the time per tick or per call.
+
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <string>
+#include "rs/utils/fps_counter.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t ticks_count = 1000;
+
+    //the tick path of the previous fps counter implementation
+    class mutex_fps_counter
+    {
+    public:
+        mutex_fps_counter(unsigned int frame_rate) : m_max_size(static_cast<size_t>(1.3 * frame_rate)) {}
+
+        void tick()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            auto time_value = std::chrono::steady_clock::now();
+            if(m_time_buffer.size() == m_max_size)
+                m_time_buffer.pop_front();
+            m_time_buffer.push_back(time_value);
+        }
+
+    private:
+        const size_t m_max_size;
+        std::mutex m_lock;
+        std::deque<std::chrono::steady_clock::time_point> m_time_buffer;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const unsigned int frame_rate = 60;
+    const string parameters = "\"fps\":" + to_string(frame_rate);
+    benchmark_runner runner(options);
+
+    mutex_fps_counter reference_counter(frame_rate);
+    runner.run("mutex_tick", parameters, "tick", ticks_count, [&]()
+    {
+        for(int32_t i = 0; i < ticks_count; i++)
+            reference_counter.tick();
+        return status_no_error;
+    });
+
+    fps_counter counter(frame_rate);
+    runner.run("fps_counter_tick", parameters, "tick", ticks_count, [&]()
+    {
+        for(int32_t i = 0; i < ticks_count; i++)
+            counter.tick();
+        return status_no_error;
+    });
+
+    //the clock read is excluded, as when the frame capture time is ticked
+    fps_counter time_counter(frame_rate);
+    auto time = fps_counter::time_point();
+    runner.run("fps_counter_tick_time", parameters, "tick", ticks_count, [&]()
+    {
+        for(int32_t i = 0; i < ticks_count; i++)
+        {
+            time += std::chrono::microseconds(16667);
+            time_counter.tick(time);
+        }
+        return status_no_error;
+    });
+
+    runner.run("fps_counter_interval_statistics", parameters, "call", 1, [&]()
+    {
+        auto statistics = counter.query_interval_statistics();
+        return statistics.intervals_count ? status_no_error : status_data_unavailable;
+    });
+
+    return runner.failures() ? -1 : 0;
+}
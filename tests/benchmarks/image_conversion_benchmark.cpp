@@ -0,0 +1,101 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Image Conversion Benchmark
+// Measures the cost of image_interface::convert_to on synthetic frames, for the pixel format conversions used by the
+// samples and the viewer. An image caches its converted images, so the convert benchmark wraps the data in a new image
+// for every conversion, and the cached benchmark measures the repeated conversion of the same image.
+// Every measurement is printed as one JSON object per line, with the time per frame.
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "rs/core/image_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "synthetic_frames.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 16;
+
+    struct conversion
+    {
+        const char *    name;
+        stream_type     stream;
+        pixel_format    source_format;
+        int32_t         source_channels;
+        pixel_format    destination_format;
+    };
+
+    const conversion conversions[] =
+    {
+        { "z16_to_rgb8", stream_type::depth, pixel_format::z16, 0, pixel_format::rgb8 },
+        { "y8_to_rgb8", stream_type::infrared, pixel_format::y8, 1, pixel_format::rgb8 },
+        { "yuyv_to_rgb8", stream_type::color, pixel_format::yuyv, 2, pixel_format::rgb8 },
+        { "rgb8_to_bgra8", stream_type::color, pixel_format::rgb8, 3, pixel_format::bgra8 },
+        { "rgb8_to_y8", stream_type::color, pixel_format::rgb8, 3, pixel_format::y8 },
+    };
+
+    status convert(image_interface * image, pixel_format format)
+    {
+        const image_interface * converted_image = nullptr;
+        auto sts = image->convert_to(format, &converted_image);
+        if(sts < status_no_error)
+            return sts;
+        converted_image->release();
+        return status_no_error;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const int32_t width = 640, height = 480;
+    benchmark_runner runner(options);
+    for(auto & conversion : conversions)
+    {
+        auto data = conversion.source_channels ? create_image_data(width, height, conversion.source_channels) : create_depth_data(width, height);
+        image_info info = { width, height, conversion.source_format, get_pixel_size(conversion.source_format) * width };
+
+        stringstream parameters_stream;
+        parameters_stream << "\"conversion\":\"" << conversion.name << "\",\"resolution\":\"" << width << "x" << height << "\"";
+        const string parameters = parameters_stream.str();
+
+        runner.run("convert_to", parameters, "frame", batch_size, [&]()
+        {
+            for(int32_t i = 0; i < batch_size; i++)
+            {
+                auto image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, { data.data(), nullptr },
+                                                                                                        conversion.stream, image_interface::flag::any, 0, 0));
+                auto sts = convert(image.get(), conversion.destination_format);
+                if(sts < status_no_error)
+                    return sts;
+            }
+            return status_no_error;
+        });
+
+        auto cached_image = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, { data.data(), nullptr },
+                                                                                                       conversion.stream, image_interface::flag::any, 0, 0));
+        runner.run("convert_to_cached", parameters, "frame", batch_size, [&]()
+        {
+            for(int32_t i = 0; i < batch_size; i++)
+            {
+                auto sts = convert(cached_image.get(), conversion.destination_format);
+                if(sts < status_no_error)
+                    return sts;
+            }
+            return status_no_error;
+        });
+    }
+
+    return runner.failures() ? -1 : 0;
+}
@@ -0,0 +1,207 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Live Stream Benchmark
+// Measures the throughput of a recording streamed live to a playback reader on the same machine, no camera is required.
+// Synthetic depth, color and two infrared streams are recorded with the disk write of the recorder to a live stream endpoint,
+// over a Unix domain socket pair and over a loopback TCP connection, uncompressed and with lz4 compression, and played as
+// they arrive with the disk read of the playback from the other end of the connection. Every iteration records a batch of
+// frames and waits until the reader played all of them.
+// Every measurement is printed as one JSON object per line, with the time per streamed frame byte. The byte rate the streams
+// need at their frame rate is reported first, for comparison.
+
+#include <stdio.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "playback/include/disk_read_factory.h"
+#include "synthetic_frames.h"
+#include "synthetic_recording.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 8;
+    const int32_t framerate = 30;
+    //a reader which doesn't play a batch in this time failed
+    const auto played_timeout = chrono::seconds(10);
+
+    //connects a pair of unix or loopback tcp sockets, the first is read and the second written
+    bool create_connection(bool is_tcp, int (&descriptors)[2])
+    {
+        if(!is_tcp)
+            return socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) == 0;
+
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t address_length = sizeof(address);
+        int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        descriptors[1] = socket(AF_INET, SOCK_STREAM, 0);
+        bool is_connected = listen_fd >= 0 && descriptors[1] >= 0 &&
+                            bind(listen_fd, reinterpret_cast<sockaddr *>(&address), address_length) == 0 &&
+                            listen(listen_fd, 1) == 0 &&
+                            getsockname(listen_fd, reinterpret_cast<sockaddr *>(&address), &address_length) == 0 &&
+                            connect(descriptors[1], reinterpret_cast<sockaddr *>(&address), address_length) == 0 &&
+                            (descriptors[0] = accept(listen_fd, nullptr, nullptr)) >= 0;
+        if(listen_fd >= 0)
+            close(listen_fd);
+        if(!is_connected && descriptors[1] >= 0)
+            close(descriptors[1]);
+        return is_connected;
+    }
+
+    /**
+    * @brief Plays a live stream with the disk read of the playback, and counts the played frames.
+    *
+    * The reader is created on its own thread, since it waits for the header of the stream, which the recorder sends when it starts.
+    */
+    class live_reader
+    {
+    public:
+        live_reader(const string & endpoint, const vector<stream_input> & inputs) : m_status(status_no_error), m_is_ready(false), m_played_count(0)
+        {
+            m_open_thread = thread([this, endpoint, &inputs]()
+            {
+                const status sts = rs::playback::disk_read_factory::create_disk_read(endpoint.c_str(), m_reader);
+                if(sts >= status_no_error)
+                {
+                    for(auto & input : inputs)
+                        m_reader->enable_stream(input.stream, true);
+                    m_reader->set_callback([this](shared_ptr<file_types::sample> sample)
+                    {
+                        if(sample->info.type != file_types::sample_type::st_image)
+                            return;
+                        lock_guard<mutex> lock(m_lock);
+                        m_played_count++;
+                        m_played_cv.notify_one();
+                    });
+                    //the played count tells a batch was played, the end of the stream isn't waited for
+                    m_reader->set_callback([]() {});
+                    m_reader->set_realtime(false);
+                    m_reader->resume();
+                }
+                lock_guard<mutex> lock(m_lock);
+                m_status = sts;
+                m_is_ready = true;
+                m_played_cv.notify_one();
+            });
+        }
+
+        ~live_reader()
+        {
+            m_open_thread.join();
+            m_reader.reset();
+        }
+
+        status wait_until_ready()
+        {
+            unique_lock<mutex> lock(m_lock);
+            if(!m_played_cv.wait_for(lock, played_timeout, [this]() { return m_is_ready; }))
+                return status_process_failed;
+            return m_status;
+        }
+
+        //waits until count frames were played since the stream started
+        status wait_until_played(int64_t count)
+        {
+            unique_lock<mutex> lock(m_lock);
+            return m_played_cv.wait_for(lock, played_timeout, [&]() { return m_played_count >= count; }) ? status_no_error : status_process_failed;
+        }
+
+    private:
+        mutex                                               m_lock;
+        condition_variable                                  m_played_cv;
+        status                                              m_status;
+        bool                                                m_is_ready;
+        int64_t                                             m_played_count;
+        unique_ptr<rs::playback::disk_read_interface>       m_reader;
+        thread                                              m_open_thread;
+    };
+
+    void run_stream(benchmark_runner & runner, const vector<stream_input> & inputs, bool is_tcp, rs::record::compression_level level)
+    {
+        stringstream parameters_stream;
+        parameters_stream << "\"streams\":\"depth_color_infrared_infrared2\",\"transport\":\"" << (is_tcp ? "tcp" : "unix")
+                          << "\",\"level\":" << static_cast<int32_t>(level);
+
+        int64_t batch_bytes = 0;
+        for(auto & input : inputs)
+            batch_bytes += static_cast<int64_t>(input.data.size()) * batch_size;
+
+        int descriptors[2] = { -1, -1 };
+        if(!create_connection(is_tcp, descriptors))
+        {
+            runner.run("live_stream_record_play", parameters_stream.str(), "byte", batch_bytes, []() { return status_file_open_failed; });
+            return;
+        }
+
+        //the endpoints own the descriptors, the reader is created first and waits for the recorder
+        live_reader reader("fd:" + to_string(descriptors[0]), inputs);
+        status start_status = status_no_error;
+        {
+            synthetic_recorder recorder("fd:" + to_string(descriptors[1]), inputs, level);
+            start_status = recorder.start();
+            if(start_status >= status_no_error)
+                start_status = reader.wait_until_ready();
+            else
+                shutdown(descriptors[1], SHUT_RDWR); //ends the stream the reader waits on
+
+            int64_t recorded_count = 0;
+            runner.run("live_stream_record_play", parameters_stream.str(), "byte", batch_bytes, [&]()
+            {
+                if(start_status < status_no_error)
+                    return start_status;
+                auto sts = recorder.record(batch_size);
+                recorded_count += batch_size * static_cast<int64_t>(inputs.size());
+                return sts < status_no_error ? sts : reader.wait_until_played(recorded_count);
+            });
+
+            //closing the stream ends the playback
+            recorder.stop();
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const vector<stream_input> inputs =
+    {
+        { rs_stream::RS_STREAM_DEPTH, rs_format::RS_FORMAT_Z16, 640, 480, 2, framerate, create_depth_data(640, 480) },
+        { rs_stream::RS_STREAM_COLOR, rs_format::RS_FORMAT_RGB8, 1920, 1080, 3, framerate, create_image_data(1920, 1080, 3) },
+        { rs_stream::RS_STREAM_INFRARED, rs_format::RS_FORMAT_Y8, 640, 480, 1, framerate, create_image_data(640, 480, 1) },
+        { rs_stream::RS_STREAM_INFRARED2, rs_format::RS_FORMAT_Y8, 640, 480, 1, framerate, create_image_data(640, 480, 1) }
+    };
+
+    benchmark_runner runner(options);
+    int64_t required_bytes_per_second = 0;
+    for(auto & input : inputs)
+        required_bytes_per_second += static_cast<int64_t>(input.data.size()) * input.framerate;
+    runner.report("live_stream_required_rate", "\"streams\":\"depth_color_infrared_infrared2\",\"framerate\":" + to_string(framerate),
+                  "\"bytes_per_second\":" + to_string(required_bytes_per_second));
+
+    for(auto is_tcp : { false, true })
+    {
+        for(auto level : { rs::record::compression_level::disabled, rs::record::compression_level::low })
+            run_stream(runner, inputs, is_tcp, level);
+    }
+
+    return runner.failures() ? -1 : 0;
+}
@@ -0,0 +1,101 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Logging Benchmark
+// Measures the caller side latency of a log call, writing through a file logging service which formats every message with its
+// location and flushes it, as a log file appender does. The sync benchmarks write on the calling thread, the async benchmarks
+// use the async logging service, and the disabled benchmark measures a call below the logger level.
+// Every measurement is printed as one JSON object per line, with the time per log call.
+
+#include <cstdio>
+#include <cwchar>
+#include <string>
+#include "rs/utils/log_utils.h"
+#include "rs/utils/async_logging_service.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t calls_count = 1000;
+
+    //writes the messages to a temporary file
+    class file_logger : public empty_logger
+    {
+    public:
+        file_logger() : m_file(tmpfile()) {}
+        ~file_logger() { if(m_file) fclose(m_file); }
+
+        bool is_level_enabled(log_level level) override { return level >= level_info; }
+
+        void log(log_level level, const char* message, const char* file_name, int line_number, const char* function_name) override
+        {
+            fprintf(m_file, "%u %s:%d %s - %s\n", level, file_name, line_number, function_name, message);
+            fflush(m_file);
+        }
+
+        void logw(log_level level, const wchar_t* message, const char* file_name, int line_number, const char* function_name) override
+        {
+            fprintf(m_file, "%u %s:%d %s - %ls\n", level, file_name, line_number, function_name, message);
+            fflush(m_file);
+        }
+
+    private:
+        FILE * m_file;
+    };
+
+    void run_logger(benchmark_runner & runner, const string & mode, logging_service * service)
+    {
+        const string parameters = "\"mode\":\"" + mode + "\"";
+        runner.run("log_stream", parameters, "call", calls_count, [&]()
+        {
+            for(int32_t i = 0; i < calls_count; i++)
+            {
+                LOG_STREAM(service, LOG_LEVEL_INFO, "frame " << i << " of stream " << 2 << " arrived, timestamp " << i * 33.3);
+            }
+            return status_no_error;
+        });
+
+        runner.run("log_cformat", parameters, "call", calls_count, [&]()
+        {
+            for(int32_t i = 0; i < calls_count; i++)
+            {
+                LOG_CFORMAT(service, LOG_LEVEL_INFO, "frame %d of stream %d arrived, timestamp %f", i, 2, i * 33.3);
+            }
+            return status_no_error;
+        });
+
+        runner.run("log_disabled_level", parameters, "call", calls_count, [&]()
+        {
+            for(int32_t i = 0; i < calls_count; i++)
+            {
+                LOG_STREAM(service, LOG_LEVEL_DEBUG, "frame " << i << " of stream " << 2 << " arrived, timestamp " << i * 33.3);
+            }
+            return status_no_error;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    benchmark_runner runner(options);
+    file_logger logger;
+    run_logger(runner, "sync", &logger);
+    {
+        //the ring buffer holds several iterations, so the measurement isn't bounded by the background thread
+        async_logging_service async_logger(&logger, 64 * 1024);
+        run_logger(runner, "async", &async_logger);
+        async_logger.flush();
+        if(async_logger.query_dropped_count())
+            fprintf(stderr, "async logging dropped %llu messages\n", static_cast<unsigned long long>(async_logger.query_dropped_count()));
+    }
+    return runner.failures() ? -1 : 0;
+}
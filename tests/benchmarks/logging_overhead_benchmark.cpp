@@ -0,0 +1,98 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Logging Overhead Benchmark
+// Measures the cost of disabled logging on loops with the logging pattern of the record and playback hot paths, no camera
+// is required. The empty logger benchmark runs with the default logger, the level disabled benchmark with a logger which
+// filters the statements below the info level at runtime, and the compiled out benchmark runs the same loops built with
+// RS_LOG_MIN_LEVEL at the info level. The no logging benchmark is the reference loop without log statements.
+// Every measurement is printed as one JSON object per line, with the time per sample.
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "rs/utils/log_utils.h"
+#include "logging_overhead_loops.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t samples_count = 1000;
+
+    //enables the info level and above, as a logger configured for a release deployment
+    class info_level_logger : public empty_logger
+    {
+    public:
+        bool is_level_enabled(log_level level) override { return level >= level_info; }
+    };
+
+    uint64_t write_samples_unlogged(const vector<sample_info> & samples)
+    {
+        uint64_t offset = 0;
+        for(auto & sample : samples)
+            offset += sample.size;
+        return offset;
+    }
+
+    void run_loops(benchmark_runner & runner, const string & parameters, const vector<sample_info> & samples,
+                   uint64_t (*write_loop)(const vector<sample_info> &), uint64_t (*read_loop)(const vector<sample_info> &))
+    {
+        //the checksum is printed, so the loops aren't optimized out
+        uint64_t checksum = 0;
+        runner.run("record_loop", parameters, "sample", samples_count, [&]()
+        {
+            checksum += write_loop(samples);
+            return status_no_error;
+        });
+        runner.run("playback_loop", parameters, "sample", samples_count, [&]()
+        {
+            checksum += read_loop(samples);
+            return status_no_error;
+        });
+        fprintf(stderr, "checksum %llu\n", static_cast<unsigned long long>(checksum));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    vector<sample_info> samples(samples_count);
+    for(int32_t i = 0; i < samples_count; i++)
+    {
+        samples[i].stream = i % 3;
+        samples[i].frame_number = i / 3;
+        samples[i].capture_time = i * 11.1;
+        samples[i].size = 640 * 480 * 2;
+    }
+
+    benchmark_runner runner(options);
+
+    run_loops(runner, "\"logging\":\"none\"", samples, write_samples_unlogged, write_samples_unlogged);
+
+    stringstream parameters;
+    parameters << "\"logging\":\"empty_logger\",\"min_level\":" << RS_LOG_MIN_LEVEL;
+    run_loops(runner, parameters.str(), samples, write_samples, read_samples);
+
+    info_level_logger level_logger;
+    logging_service * default_logger = logger.m_logger;
+    logger.m_logger = &level_logger;
+    logger.refresh_level();
+    parameters.str("");
+    parameters << "\"logging\":\"level_disabled\",\"min_level\":" << RS_LOG_MIN_LEVEL;
+    run_loops(runner, parameters.str(), samples, write_samples, read_samples);
+
+    run_loops(runner, "\"logging\":\"compiled_out\",\"min_level\":20000", samples, write_samples_stripped, read_samples_stripped);
+    logger.m_logger = default_logger;
+    logger.refresh_level();
+
+    return runner.failures() ? -1 : 0;
+}
@@ -0,0 +1,74 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Per sample loops with the logging pattern of the record and playback hot paths: a function scope log and verbose statements
+// per sample, and a debug statement per batch. Included by a translation unit per compiled log level, so the loops have
+// internal linkage, and each translation unit exports its loops under its own names.
+
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "rs/utils/log_utils.h"
+
+namespace rs
+{
+    namespace benchmarks
+    {
+        struct sample_info
+        {
+            int32_t     stream;
+            uint64_t    frame_number;
+            double      capture_time;
+            uint32_t    size;
+        };
+
+        uint64_t write_samples_stripped(const std::vector<sample_info> & samples);
+        uint64_t read_samples_stripped(const std::vector<sample_info> & samples);
+    }
+}
+
+namespace
+{
+    using rs::benchmarks::sample_info;
+
+    //emulates disk_write::write_sample, the returned offset keeps the loop from being optimized out
+    uint64_t write_sample(const sample_info & sample, uint64_t offset)
+    {
+        LOG_FUNC_SCOPE();
+        LOG_VERBOSE("write frame, " "stream type - " << sample.stream << " capture time - " << sample.capture_time);
+        LOG_VERBOSE("frame number - " << sample.frame_number << " ,size - " << sample.size);
+        return offset + sample.size;
+    }
+
+    //emulates disk_read_base::prefetch_sample and the callback dispatch
+    uint64_t read_sample(const sample_info & sample, uint64_t offset)
+    {
+        LOG_FUNC_SCOPE();
+        LOG_VERBOSE("sample prefetched, sample type - " << sample.stream);
+        LOG_VERBOSE("sample prefetched, sample capture time - " << sample.capture_time);
+        LOG_VERBOSE("calling callback, frame stream type - " << sample.stream);
+        return offset ^ (sample.frame_number + sample.size);
+    }
+
+    uint64_t write_samples(const std::vector<sample_info> & samples)
+    {
+        uint64_t offset = 0;
+        for(auto & sample : samples)
+        {
+            offset = write_sample(sample, offset);
+        }
+        LOG_DEBUG("wrote " << samples.size() << " samples, offset - " << offset);
+        return offset;
+    }
+
+    uint64_t read_samples(const std::vector<sample_info> & samples)
+    {
+        uint64_t offset = 0;
+        for(auto & sample : samples)
+        {
+            offset = read_sample(sample, offset);
+        }
+        LOG_DEBUG("read " << samples.size() << " samples");
+        return offset;
+    }
+}
@@ -0,0 +1,21 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// The hot loops of the logging overhead benchmark, with the statements below the info level compiled out.
+
+#ifdef RS_LOG_MIN_LEVEL
+#undef RS_LOG_MIN_LEVEL
+#endif
+#define RS_LOG_MIN_LEVEL 20000
+
+#include "logging_overhead_loops.h"
+
+uint64_t rs::benchmarks::write_samples_stripped(const std::vector<sample_info> & samples)
+{
+    return write_samples(samples);
+}
+
+uint64_t rs::benchmarks::read_samples_stripped(const std::vector<sample_info> & samples)
+{
+    return read_samples(samples);
+}
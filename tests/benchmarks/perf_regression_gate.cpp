@@ -0,0 +1,378 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Performance Regression Gate
+// Runs a fixed set of workloads on synthetic frames, no camera is required: records the same frames uncompressed and with lz4
+// compression, indexes and plays the compressed file without real time pacing, and runs it through the pipeline with the max
+// depth value module. The measured throughput and latency metrics are compared against a baseline file, and the gate fails
+// when a metric is worse than its baseline value by more than its tolerance.
+//
+// The baseline file holds one metric per line, "<metric> <baseline value> <tolerance percent>", lines starting with # are comments.
+// The gate runs with the tests (ctest) against the checked in baseline. The baseline is machine specific: when the machine running
+// the gate changes, regenerate it there with "-u <baseline file> -t 15" and review the measured values before checking them in.
+// Usage: rs_perf_regression_gate -b <baseline file> [-t <tolerance percent for all the metrics>] [-u <updated baseline output file>]
+
+#include <stdio.h>
+#include <cmath>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include "rs/playback/playback_context.h"
+#include "rs/playback/playback_device.h"
+#include "rs/core/pipeline_async.h"
+#include "rs/cv_modules/max_depth_value_module/max_depth_value_module.h"
+#include "rs/utils/performance_counters.h"
+#include "synthetic_frames.h"
+#include "synthetic_recording.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t frames_count = 120;
+    const int32_t width = 640, height = 480, framerate = 30;
+    const double default_tolerance = 30.0;
+    const chrono::seconds playback_timeout(60);
+
+    struct gate_options
+    {
+        string  baseline_file;
+        string  updated_baseline_file;
+        double  tolerance;          /**< Overrides the baseline tolerances when not negative */
+    };
+
+    struct baseline_metric
+    {
+        double  value;
+        double  tolerance;
+    };
+
+    struct measured_metric
+    {
+        string  name;
+        bool    higher_is_better;
+        double  value;
+    };
+
+    bool parse_gate_options(int argc, char* argv[], gate_options & options)
+    {
+        options = { "", "", -1 };
+        for(int i = 1; i < argc; i++)
+        {
+            const string arg(argv[i]);
+            if(arg == "-b" && i + 1 < argc)
+                options.baseline_file = argv[++i];
+            else if(arg == "-u" && i + 1 < argc)
+                options.updated_baseline_file = argv[++i];
+            else if(arg == "-t" && i + 1 < argc)
+                options.tolerance = atof(argv[++i]);
+            else
+            {
+                options.baseline_file.clear();
+                break;
+            }
+        }
+        if(options.baseline_file.empty())
+        {
+            cerr << "usage: " << argv[0] << " -b <baseline file> [-t <tolerance percent>] [-u <updated baseline output file>]" << endl;
+            return false;
+        }
+        return true;
+    }
+
+    status read_baseline(const string & file_path, map<string, baseline_metric> & baseline)
+    {
+        ifstream file(file_path.c_str());
+        if(!file.is_open())
+            return status_file_open_failed;
+
+        string line;
+        while(getline(file, line))
+        {
+            if(line.empty() || line[0] == '#')
+                continue;
+            istringstream line_stream(line);
+            string name;
+            baseline_metric metric = {};
+            if(!(line_stream >> name >> metric.value >> metric.tolerance))
+            {
+                cerr << "invalid baseline line: " << line << endl;
+                return status_file_read_failed;
+            }
+            baseline[name] = metric;
+        }
+        return status_no_error;
+    }
+
+    //the tolerance overrides the baseline tolerances when not negative, as in the comparison
+    status write_baseline(const string & file_path, const vector<measured_metric> & metrics, const map<string, baseline_metric> & baseline,
+                          double tolerance)
+    {
+        ofstream file(file_path.c_str());
+        if(!file.is_open())
+            return status_file_open_failed;
+        file << "# performance regression gate baseline: <metric> <baseline value> <tolerance percent>" << endl;
+        file << fixed << setprecision(3);
+        for(auto & metric : metrics)
+        {
+            auto baseline_metric = baseline.find(metric.name);
+            file << metric.name << " " << metric.value << " "
+                 << (tolerance >= 0 ? tolerance : baseline_metric != baseline.end() ? baseline_metric->second.tolerance : default_tolerance) << endl;
+        }
+        return status_no_error;
+    }
+
+    double query_percentile_90(const string & name)
+    {
+        performance_counter_value value = {};
+        return PERF_COUNTERS.query_value(name, value) < status_no_error ? 0 : value.percentile_90;
+    }
+
+    double seconds_since(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    //waits until the playback reaches the end of the file
+    bool wait_for_end_of_file(rs::playback::device * device)
+    {
+        const auto start = chrono::steady_clock::now();
+        while(device->is_streaming())
+        {
+            if(chrono::steady_clock::now() - start > playback_timeout)
+                return false;
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    status run_record(const vector<stream_input> & inputs, const string & file_path, rs::record::compression_level level,
+                      const string & name, vector<measured_metric> & metrics)
+    {
+        PERF_COUNTERS.reset();
+        synthetic_recorder recorder(file_path, inputs, level);
+        auto sts = recorder.start();
+        if(sts < status_no_error)
+            return sts;
+        const auto start = chrono::steady_clock::now();
+        sts = recorder.record(frames_count);
+        const double duration = seconds_since(start);
+        recorder.stop();
+        if(sts < status_no_error)
+            return sts;
+
+        metrics.push_back({ name + ".frames_per_s", true, frames_count * inputs.size() / duration });
+        if(level != rs::record::compression_level::disabled)
+            metrics.push_back({ name + ".encode_time_us_p90", false, query_percentile_90("record.encode_time_us") });
+        return status_no_error;
+    }
+
+    status run_playback(const vector<stream_input> & inputs, const string & file_path, vector<measured_metric> & metrics)
+    {
+        //indexing is incremental, seeking to the last frame indexes the whole file
+        auto start = chrono::steady_clock::now();
+        {
+            rs::playback::context context(file_path.c_str());
+            rs::playback::device * device = context.get_playback_device();
+            for(auto & input : inputs)
+                device->enable_stream(static_cast<rs::stream>(input.stream), rs::preset::best_quality);
+            if(!device->set_frame_by_index(frames_count - 1, rs::stream::depth))
+                return status_item_unavailable;
+        }
+        metrics.push_back({ "playback.index_ms", false, seconds_since(start) * 1000 });
+
+        PERF_COUNTERS.reset();
+        rs::playback::context context(file_path.c_str());
+        rs::playback::device * device = context.get_playback_device();
+        std::atomic<int32_t> played_frames(0);
+        for(auto & input : inputs)
+        {
+            device->enable_stream(static_cast<rs::stream>(input.stream), rs::preset::best_quality);
+            device->set_frame_callback(static_cast<rs::stream>(input.stream), [&played_frames](rs::frame frame) { played_frames++; });
+        }
+        device->set_real_time(false);
+
+        start = chrono::steady_clock::now();
+        device->start();
+        const bool reached_end_of_file = wait_for_end_of_file(device);
+        const double duration = seconds_since(start);
+        device->stop();
+        if(!reached_end_of_file)
+            return status_exec_timeout;
+
+        //without real time pacing every frame is delivered
+        if(played_frames != frames_count * static_cast<int32_t>(inputs.size()))
+            return status_process_failed;
+        metrics.push_back({ "playback_unpaced.frames_per_s", true, played_frames / duration });
+        metrics.push_back({ "playback_unpaced.decode_time_us_p90", false, query_percentile_90("playback.decode_time_us") });
+        return status_no_error;
+    }
+
+    class sample_sets_counter : public pipeline_async_interface::callback_handler
+    {
+    public:
+        sample_sets_counter() : m_count(0), m_error(status_no_error) {}
+        void on_new_sample_set(const correlated_sample_set & sample_set) override { m_count++; }
+        void on_error(status status) override { m_error = status; }
+        int32_t query_count() const { return m_count; }
+        status query_error() const { return m_error; }
+    private:
+        std::atomic<int32_t> m_count;
+        std::atomic<status> m_error;
+    };
+
+    status run_pipeline(const string & file_path, vector<measured_metric> & metrics)
+    {
+        PERF_COUNTERS.reset();
+        pipeline_async pipeline(pipeline_async::testing_mode::playback, file_path.c_str());
+        //the input queue holds the whole file, so no sample set is dropped by the module
+        rs::cv_modules::max_depth_value_module module(0, true, 1, frames_count);
+        auto sts = pipeline.add_cv_module(&module);
+        if(sts < status_no_error)
+            return sts;
+        sts = pipeline.set_config({});
+        if(sts < status_no_error)
+            return sts;
+
+        rs::playback::device * device = static_cast<rs::playback::device *>(pipeline.get_device());
+        device->set_real_time(false);
+        sample_sets_counter counter;
+        const auto start = chrono::steady_clock::now();
+        sts = pipeline.start(&counter);
+        if(sts < status_no_error)
+            return sts;
+        const bool reached_end_of_file = wait_for_end_of_file(device);
+        const double duration = seconds_since(start);
+        pipeline.stop();
+        if(!reached_end_of_file)
+            return status_exec_timeout;
+        if(counter.query_error() < status_no_error)
+            return counter.query_error();
+
+        metrics.push_back({ "pipeline.sample_sets_per_s", true, counter.query_count() / duration });
+        metrics.push_back({ "pipeline.cv_module_process_time_us_p90", false, query_percentile_90("pipeline.cv_module_process_time_us") });
+        return status_no_error;
+    }
+
+    //prints the comparison table, returns the number of regressed or missing metrics
+    int32_t compare(const vector<measured_metric> & metrics, const map<string, baseline_metric> & baseline, double tolerance_override)
+    {
+        int32_t regressions = 0;
+        cout << left << setw(42) << "metric" << right << setw(14) << "baseline" << setw(14) << "measured"
+             << setw(10) << "change" << setw(11) << "tolerance" << "  result" << endl;
+        cout << fixed;
+        for(auto & metric : metrics)
+        {
+            cout << left << setw(42) << metric.name << right;
+            auto baseline_metric = baseline.find(metric.name);
+            if(baseline_metric == baseline.end())
+            {
+                cout << setw(14) << "-" << setw(14) << setprecision(3) << metric.value << setw(10) << "-" << setw(11) << "-" << "  new" << endl;
+                continue;
+            }
+
+            const double tolerance = tolerance_override >= 0 ? tolerance_override : baseline_metric->second.tolerance;
+            const double baseline_value = baseline_metric->second.value;
+            const double change = baseline_value != 0 ? (metric.value - baseline_value) / std::abs(baseline_value) * 100 : 0;
+            const double worse_change = metric.higher_is_better ? -change : change;
+            const bool regressed = worse_change > tolerance;
+            if(regressed)
+                regressions++;
+
+            stringstream change_stream, tolerance_stream;
+            change_stream << showpos << fixed << setprecision(1) << change << "%";
+            tolerance_stream << fixed << setprecision(1) << tolerance << "%";
+            cout << setw(14) << setprecision(3) << baseline_value << setw(14) << metric.value
+                 << setw(10) << change_stream.str() << setw(11) << tolerance_stream.str()
+                 << "  " << (regressed ? "REGRESSED" : worse_change < 0 ? "improved" : "ok")
+                 << "  (" << (metric.higher_is_better ? "higher" : "lower") << " is better)" << endl;
+        }
+
+        for(auto & baseline_metric : baseline)
+        {
+            bool is_measured = false;
+            for(auto & metric : metrics)
+                is_measured |= metric.name == baseline_metric.first;
+            if(!is_measured)
+            {
+                cout << left << setw(42) << baseline_metric.first << right << setw(14) << setprecision(3) << baseline_metric.second.value
+                     << setw(14) << "-" << setw(10) << "-" << setw(11) << "-" << "  MISSING" << endl;
+                regressions++;
+            }
+        }
+        return regressions;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    gate_options options;
+    if(!parse_gate_options(argc, argv, options))
+        return -1;
+
+    map<string, baseline_metric> baseline;
+    if(read_baseline(options.baseline_file, baseline) < status_no_error)
+    {
+        cerr << "failed to read the baseline file " << options.baseline_file << endl;
+        return -1;
+    }
+
+    const vector<stream_input> inputs =
+    {
+        { rs_stream::RS_STREAM_DEPTH, rs_format::RS_FORMAT_Z16, width, height, 2, framerate, create_depth_data(width, height) },
+        { rs_stream::RS_STREAM_INFRARED, rs_format::RS_FORMAT_Y8, width, height, 1, framerate, create_image_data(width, height, 1) }
+    };
+    const string raw_file_path = "rs_perf_regression_gate_raw.rssdk";
+    const string lz4_file_path = "rs_perf_regression_gate_lz4.rssdk";
+
+    vector<measured_metric> metrics;
+    vector<pair<string, status>> failures;
+    auto run = [&](const string & workload, const std::function<status()> & function)
+    {
+        status sts = status_no_error;
+        try
+        {
+            sts = function();
+        }
+        catch(const std::exception & ex)
+        {
+            cerr << workload << " failed: " << ex.what() << endl;
+            sts = status_process_failed;
+        }
+        if(sts < status_no_error)
+            failures.push_back({ workload, sts });
+    };
+
+    run("record_raw", [&]() { return run_record(inputs, raw_file_path, rs::record::compression_level::disabled, "record_raw", metrics); });
+    run("record_lz4", [&]() { return run_record(inputs, lz4_file_path, rs::record::compression_level::low, "record_lz4", metrics); });
+    run("playback", [&]() { return run_playback(inputs, lz4_file_path, metrics); });
+    run("pipeline", [&]() { return run_pipeline(lz4_file_path, metrics); });
+    ::remove(raw_file_path.c_str());
+    ::remove(lz4_file_path.c_str());
+
+    const int32_t regressions = compare(metrics, baseline, options.tolerance);
+    for(auto & failure : failures)
+        cout << "workload " << failure.first << " failed, status " << failure.second << endl;
+
+    if(!options.updated_baseline_file.empty() && write_baseline(options.updated_baseline_file, metrics, baseline, options.tolerance) < status_no_error)
+        cerr << "failed to write the updated baseline file " << options.updated_baseline_file << endl;
+
+    if(regressions || !failures.empty())
+    {
+        cout << regressions << " metrics regressed, " << failures.size() << " workloads failed" << endl;
+        return -1;
+    }
+    cout << "no performance regression" << endl;
+    return 0;
+}
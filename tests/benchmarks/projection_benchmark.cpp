@@ -0,0 +1,196 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Projection Benchmark
+// Measures the cost of the projection module methods on synthetic frames, no camera is required.
+// The projection is created from calibration sets stored in this file, covering the depth and color resolutions of the
+// camera. Every measurement is printed as one JSON object per line, with the median time per pixel or per point, so
+// the output can be collected and compared between builds.
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "rs/core/projection_interface.h"
+#include "rs/core/image_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    struct calibration
+    {
+        const char * name;
+        intrinsics   depth;
+        intrinsics   color;
+        extrinsics   depth_to_color;
+    };
+
+    //calibration sets stored from r200 / zr300 cameras, the color distortion model is the one reported by librealsense
+    const calibration calibrations[] =
+    {
+        {
+            "depth_320x240_color_640x480",
+            { 320, 240, 159.2f, 118.7f, 291.6f, 291.6f, distortion_type::none, { 0.f, 0.f, 0.f, 0.f, 0.f } },
+            { 640, 480, 315.4f, 241.2f, 617.3f, 617.1f, distortion_type::modified_brown_conrady, { 0.113f, -0.231f, 0.0011f, 0.0014f, 0.098f } },
+            { { 0.99998f, -0.0035f, 0.0046f, 0.0035f, 0.99999f, 0.0012f, -0.0046f, -0.0012f, 0.99998f }, { 0.0589f, 0.0002f, 0.0031f } }
+        },
+        {
+            "depth_480x360_color_640x480",
+            { 480, 360, 239.1f, 178.4f, 437.4f, 437.4f, distortion_type::none, { 0.f, 0.f, 0.f, 0.f, 0.f } },
+            { 640, 480, 315.4f, 241.2f, 617.3f, 617.1f, distortion_type::modified_brown_conrady, { 0.113f, -0.231f, 0.0011f, 0.0014f, 0.098f } },
+            { { 0.99998f, -0.0035f, 0.0046f, 0.0035f, 0.99999f, 0.0012f, -0.0046f, -0.0012f, 0.99998f }, { 0.0589f, 0.0002f, 0.0031f } }
+        },
+        {
+            "depth_628x468_color_640x480",
+            { 628, 468, 313.9f, 232.6f, 583.2f, 583.2f, distortion_type::none, { 0.f, 0.f, 0.f, 0.f, 0.f } },
+            { 640, 480, 315.4f, 241.2f, 617.3f, 617.1f, distortion_type::modified_brown_conrady, { 0.113f, -0.231f, 0.0011f, 0.0014f, 0.098f } },
+            { { 0.99998f, -0.0035f, 0.0046f, 0.0035f, 0.99999f, 0.0012f, -0.0046f, -0.0012f, 0.99998f }, { 0.0589f, 0.0002f, 0.0031f } }
+        },
+        {
+            "depth_628x468_color_1920x1080",
+            { 628, 468, 313.9f, 232.6f, 583.2f, 583.2f, distortion_type::none, { 0.f, 0.f, 0.f, 0.f, 0.f } },
+            { 1920, 1080, 956.3f, 543.7f, 1389.6f, 1388.9f, distortion_type::modified_brown_conrady, { 0.113f, -0.231f, 0.0011f, 0.0014f, 0.098f } },
+            { { 0.99998f, -0.0035f, 0.0046f, 0.0035f, 0.99999f, 0.0012f, -0.0046f, -0.0012f, 0.99998f }, { 0.0589f, 0.0002f, 0.0031f } }
+        },
+    };
+
+    const int32_t points_counts[] = { 1000, 10000, 100000 };
+
+    //a tilted plane with holes every few pixels, similar to the invalid pixels ratio of a real scene
+    vector<uint16_t> create_depth(int width, int height)
+    {
+        vector<uint16_t> depth(width * height);
+        for(int y = 0; y < height; y++)
+        {
+            for(int x = 0; x < width; x++)
+            {
+                const bool hole = (x * 7 + y * 13) % 17 == 0;
+                depth[y * width + x] = hole ? 0 : static_cast<uint16_t>(800 + x + 2 * y + (x * y) % 37);
+            }
+        }
+        return depth;
+    }
+
+    vector<uint8_t> create_color(int width, int height)
+    {
+        vector<uint8_t> color(width * height * 3);
+        for(size_t i = 0; i < color.size(); i++)
+            color[i] = static_cast<uint8_t>(i * 31);
+        return color;
+    }
+
+    //spreads the points over the whole image, the depth points carry the depth of their pixel
+    vector<point3dF32> create_depth_points(const vector<uint16_t> & depth, int width, int height, int32_t count)
+    {
+        vector<point3dF32> points(count);
+        for(int32_t i = 0; i < count; i++)
+        {
+            const int pixel = static_cast<int>((static_cast<int64_t>(i) * 7919) % (width * height));
+            const uint16_t z = depth[pixel] ? depth[pixel] : 1000;
+            points[i] = { static_cast<float>(pixel % width), static_cast<float>(pixel / width), static_cast<float>(z) };
+        }
+        return points;
+    }
+
+    vector<pointF32> create_color_points(int width, int height, int32_t count)
+    {
+        vector<pointF32> points(count);
+        for(int32_t i = 0; i < count; i++)
+        {
+            const int pixel = static_cast<int>((static_cast<int64_t>(i) * 7919) % (width * height));
+            points[i] = { static_cast<float>(pixel % width), static_cast<float>(pixel / width) };
+        }
+        return points;
+    }
+
+    void run_calibration(benchmark_runner & runner, const calibration & calib)
+    {
+        intrinsics depth_intrin = calib.depth;
+        intrinsics color_intrin = calib.color;
+        extrinsics extrin = calib.depth_to_color;
+        auto projection = get_unique_ptr_with_releaser(projection_interface::create_instance(&color_intrin, &depth_intrin, &extrin));
+
+        stringstream parameters_stream;
+        parameters_stream << "\"calibration\":\"" << calib.name << "\""
+                          << ",\"depth\":\"" << depth_intrin.width << "x" << depth_intrin.height << "\""
+                          << ",\"color\":\"" << color_intrin.width << "x" << color_intrin.height << "\"";
+        const string parameters = parameters_stream.str();
+
+        const int depth_width = depth_intrin.width, depth_height = depth_intrin.height;
+        const int color_width = color_intrin.width, color_height = color_intrin.height;
+        const int64_t depth_pixels = static_cast<int64_t>(depth_width) * depth_height;
+        const int64_t color_pixels = static_cast<int64_t>(color_width) * color_height;
+
+        vector<uint16_t> depth_data = create_depth(depth_width, depth_height);
+        vector<uint8_t> color_data = create_color(color_width, color_height);
+        image_info depth_info = { depth_width, depth_height, pixel_format::z16, depth_width * static_cast<int32_t>(sizeof(uint16_t)) };
+        image_info color_info = { color_width, color_height, pixel_format::rgb8, color_width * 3 };
+        auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depth_info, { depth_data.data(), nullptr },
+                                                                                                stream_type::depth, image_interface::flag::any, 0, 0));
+        auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&color_info, { color_data.data(), nullptr },
+                                                                                                stream_type::color, image_interface::flag::any, 0, 0));
+
+        //frame methods, the cost is reported per pixel of the output frame
+        vector<pointF32> uvmap(depth_pixels);
+        vector<pointF32> inv_uvmap(color_pixels);
+        vector<point3dF32> vertices(depth_pixels);
+        runner.run("query_uvmap", parameters, "pixel", depth_pixels, [&]() { return projection->query_uvmap(depth.get(), uvmap.data()); });
+        runner.run("query_invuvmap", parameters, "pixel", color_pixels, [&]() { return projection->query_invuvmap(depth.get(), inv_uvmap.data()); });
+        runner.run("query_vertices", parameters, "pixel", depth_pixels, [&]() { return projection->query_vertices(depth.get(), vertices.data()); });
+
+        //a quarter of the frame around the center
+        const rect depth_roi = { depth_width / 4, depth_height / 4, depth_width / 2, depth_height / 2 };
+        const rect color_roi = { color_width / 4, color_height / 4, color_width / 2, color_height / 2 };
+        const int64_t depth_roi_pixels = static_cast<int64_t>(depth_roi.width) * depth_roi.height;
+        const int64_t color_roi_pixels = static_cast<int64_t>(color_roi.width) * color_roi.height;
+        runner.run("query_uvmap_roi", parameters, "pixel", depth_roi_pixels,
+                   [&]() { return projection->query_uvmap_roi(depth.get(), depth_roi, uvmap.data(), false); });
+        runner.run("query_invuvmap_roi", parameters, "pixel", color_roi_pixels,
+                   [&]() { return projection->query_invuvmap_roi(depth.get(), color_roi, inv_uvmap.data(), false); });
+        runner.run("query_vertices_roi", parameters, "pixel", depth_roi_pixels,
+                   [&]() { return projection->query_vertices_roi(depth.get(), depth_roi, vertices.data(), false); });
+
+        runner.run("create_color_image_mapped_to_depth", parameters, "pixel", depth_pixels, [&]()
+        {
+            auto image = get_unique_ptr_with_releaser(projection->create_color_image_mapped_to_depth(depth.get(), color.get()));
+            return image ? status_no_error : status_process_failed;
+        });
+        runner.run("create_depth_image_mapped_to_color", parameters, "pixel", color_pixels, [&]()
+        {
+            auto image = get_unique_ptr_with_releaser(projection->create_depth_image_mapped_to_color(depth.get(), color.get()));
+            return image ? status_no_error : status_process_failed;
+        });
+
+        //point methods, the cost is reported per point
+        for(auto count : points_counts)
+        {
+            vector<point3dF32> depth_points = create_depth_points(depth_data, depth_width, depth_height, count);
+            vector<pointF32> color_points = create_color_points(color_width, color_height, count);
+            vector<point3dF32> camera_points(count);
+            vector<pointF32> mapped_points(count);
+            runner.run("project_depth_to_camera", parameters, "point", count,
+                       [&]() { return projection->project_depth_to_camera(count, depth_points.data(), camera_points.data()); });
+            runner.run("map_depth_to_color", parameters, "point", count,
+                       [&]() { return projection->map_depth_to_color(count, depth_points.data(), mapped_points.data()); });
+            runner.run("map_color_to_depth", parameters, "point", count,
+                       [&]() { return projection->map_color_to_depth(depth.get(), count, color_points.data(), mapped_points.data()); });
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    benchmark_runner runner(options);
+    for(const auto & calib : calibrations)
+        run_calibration(runner, calib);
+    return runner.failures() ? -1 : 0;
+}
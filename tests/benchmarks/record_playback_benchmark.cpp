@@ -0,0 +1,110 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Record Playback Benchmark
+// Measures the recording and reading paths on temporary files of synthetic depth and color frames, no camera is required.
+// The record benchmark passes a batch of frames to disk_write::record_sample and waits until the write thread has
+// written them all, uncompressed and with lz4 compression. The files it writes are then opened, fully indexed and
+// randomly accessed by frame index with the disk read of the playback, and removed at exit.
+// Every measurement is printed as one JSON object per line, with the time per frame, per file or per seek.
+
+#include <stdio.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include "playback/include/disk_read_factory.h"
+#include "synthetic_frames.h"
+#include "synthetic_recording.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 16;
+    const int32_t width = 320, height = 240, framerate = 30;
+
+    void run_record(benchmark_runner & runner, const vector<stream_input> & inputs, const string & file_path, rs::record::compression_level level)
+    {
+        stringstream parameters_stream;
+        parameters_stream << "\"streams\":\"depth_color\",\"resolution\":\"" << width << "x" << height << "\",\"level\":" << static_cast<int32_t>(level);
+
+        synthetic_recorder recorder(file_path, inputs, level);
+        const status start_status = recorder.start();
+        runner.run("disk_write_record_sample", parameters_stream.str(), "frame", batch_size * static_cast<int32_t>(inputs.size()), [&]()
+        {
+            return start_status < status_no_error ? start_status : recorder.record(batch_size);
+        });
+        recorder.stop();
+    }
+
+    void run_read(benchmark_runner & runner, const string & file_path, rs::record::compression_level level)
+    {
+        const string parameters = "\"streams\":\"depth_color\",\"level\":" + to_string(static_cast<int32_t>(level));
+
+        runner.run("disk_read_open", parameters, "file", 1, [&]()
+        {
+            std::unique_ptr<rs::playback::disk_read_interface> reader;
+            return rs::playback::disk_read_factory::create_disk_read(file_path.c_str(), reader);
+        });
+
+        std::unique_ptr<rs::playback::disk_read_interface> reader;
+        if(rs::playback::disk_read_factory::create_disk_read(file_path.c_str(), reader) < status_no_error ||
+           reader->query_number_of_frames(rs_stream::RS_STREAM_DEPTH) == 0)
+        {
+            runner.run("disk_read_index", parameters, "frame", 1, []() { return status_item_unavailable; });
+            return;
+        }
+        const uint32_t frames_count = reader->query_number_of_frames(rs_stream::RS_STREAM_DEPTH);
+
+        //indexing is incremental, seeking to the last frame indexes the whole file
+        runner.run("disk_read_index", parameters, "frame", frames_count, [&]()
+        {
+            std::unique_ptr<rs::playback::disk_read_interface> indexed_reader;
+            auto sts = rs::playback::disk_read_factory::create_disk_read(file_path.c_str(), indexed_reader);
+            if(sts < status_no_error)
+                return sts;
+            return indexed_reader->set_frame_by_index(frames_count - 1, rs_stream::RS_STREAM_DEPTH).empty() ? status_process_failed : status_no_error;
+        });
+
+        //a fixed pseudo random sequence keeps the seeks comparable between runs
+        uint32_t index = 0;
+        runner.run("disk_read_seek", parameters, "seek", batch_size, [&]()
+        {
+            for(int32_t i = 0; i < batch_size; i++)
+            {
+                index = (index * 1103515245 + 12345) % frames_count;
+                if(reader->set_frame_by_index(index, rs_stream::RS_STREAM_DEPTH).empty())
+                    return status_process_failed;
+            }
+            return status_no_error;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const vector<stream_input> inputs =
+    {
+        { rs_stream::RS_STREAM_DEPTH, rs_format::RS_FORMAT_Z16, width, height, 2, framerate, create_depth_data(width, height) },
+        { rs_stream::RS_STREAM_COLOR, rs_format::RS_FORMAT_RGB8, width, height, 3, framerate, create_image_data(width, height, 3) }
+    };
+
+    benchmark_runner runner(options);
+    for(auto level : { rs::record::compression_level::disabled, rs::record::compression_level::low })
+    {
+        const string file_path = "rs_record_playback_benchmark_" + to_string(static_cast<int32_t>(level)) + ".rssdk";
+        run_record(runner, inputs, file_path, level);
+        run_read(runner, file_path, level);
+        ::remove(file_path.c_str());
+    }
+
+    return runner.failures() ? -1 : 0;
+}
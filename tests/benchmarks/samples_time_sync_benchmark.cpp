@@ -0,0 +1,123 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Samples Time Sync Benchmark
+// Measures the cost of samples_time_sync_interface::insert, called for every frame and motion sample of a synced pipeline,
+// with depth and color frames of matching time stamps, and of the cyclic array the sync utility buffers the samples in.
+// The image create benchmark is the reference for the image wrapping, included in the insert measurement.
+// Every measurement is printed as one JSON object per line, with the time per inserted sample.
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include "rs/core/image_interface.h"
+#include "rs/core/motion_sample.h"
+#include "rs/utils/cyclic_array.h"
+#include "rs/utils/samples_time_sync_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 64;
+
+    image_interface * create_image(stream_type stream, double time_stamp, uint64_t frame_number)
+    {
+        //the sync utility reads only the image time stamp and number
+        image_info info = {};
+        return image_interface::create_instance_from_raw_data(&info, { nullptr, nullptr }, stream, image_interface::flag::any, time_stamp, frame_number);
+    }
+
+    void release_sample_set(correlated_sample_set & sample_set)
+    {
+        for(int32_t i = 0; i < static_cast<int32_t>(stream_type::max); i++)
+        {
+            auto & image = sample_set[static_cast<stream_type>(i)];
+            if(image)
+                image->release();
+            image = nullptr;
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const int fps = 30;
+    const double frame_interval_ms = 1000.0 / fps;
+    benchmark_runner runner(options);
+
+    uint64_t frame_number = 0;
+    runner.run("image_create", "\"fps\":" + to_string(fps), "sample", batch_size, [&]()
+    {
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            frame_number++;
+            auto image = get_unique_ptr_with_releaser(create_image(stream_type::depth, static_cast<double>(frame_number) * frame_interval_ms, frame_number));
+        }
+        return status_no_error;
+    });
+
+    int streams_fps[static_cast<int>(stream_type::max)] = {0};
+    int motions_fps[static_cast<int>(motion_type::max)] = {0};
+    streams_fps[static_cast<int>(stream_type::depth)] = fps;
+    streams_fps[static_cast<int>(stream_type::color)] = fps;
+    auto samples_sync = get_unique_ptr_with_releaser(samples_time_sync_interface::create_instance(streams_fps, motions_fps,
+                                                                                                 samples_time_sync_interface::external_device_name));
+    frame_number = 0;
+    runner.run("samples_time_sync_insert", "\"streams\":\"depth_color\",\"fps\":" + to_string(fps), "sample", 2 * batch_size, [&]()
+    {
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            frame_number++;
+            const double time_stamp = static_cast<double>(frame_number) * frame_interval_ms;
+            auto color = get_unique_ptr_with_releaser(create_image(stream_type::color, time_stamp, frame_number));
+            auto depth = get_unique_ptr_with_releaser(create_image(stream_type::depth, time_stamp, frame_number));
+            correlated_sample_set sample_set = {};
+            const bool color_matched = samples_sync->insert(color.get(), sample_set);
+            const bool depth_matched = samples_sync->insert(depth.get(), sample_set);
+            release_sample_set(sample_set);
+            //every depth frame completes the set of the color frame with the same time stamp
+            if(color_matched || !depth_matched)
+                return status_process_failed;
+        }
+        return status_no_error;
+    });
+    samples_sync->flush();
+
+    const unsigned int capacity = 16;
+    cyclic_array<motion_sample> motions(capacity);
+    runner.run("cyclic_array_push_pop", "\"capacity\":" + to_string(capacity), "sample", batch_size, [&]()
+    {
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            motion_sample sample = { motion_type::accel, static_cast<double>(i), static_cast<uint64_t>(i), { 0.f, 9.8f, 0.f } };
+            motions.push_back(sample);
+            if(motions.front().frame_number != static_cast<uint64_t>(i))
+                return status_process_failed;
+            motions.pop_front();
+        }
+        return status_no_error;
+    });
+
+    //a full array overwrites its oldest sample on every push
+    runner.run("cyclic_array_push_full", "\"capacity\":" + to_string(capacity), "sample", batch_size, [&]()
+    {
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            motion_sample sample = { motion_type::gyro, static_cast<double>(i), static_cast<uint64_t>(i), { 0.1f, 0.2f, 0.3f } };
+            motions.push_back(sample);
+        }
+        return motions.size() == capacity ? status_no_error : status_process_failed;
+    });
+
+    return runner.failures() ? -1 : 0;
+}
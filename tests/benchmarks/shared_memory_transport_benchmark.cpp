@@ -0,0 +1,298 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Shared Memory Transport Benchmark
+// Measures the shared memory transport of sample sets between two processes of one machine, with synthetic sets of 4 streams:
+// 640x480 depth, 1080p color, 640x480 infrared and 640x480 fisheye. A forked subscriber process receives the sets and reads
+// one byte of every page of the received images, in place. The publish throughput is measured with sets published as fast
+// as possible, the subscriber receives the latest set and skips the others. The end-to-end latency, from before the publish
+// call to the return of the receive call in the subscriber, is measured with sets published at a fixed rate. The image time
+// stamps carry the publish time, both processes read the same monotonic clock.
+// Every measurement is printed as one JSON object per line.
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rs/core/image_interface.h"
+#include "rs/utils/shared_memory_transport_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "synthetic_frames.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 16;
+    const uint32_t slots_count = 4;
+    const int32_t paced_fps = 60;
+    //the frame numbers of the paced sets start here, the subscriber measures the latency of these sets only
+    const uint64_t paced_frame_number = 1ull << 32;
+    const uint32_t receive_timeout_ms = 5000;
+    const size_t page_size = 4096;
+
+    struct stream_source
+    {
+        stream_type         stream;
+        pixel_format        format;
+        int32_t             width;
+        int32_t             height;
+        int32_t             pixel_size;
+        vector<uint8_t>     data;
+    };
+
+    //sent by the subscriber process through a pipe once the publisher is released
+    struct subscriber_results
+    {
+        int32_t     is_valid;
+        uint64_t    received_count;
+        uint64_t    skipped_count;
+        uint64_t    throughput_received_count;
+        double      throughput_span_ms;
+        uint64_t    latency_count;
+        double      latency_median_ms;
+        double      latency_p99_ms;
+        double      latency_max_ms;
+        uint32_t    pages_checksum; //keeps the page reads from being optimized out
+    };
+
+    double monotonic_time_ms()
+    {
+        timespec now = {};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1000000.0;
+    }
+
+    bool write_all(int fd, const void * data, size_t size)
+    {
+        const uint8_t * bytes = static_cast<const uint8_t *>(data);
+        while(size > 0)
+        {
+            ssize_t written = write(fd, bytes, size);
+            if(written < 0 && errno == EINTR)
+                continue;
+            if(written <= 0)
+                return false;
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool read_all(int fd, void * data, size_t size)
+    {
+        uint8_t * bytes = static_cast<uint8_t *>(data);
+        while(size > 0)
+        {
+            ssize_t bytes_read = read(fd, bytes, size);
+            if(bytes_read < 0 && errno == EINTR)
+                continue;
+            if(bytes_read <= 0)
+                return false;
+            bytes += bytes_read;
+            size -= static_cast<size_t>(bytes_read);
+        }
+        return true;
+    }
+
+    //runs in the subscriber process, receives until the publisher is released
+    int run_subscriber(const string & name, int ready_fd, int results_fd)
+    {
+        subscriber_results results = {};
+        vector<double> latencies;
+        uint32_t touched = 0;
+        {
+            auto subscriber = get_unique_ptr_with_releaser(shared_memory_subscriber_interface::create_instance(name.c_str()));
+            const char ready = subscriber ? 1 : 0;
+            if(!write_all(ready_fd, &ready, sizeof(ready)) || !subscriber)
+                return -1;
+
+            double first_receive_time = 0, last_receive_time = 0;
+            while(true)
+            {
+                correlated_sample_set sample_set = {};
+                const status sts = subscriber->receive(sample_set, receive_timeout_ms);
+                if(sts != status_no_error)
+                {
+                    results.is_valid = sts == status_device_lost;
+                    break;
+                }
+                const double receive_time = monotonic_time_ms();
+                results.received_count++;
+
+                double time_stamp = 0;
+                uint64_t frame_number = 0;
+                for(int32_t i = 0; i < static_cast<int32_t>(stream_type::max); i++)
+                {
+                    auto & image = sample_set.images[i];
+                    if(!image)
+                        continue;
+                    time_stamp = image->query_time_stamp();
+                    frame_number = image->query_frame_number();
+                    const uint8_t * data = static_cast<const uint8_t *>(image->query_data());
+                    const size_t size = static_cast<size_t>(image->query_info().pitch) * static_cast<size_t>(image->query_info().height);
+                    for(size_t offset = 0; offset < size; offset += page_size)
+                        touched += data[offset];
+                    image->release();
+                    image = nullptr;
+                }
+
+                if(frame_number < paced_frame_number)
+                {
+                    if(results.throughput_received_count++ == 0)
+                        first_receive_time = receive_time;
+                    last_receive_time = receive_time;
+                }
+                else
+                {
+                    latencies.push_back(receive_time - time_stamp);
+                }
+            }
+            results.skipped_count = subscriber->query_skipped_count();
+            results.throughput_span_ms = last_receive_time - first_receive_time;
+        }
+
+        results.latency_count = latencies.size();
+        if(!latencies.empty())
+        {
+            sort(latencies.begin(), latencies.end());
+            results.latency_median_ms = latencies[latencies.size() / 2];
+            results.latency_p99_ms = latencies[latencies.size() * 99 / 100];
+            results.latency_max_ms = latencies.back();
+        }
+        results.pages_checksum = touched;
+        return write_all(results_fd, &results, sizeof(results)) ? 0 : -1;
+    }
+
+    status publish_set(shared_memory_publisher_interface & publisher, const vector<stream_source> & sources, uint64_t frame_number)
+    {
+        correlated_sample_set sample_set = {};
+        const double time_stamp = monotonic_time_ms();
+        for(auto & source : sources)
+        {
+            image_info info = { source.width, source.height, source.format, source.width * source.pixel_size };
+            sample_set[source.stream] = image_interface::create_instance_from_raw_data(&info, { source.data.data(), nullptr }, source.stream,
+                                                                                       image_interface::flag::any, time_stamp, frame_number);
+        }
+        const status sts = publisher.publish(sample_set);
+        for(auto & source : sources)
+            sample_set[source.stream]->release();
+        return sts;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    vector<stream_source> sources =
+    {
+        { stream_type::depth, pixel_format::z16, 640, 480, 2, create_depth_data(640, 480) },
+        { stream_type::color, pixel_format::rgb8, 1920, 1080, 3, create_image_data(1920, 1080, 3) },
+        { stream_type::infrared, pixel_format::y8, 640, 480, 1, create_image_data(640, 480, 1) },
+        { stream_type::fisheye, pixel_format::raw8, 640, 480, 1, create_image_data(640, 480, 1) }
+    };
+    //the image sizes are multiples of the 64 bytes slot alignment
+    uint64_t set_bytes = 0;
+    for(auto & source : sources)
+        set_bytes += source.data.size();
+
+    benchmark_runner runner(options);
+    const string name = "rs_shared_memory_transport_benchmark_" + to_string(getpid());
+    auto publisher = get_unique_ptr_with_releaser(shared_memory_publisher_interface::create_instance(name.c_str(), slots_count, set_bytes));
+    int ready_pipe[2], results_pipe[2];
+    if(!publisher || pipe(ready_pipe) != 0 || pipe(results_pipe) != 0)
+    {
+        cerr << "failed to create the shared memory publisher" << endl;
+        return -1;
+    }
+
+    const pid_t subscriber_pid = fork();
+    if(subscriber_pid == 0)
+    {
+        //the subscriber process exits without releasing the copy of the publisher it inherited
+        close(ready_pipe[0]);
+        close(results_pipe[0]);
+        _exit(run_subscriber(name, ready_pipe[1], results_pipe[1]) == 0 ? 0 : 1);
+    }
+    close(ready_pipe[1]);
+    close(results_pipe[1]);
+    char ready = 0;
+    if(subscriber_pid < 0 || !read_all(ready_pipe[0], &ready, sizeof(ready)) || !ready)
+    {
+        cerr << "failed to start the subscriber process" << endl;
+        return -1;
+    }
+
+    stringstream parameters_stream;
+    parameters_stream << "\"streams\":\"depth_color_infrared_fisheye\",\"set_bytes\":" << set_bytes << ",\"slots\":" << slots_count;
+    const string parameters = parameters_stream.str();
+
+    uint64_t frame_number = 0;
+    runner.run("shared_memory_publish", parameters, "byte", static_cast<int64_t>(set_bytes) * batch_size, [&]()
+    {
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            //a set dropped because the subscriber holds all the slots is reported by the dropped count
+            const status sts = publish_set(*publisher, sources, ++frame_number);
+            if(sts < status_no_error && sts != status_item_unavailable)
+                return sts;
+        }
+        return status_no_error;
+    });
+    const uint64_t published_count = frame_number;
+    const uint64_t dropped_count = publisher->query_dropped_count();
+
+    //the paced sets are published at a fixed rate, so the subscriber waits for each of them
+    const auto interval = chrono::microseconds(1000000 / paced_fps);
+    auto next_publish = chrono::steady_clock::now();
+    status paced_status = status_no_error;
+    for(int32_t i = 0; i < options.iterations * batch_size && paced_status >= status_no_error; i++)
+    {
+        this_thread::sleep_until(next_publish);
+        next_publish += interval;
+        paced_status = publish_set(*publisher, sources, paced_frame_number + static_cast<uint64_t>(i));
+    }
+
+    //releasing the publisher ends the subscriber
+    publisher.reset();
+    subscriber_results results = {};
+    const bool has_results = read_all(results_pipe[0], &results, sizeof(results));
+    int subscriber_status = 0;
+    waitpid(subscriber_pid, &subscriber_status, 0);
+    if(!has_results || !results.is_valid || paced_status < status_no_error)
+    {
+        cerr << "the shared memory subscriber failed, publish status " << paced_status << endl;
+        return -1;
+    }
+
+    stringstream throughput_stream;
+    throughput_stream << fixed << setprecision(3) << "\"published_sets\":" << published_count
+                      << ",\"dropped_sets\":" << dropped_count
+                      << ",\"received_sets\":" << results.throughput_received_count
+                      << ",\"skipped_sets\":" << results.skipped_count
+                      << ",\"received_sets_per_s\":" << (results.throughput_span_ms > 0 ? static_cast<double>(results.throughput_received_count) * 1000.0 / results.throughput_span_ms : 0.0);
+    runner.report("shared_memory_receive_throughput", parameters, throughput_stream.str());
+
+    stringstream latency_stream;
+    latency_stream << fixed << setprecision(3) << "\"received_sets\":" << results.latency_count
+                   << ",\"median_ms\":" << results.latency_median_ms
+                   << ",\"p99_ms\":" << results.latency_p99_ms
+                   << ",\"max_ms\":" << results.latency_max_ms;
+    runner.report("shared_memory_end_to_end_latency", parameters + ",\"fps\":" + to_string(paced_fps), latency_stream.str());
+
+    return runner.failures() ? -1 : 0;
+}
@@ -0,0 +1,39 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+namespace rs
+{
+    namespace benchmarks
+    {
+        //a depth ramp with holes, close to the compression ratio of a real scene
+        inline std::vector<uint8_t> create_depth_data(int32_t width, int32_t height)
+        {
+            std::vector<uint8_t> data(width * height * sizeof(uint16_t));
+            uint16_t * depth = reinterpret_cast<uint16_t *>(data.data());
+            for(int32_t i = 0; i < width * height; i++)
+                depth[i] = static_cast<uint16_t>(i % 7 ? 800 + i % 4000 : 0);
+            return data;
+        }
+
+        //gradients with low bits noise, channels is 1 for infrared and 3 for color
+        inline std::vector<uint8_t> create_image_data(int32_t width, int32_t height, int32_t channels)
+        {
+            std::vector<uint8_t> data(width * height * channels);
+            uint32_t noise = 12345;
+            for(int32_t y = 0; y < height; y++)
+            {
+                for(int32_t x = 0; x < width; x++)
+                {
+                    noise = noise * 1103515245 + 12345;
+                    for(int32_t c = 0; c < channels; c++)
+                        data[(y * width + x) * channels + c] = static_cast<uint8_t>((x + y * (c + 1)) / 4 + ((noise >> 16) & 0x3));
+                }
+            }
+            return data;
+        }
+    }
+}
@@ -0,0 +1,160 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#pragma once
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include "record/include/disk_write.h"
+#include "rs/utils/performance_counters.h"
+
+namespace rs
+{
+    namespace benchmarks
+    {
+        struct stream_input
+        {
+            rs_stream               stream;
+            rs_format               format;
+            int32_t                 width;
+            int32_t                 height;
+            int32_t                 bpp;
+            int32_t                 framerate;
+            std::vector<uint8_t>    data;
+        };
+
+        /**
+        * @brief Records frames of synthetic streams with the disk write of the recorder, without a device.
+        *
+        * Every frame references the data of its stream input, so the measured time covers the recorder queue, the compression
+        * and the file writes, without any frame copy.
+        */
+        class synthetic_recorder
+        {
+        public:
+            synthetic_recorder(const std::string & file_path, const std::vector<stream_input> & inputs, rs::record::compression_level level,
+                               bool direct_io = false) :
+                m_file_path(file_path), m_inputs(inputs), m_level(level), m_direct_io(direct_io), m_written_samples_count(0),
+                m_frames_dropped_counter(PERF_COUNTERS.query_counter("record.frames_dropped")), m_is_started(false), m_frame_number(0) {}
+
+            ~synthetic_recorder()
+            {
+                stop();
+            }
+
+            rs::core::status start()
+            {
+                static const char * device_name = "synthetic_recorder";
+                rs::record::configuration config = {};
+                config.m_file_path = m_file_path;
+                config.m_camera_info[rs_camera_info::RS_CAMERA_INFO_DEVICE_NAME] = { static_cast<uint32_t>(std::strlen(device_name) + 1), device_name };
+                config.m_coordinate_system = rs::core::file_types::coordinate_system::rear_default;
+                config.m_capture_mode = rs::playback::capture_mode::synced;
+                config.m_direct_io = m_direct_io;
+                for(auto & input : m_inputs)
+                {
+                    rs::core::file_types::stream_profile profile = {};
+                    profile.info = create_frame_info(input);
+                    profile.frame_rate = input.framerate;
+                    profile.intrinsics.width = input.width;
+                    profile.intrinsics.height = input.height;
+                    config.m_stream_profiles[input.stream] = profile;
+                    config.m_compression_config[input.stream] = m_level;
+                    if(input.stream == rs_stream::RS_STREAM_DEPTH)
+                        config.m_capabilities.push_back(rs_capabilities::RS_CAPABILITIES_DEPTH);
+                    if(input.stream == rs_stream::RS_STREAM_COLOR)
+                        config.m_capabilities.push_back(rs_capabilities::RS_CAPABILITIES_COLOR);
+                    if(input.stream == rs_stream::RS_STREAM_INFRARED)
+                        config.m_capabilities.push_back(rs_capabilities::RS_CAPABILITIES_INFRARED);
+                }
+
+                try
+                {
+                    auto sts = m_writer.configure(config);
+                    if(sts < rs::core::status_no_error)
+                        return sts;
+                }
+                catch(const std::exception &)
+                {
+                    return rs::core::status_file_open_failed;
+                }
+                m_is_started = m_writer.start();
+                return m_is_started ? rs::core::status_no_error : rs::core::status_init_failed;
+            }
+
+            //records count frames of each stream and waits until the write thread has written them all
+            rs::core::status record(int32_t count)
+            {
+                if(!m_is_started)
+                    return rs::core::status_invalid_state;
+
+                const int64_t frames_dropped = m_frames_dropped_counter.query();
+                for(int32_t i = 0; i < count; i++)
+                {
+                    m_frame_number++;
+                    for(auto & input : m_inputs)
+                    {
+                        auto frame = new rs::core::file_types::frame_sample(create_frame_info(input), m_frame_number * 1000000 / input.framerate);
+                        frame->finfo.number = m_frame_number;
+                        frame->finfo.time_stamp = static_cast<double>(m_frame_number) * 1000.0 / input.framerate;
+                        frame->data = input.data.data();
+                        std::shared_ptr<rs::core::file_types::sample> sample(frame, [this](rs::core::file_types::sample * sample)
+                        {
+                            delete sample;
+                            std::lock_guard<std::mutex> lock(m_written_samples_lock);
+                            m_written_samples_count++;
+                            m_written_samples_cv.notify_one();
+                        });
+                        m_writer.record_sample(sample);
+                    }
+                }
+
+                //dropped samples are released by the recorder as well, and fail the recording
+                const int32_t samples_count = count * static_cast<int32_t>(m_inputs.size());
+                std::unique_lock<std::mutex> lock(m_written_samples_lock);
+                m_written_samples_cv.wait(lock, [&]() { return m_written_samples_count >= samples_count; });
+                m_written_samples_count -= samples_count;
+                return m_frames_dropped_counter.query() == frames_dropped ? rs::core::status_no_error : rs::core::status_process_failed;
+            }
+
+            //closes the file, after which it can be played
+            void stop()
+            {
+                if(!m_is_started)
+                    return;
+                m_writer.stop();
+                m_is_started = false;
+            }
+
+        private:
+            static rs::core::file_types::frame_info create_frame_info(const stream_input & input)
+            {
+                rs::core::file_types::frame_info info = {};
+                info.width = input.width;
+                info.height = input.height;
+                info.format = input.format;
+                info.bpp = input.bpp;
+                info.stride = input.width * input.bpp;
+                info.stream = input.stream;
+                info.framerate = input.framerate;
+                return info;
+            }
+
+            const std::string                   m_file_path;
+            const std::vector<stream_input> &   m_inputs;
+            const rs::record::compression_level m_level;
+            const bool                          m_direct_io;
+            //the samples released on the write thread signal the counter, so it is destroyed after the disk write
+            std::mutex                          m_written_samples_lock;
+            std::condition_variable             m_written_samples_cv;
+            int32_t                             m_written_samples_count;
+            rs::utils::performance_counter &    m_frames_dropped_counter;
+            rs::record::disk_write              m_writer;
+            bool                                m_is_started;
+            unsigned long long                  m_frame_number;
+        };
+    }
+}
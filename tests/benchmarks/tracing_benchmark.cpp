@@ -0,0 +1,68 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Tracing Benchmark
+// Measures the cost of a trace point with tracing disabled and enabled, and the time to dump the recorded events to a Chrome
+// trace file. A recorded frame passes through a few spans, so the per span cost compares with the frame period of the streams.
+// Every measurement is printed as one JSON object per line, with the time per trace point or per dumped event.
+
+#include <stdio.h>
+#include <string>
+#include "rs/utils/event_tracer.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t spans_count = 1000;
+
+    void run_trace_points(benchmark_runner & runner, const string & parameters)
+    {
+        runner.run("trace_scope", parameters, "span", spans_count, [&]()
+        {
+            for(int32_t i = 0; i < spans_count; i++)
+            {
+                TRACE_SCOPE("benchmark", "span");
+            }
+            return status_no_error;
+        });
+
+        runner.run("trace_counter", parameters, "event", spans_count, [&]()
+        {
+            for(int32_t i = 0; i < spans_count; i++)
+            {
+                TRACE_COUNTER("benchmark", "counter", i);
+            }
+            return status_no_error;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    benchmark_runner runner(options);
+    TRACE_TRACER.disable();
+    run_trace_points(runner, "\"tracing\":\"disabled\"");
+
+    //the buffer holds the events of all the iterations, so no event is dropped
+    const uint32_t events_count = 2 * spans_count * (options.iterations + 1);
+    TRACE_TRACER.enable(events_count);
+    run_trace_points(runner, "\"tracing\":\"enabled\"");
+    TRACE_TRACER.disable();
+
+    const string file_path = "tracing_benchmark.json";
+    runner.run("trace_dump", "\"tracing\":\"enabled\"", "event", events_count, [&]()
+    {
+        return TRACE_TRACER.dump(file_path.c_str());
+    });
+    remove(file_path.c_str());
+
+    return runner.failures() || TRACE_TRACER.query_dropped_count() ? -1 : 0;
+}
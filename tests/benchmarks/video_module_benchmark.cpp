@@ -0,0 +1,137 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+// Video Module Benchmark
+// Measures the per sample cost of the max depth value module on synthetic depth frames, no camera is required.
+// The compute benchmark calls the depth statistics directly, as the reference for the module overhead in sync mode,
+// and in async mode with one worker and with a worker per hardware thread.
+// Every measurement is printed as one JSON object per line, with the time per sample.
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "rs/core/image_interface.h"
+#include "rs/utils/depth_statistics_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+#include "rs/cv_modules/max_depth_value_module/max_depth_value_module.h"
+#include "benchmark_runner.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::cv_modules;
+using namespace rs::benchmarks;
+
+namespace
+{
+    const int32_t batch_size = 64;
+
+    //counts the module outputs, so a batch is measured until its last output is ready
+    class outputs_counter : public video_module_interface::processing_event_handler
+    {
+    public:
+        outputs_counter() : m_count(0) {}
+
+        void module_output_ready(video_module_interface * sender, correlated_sample_set * sample) override
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_count++;
+            m_count_changed.notify_one();
+        }
+
+        void wait_for(int32_t count)
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_count_changed.wait(lock, [&]() { return m_count >= count; });
+            m_count -= count;
+        }
+
+    private:
+        std::mutex m_lock;
+        std::condition_variable m_count_changed;
+        int32_t m_count;
+    };
+
+    void run_async(benchmark_runner & runner, const string & parameters, image_interface * depth, uint32_t workers_count)
+    {
+        //the queue holds a full batch, so no sample is dropped
+        max_depth_value_module module(0, true, workers_count, batch_size);
+        outputs_counter counter;
+        module.register_event_handler(&counter);
+
+        stringstream parameters_stream;
+        parameters_stream << parameters << ",\"workers\":" << workers_count;
+        runner.run("max_depth_module_async", parameters_stream.str(), "sample", batch_size, [&]()
+        {
+            correlated_sample_set sample_set = {};
+            sample_set[stream_type::depth] = depth;
+            for(int32_t i = 0; i < batch_size; i++)
+            {
+                auto sts = module.process_sample_set(sample_set);
+                if(sts < status_no_error)
+                    return sts;
+            }
+            counter.wait_for(batch_size);
+            return module.query_processing_statistics().dropped ? status_process_failed : status_no_error;
+        });
+        module.unregister_event_handler(&counter);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    benchmark_options options;
+    if(!parse_benchmark_options(argc, argv, options))
+        return -1;
+
+    const int32_t width = 628, height = 468;
+    vector<uint16_t> depth_data(width * height);
+    for(size_t i = 0; i < depth_data.size(); i++)
+        depth_data[i] = static_cast<uint16_t>(i % 7 ? 800 + i % 4000 : 0);
+    image_info depth_info = { width, height, pixel_format::z16, width * static_cast<int32_t>(sizeof(uint16_t)) };
+    auto depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&depth_info, { depth_data.data(), nullptr },
+                                                                                            stream_type::depth, image_interface::flag::any, 0, 0));
+    stringstream parameters_stream;
+    parameters_stream << "\"depth\":\"" << width << "x" << height << "\"";
+    const string parameters = parameters_stream.str();
+
+    benchmark_runner runner(options);
+
+    auto statistics_utility = get_unique_ptr_with_releaser(depth_statistics_interface::create_instance());
+    runner.run("depth_statistics_compute", parameters, "sample", batch_size, [&]()
+    {
+        depth_statistics statistics = {};
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            auto sts = statistics_utility->query_statistics(depth.get(), nullptr, statistics);
+            if(sts < status_no_error)
+                return sts;
+        }
+        return status_no_error;
+    });
+
+    max_depth_value_module sync_module(0, false);
+    runner.run("max_depth_module_sync", parameters, "sample", batch_size, [&]()
+    {
+        correlated_sample_set sample_set = {};
+        sample_set[stream_type::depth] = depth.get();
+        for(int32_t i = 0; i < batch_size; i++)
+        {
+            auto sts = sync_module.process_sample_set(sample_set);
+            if(sts < status_no_error)
+                return sts;
+            sync_module.get_max_depth_value_data();
+        }
+        return status_no_error;
+    });
+
+    run_async(runner, parameters, depth.get(), 1);
+    const uint32_t hardware_threads = thread::hardware_concurrency();
+    if(hardware_threads > 1)
+        run_async(runner, parameters, depth.get(), hardware_threads);
+
+    return runner.failures() ? -1 : 0;
+}
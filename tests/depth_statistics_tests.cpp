@@ -0,0 +1,176 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "rs/core/image_interface.h"
+#include "rs/utils/depth_statistics_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace depth_statistics_tests_setup
+{
+    //the pitch is padded to check that the padding isn't reduced, and the width isn't a multiple of the simd width
+    static const int32_t width = 637;
+    static const int32_t height = 479;
+    static const int32_t pitch = (width + 11) * sizeof(uint16_t);
+    static const uint16_t padding_value = 65535;
+
+    //pseudo random depth with about one invalid pixel out of five
+    vector<uint16_t> create_depth_data()
+    {
+        vector<uint16_t> data(pitch / sizeof(uint16_t) * height, padding_value);
+        srand(7);
+        for(int32_t y = 0; y < height; y++)
+        {
+            for(int32_t x = 0; x < width; x++)
+            {
+                const uint16_t value = static_cast<uint16_t>(rand() % 9000);
+                data[y * pitch / sizeof(uint16_t) + x] = rand() % 5 == 0 ? 0 : std::max<uint16_t>(value, 1);
+            }
+        }
+        return data;
+    }
+
+    //the reference collects the valid values of the region
+    vector<uint16_t> valid_values(const vector<uint16_t> & data, const rect & roi)
+    {
+        vector<uint16_t> values;
+        for(int32_t y = roi.y; y < roi.y + roi.height; y++)
+        {
+            for(int32_t x = roi.x; x < roi.x + roi.width; x++)
+            {
+                const uint16_t value = data[y * pitch / sizeof(uint16_t) + x];
+                if(value)
+                    values.push_back(value);
+            }
+        }
+        return values;
+    }
+
+    void check_statistics(const depth_statistics & statistics, const vector<uint16_t> & data, const rect & roi)
+    {
+        vector<uint16_t> values = valid_values(data, roi);
+        uint64_t sum = 0;
+        for(auto value : values)
+            sum += value;
+        ASSERT_FALSE(values.empty());
+        EXPECT_EQ(values.size(), statistics.valid_count);
+        EXPECT_EQ(static_cast<uint64_t>(roi.width) * roi.height, statistics.pixels_count);
+        EXPECT_EQ(*std::min_element(values.begin(), values.end()), statistics.min_depth);
+        EXPECT_EQ(*std::max_element(values.begin(), values.end()), statistics.max_depth);
+        EXPECT_DOUBLE_EQ(static_cast<double>(sum) / values.size(), statistics.mean_depth);
+    }
+}
+
+using namespace depth_statistics_tests_setup;
+
+//the tests run with a single thread and with several threads, to cover both the simd reduction and the bands merge
+class depth_statistics_tests : public testing::Test
+{
+protected:
+    const vector<uint32_t> m_threads_counts = { 1, 4 };
+    vector<uint16_t> m_data;
+    rs::utils::unique_ptr<image_interface> m_depth;
+
+    virtual void SetUp()
+    {
+        m_data = create_depth_data();
+        image_info info = { width, height, pixel_format::z16, pitch };
+        m_depth = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, { m_data.data(), nullptr }, stream_type::depth,
+                                                                                              image_interface::flag::any, 0, 0));
+    }
+};
+
+TEST_F(depth_statistics_tests, full_frame_statistics_match_reference)
+{
+    for(auto threads_count : m_threads_counts)
+    {
+        auto statistics_utility = get_unique_ptr_with_releaser(depth_statistics_interface::create_instance(threads_count));
+        depth_statistics statistics = {};
+        ASSERT_EQ(status_no_error, statistics_utility->query_statistics(m_depth.get(), nullptr, statistics));
+        check_statistics(statistics, m_data, { 0, 0, width, height });
+    }
+}
+
+TEST_F(depth_statistics_tests, roi_statistics_match_reference)
+{
+    const rect rois[] = { { 0, 0, 1, 1 }, { 3, 5, 7, 3 }, { 101, 77, 333, 211 }, { width - 17, height - 9, 17, 9 }, { 0, 0, width, height } };
+    const int32_t rois_count = sizeof(rois) / sizeof(rois[0]);
+    for(auto threads_count : m_threads_counts)
+    {
+        auto statistics_utility = get_unique_ptr_with_releaser(depth_statistics_interface::create_instance(threads_count));
+        vector<depth_statistics> statistics(rois_count);
+        ASSERT_EQ(status_no_error, statistics_utility->query_roi_statistics(m_depth.get(), rois, rois_count, statistics.data()));
+        for(int32_t i = 0; i < rois_count; i++)
+        {
+            if(valid_values(m_data, rois[i]).empty())
+            {
+                EXPECT_EQ(0u, statistics[i].valid_count);
+                EXPECT_EQ(0, statistics[i].min_depth);
+                EXPECT_EQ(0, statistics[i].max_depth);
+                continue;
+            }
+            check_statistics(statistics[i], m_data, rois[i]);
+        }
+
+        const rect outside_roi = { width - 10, 0, 11, 10 };
+        depth_statistics outside_statistics = {};
+        EXPECT_EQ(status_param_unsupported, statistics_utility->query_statistics(m_depth.get(), &outside_roi, outside_statistics));
+    }
+}
+
+TEST_F(depth_statistics_tests, histogram_and_percentiles_match_reference)
+{
+    const rect roi = { 50, 40, 500, 400 };
+    vector<uint16_t> values = valid_values(m_data, roi);
+    std::sort(values.begin(), values.end());
+
+    const uint16_t min_depth = 1000, max_depth = 6999;
+    const int32_t bins_count = 60;
+    vector<uint32_t> histogram(bins_count), expected_histogram(bins_count, 0);
+    for(auto value : values)
+    {
+        if(value >= min_depth && value <= max_depth)
+            expected_histogram[(value - min_depth) * bins_count / (max_depth - min_depth + 1)]++;
+    }
+    const float percentiles[] = { 0.f, 1.f, 25.f, 50.f, 90.f, 99.9f, 100.f };
+    const int32_t percentiles_count = sizeof(percentiles) / sizeof(percentiles[0]);
+    vector<uint16_t> expected_values(percentiles_count);
+    for(int32_t i = 0; i < percentiles_count; i++)
+    {
+        const size_t rank = std::max<size_t>(1, static_cast<size_t>(std::ceil(percentiles[i] / 100.0 * values.size())));
+        expected_values[i] = values[rank - 1];
+    }
+
+    for(auto threads_count : m_threads_counts)
+    {
+        auto statistics_utility = get_unique_ptr_with_releaser(depth_statistics_interface::create_instance(threads_count));
+        ASSERT_EQ(status_no_error, statistics_utility->query_histogram(m_depth.get(), &roi, min_depth, max_depth, bins_count, histogram.data()));
+        EXPECT_EQ(expected_histogram, histogram);
+
+        vector<uint16_t> percentile_values(percentiles_count);
+        ASSERT_EQ(status_no_error, statistics_utility->query_percentiles(m_depth.get(), &roi, percentiles, percentiles_count, percentile_values.data()));
+        EXPECT_EQ(expected_values, percentile_values);
+    }
+}
+
+TEST_F(depth_statistics_tests, invalid_images_are_rejected)
+{
+    auto statistics_utility = get_unique_ptr_with_releaser(depth_statistics_interface::create_instance(1));
+    depth_statistics statistics = {};
+    EXPECT_EQ(status_handle_invalid, statistics_utility->query_statistics(nullptr, nullptr, statistics));
+
+    vector<uint8_t> data(64 * 48 * 3);
+    image_info info = { 64, 48, pixel_format::rgb8, 64 * 3 };
+    auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&info, { data.data(), nullptr }, stream_type::color,
+                                                                                            image_interface::flag::any, 0, 0));
+    EXPECT_EQ(status_param_unsupported, statistics_utility->query_statistics(color.get(), nullptr, statistics));
+}
@@ -0,0 +1,95 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "rs/utils/event_tracer.h"
+
+using namespace std;
+
+namespace event_tracer_tests_setup
+{
+    string read_file(const string & file_path)
+    {
+        ifstream file(file_path);
+        stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    size_t count_occurrences(const string & text, const string & pattern)
+    {
+        size_t count = 0;
+        for(size_t position = text.find(pattern); position != string::npos; position = text.find(pattern, position + 1))
+        {
+            count++;
+        }
+        return count;
+    }
+}
+
+using namespace event_tracer_tests_setup;
+
+GTEST_TEST(event_tracer_tests, dump_writes_the_events_of_each_thread)
+{
+    const string file_path = "event_tracer_test.json";
+    TRACE_TRACER.enable();
+    std::thread worker([]()
+    {
+        TRACE_THREAD_NAME("test_worker");
+        for(int i = 0; i < 10; i++)
+        {
+            TRACE_SCOPE("test", "worker_span");
+        }
+        TRACE_INSTANT("test", "worker_drop");
+    });
+    worker.join();
+    {
+        TRACE_SCOPE("test", "main_span");
+        TRACE_COUNTER("test", "main_counter", 42);
+    }
+    TRACE_TRACER.disable();
+    {
+        TRACE_SCOPE("test", "disabled_span");
+    }
+
+    ASSERT_EQ(rs::core::status_no_error, TRACE_TRACER.dump(file_path.c_str()));
+    const string trace = read_file(file_path);
+    remove(file_path.c_str());
+
+    EXPECT_EQ(0u, trace.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+    EXPECT_EQ(10u, count_occurrences(trace, "\"name\":\"worker_span\""));
+    EXPECT_EQ(1u, count_occurrences(trace, "\"name\":\"main_span\""));
+    EXPECT_EQ(1u, count_occurrences(trace, "\"ph\":\"i\""));
+    EXPECT_EQ(1u, count_occurrences(trace, "\"args\":{\"value\":42}"));
+    EXPECT_EQ(1u, count_occurrences(trace, "\"args\":{\"name\":\"test_worker\"}"));
+    EXPECT_EQ(0u, count_occurrences(trace, "disabled_span"));
+    EXPECT_EQ(0u, TRACE_TRACER.query_dropped_count());
+}
+
+GTEST_TEST(event_tracer_tests, full_thread_buffer_drops_events)
+{
+    const string file_path = "event_tracer_test.json";
+    TRACE_TRACER.enable(16);
+    for(int i = 0; i < 20; i++)
+    {
+        TRACE_INSTANT("test", "instant");
+    }
+    TRACE_TRACER.disable();
+    EXPECT_EQ(4u, TRACE_TRACER.query_dropped_count());
+
+    ASSERT_EQ(rs::core::status_no_error, TRACE_TRACER.dump(file_path.c_str()));
+    const string trace = read_file(file_path);
+    remove(file_path.c_str());
+    EXPECT_EQ(16u, count_occurrences(trace, "\"name\":\"instant\""));
+
+    //a new session discards the events of the previous one
+    TRACE_TRACER.enable();
+    TRACE_TRACER.disable();
+    EXPECT_EQ(0u, TRACE_TRACER.query_dropped_count());
+}
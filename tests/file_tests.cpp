@@ -0,0 +1,216 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <stdio.h>
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <thread>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include "gtest/gtest.h"
+#include "include/file.h"
+#include "direct_io_file.h"
+#include "stream_write_file.h"
+#include "live_stream.h"
+
+using namespace std;
+using namespace rs::core;
+
+namespace file_tests_setup
+{
+    static const string file_path = "file_test.rssdk";
+    static const string preallocated_file_path = "file_test_preallocated.rssdk";
+    static const string direct_io_file_path = "file_test_direct_io.rssdk";
+
+    //writes a header placeholder, the data in chunks, then rewrites the header, the same sequence the recorder uses
+    void write_file(file & f, const vector<uint8_t> & data, uint32_t chunk_size)
+    {
+        uint32_t header = 0, bytes_written = 0;
+        ASSERT_EQ(status_no_error, f.write_bytes(&header, sizeof(header), bytes_written));
+        for(uint32_t offset = 0; offset < data.size(); offset += chunk_size)
+        {
+            uint32_t size = std::min(chunk_size, static_cast<uint32_t>(data.size()) - offset);
+            ASSERT_EQ(status_no_error, f.write_bytes(data.data() + offset, size, bytes_written));
+            ASSERT_EQ(size, bytes_written);
+        }
+        uint64_t position = 0;
+        header = static_cast<uint32_t>(data.size());
+        ASSERT_EQ(status_no_error, f.set_position(0, move_method::begin));
+        ASSERT_EQ(status_no_error, f.write_bytes(&header, sizeof(header), bytes_written));
+        ASSERT_EQ(status_no_error, f.set_position(0, move_method::end, &position));
+        ASSERT_EQ(data.size() + sizeof(header), position);
+    }
+
+    vector<uint8_t> create_data(size_t size)
+    {
+        vector<uint8_t> data(size);
+        for(size_t i = 0; i < data.size(); i++)
+            data[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+        return data;
+    }
+
+    vector<uint8_t> read_file(const string & path)
+    {
+        ifstream stream(path, ios::binary);
+        return vector<uint8_t>((istreambuf_iterator<char>(stream)), istreambuf_iterator<char>());
+    }
+
+    //streams the data written by write_file over a socket pair, returns the received stream
+    vector<uint8_t> stream_file(const vector<uint8_t> & data, uint32_t chunk_size)
+    {
+        int descriptors[2] = { -1, -1 };
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, descriptors) != 0)
+            return vector<uint8_t>();
+
+        //the writer blocks while the stream isn't read, so the stream is received on another thread
+        vector<uint8_t> received;
+        std::thread reader([&]()
+        {
+            auto stream = rs::playback::live_stream::open("fd:" + to_string(descriptors[0]));
+            if(!stream)
+                return;
+            rs::playback::live_stream_file stream_reader(stream);
+            uint8_t buffer[4096];
+            uint32_t bytes_read = 0;
+            size_t remaining = data.size() + sizeof(uint32_t);
+            while(remaining > 0)
+            {
+                uint32_t size = static_cast<uint32_t>(std::min(sizeof(buffer), remaining));
+                if(stream_reader.read_bytes(buffer, size, bytes_read) != status_no_error)
+                    break;
+                received.insert(received.end(), buffer, buffer + size);
+                remaining -= size;
+            }
+            //the stream ends with the written data
+            if(stream_reader.read_bytes(buffer, 1, bytes_read) == status_no_error)
+                received.push_back(buffer[0]);
+        });
+
+        rs::record::stream_write_file writer;
+        EXPECT_EQ(status_no_error, writer.open("fd:" + to_string(descriptors[1]), open_file_option::write));
+        write_file(writer, data, chunk_size);
+        EXPECT_EQ(status_no_error, writer.close());
+        reader.join();
+        return received;
+    }
+}
+
+using namespace file_tests_setup;
+
+class file_fixture : public testing::Test
+{
+protected:
+    static void TearDownTestCase()
+    {
+        ::remove(file_path.c_str());
+        ::remove(preallocated_file_path.c_str());
+        ::remove(direct_io_file_path.c_str());
+    }
+};
+
+TEST_F(file_fixture, preallocated_file_is_identical)
+{
+    auto data = create_data(3 * 1024 * 1024 + 17);
+
+    file regular_file;
+    ASSERT_EQ(status_no_error, regular_file.open(file_path, open_file_option::write));
+    write_file(regular_file, data, 4096);
+    ASSERT_EQ(status_no_error, regular_file.close());
+
+    //the expected size is much larger than the written data, so most of the reserved space is released on close
+    file preallocated_file;
+    auto sts = preallocated_file.set_preallocation(256 * 1024 * 1024);
+    if(sts == status_feature_unsupported)
+        return;
+    ASSERT_EQ(status_no_error, sts);
+    ASSERT_EQ(status_no_error, preallocated_file.open(preallocated_file_path, open_file_option::write));
+    write_file(preallocated_file, data, 4096);
+    ASSERT_EQ(status_no_error, preallocated_file.close());
+
+    auto regular_content = read_file(file_path);
+    auto preallocated_content = read_file(preallocated_file_path);
+    ASSERT_EQ(data.size() + sizeof(uint32_t), regular_content.size());
+    ASSERT_EQ(regular_content.size(), preallocated_content.size());
+    EXPECT_TRUE(regular_content == preallocated_content);
+
+    struct stat regular_status = {}, preallocated_status = {};
+    ASSERT_EQ(0, stat(file_path.c_str(), &regular_status));
+    ASSERT_EQ(0, stat(preallocated_file_path.c_str(), &preallocated_status));
+    EXPECT_EQ(regular_status.st_size, preallocated_status.st_size);
+    //the allocated blocks may be rounded up to the file system block, but not to the reserved extent
+    EXPECT_LT(static_cast<int64_t>(preallocated_status.st_blocks) * 512, static_cast<int64_t>(preallocated_status.st_size) + 1024 * 1024);
+}
+
+TEST_F(file_fixture, preallocated_file_is_readable)
+{
+    file preallocated_file;
+    if(preallocated_file.set_preallocation(1024 * 1024) == status_feature_unsupported)
+        return;
+    ASSERT_EQ(status_no_error, preallocated_file.open(preallocated_file_path, open_file_option::write));
+    uint32_t bytes_written = 0;
+    const uint64_t value = 0x0123456789abcdef;
+    ASSERT_EQ(status_no_error, preallocated_file.write_bytes(&value, sizeof(value), bytes_written));
+    ASSERT_EQ(status_no_error, preallocated_file.close());
+
+    file reader;
+    ASSERT_EQ(status_no_error, reader.open(preallocated_file_path, open_file_option::read));
+    uint64_t position = 0, read_value = 0;
+    uint32_t bytes_read = 0;
+    ASSERT_EQ(status_no_error, reader.set_position(0, move_method::end, &position));
+    EXPECT_EQ(sizeof(value), position);
+    ASSERT_EQ(status_no_error, reader.set_position(0, move_method::begin));
+    ASSERT_EQ(status_no_error, reader.read_bytes(&read_value, sizeof(read_value), bytes_read));
+    EXPECT_EQ(value, read_value);
+}
+
+TEST_F(file_fixture, direct_io_file_is_identical)
+{
+    //odd chunks cross the block boundaries, and the header rewrite targets an already written block
+    auto data = create_data(5 * 1024 * 1024 + 123);
+
+    file regular_file;
+    ASSERT_EQ(status_no_error, regular_file.open(file_path, open_file_option::write));
+    write_file(regular_file, data, 12345);
+    ASSERT_EQ(status_no_error, regular_file.close());
+
+    rs::record::direct_io_file direct_file;
+    ASSERT_EQ(status_no_error, direct_file.open(direct_io_file_path, open_file_option::write));
+    write_file(direct_file, data, 12345);
+    uint64_t position = 0;
+    EXPECT_NE(status_no_error, direct_file.set_position(1, move_method::end, &position));
+    ASSERT_EQ(status_no_error, direct_file.close());
+
+    auto regular_content = read_file(file_path);
+    auto direct_content = read_file(direct_io_file_path);
+    ASSERT_EQ(data.size() + sizeof(uint32_t), direct_content.size());
+    EXPECT_TRUE(regular_content == direct_content);
+}
+
+TEST_F(file_fixture, stream_write_file_is_received)
+{
+    //the data crosses the blocks kept by the live stream, and the header rewrite targets data which is still pending
+    auto data = create_data(3 * 1024 * 1024 + 17);
+
+    file regular_file;
+    ASSERT_EQ(status_no_error, regular_file.open(file_path, open_file_option::write));
+    write_file(regular_file, data, 4096);
+    ASSERT_EQ(status_no_error, regular_file.close());
+
+    auto received = stream_file(data, 4096);
+    ASSERT_EQ(data.size() + sizeof(uint32_t), received.size());
+    EXPECT_TRUE(read_file(file_path) == received);
+}
+
+TEST_F(file_fixture, stream_write_file_drops_rewrites_of_sent_data)
+{
+    //a large chunk is sent together with the header placeholder, so the header rewrite is dropped
+    auto data = create_data(1024 * 1024);
+
+    auto received = stream_file(data, 256 * 1024);
+    ASSERT_EQ(data.size() + sizeof(uint32_t), received.size());
+    EXPECT_TRUE(std::equal(received.begin(), received.begin() + sizeof(uint32_t), vector<uint8_t>(sizeof(uint32_t), 0).begin()));
+    EXPECT_TRUE(std::equal(data.begin(), data.end(), received.begin() + sizeof(uint32_t)));
+}
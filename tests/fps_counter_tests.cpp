@@ -2,6 +2,8 @@
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
 #include <memory>
+#include <thread>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "file_types.h"
@@ -100,3 +102,92 @@ TEST_F(fps_counter_tests, comparison_fps)
     ASSERT_NEAR(average_current_diff, 0, fps_tests_setup::threshold);
 }
 
+
+GTEST_TEST(fps_counter_statistics_tests, interval_statistics_of_synthetic_ticks)
+{
+    const int frame_rate = 30;
+    fps_counter counter(frame_rate, 100);
+    auto time = fps_counter::time_point();
+    // the first frames are skipped
+    for(int i = 0; i < 5; i++)
+    {
+        counter.tick(time);
+    }
+    EXPECT_EQ(0u, counter.frames_count());
+
+    // 33 ms intervals, with a 100 ms gap which misses two frames
+    for(int i = 0; i < 50; i++)
+    {
+        time += std::chrono::milliseconds(i == 25 ? 100 : 33);
+        counter.tick(time);
+    }
+    EXPECT_EQ(50u, counter.frames_count());
+
+    auto statistics = counter.query_interval_statistics();
+    EXPECT_EQ(49u, statistics.intervals_count);
+    EXPECT_NEAR(33.0, statistics.min_ms, 0.001);
+    EXPECT_NEAR(100.0, statistics.max_ms, 0.001);
+    EXPECT_NEAR(33.0, statistics.median_ms, 0.001);
+    EXPECT_GT(statistics.jitter_ms, 0.0);
+    EXPECT_EQ(2u, statistics.dropped_frames);
+    EXPECT_NEAR(100.0, counter.interval_percentile_ms(100), 0.001);
+    EXPECT_EQ(2u, counter.estimated_dropped_frames());
+    EXPECT_NEAR(1000.0 * 49 / (48 * 33 + 100), counter.current_fps(), 0.001);
+}
+
+GTEST_TEST(fps_counter_statistics_tests, window_keeps_the_last_ticks)
+{
+    fps_counter counter(60, 10);
+    auto time = fps_counter::time_point();
+    for(int i = 0; i < 5; i++)
+    {
+        counter.tick(time);
+    }
+    for(int i = 0; i < 100; i++)
+    {
+        time += std::chrono::milliseconds(i < 90 ? 10 : 20);
+        counter.tick(time);
+    }
+    auto statistics = counter.query_interval_statistics();
+    EXPECT_EQ(9u, statistics.intervals_count);
+    EXPECT_NEAR(20.0, statistics.min_ms, 0.001);
+    EXPECT_NEAR(50.0, counter.current_fps(), 0.001);
+    // the first counted tick is 10 ms after the skipped ticks
+    EXPECT_NEAR(1000.0 * 99 / (89 * 10 + 10 * 20), counter.total_average_fps(), 0.001);
+}
+
+GTEST_TEST(fps_counter_statistics_tests, concurrent_ticks_are_counted)
+{
+    fps_counter counter(60, 64);
+    const int threads_count = 4, ticks_count = 10000;
+    std::vector<std::thread> threads;
+    for(int i = 0; i < threads_count; i++)
+    {
+        threads.push_back(std::thread([&counter]()
+        {
+            for(int j = 0; j < ticks_count; j++)
+            {
+                counter.tick();
+            }
+        }));
+    }
+    // the queries run while the window is overwritten
+    for(int i = 0; i < 100; i++)
+    {
+        auto statistics = counter.query_interval_statistics();
+        EXPECT_LE(statistics.intervals_count, 63u);
+        EXPECT_LE(statistics.min_ms, statistics.max_ms);
+        // a counted tick publishes the first time value, so the average isn't taken from a missing first tick
+        if(counter.frames_count() > 1)
+        {
+            const double average_fps = counter.total_average_fps();
+            EXPECT_TRUE(average_fps == 0 || average_fps > 1.0) << average_fps;
+        }
+    }
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(static_cast<uint64_t>(threads_count * ticks_count - 5), counter.frames_count());
+    EXPECT_EQ(63u, counter.query_interval_statistics().intervals_count);
+}
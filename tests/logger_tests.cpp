@@ -1,10 +1,229 @@
 // License: Apache 2.0. See LICENSE file in root directory.
 // Copyright(c) 2016 Intel Corporation. All Rights Reserved.
 
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include <string>
+
 #include "gtest/gtest.h"
 #include "rs_sdk.h"
+#include "rs/utils/async_logging_service.h"
 
 GTEST_TEST(LoggerTests, logger_configured_test)
 {
     ASSERT_NE(LOGGER_TYPE,rs::utils::logging_service::logger_type::empty_logger) << "Logger .so file is not loaded, or logger configuration failure.";
 }
+
+namespace logger_tests_setup
+{
+    //collects the messages, optionally blocking the writer until released
+    class recording_logger : public rs::utils::empty_logger
+    {
+    public:
+        recording_logger() : m_is_blocked(false) {}
+
+        bool is_level_enabled(log_level level) override { return level >= level_debug; }
+
+        void log(log_level level, const char* message, const char* file_name, int line_number, const char* function_name) override
+        {
+            wait_while_blocked();
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_messages.push_back(message);
+            m_lines.push_back(line_number);
+        }
+
+        void logw(log_level level, const wchar_t* message, const char* file_name, int line_number, const char* function_name) override
+        {
+            wait_while_blocked();
+            std::wstring wide_message(message);
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_messages.push_back(std::string(wide_message.begin(), wide_message.end()));
+            m_lines.push_back(line_number);
+        }
+
+        void set_blocked(bool is_blocked)
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_is_blocked = is_blocked;
+            m_unblocked.notify_all();
+        }
+
+        std::vector<std::string> query_messages()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_messages;
+        }
+
+        std::vector<int> query_lines()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_lines;
+        }
+
+    private:
+        void wait_while_blocked()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_unblocked.wait(lock, [this]() { return !m_is_blocked; });
+        }
+
+        std::mutex m_lock;
+        std::condition_variable m_unblocked;
+        bool m_is_blocked;
+        std::vector<std::string> m_messages;
+        std::vector<int> m_lines;
+    };
+}
+
+using namespace logger_tests_setup;
+
+GTEST_TEST(async_logging_service_tests, messages_are_written_in_order_with_their_location)
+{
+    recording_logger wrapped_logger;
+    rs::utils::async_logging_service async_logger(&wrapped_logger, 128);
+    rs::utils::logging_service * service = &async_logger;
+
+    EXPECT_TRUE(async_logger.is_level_enabled(LOG_LEVEL_DEBUG));
+    EXPECT_FALSE(async_logger.is_level_enabled(LOG_LEVEL_VERBOSE));
+    for(int i = 0; i < 100; i++)
+    {
+        LOG_STREAM(service, LOG_LEVEL_INFO, "frame " << i);
+    }
+    LOG_CFORMAT(service, LOG_LEVEL_ERROR, "%s", std::string(1000, 'x').c_str());
+    async_logger.flush();
+
+    auto messages = wrapped_logger.query_messages();
+    ASSERT_EQ(101u, messages.size());
+    for(int i = 0; i < 100; i++)
+    {
+        EXPECT_EQ("frame " + std::to_string(i), messages[i]);
+    }
+    //long messages are truncated
+    EXPECT_EQ(std::string(rs::utils::async_logging_service::max_message_length, 'x'), messages[100]);
+    EXPECT_NE(0, wrapped_logger.query_lines()[0]);
+    EXPECT_EQ(0u, async_logger.query_dropped_count());
+}
+
+GTEST_TEST(async_logging_service_tests, concurrent_threads_keep_their_messages_order)
+{
+    recording_logger wrapped_logger;
+    const int threads_count = 4, messages_count = 2000;
+    {
+        rs::utils::async_logging_service async_logger(&wrapped_logger, 64, rs::utils::async_logging_service::overflow_policy::block);
+        std::vector<std::thread> threads;
+        for(int thread_index = 0; thread_index < threads_count; thread_index++)
+        {
+            threads.push_back(std::thread([&async_logger, thread_index]()
+            {
+                for(int i = 0; i < messages_count; i++)
+                {
+                    async_logger.log(LOG_LEVEL_INFO, std::to_string(thread_index * messages_count + i).c_str(), __FILE__, __LINE__, __FUNCTION__);
+                }
+            }));
+        }
+        for(auto & thread : threads)
+        {
+            thread.join();
+        }
+        //the destructor writes the pending messages
+    }
+
+    auto messages = wrapped_logger.query_messages();
+    ASSERT_EQ(static_cast<size_t>(threads_count * messages_count), messages.size());
+    std::vector<int> last_values(threads_count, -1);
+    for(auto & message : messages)
+    {
+        const int value = std::stoi(message);
+        EXPECT_LT(last_values[value / messages_count], value);
+        last_values[value / messages_count] = value;
+    }
+}
+
+GTEST_TEST(async_logging_service_tests, full_buffer_drops_and_reports_messages)
+{
+    recording_logger wrapped_logger;
+    rs::utils::async_logging_service async_logger(&wrapped_logger, 8);
+
+    //the writer blocks on the first message, so the ring buffer fills up
+    wrapped_logger.set_blocked(true);
+    for(int i = 0; i < 20; i++)
+    {
+        async_logger.log(LOG_LEVEL_INFO, "message", __FILE__, __LINE__, __FUNCTION__);
+    }
+    EXPECT_GE(async_logger.query_dropped_count(), 20u - 8u - 1u);
+    EXPECT_LE(async_logger.query_dropped_count(), 20u - 8u);
+    wrapped_logger.set_blocked(false);
+    async_logger.flush();
+
+    auto messages = wrapped_logger.query_messages();
+    ASSERT_EQ(20u - async_logger.query_dropped_count() + 1, messages.size());
+    EXPECT_NE(std::string::npos, messages.back().find("messages were dropped"));
+}
+
+GTEST_TEST(async_logging_service_tests, async_mode_switches_while_threads_log)
+{
+    recording_logger wrapped_logger;
+    rs::utils::log_util util;
+    util.m_logger = &wrapped_logger;
+    const int threads_count = 4, messages_count = 2000;
+    std::atomic<bool> is_logging(true);
+    std::vector<std::thread> threads;
+    for(int thread_index = 0; thread_index < threads_count; thread_index++)
+    {
+        threads.push_back(std::thread([&util]()
+        {
+            for(int i = 0; i < messages_count; i++)
+            {
+                util.get_active_logger()->log(LOG_LEVEL_INFO, "message", __FILE__, __LINE__, __FUNCTION__);
+            }
+        }));
+    }
+    std::thread switching_thread([&util, &is_logging]()
+    {
+        while(is_logging)
+        {
+            EXPECT_EQ(rs::core::status_no_error, util.enable_async_mode(64, true));
+            util.disable_async_mode();
+        }
+    });
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+    is_logging = false;
+    switching_thread.join();
+    util.disable_async_mode();
+
+    //the async service isn't deleted on disable, so no message is lost and none is dropped with the block policy
+    EXPECT_EQ(static_cast<size_t>(threads_count * messages_count), wrapped_logger.query_messages().size());
+    EXPECT_EQ(&wrapped_logger, util.get_active_logger());
+    EXPECT_EQ(rs::core::status_param_unsupported, util.enable_async_mode(128, true));
+    util.m_logger = &util.m_empty_logger;
+}
+
+GTEST_TEST(scope_log_tests, logs_begin_and_end_only_at_enabled_level)
+{
+    recording_logger scope_logger;
+    rs::utils::logging_service * default_logger = logger.m_logger;
+    logger.m_logger = &scope_logger;
+    logger.refresh_level();
+    EXPECT_FALSE(logger.may_log(LOG_LEVEL_VERBOSE));
+    EXPECT_FALSE(logger.may_log(LOG_LEVEL_TRACE));
+    EXPECT_TRUE(logger.may_log(LOG_LEVEL_TRACE + 1));
+    EXPECT_TRUE(logger.may_log(LOG_LEVEL_DEBUG));
+    {
+        rs::utils::scope_log enabled_scope("enabled scope", LOG_LEVEL_INFO);
+        rs::utils::scope_log disabled_scope("disabled scope", LOG_LEVEL_VERBOSE);
+        EXPECT_EQ(1u, scope_logger.query_messages().size());
+    }
+    logger.m_logger = default_logger;
+    logger.refresh_level();
+
+    auto messages = scope_logger.query_messages();
+    ASSERT_EQ(2u, messages.size());
+    EXPECT_EQ("enabled scope - begin", messages[0]);
+    EXPECT_EQ("enabled scope - end", messages[1]);
+}
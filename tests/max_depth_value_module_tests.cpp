@@ -0,0 +1,452 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdio>
+
+#include "gtest/gtest.h"
+#include "rs_sdk.h"
+#include "rs/synthetic/synthetic_context.h"
+#include "rs/utils/async_processing_queue.h"
+#include "rs/utils/async_video_module_base.h"
+#include "rs/utils/self_releasing_array_data_releaser.h"
+#include "rs/cv_modules/max_depth_value_module/max_depth_value_module.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+using namespace rs::cv_modules;
+
+namespace max_depth_value_module_tests_setup
+{
+    static const string file_path = "rstest_max_depth_value_module.rssdk";
+    static const int32_t frames_count = 90;
+    static const uint64_t milliseconds_added_to_simulate_larger_computation_time = 20;
+
+    //records a depth stream of the synthetic device, the camera resolution at a higher rate to keep the recording short
+    void record()
+    {
+        rs::synthetic::context synthetic_context({{{rs::stream::depth, 628, 468, rs::format::z16, 300, 0, 0}}, {0, 0}});
+        rs::record::context context(file_path.c_str(), synthetic_context);
+        ASSERT_NE(0, context.get_device_count()) << "no device detected";
+        rs::device * device = context.get_device(0);
+        device->enable_stream(rs::stream::depth, 628, 468, rs::format::z16, 300);
+        device->start();
+        for(int32_t i = 0; i < frames_count; i++)
+        {
+            device->wait_for_frames();
+        }
+        device->stop();
+    }
+
+    //reads the recorded depth frames to memory, so the feeding rate isn't limited by the playback
+    void read_depth_images(vector<rs::utils::unique_ptr<image_interface>> & images)
+    {
+        rs::playback::context context(file_path.c_str());
+        rs::playback::device * device = context.get_playback_device();
+        ASSERT_NE(nullptr, device);
+        device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+
+        image_info info = { device->get_stream_width(rs::stream::depth), device->get_stream_height(rs::stream::depth), pixel_format::z16,
+                            device->get_stream_width(rs::stream::depth) * static_cast<int32_t>(sizeof(uint16_t)) };
+        const int32_t size = info.pitch * info.height;
+        for(int32_t i = 0; i < device->get_frame_count(rs::stream::depth); i++)
+        {
+            ASSERT_TRUE(device->set_frame_by_index(i, rs::stream::depth));
+            uint8_t * data = new uint8_t[size];
+            memcpy(data, device->get_frame_data(rs::stream::depth), size);
+            //the index is used as the frame number, to check the outputs order
+            images.push_back(get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(
+                                 &info, { data, new self_releasing_array_data_releaser(data) }, stream_type::depth, image_interface::flag::any,
+                                 device->get_frame_timestamp(rs::stream::depth), static_cast<uint64_t>(i))));
+        }
+    }
+
+    //collects the frame numbers of the module outputs
+    class output_handler : public video_module_interface::processing_event_handler
+    {
+    public:
+        output_handler(max_depth_value_module & module) : m_module(module) {}
+
+        void module_output_ready(video_module_interface * sender, correlated_sample_set * sample) override
+        {
+            auto output_data = m_module.get_max_depth_value_data();
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_frame_numbers.push_back(output_data.frame_number);
+        }
+
+        vector<uint64_t> query_frame_numbers()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_frame_numbers;
+        }
+
+    private:
+        max_depth_value_module & m_module;
+        std::mutex m_lock;
+        vector<uint64_t> m_frame_numbers;
+    };
+
+    //feeds the images with a constant interval, and waits until every image is processed or dropped
+    async_processing_statistics feed(max_depth_value_module & module, const vector<rs::utils::unique_ptr<image_interface>> & images,
+                                     std::chrono::microseconds interval)
+    {
+        auto next_time = std::chrono::steady_clock::now();
+        for(auto & image : images)
+        {
+            correlated_sample_set sample_set = {};
+            sample_set[stream_type::depth] = image.get();
+            EXPECT_EQ(status_no_error, module.process_sample_set(sample_set));
+            next_time += interval;
+            std::this_thread::sleep_until(next_time);
+        }
+
+        async_processing_statistics statistics = module.query_processing_statistics();
+        const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while(statistics.processed + statistics.failed + statistics.dropped < statistics.queued && std::chrono::steady_clock::now() < timeout)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            statistics = module.query_processing_statistics();
+        }
+        //let the last output reach the handler
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return statistics;
+    }
+}
+
+using namespace max_depth_value_module_tests_setup;
+
+TEST(async_processing_queue_tests, outputs_are_emitted_in_order)
+{
+    std::mutex lock;
+    vector<int> outputs;
+    {
+        //later inputs are faster to process, so the workers complete them out of order
+        async_processing_queue<int, int> queue(4, 100,
+            [](uint32_t worker_index, int & input, int & output)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10 - input % 10));
+                output = input;
+                return input % 7 == 3 ? status_exec_aborted : status_no_error;
+            },
+            [&](int & output)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                outputs.push_back(output);
+            });
+
+        for(int i = 0; i < 100; i++)
+        {
+            EXPECT_TRUE(queue.push(i));
+        }
+        queue.flush();
+
+        auto statistics = queue.query_statistics();
+        EXPECT_EQ(100u, statistics.queued);
+        EXPECT_EQ(0u, statistics.dropped);
+        EXPECT_EQ(14u, statistics.failed);
+        EXPECT_EQ(86u, statistics.processed);
+        EXPECT_EQ(0u, statistics.queue_size);
+    }
+
+    //the failed inputs are skipped
+    ASSERT_EQ(86u, outputs.size());
+    for(size_t i = 1; i < outputs.size(); i++)
+    {
+        EXPECT_LT(outputs[i - 1], outputs[i]);
+        EXPECT_NE(3, outputs[i] % 7);
+    }
+}
+
+TEST(async_processing_queue_tests, full_queue_drops_the_oldest_input)
+{
+    std::mutex gate;
+    vector<int> outputs;
+    gate.lock();
+    {
+        async_processing_queue<int, int> queue(1, 2,
+            [&](uint32_t worker_index, int & input, int & output)
+            {
+                //block the worker until the queue is full
+                std::lock_guard<std::mutex> guard(gate);
+                output = input;
+                return status_no_error;
+            },
+            [&](int & output) { outputs.push_back(output); });
+
+        EXPECT_TRUE(queue.push(0));
+        //wait for the worker to take the first input
+        while(queue.query_statistics().queue_size != 0)
+        {
+            std::this_thread::yield();
+        }
+        EXPECT_TRUE(queue.push(1));
+        EXPECT_TRUE(queue.push(2));
+        EXPECT_FALSE(queue.push(3));
+        EXPECT_FALSE(queue.push(4));
+        gate.unlock();
+        queue.flush();
+
+        auto statistics = queue.query_statistics();
+        EXPECT_EQ(5u, statistics.queued);
+        EXPECT_EQ(2u, statistics.dropped);
+        EXPECT_EQ(3u, statistics.processed);
+        EXPECT_EQ(2u, statistics.max_queue_size);
+    }
+    EXPECT_EQ(vector<int>({ 0, 3, 4 }), outputs);
+}
+
+//a module which outputs the frame number of its depth images, images with an odd frame number fail
+class frame_number_module : public async_video_module_base<uint64_t>
+{
+public:
+    frame_number_module(bool is_async_processing, uint32_t workers_count, uint32_t input_queue_size, full_queue_policy policy) :
+        async_video_module_base(is_async_processing, workers_count, input_queue_size, policy) {}
+
+    int32_t query_module_uid() override { return 0; }
+    status query_supported_module_config(int32_t idx, supported_module_config & supported_config) override { return status_item_unavailable; }
+    status query_current_module_config(actual_module_config & module_config) override { return status_no_error; }
+    status set_module_config(const actual_module_config & module_config) override { return status_no_error; }
+    status reset_config() override { return status_no_error; }
+
+    vector<uint64_t> query_outputs()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_outputs;
+    }
+
+    void stop()
+    {
+        stop_processing();
+    }
+
+    ~frame_number_module()
+    {
+        stop_processing();
+    }
+
+protected:
+    status check_sample_set(const correlated_sample_set & sample_set) override
+    {
+        return sample_set[stream_type::depth] ? status_no_error : status_item_unavailable;
+    }
+
+    status process_sample(uint32_t worker_index, const correlated_sample_set & sample_set, uint64_t & output) override
+    {
+        output = sample_set[stream_type::depth]->query_frame_number();
+        std::this_thread::sleep_for(std::chrono::milliseconds(output % 3));
+        return output % 2 ? status_exec_aborted : status_no_error;
+    }
+
+    void on_output(uint64_t & output) override
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_outputs.push_back(output);
+    }
+
+private:
+    std::mutex m_lock;
+    vector<uint64_t> m_outputs;
+};
+
+class async_video_module_base_tests : public testing::Test
+{
+protected:
+    vector<uint16_t> m_data;
+    vector<rs::utils::unique_ptr<image_interface>> m_images;
+
+    virtual void SetUp()
+    {
+        m_data.assign(32 * 24, 1000);
+        image_info info = { 32, 24, pixel_format::z16, 32 * static_cast<int32_t>(sizeof(uint16_t)) };
+        for(uint64_t frame_number = 0; frame_number < 40; frame_number++)
+        {
+            m_images.push_back(get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(
+                                   &info, { m_data.data(), nullptr }, stream_type::depth, image_interface::flag::any, 0, frame_number)));
+        }
+    }
+
+    void feed(frame_number_module & module)
+    {
+        for(auto & image : m_images)
+        {
+            correlated_sample_set sample_set = {};
+            sample_set[stream_type::depth] = image.get();
+            EXPECT_EQ(status_no_error, module.process_sample_set(sample_set));
+        }
+    }
+};
+
+TEST_F(async_video_module_base_tests, sync_processing_outputs_on_the_calling_thread)
+{
+    frame_number_module module(false, 1, 1, full_queue_policy::drop_oldest);
+    correlated_sample_set empty_sample_set = {};
+    EXPECT_EQ(status_item_unavailable, module.process_sample_set(empty_sample_set));
+
+    correlated_sample_set sample_set = {};
+    sample_set[stream_type::depth] = m_images[2].get();
+    EXPECT_EQ(status_no_error, module.process_sample_set(sample_set));
+    sample_set[stream_type::depth] = m_images[3].get();
+    EXPECT_EQ(status_exec_aborted, module.process_sample_set(sample_set));
+    EXPECT_EQ(vector<uint64_t>({ 2 }), module.query_outputs());
+    EXPECT_EQ(1u, module.query_processing_timing().samples_count);
+}
+
+TEST_F(async_video_module_base_tests, async_processing_with_back_pressure_keeps_every_sample_in_order)
+{
+    frame_number_module module(true, 4, 2, full_queue_policy::block);
+    feed(module);
+
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    auto statistics = module.query_processing_statistics();
+    while(statistics.processed + statistics.failed < m_images.size() && std::chrono::steady_clock::now() < timeout)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        statistics = module.query_processing_statistics();
+    }
+
+    EXPECT_EQ(m_images.size(), statistics.queued);
+    EXPECT_EQ(0u, statistics.dropped);
+    EXPECT_EQ(m_images.size() / 2, statistics.failed);
+    EXPECT_GE(2u, statistics.max_queue_size);
+
+    //let the last output reach the module
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    auto outputs = module.query_outputs();
+    ASSERT_EQ(m_images.size() / 2, outputs.size());
+    for(size_t i = 0; i < outputs.size(); i++)
+    {
+        EXPECT_EQ(2 * i, outputs[i]);
+    }
+
+    auto timing = module.query_processing_timing();
+    EXPECT_EQ(outputs.size(), timing.samples_count);
+    EXPECT_LE(timing.average_processing_time_ms, timing.max_processing_time_ms);
+    EXPECT_LE(timing.average_processing_time_ms, timing.average_latency_ms);
+}
+
+TEST_F(async_video_module_base_tests, images_are_released_after_processing)
+{
+    {
+        frame_number_module module(true, 2, 100, full_queue_policy::drop_oldest);
+        feed(module);
+        module.flush_resources();
+    }
+    //only the fixture references remain, whether the images were processed or flushed
+    for(auto & image : m_images)
+    {
+        EXPECT_EQ(2, image->add_ref());
+        image->release();
+    }
+}
+
+TEST_F(async_video_module_base_tests, sample_sets_are_rejected_after_stop_processing)
+{
+    {
+        frame_number_module module(true, 2, 2, full_queue_policy::block);
+        std::thread feeder([&]()
+        {
+            for(auto & image : m_images)
+            {
+                correlated_sample_set sample_set = {};
+                sample_set[stream_type::depth] = image.get();
+                module.process_sample_set(sample_set);
+            }
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        module.stop();
+        feeder.join();
+
+        correlated_sample_set sample_set = {};
+        sample_set[stream_type::depth] = m_images[0].get();
+        EXPECT_EQ(status_invalid_state, module.process_sample_set(sample_set));
+        EXPECT_EQ(0u, module.query_processing_statistics().queued);
+    }
+    for(auto & image : m_images)
+    {
+        EXPECT_EQ(2, image->add_ref());
+        image->release();
+    }
+}
+
+//the load test feeds a recorded synthetic depth stream at twice the rate a single worker can process
+class max_depth_value_module_load_tests : public testing::Test
+{
+protected:
+    static vector<rs::utils::unique_ptr<image_interface>> m_images;
+
+    static void SetUpTestCase()
+    {
+        record();
+        read_depth_images(m_images);
+    }
+
+    static void TearDownTestCase()
+    {
+        m_images.clear();
+        ::remove(file_path.c_str());
+    }
+
+    //measures the single thread processing time of the module in sync mode
+    std::chrono::microseconds query_single_thread_processing_time()
+    {
+        max_depth_value_module module(milliseconds_added_to_simulate_larger_computation_time, false);
+        auto start = std::chrono::steady_clock::now();
+        for(auto & image : m_images)
+        {
+            correlated_sample_set sample_set = {};
+            sample_set[stream_type::depth] = image.get();
+            EXPECT_EQ(status_no_error, module.process_sample_set(sample_set));
+            module.get_max_depth_value_data();
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start) / m_images.size();
+    }
+};
+
+vector<rs::utils::unique_ptr<image_interface>> max_depth_value_module_load_tests::m_images;
+
+TEST_F(max_depth_value_module_load_tests, single_worker_drops_samples)
+{
+    ASSERT_FALSE(m_images.empty());
+    auto interval = query_single_thread_processing_time() / 2;
+
+    max_depth_value_module module(milliseconds_added_to_simulate_larger_computation_time, true, 1, 1);
+    output_handler handler(module);
+    ASSERT_EQ(status_no_error, module.register_event_handler(&handler));
+    auto statistics = feed(module, m_images, interval);
+    ASSERT_EQ(status_no_error, module.unregister_event_handler(&handler));
+
+    EXPECT_EQ(m_images.size(), statistics.queued);
+    EXPECT_GT(statistics.dropped, 0u);
+    EXPECT_EQ(0u, statistics.failed);
+    EXPECT_EQ(statistics.queued, statistics.processed + statistics.dropped);
+    EXPECT_EQ(statistics.processed, handler.query_frame_numbers().size());
+}
+
+TEST_F(max_depth_value_module_load_tests, multiple_workers_keep_up_in_order)
+{
+    ASSERT_FALSE(m_images.empty());
+    auto interval = query_single_thread_processing_time() / 2;
+
+    max_depth_value_module module(milliseconds_added_to_simulate_larger_computation_time, true, 4, 4);
+    output_handler handler(module);
+    ASSERT_EQ(status_no_error, module.register_event_handler(&handler));
+    auto statistics = feed(module, m_images, interval);
+    ASSERT_EQ(status_no_error, module.unregister_event_handler(&handler));
+
+    EXPECT_EQ(m_images.size(), statistics.queued);
+    EXPECT_EQ(0u, statistics.dropped);
+    EXPECT_EQ(m_images.size(), statistics.processed);
+
+    auto frame_numbers = handler.query_frame_numbers();
+    ASSERT_EQ(m_images.size(), frame_numbers.size());
+    for(size_t i = 0; i < frame_numbers.size(); i++)
+    {
+        EXPECT_EQ(i, frame_numbers[i]);
+    }
+}
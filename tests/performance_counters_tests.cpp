@@ -0,0 +1,176 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <librealsense/rs.hpp>
+#include "gtest/gtest.h"
+#include "rs/utils/performance_counters.h"
+#include "rs/record/record_context.h"
+#include "rs/synthetic/synthetic_context.h"
+#include "rs/playback/playback_context.h"
+
+using namespace std;
+using namespace rs::utils;
+
+namespace performance_counters_tests_setup
+{
+    static const string file_path = "performance_counters_test.rssdk";
+    static const string dump_file_path = "performance_counters_test.json";
+
+    int64_t query_value(const string & name)
+    {
+        performance_counter_value value = {};
+        return PERF_COUNTERS.query_value(name, value) == rs::core::status_no_error ? value.value : -1;
+    }
+}
+
+using namespace performance_counters_tests_setup;
+
+GTEST_TEST(performance_counters_tests, registry_returns_the_same_counter_per_name)
+{
+    performance_counters counters;
+    performance_counter & counter = counters.query_counter("test.counter");
+    EXPECT_EQ(&counter, &counters.query_counter("test.counter"));
+    EXPECT_THROW(counters.query_gauge("test.counter"), std::invalid_argument);
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++)
+    {
+        threads.push_back(std::thread([&counters]()
+        {
+            performance_counter & thread_counter = counters.query_counter("test.counter");
+            for(int j = 0; j < 1000; j++)
+            {
+                thread_counter.add();
+            }
+        }));
+    }
+    for(auto & thread : threads)
+    {
+        thread.join();
+    }
+
+    performance_gauge & gauge = counters.query_gauge("test.gauge");
+    gauge.set(10);
+    gauge.add(-7);
+
+    performance_counter_value value = {};
+    ASSERT_EQ(rs::core::status_no_error, counters.query_value("test.counter", value));
+    EXPECT_EQ(performance_counter_type::counter, value.type);
+    EXPECT_EQ(4000, value.value);
+    ASSERT_EQ(rs::core::status_no_error, counters.query_value("test.gauge", value));
+    EXPECT_EQ(3, value.value);
+    EXPECT_EQ(10, value.max);
+    EXPECT_EQ(rs::core::status_item_unavailable, counters.query_value("test.missing", value));
+
+    auto values = counters.query_values();
+    ASSERT_EQ(2u, values.size());
+    EXPECT_EQ("test.counter", values[0].name);
+    EXPECT_EQ("test.gauge", values[1].name);
+
+    counters.reset();
+    EXPECT_EQ(0, counter.query());
+    EXPECT_EQ(3, gauge.query_max());
+}
+
+GTEST_TEST(performance_counters_tests, histogram_estimates_percentiles_within_a_bucket)
+{
+    performance_histogram histogram;
+    EXPECT_EQ(0, histogram.query_percentile(50));
+    for(int64_t value = 1; value <= 1000; value++)
+    {
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(1000u, histogram.query_count());
+    EXPECT_EQ(500500, histogram.query_sum());
+    EXPECT_EQ(1, histogram.query_min());
+    EXPECT_EQ(1000, histogram.query_max());
+    //the power of two buckets bound the estimate error by a factor of two
+    const double median = histogram.query_percentile(50);
+    EXPECT_LE(250.0, median);
+    EXPECT_GE(1000.0, median);
+    const double percentile_99 = histogram.query_percentile(99);
+    EXPECT_LE(median, percentile_99);
+    EXPECT_GE(1000.0, percentile_99);
+}
+
+GTEST_TEST(performance_counters_tests, periodic_dump_writes_a_line_per_period)
+{
+    performance_counters counters;
+    counters.query_counter("test.counter").add(5);
+    counters.query_histogram("test.histogram").record(100);
+    ASSERT_EQ(rs::core::status_no_error, counters.start_periodic_dump(dump_file_path, 10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    counters.stop_periodic_dump();
+
+    ifstream file(dump_file_path);
+    string line, last_line;
+    int lines_count = 0;
+    while(getline(file, line))
+    {
+        lines_count++;
+        last_line = line;
+    }
+    file.close();
+    remove(dump_file_path.c_str());
+
+    EXPECT_LE(2, lines_count);
+    EXPECT_EQ(0u, last_line.find("{\"time_ms\":"));
+    EXPECT_NE(string::npos, last_line.find("\"test.counter\":5"));
+    EXPECT_NE(string::npos, last_line.find("\"test.histogram\":{\"count\":1,\"min\":100,\"max\":100"));
+
+    EXPECT_EQ(rs::core::status_file_open_failed, counters.start_periodic_dump("/missing_directory/performance_counters.json"));
+}
+
+GTEST_TEST(performance_counters_tests, record_and_playback_update_the_counters)
+{
+    PERF_COUNTERS.reset();
+    const int frames_count = 30;
+    {
+        //the synthetic device feeds the recorder, a high frame rate keeps the recording short
+        rs::synthetic::context synthetic_context({{{rs::stream::depth, 640, 480, rs::format::z16, 300, 0, 0}}, {0, 0}});
+        rs::record::context record_context(file_path.c_str(), synthetic_context);
+        ASSERT_NE(0, record_context.get_device_count()) << "no device detected";
+        rs::device * device = record_context.get_device(0);
+        device->enable_stream(rs::stream::depth, 640, 480, rs::format::z16, 300);
+        device->start();
+        for(int i = 0; i < frames_count; i++)
+        {
+            device->wait_for_frames();
+        }
+        device->stop();
+    }
+
+    EXPECT_LT(0, query_value("record.bytes_written"));
+    performance_counter_value encode_time = {};
+    ASSERT_EQ(rs::core::status_no_error, PERF_COUNTERS.query_value("record.encode_time_us", encode_time));
+    EXPECT_LT(0, encode_time.value);
+    EXPECT_LE(0, query_value("record.frames_dropped"));
+
+    {
+        rs::playback::context playback_context(file_path.c_str());
+        rs::device * device = playback_context.get_device(0);
+        device->enable_stream(rs::stream::depth, 640, 480, rs::format::z16, 300);
+        device->start();
+        for(int i = 0; i < frames_count / 2; i++)
+        {
+            device->wait_for_frames();
+        }
+        device->stop();
+    }
+    ::remove(file_path.c_str());
+
+    EXPECT_LT(0, query_value("playback.bytes_read"));
+    performance_counter_value decode_time = {};
+    ASSERT_EQ(rs::core::status_no_error, PERF_COUNTERS.query_value("playback.decode_time_us", decode_time));
+    EXPECT_LT(0, decode_time.value);
+    EXPECT_LE(decode_time.min, decode_time.percentile_50);
+    EXPECT_GE(decode_time.max, decode_time.percentile_99);
+}
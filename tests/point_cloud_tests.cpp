@@ -0,0 +1,329 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstring>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <chrono>
+#include <thread>
+#include <cmath>
+
+#include "gtest/gtest.h"
+#include "rs/core/image_interface.h"
+#include "rs/utils/point_cloud_writer_interface.h"
+#include "rs/utils/organized_point_cloud_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace point_cloud_tests_setup
+{
+    static const sizeI32 depth_size = {640, 480};
+    static const sizeI32 color_size = {320, 240};
+
+    //creates a vga vertices buffer where every fourth vertex is invalid, returns the number of valid vertices
+    uint32_t create_vertices(vector<point3dF32> & vertices)
+    {
+        vertices.resize(depth_size.width * depth_size.height);
+        uint32_t valid_count = 0;
+        for(int y = 0; y < depth_size.height; y++)
+        {
+            for(int x = 0; x < depth_size.width; x++)
+            {
+                const int i = y * depth_size.width + x;
+                vertices[i] = { static_cast<float>(x - depth_size.width / 2), static_cast<float>(y - depth_size.height / 2), 1000.f + x };
+                if(i % 4 == 0)
+                    vertices[i].z = 0;
+                else if(i % 4 == 1 && x % 2 == 0)
+                    vertices[i].z = std::numeric_limits<float>::quiet_NaN();
+                else
+                    valid_count++;
+            }
+        }
+        return valid_count;
+    }
+
+    //reads the file, splits it to the textual header and the binary body
+    bool read_point_cloud_file(const string & file_path, const string & header_end, string & header, string & body)
+    {
+        ifstream file(file_path, ios::binary);
+        if(!file.good())
+            return false;
+        stringstream content;
+        content << file.rdbuf();
+        const string data = content.str();
+        const size_t header_size = data.find(header_end);
+        if(header_size == string::npos)
+            return false;
+        header = data.substr(0, header_size + header_end.size());
+        body = data.substr(header_size + header_end.size());
+        return true;
+    }
+
+    //creates a vga plane z = 1000 + 0.5 * x facing the camera, with an invalid border column
+    void create_plane_vertices(vector<point3dF32> & vertices)
+    {
+        vertices.resize(depth_size.width * depth_size.height);
+        for(int y = 0; y < depth_size.height; y++)
+        {
+            for(int x = 0; x < depth_size.width; x++)
+            {
+                const float vx = static_cast<float>(x - depth_size.width / 2);
+                const float vy = static_cast<float>(y - depth_size.height / 2);
+                vertices[y * depth_size.width + x] = { vx, vy, x == 0 ? 0.f : 1000.f + 0.5f * vx };
+            }
+        }
+    }
+
+    template<typename F> double measure_ms(int iterations, F function)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for(int i = 0; i < iterations; i++)
+            function();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+}
+
+using namespace point_cloud_tests_setup;
+
+//zero and NaN depth vertices are dropped, the header declares the valid points count
+TEST(point_cloud_writer_tests, ply_filters_invalid_points)
+{
+    vector<point3dF32> vertices;
+    const uint32_t valid_count = create_vertices(vertices);
+
+    auto writer = get_unique_ptr_with_releaser(point_cloud_writer_interface::create_instance(point_cloud_format::ply, 1));
+    point_cloud_frame frame = { vertices.data(), depth_size, nullptr, nullptr };
+    const string file_path = "point_cloud_test.ply";
+    ASSERT_EQ(status_no_error, writer->write(file_path.c_str(), frame));
+
+    string header, body;
+    ASSERT_TRUE(read_point_cloud_file(file_path, "end_header\n", header, body));
+    std::remove(file_path.c_str());
+
+    EXPECT_NE(string::npos, header.find("format binary_little_endian 1.0\n"));
+    EXPECT_NE(string::npos, header.find("element vertex " + to_string(valid_count) + "\n"));
+    EXPECT_EQ(string::npos, header.find("property uchar red"));
+    ASSERT_EQ(valid_count * 3 * sizeof(float), body.size());
+
+    //first valid vertex is the second one in the buffer
+    point3dF32 first_point;
+    memcpy(&first_point, body.data(), sizeof(first_point));
+    EXPECT_EQ(vertices[1].x, first_point.x);
+    EXPECT_EQ(vertices[1].y, first_point.y);
+    EXPECT_EQ(vertices[1].z, first_point.z);
+
+    auto stats = writer->query_statistics();
+    EXPECT_EQ(1u, stats.frames_written);
+    EXPECT_EQ(valid_count, stats.points_written);
+    EXPECT_EQ(header.size() + body.size(), stats.bytes_written);
+}
+
+//color is sampled through the uvmap and packed as 0x00RRGGBB, unmapped points are black
+TEST(point_cloud_writer_tests, pcd_with_color)
+{
+    vector<point3dF32> vertices;
+    const uint32_t valid_count = create_vertices(vertices);
+
+    vector<pointF32> uvmap(vertices.size());
+    for(int y = 0; y < depth_size.height; y++)
+    {
+        for(int x = 0; x < depth_size.width; x++)
+        {
+            pointF32 uv = { static_cast<float>(x) / depth_size.width, static_cast<float>(y) / depth_size.height };
+            uvmap[y * depth_size.width + x] = x < depth_size.width / 2 ? pointF32{-1.f, -1.f} : uv;
+        }
+    }
+
+    //every color pixel is b = 10, g = 20, r = 30
+    vector<uint8_t> color_data(color_size.width * color_size.height * 3);
+    for(size_t i = 0; i < color_data.size(); i += 3)
+    {
+        color_data[i] = 10; color_data[i + 1] = 20; color_data[i + 2] = 30;
+    }
+    image_info color_info = { color_size.width, color_size.height, pixel_format::bgr8, color_size.width * 3 };
+    auto color = get_unique_ptr_with_releaser(image_interface::create_instance_from_raw_data(&color_info, {color_data.data(), nullptr},
+                                                                                            stream_type::color, image_interface::flag::any, 0, 0));
+
+    auto writer = get_unique_ptr_with_releaser(point_cloud_writer_interface::create_instance(point_cloud_format::pcd, 1));
+    point_cloud_frame frame = { vertices.data(), depth_size, color.get(), nullptr };
+    const string file_path = "point_cloud_test.pcd";
+    ASSERT_EQ(status_handle_invalid, writer->write(file_path.c_str(), frame));
+    frame.uvmap = uvmap.data();
+    ASSERT_EQ(status_no_error, writer->write(file_path.c_str(), frame));
+
+    string header, body;
+    ASSERT_TRUE(read_point_cloud_file(file_path, "DATA binary\n", header, body));
+    std::remove(file_path.c_str());
+
+    EXPECT_NE(string::npos, header.find("FIELDS x y z rgb\n"));
+    EXPECT_NE(string::npos, header.find("POINTS " + to_string(valid_count) + "\n"));
+    ASSERT_EQ(valid_count * 4 * sizeof(float), body.size());
+
+    uint32_t mapped_count = 0, unmapped_count = 0;
+    for(uint32_t i = 0; i < valid_count; i++)
+    {
+        float x;
+        uint32_t rgb;
+        memcpy(&x, body.data() + i * 16, sizeof(x));
+        memcpy(&rgb, body.data() + i * 16 + 12, sizeof(rgb));
+        if(x + depth_size.width / 2 < depth_size.width / 2)
+        {
+            EXPECT_EQ(0u, rgb);
+            unmapped_count++;
+        }
+        else
+        {
+            EXPECT_EQ(0x1e140au, rgb);
+            mapped_count++;
+        }
+    }
+    EXPECT_GT(mapped_count, 0u);
+    EXPECT_GT(unmapped_count, 0u);
+}
+
+//frames queued to the worker pool are all written, the caller buffer is reused between frames
+TEST(point_cloud_writer_tests, async_export_throughput)
+{
+    const int frames_count = 60;
+    vector<point3dF32> vertices;
+    const uint32_t valid_count = create_vertices(vertices);
+
+    auto writer = get_unique_ptr_with_releaser(point_cloud_writer_interface::create_instance(point_cloud_format::ply, 4));
+    vector<string> file_paths;
+    for(int i = 0; i < frames_count; i++)
+    {
+        file_paths.push_back("point_cloud_test_" + to_string(i) + ".ply");
+        point_cloud_frame frame = { vertices.data(), depth_size, nullptr, nullptr };
+        ASSERT_EQ(status_no_error, writer->write_async(file_paths.back().c_str(), frame));
+    }
+    ASSERT_EQ(status_no_error, writer->flush());
+
+    auto stats = writer->query_statistics();
+    std::cout << "point cloud export: " << stats.frames_written << " vga frames, " << stats.frames_per_second << " frames/s, "
+              << stats.bytes_written / (1024 * 1024) << " MB" << std::endl;
+    EXPECT_EQ(static_cast<uint64_t>(frames_count), stats.frames_written);
+    EXPECT_EQ(0u, stats.frames_failed);
+    EXPECT_EQ(static_cast<uint64_t>(frames_count) * valid_count, stats.points_written);
+
+    for(auto & file_path : file_paths)
+    {
+        string header, body;
+        EXPECT_TRUE(read_point_cloud_file(file_path, "end_header\n", header, body));
+        EXPECT_EQ(valid_count * 3 * sizeof(float), body.size());
+        std::remove(file_path.c_str());
+    }
+}
+
+//the mask marks exactly the vertices with a positive depth, with the same result for any number of threads
+TEST(organized_point_cloud_tests, validity_mask)
+{
+    vector<point3dF32> vertices;
+    const uint32_t valid_count = create_vertices(vertices);
+    vector<uint8_t> mask(vertices.size());
+
+    for(uint32_t threads : {1u, 3u, 0u})
+    {
+        auto cloud = get_unique_ptr_with_releaser(organized_point_cloud_interface::create_instance(threads));
+        int32_t count = 0;
+        ASSERT_EQ(status_no_error, cloud->query_validity_mask(vertices.data(), depth_size, mask.data(), &count));
+        EXPECT_EQ(static_cast<int32_t>(valid_count), count);
+        for(size_t i = 0; i < vertices.size(); i++)
+        {
+            ASSERT_EQ(vertices[i].z > 0 ? 255 : 0, mask[i]);
+        }
+    }
+
+    auto cloud = get_unique_ptr_with_releaser(organized_point_cloud_interface::create_instance());
+    EXPECT_EQ(status_handle_invalid, cloud->query_validity_mask(nullptr, depth_size, mask.data()));
+    EXPECT_EQ(status_param_unsupported, cloud->query_validity_mask(vertices.data(), {0, 0}, mask.data()));
+    std::cout << "vga validity mask: " << measure_ms(100, [&]() { cloud->query_validity_mask(vertices.data(), depth_size, mask.data()); }) << " ms" << std::endl;
+}
+
+//normals of a tilted plane match the analytic normal, invalid vertices get a zero normal
+TEST(organized_point_cloud_tests, plane_normals)
+{
+    vector<point3dF32> vertices;
+    create_plane_vertices(vertices);
+    vector<point3dF32> normals(vertices.size());
+
+    //plane z = 1000 + 0.5x has the normal (0.5, 0, -1) oriented towards the camera
+    const float norm = std::sqrt(0.5f * 0.5f + 1.f);
+    const point3dF32 expected = { 0.5f / norm, 0, -1.f / norm };
+
+    auto single_thread = get_unique_ptr_with_releaser(organized_point_cloud_interface::create_instance(1));
+    auto multi_thread = get_unique_ptr_with_releaser(organized_point_cloud_interface::create_instance());
+    for(auto cloud : {single_thread.get(), multi_thread.get()})
+    {
+        ASSERT_EQ(status_no_error, cloud->query_normals(vertices.data(), depth_size, normals.data()));
+        float max_error = 0;
+        for(int y = 0; y < depth_size.height; y++)
+        {
+            for(int x = 0; x < depth_size.width; x++)
+            {
+                const point3dF32 & normal = normals[y * depth_size.width + x];
+                if(x == 0)
+                {
+                    ASSERT_EQ(0.f, normal.x);
+                    ASSERT_EQ(0.f, normal.y);
+                    ASSERT_EQ(0.f, normal.z);
+                    continue;
+                }
+                max_error = std::max(max_error, std::fabs(normal.x - expected.x) + std::fabs(normal.y - expected.y) + std::fabs(normal.z - expected.z));
+            }
+        }
+        EXPECT_LT(max_error, 1e-4f);
+    }
+
+    //a depth step larger than the threshold isolates the column after it
+    vertices[10 * depth_size.width + 300].z += 100;
+    ASSERT_EQ(status_no_error, multi_thread->query_normals(vertices.data(), depth_size, normals.data(), 50));
+    EXPECT_EQ(0.f, normals[10 * depth_size.width + 300].z);
+    EXPECT_NEAR(expected.z, normals[10 * depth_size.width + 301].z, 1e-4f);
+
+    std::cout << "vga normals: 1 thread " << measure_ms(50, [&]() { single_thread->query_normals(vertices.data(), depth_size, normals.data()); })
+              << " ms, " << std::thread::hardware_concurrency() << " threads "
+              << measure_ms(50, [&]() { multi_thread->query_normals(vertices.data(), depth_size, normals.data()); }) << " ms" << std::endl;
+}
+
+//each occupied voxel is replaced by the centroid of its vertices, a too small output reports the overflow
+TEST(organized_point_cloud_tests, voxel_grid_downsample)
+{
+    //vertices on a 1 mm grid, 10 mm voxels hold 10x10 vertices
+    vector<point3dF32> vertices(depth_size.width * depth_size.height);
+    for(int y = 0; y < depth_size.height; y++)
+    {
+        for(int x = 0; x < depth_size.width; x++)
+        {
+            vertices[y * depth_size.width + x] = { x + 0.5f, y + 0.5f, y < 10 ? 0.f : 1000.5f };
+        }
+    }
+    vector<point3dF32> points(vertices.size());
+    int32_t points_count = 0;
+
+    auto cloud = get_unique_ptr_with_releaser(organized_point_cloud_interface::create_instance());
+    for(int repeat = 0; repeat < 2; repeat++)
+    {
+        ASSERT_EQ(status_no_error, cloud->voxel_grid_downsample(vertices.data(), depth_size, 10.f, points.data(), static_cast<int32_t>(points.size()), &points_count));
+        ASSERT_EQ((depth_size.width / 10) * (depth_size.height / 10 - 1), points_count);
+        EXPECT_FLOAT_EQ(5.f, points[0].x);
+        EXPECT_FLOAT_EQ(15.f, points[0].y);
+        EXPECT_FLOAT_EQ(1000.5f, points[0].z);
+    }
+
+    EXPECT_EQ(status_value_out_of_range, cloud->voxel_grid_downsample(vertices.data(), depth_size, 10.f, points.data(), 5, &points_count));
+    EXPECT_EQ(5, points_count);
+    EXPECT_EQ(status_param_unsupported, cloud->voxel_grid_downsample(vertices.data(), depth_size, 0.f, points.data(), 5, &points_count));
+
+    create_vertices(vertices);
+    std::cout << "vga voxel grid 10 mm: " << measure_ms(50, [&]() { cloud->voxel_grid_downsample(vertices.data(), depth_size, 10.f, points.data(),
+                                                                                                  static_cast<int32_t>(points.size()), &points_count); })
+              << " ms, " << points_count << " voxels" << std::endl;
+}
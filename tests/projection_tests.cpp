@@ -6,8 +6,11 @@
 #include <stdlib.h>
 #include <locale>
 #include <algorithm>
+#include <chrono>
+#include <iostream>
 #include "rs/utils/librealsense_conversion_utils.h"
 #include "rs/utils/smart_ptr_helpers.h"
+#include "math_projection_interface.h"
 
 #ifdef WIN32
 #define NOMINMAX
@@ -1457,3 +1460,318 @@ TEST_F(projection_fixture, create_color_image_mapped_to_depth_query_uvmap)
         }
     }
 }
+
+
+/*
+    Test:
+        distortion_lut_uvmap_matches_exact_uvmap
+
+    Target:
+        Checks the optional color distortion grid of the math projection UV map, rs_projection_16u32f_c1cxr, against
+        the exact distortion polynomial. QueryUVMap doesn't pass a grid, it always uses the exact polynomial
+
+    Scope:
+        Synthetic VGA depth image and full HD unrectified color calibration, no camera required
+
+    Description:
+        Computes the UV map of the same depth image twice, once with the exact per pixel distortion and once with
+        the bilinear distortion grid, and measures the difference in color pixels. The time of both paths is printed.
+
+    Pass Criteria:
+        Test passes if the maximal difference is less than a hundredth of a color pixel.
+*/
+GTEST_TEST(projection_lookup_tables, distortion_lut_uvmap_matches_exact_uvmap)
+{
+    const sizeI32 depth_size = { 640, 480 };
+    const sizeI32 color_size = { 1920, 1080 };
+    float camera_depth[4] = { 580.f, 319.5f, 580.f, 239.5f };
+    float camera_color[4] = { 1400.f / color_size.width, 960.f / color_size.width, 1400.f / color_size.height, 540.f / color_size.height };
+    float distortion[5] = { 0.12f, -0.25f, 0.001f, 0.0015f, 0.08f };
+    float rotation[9] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+    float translation[3] = { -25.f, 0.f, 0.f };
+
+    math_projection projection;
+    int spec_size = 0;
+    ASSERT_EQ(status_no_error, projection.rs_projection_get_size_32f(depth_size, &spec_size));
+    std::vector<uint8_t> spec(spec_size, 0);
+    ASSERT_EQ(status_no_error, projection.rs_projection_init_32f(depth_size, camera_depth, 0, (projection_spec_32f*)spec.data()));
+
+    pointF32 range_min = { -960.f / 1400.f * 1.2f, -540.f / 1400.f * 1.2f };
+    pointF32 range_max = { 960.f / 1400.f * 1.2f, 540.f / 1400.f * 1.2f };
+    sizeI32 grid_size = { color_size.width * 12 / 80 + 2, color_size.height * 12 / 80 + 2 };
+    distortion_lut_32f lut;
+    ASSERT_EQ(status_no_error, projection.rs_distortion_lut_init_32f(range_min, range_max, grid_size, distortion, &lut));
+
+    std::vector<uint16_t> depth(depth_size.width * depth_size.height);
+    for (int y = 0; y < depth_size.height; y++)
+        for (int x = 0; x < depth_size.width; x++)
+            depth[y * depth_size.width + x] = static_cast<uint16_t>(((x + y) % 7 == 0) ? 0 : 500 + (x * 7 + y * 3) % 3000);
+
+    const int step_src = depth_size.width * sizeof(uint16_t);
+    const int step_dst = depth_size.width * sizeof(pointF32);
+    std::vector<pointF32> exact_uvmap(depth.size()), lut_uvmap(depth.size());
+
+    const int iterations = 10;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        projection.rs_projection_16u32f_c1cxr(depth.data(), depth_size, step_src, (float*)exact_uvmap.data(), step_dst,
+                                              rotation, translation, distortion, camera_color, (const projection_spec_32f*)spec.data());
+    auto exact_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        projection.rs_projection_16u32f_c1cxr(depth.data(), depth_size, step_src, (float*)lut_uvmap.data(), step_dst,
+                                              rotation, translation, distortion, camera_color, (const projection_spec_32f*)spec.data(), &lut);
+    auto lut_time = std::chrono::steady_clock::now() - start;
+
+    float max_err = 0.f;
+    for (size_t i = 0; i < depth.size(); i++)
+    {
+        pointF32 exact = { exact_uvmap[i].x * color_size.width, exact_uvmap[i].y * color_size.height };
+        pointF32 approx = { lut_uvmap[i].x * color_size.width, lut_uvmap[i].y * color_size.height };
+        max_err = std::max(max_err, distancePixels(exact, approx));
+    }
+    EXPECT_LE(max_err, 0.01f);
+
+    std::cout << "uvmap exact distortion: " << std::chrono::duration_cast<std::chrono::microseconds>(exact_time).count() / iterations << " usec, "
+              << "distortion grid: " << std::chrono::duration_cast<std::chrono::microseconds>(lut_time).count() / iterations << " usec, "
+              << "max error [pxls]: " << max_err << std::endl;
+}
+
+
+/*
+    Test:
+        vertices_from_rays_match_project_depth_to_camera
+
+    Target:
+        Checks the precomputed per pixel rays used by QueryVertices against ProjectDepthToCamera
+
+    Scope:
+        Synthetic VGA depth image, no camera required
+
+    Description:
+        Computes the vertices of a depth image with the precomputed rays and deprojects the same pixels one by one.
+        The time of both paths is printed.
+
+    Pass Criteria:
+        Test passes if the maximal distance between the vertices is less than a hundredth of a millimeter.
+*/
+GTEST_TEST(projection_lookup_tables, vertices_from_rays_match_project_depth_to_camera)
+{
+    const sizeI32 depth_size = { 640, 480 };
+    float camera_depth[4] = { 580.f, 319.5f, 580.f, 239.5f };
+
+    math_projection projection;
+    int spec_size = 0;
+    ASSERT_EQ(status_no_error, projection.rs_projection_get_size_32f(depth_size, &spec_size));
+    std::vector<uint8_t> spec(spec_size, 0);
+    ASSERT_EQ(status_no_error, projection.rs_projection_init_32f(depth_size, camera_depth, 0, (projection_spec_32f*)spec.data()));
+
+    std::vector<uint16_t> depth(depth_size.width * depth_size.height);
+    std::vector<point3dF32> pos_uvz(depth.size());
+    for (int y = 0; y < depth_size.height; y++)
+    {
+        for (int x = 0; x < depth_size.width; x++)
+        {
+            uint16_t z = static_cast<uint16_t>(((x + y) % 7 == 0) ? 0 : 500 + (x * 7 + y * 3) % 3000);
+            depth[y * depth_size.width + x] = z;
+            pos_uvz[y * depth_size.width + x] = { (float)x, (float)y, (float)z };
+        }
+    }
+
+    std::vector<point3dF32> vertices(depth.size()), exact_vertices(depth.size());
+    const int iterations = 10;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        ASSERT_EQ(status_no_error, projection.rs_vertices_16u32f_c3r(depth.data(), depth_size, depth_size.width * sizeof(uint16_t), (float*)vertices.data(),
+                                                                    depth_size.width * sizeof(point3dF32), (const projection_spec_32f*)spec.data()));
+    auto rays_time = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        projection.rs_3d_array_projection_32f((const float*)pos_uvz.data(), (float*)exact_vertices.data(), static_cast<int>(pos_uvz.size()), camera_depth, 0, 0, 0, 0, 0);
+    auto exact_time = std::chrono::steady_clock::now() - start;
+
+    float max_err = 0.f;
+    for (size_t i = 0; i < depth.size(); i++)
+    {
+        max_err = std::max(max_err, distance3d(vertices[i], exact_vertices[i]));
+    }
+    EXPECT_LE(max_err, 0.01f);
+
+    std::cout << "vertices from rays: " << std::chrono::duration_cast<std::chrono::microseconds>(rays_time).count() / iterations << " usec, "
+              << "per pixel deprojection: " << std::chrono::duration_cast<std::chrono::microseconds>(exact_time).count() / iterations << " usec, "
+              << "max error [mm]: " << max_err << std::endl;
+}
+
+
+/*
+    Test:
+        roi_queries_match_full_frame
+
+    Target:
+        Checks the region of interest variants of the UV map, vertices and inverse UV map calculations
+
+    Scope:
+        Synthetic VGA depth image and full HD unrectified color calibration, no camera required
+
+    Description:
+        Computes the UV map and the vertices of a depth region of interest, and the inverse UV map of a color region
+        of interest, both to a compact buffer and to a full frame buffer, and compares them to the full frame results.
+        The time of the full frame and of the region of interest calculations is printed.
+
+    Pass Criteria:
+        Test passes if the region of interest values are identical to the full frame values, and the full frame buffers
+        are untouched outside of the region of interest.
+*/
+GTEST_TEST(projection_lookup_tables, roi_queries_match_full_frame)
+{
+    const sizeI32 depth_size = { 640, 480 };
+    const sizeI32 color_size = { 1920, 1080 };
+    float camera_depth[4] = { 580.f, 319.5f, 580.f, 239.5f };
+    float camera_color[4] = { 1400.f / color_size.width, 960.f / color_size.width, 1400.f / color_size.height, 540.f / color_size.height };
+    float distortion[5] = { 0.12f, -0.25f, 0.001f, 0.0015f, 0.08f };
+    float rotation[9] = { 1.f, 0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f };
+    float translation[3] = { -25.f, 0.f, 0.f };
+
+    math_projection projection;
+    int spec_size = 0;
+    ASSERT_EQ(status_no_error, projection.rs_projection_get_size_32f(depth_size, &spec_size));
+    std::vector<uint8_t> spec(spec_size, 0);
+    ASSERT_EQ(status_no_error, projection.rs_projection_init_32f(depth_size, camera_depth, 0, (projection_spec_32f*)spec.data()));
+    const projection_spec_32f* pspec = (const projection_spec_32f*)spec.data();
+
+    std::vector<uint16_t> depth(depth_size.width * depth_size.height);
+    for (int y = 0; y < depth_size.height; y++)
+        for (int x = 0; x < depth_size.width; x++)
+            depth[y * depth_size.width + x] = static_cast<uint16_t>(((x + y) % 7 == 0) ? 0 : 500 + (x * 7 + y * 3) % 3000);
+    const int step_src = depth_size.width * sizeof(uint16_t);
+    const rect depth_roi = { 200, 150, 160, 120 };
+    const rect color_roi = { 700, 300, 480, 270 };
+    const pointF32 sentinel = { -7.f, -7.f };
+    const point3dF32 sentinel3d = { -7.f, -7.f, -7.f };
+
+    //uvmap
+    std::vector<pointF32> uvmap(depth.size());
+    std::vector<pointF32> roi_uvmap(depth_roi.width * depth_roi.height);
+    std::vector<pointF32> full_frame_roi_uvmap(depth.size(), sentinel);
+    const int iterations = 10;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        projection.rs_projection_16u32f_c1cxr(depth.data(), depth_size, step_src, (float*)uvmap.data(), depth_size.width * sizeof(pointF32),
+                                              rotation, translation, distortion, camera_color, pspec);
+    auto full_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        ASSERT_EQ(status_no_error, projection.rs_projection_16u32f_c1cxr(depth.data(), depth_size, step_src, (float*)roi_uvmap.data(),
+                                                                        depth_roi.width * sizeof(pointF32), rotation, translation, distortion,
+                                                                        camera_color, pspec, nullptr, &depth_roi));
+    auto roi_time = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(status_no_error, projection.rs_projection_16u32f_c1cxr(depth.data(), depth_size, step_src,
+                                                                    (float*)(full_frame_roi_uvmap.data() + depth_roi.y * depth_size.width + depth_roi.x),
+                                                                    depth_size.width * sizeof(pointF32), rotation, translation, distortion,
+                                                                    camera_color, pspec, nullptr, &depth_roi));
+    int mismatches = 0;
+    for (int y = 0; y < depth_size.height; y++)
+    {
+        for (int x = 0; x < depth_size.width; x++)
+        {
+            const bool inside = x >= depth_roi.x && x < depth_roi.x + depth_roi.width && y >= depth_roi.y && y < depth_roi.y + depth_roi.height;
+            const pointF32 full = full_frame_roi_uvmap[y * depth_size.width + x];
+            const pointF32 expected = inside ? uvmap[y * depth_size.width + x] : sentinel;
+            mismatches += (full.x != expected.x || full.y != expected.y) ? 1 : 0;
+            if (inside)
+            {
+                const pointF32 compact = roi_uvmap[(y - depth_roi.y) * depth_roi.width + x - depth_roi.x];
+                mismatches += (compact.x != expected.x || compact.y != expected.y) ? 1 : 0;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+    std::cout << "uvmap full frame: " << std::chrono::duration_cast<std::chrono::microseconds>(full_time).count() / iterations << " usec, "
+              << "roi: " << std::chrono::duration_cast<std::chrono::microseconds>(roi_time).count() / iterations << " usec" << std::endl;
+
+    //vertices
+    std::vector<point3dF32> vertices(depth.size());
+    std::vector<point3dF32> roi_vertices(depth_roi.width * depth_roi.height);
+    std::vector<point3dF32> full_frame_roi_vertices(depth.size(), sentinel3d);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        ASSERT_EQ(status_no_error, projection.rs_vertices_16u32f_c3r(depth.data(), depth_size, step_src, (float*)vertices.data(),
+                                                                    depth_size.width * sizeof(point3dF32), pspec));
+    full_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        ASSERT_EQ(status_no_error, projection.rs_vertices_16u32f_c3r(depth.data(), depth_size, step_src, (float*)roi_vertices.data(),
+                                                                    depth_roi.width * sizeof(point3dF32), pspec, &depth_roi));
+    roi_time = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(status_no_error, projection.rs_vertices_16u32f_c3r(depth.data(), depth_size, step_src,
+                                                                (float*)(full_frame_roi_vertices.data() + depth_roi.y * depth_size.width + depth_roi.x),
+                                                                depth_size.width * sizeof(point3dF32), pspec, &depth_roi));
+    mismatches = 0;
+    for (int y = 0; y < depth_size.height; y++)
+    {
+        for (int x = 0; x < depth_size.width; x++)
+        {
+            const bool inside = x >= depth_roi.x && x < depth_roi.x + depth_roi.width && y >= depth_roi.y && y < depth_roi.y + depth_roi.height;
+            const point3dF32 full = full_frame_roi_vertices[y * depth_size.width + x];
+            const point3dF32 expected = inside ? vertices[y * depth_size.width + x] : sentinel3d;
+            mismatches += (full.x != expected.x || full.y != expected.y || full.z != expected.z) ? 1 : 0;
+            if (inside)
+            {
+                const point3dF32 compact = roi_vertices[(y - depth_roi.y) * depth_roi.width + x - depth_roi.x];
+                mismatches += (compact.x != expected.x || compact.y != expected.y || compact.z != expected.z) ? 1 : 0;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+    std::cout << "vertices full frame: " << std::chrono::duration_cast<std::chrono::microseconds>(full_time).count() / iterations << " usec, "
+              << "roi: " << std::chrono::duration_cast<std::chrono::microseconds>(roi_time).count() / iterations << " usec" << std::endl;
+
+    //inverse uvmap, the region of interest is in color coordinates
+    const rect uvmap_roi = { 0, 0, depth_size.width, depth_size.height };
+    const pointF32 threshold = { 4.f + (float)color_size.width / depth_size.width, 4.f + (float)color_size.height / depth_size.height };
+    const int uvmap_step = depth_size.width * sizeof(pointF32);
+    std::vector<pointF32> inv_uvmap(color_size.width * color_size.height);
+    std::vector<pointF32> roi_inv_uvmap(color_roi.width * color_roi.height);
+    std::vector<pointF32> full_frame_roi_inv_uvmap(inv_uvmap.size(), sentinel);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        ASSERT_EQ(status_no_error, projection.rs_uvmap_invertor_32f_c2r((float*)uvmap.data(), uvmap_step, depth_size, uvmap_roi, (float*)inv_uvmap.data(),
+                                                                       color_size.width * sizeof(pointF32), color_size, 1, threshold));
+    full_time = std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+        ASSERT_EQ(status_no_error, projection.rs_uvmap_invertor_roi_32f_c2r((float*)uvmap.data(), uvmap_step, depth_size, uvmap_roi, (float*)roi_inv_uvmap.data(),
+                                                                           color_roi.width * sizeof(pointF32), color_size, color_roi, 1, 1, threshold));
+    roi_time = std::chrono::steady_clock::now() - start;
+    ASSERT_EQ(status_no_error, projection.rs_uvmap_invertor_roi_32f_c2r((float*)uvmap.data(), uvmap_step, depth_size, uvmap_roi, (float*)full_frame_roi_inv_uvmap.data(),
+                                                                       color_size.width * sizeof(pointF32), color_size, color_roi, 0, 1, threshold));
+    mismatches = 0;
+    int valid = 0;
+    for (int y = 0; y < color_size.height; y++)
+    {
+        for (int x = 0; x < color_size.width; x++)
+        {
+            const bool inside = x >= color_roi.x && x < color_roi.x + color_roi.width && y >= color_roi.y && y < color_roi.y + color_roi.height;
+            const pointF32 full = full_frame_roi_inv_uvmap[y * color_size.width + x];
+            const pointF32 expected = inside ? inv_uvmap[y * color_size.width + x] : sentinel;
+            mismatches += (full.x != expected.x || full.y != expected.y) ? 1 : 0;
+            if (inside)
+            {
+                const pointF32 compact = roi_inv_uvmap[(y - color_roi.y) * color_roi.width + x - color_roi.x];
+                mismatches += (compact.x != expected.x || compact.y != expected.y) ? 1 : 0;
+                valid += expected.x >= 0 ? 1 : 0;
+            }
+        }
+    }
+    EXPECT_EQ(0, mismatches);
+    EXPECT_GT(valid, 0);
+    std::cout << "inverse uvmap full frame: " << std::chrono::duration_cast<std::chrono::microseconds>(full_time).count() / iterations << " usec, "
+              << "roi: " << std::chrono::duration_cast<std::chrono::microseconds>(roi_time).count() / iterations << " usec" << std::endl;
+
+    //a region of interest outside of the image is rejected
+    const rect outside_roi = { 600, 400, 100, 100 };
+    EXPECT_EQ(status_param_unsupported, projection.rs_vertices_16u32f_c3r(depth.data(), depth_size, step_src, (float*)roi_vertices.data(),
+                                                                         depth_roi.width * sizeof(point3dF32), pspec, &outside_roi));
+}
@@ -0,0 +1,210 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <unistd.h>
+#include <sys/wait.h>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "rs/core/image_interface.h"
+#include "rs/utils/shared_memory_transport_interface.h"
+#include "rs/utils/smart_ptr_helpers.h"
+
+using namespace std;
+using namespace rs::core;
+using namespace rs::utils;
+
+namespace shared_memory_transport_tests_setup
+{
+    static const int32_t width = 320;
+    static const int32_t height = 240;
+    static const uint64_t slot_size = width * height * (sizeof(uint16_t) + 3);
+
+    void release_images(correlated_sample_set & sample_set)
+    {
+        for(int32_t i = 0; i < static_cast<int32_t>(stream_type::max); i++)
+        {
+            if(sample_set.images[i])
+                sample_set.images[i]->release();
+            sample_set.images[i] = nullptr;
+        }
+    }
+}
+
+using namespace shared_memory_transport_tests_setup;
+
+class shared_memory_transport_tests : public testing::Test
+{
+protected:
+    string m_name;
+    vector<uint8_t> m_depth_data;
+    vector<uint8_t> m_color_data;
+    rs::utils::unique_ptr<shared_memory_publisher_interface> m_publisher;
+    rs::utils::unique_ptr<shared_memory_subscriber_interface> m_subscriber;
+
+    virtual void SetUp()
+    {
+        m_name = "rs_shared_memory_transport_tests_" + to_string(getpid());
+        m_depth_data.resize(width * height * sizeof(uint16_t));
+        m_color_data.resize(width * height * 3);
+        for(size_t i = 0; i < m_depth_data.size(); i++)
+            m_depth_data[i] = static_cast<uint8_t>(i % 251);
+        for(size_t i = 0; i < m_color_data.size(); i++)
+            m_color_data[i] = static_cast<uint8_t>(i % 241);
+        m_publisher = get_unique_ptr_with_releaser(shared_memory_publisher_interface::create_instance(m_name.c_str(), 2, slot_size));
+        ASSERT_NE(nullptr, m_publisher);
+        m_subscriber = get_unique_ptr_with_releaser(shared_memory_subscriber_interface::create_instance(m_name.c_str()));
+        ASSERT_NE(nullptr, m_subscriber);
+    }
+
+    status publish(uint64_t frame_number)
+    {
+        image_info depth_info = { width, height, pixel_format::z16, width * static_cast<int32_t>(sizeof(uint16_t)) };
+        image_info color_info = { width, height, pixel_format::rgb8, width * 3 };
+        correlated_sample_set sample_set = {};
+        sample_set[stream_type::depth] = image_interface::create_instance_from_raw_data(&depth_info, { m_depth_data.data(), nullptr }, stream_type::depth,
+                                                                                        image_interface::flag::any, static_cast<double>(frame_number) * 33, frame_number);
+        sample_set[stream_type::color] = image_interface::create_instance_from_raw_data(&color_info, { m_color_data.data(), nullptr }, stream_type::color,
+                                                                                        image_interface::flag::any, static_cast<double>(frame_number) * 33, frame_number);
+        sample_set[motion_type::accel] = { motion_type::accel, static_cast<double>(frame_number) * 33, frame_number, { 0.f, 9.8f, 0.f } };
+        const status sts = m_publisher->publish(sample_set);
+        release_images(sample_set);
+        return sts;
+    }
+};
+
+TEST_F(shared_memory_transport_tests, received_set_matches_the_published_set)
+{
+    ASSERT_EQ(status_no_error, publish(1));
+    correlated_sample_set sample_set = {};
+    ASSERT_EQ(status_no_error, m_subscriber->receive(sample_set, 1000));
+
+    auto depth = sample_set[stream_type::depth];
+    auto color = sample_set[stream_type::color];
+    ASSERT_NE(nullptr, depth);
+    ASSERT_NE(nullptr, color);
+    EXPECT_EQ(nullptr, sample_set[stream_type::infrared]);
+    EXPECT_EQ(pixel_format::z16, depth->query_info().format);
+    EXPECT_EQ(width, color->query_info().width);
+    EXPECT_EQ(1u, depth->query_frame_number());
+    EXPECT_DOUBLE_EQ(33, color->query_time_stamp());
+    //the received images reference the shared memory, not the published data
+    EXPECT_NE(m_depth_data.data(), depth->query_data());
+    EXPECT_EQ(0, memcmp(m_depth_data.data(), depth->query_data(), m_depth_data.size()));
+    EXPECT_EQ(0, memcmp(m_color_data.data(), color->query_data(), m_color_data.size()));
+    EXPECT_EQ(1u, sample_set[motion_type::accel].frame_number);
+    EXPECT_FLOAT_EQ(9.8f, sample_set[motion_type::accel].data[1]);
+    release_images(sample_set);
+}
+
+TEST_F(shared_memory_transport_tests, latest_set_is_received_and_the_others_are_skipped)
+{
+    for(uint64_t frame_number = 1; frame_number <= 3; frame_number++)
+        ASSERT_EQ(status_no_error, publish(frame_number));
+    correlated_sample_set sample_set = {};
+    ASSERT_EQ(status_no_error, m_subscriber->receive(sample_set, 1000));
+    EXPECT_EQ(3u, sample_set[stream_type::depth]->query_frame_number());
+    EXPECT_EQ(2u, m_subscriber->query_skipped_count());
+    release_images(sample_set);
+
+    EXPECT_EQ(status_exec_timeout, m_subscriber->receive(sample_set, 10));
+}
+
+TEST_F(shared_memory_transport_tests, held_slots_are_not_overwritten)
+{
+    ASSERT_EQ(status_no_error, publish(1));
+    correlated_sample_set held_set = {};
+    ASSERT_EQ(status_no_error, m_subscriber->receive(held_set, 1000));
+
+    //one slot is held by the subscriber and the other holds the latest set
+    ASSERT_EQ(status_no_error, publish(2));
+    EXPECT_EQ(status_item_unavailable, publish(3));
+    EXPECT_EQ(1u, m_publisher->query_dropped_count());
+    EXPECT_EQ(1u, held_set[stream_type::depth]->query_frame_number());
+    EXPECT_EQ(0, memcmp(m_depth_data.data(), held_set[stream_type::depth]->query_data(), m_depth_data.size()));
+
+    //the slot is reused once all the images of its set are released
+    held_set[stream_type::depth]->release();
+    held_set[stream_type::depth] = nullptr;
+    EXPECT_EQ(status_item_unavailable, publish(3));
+    release_images(held_set);
+    EXPECT_EQ(status_no_error, publish(3));
+}
+
+TEST_F(shared_memory_transport_tests, slots_held_by_a_terminated_subscriber_are_reclaimed)
+{
+    int ready_pipe[2] = { -1, -1 };
+    ASSERT_EQ(0, pipe(ready_pipe));
+    pid_t child = fork();
+    ASSERT_NE(-1, child);
+    if(child == 0)
+    {
+        //the child attaches, receives the first set and terminates without releasing its images
+        auto subscriber = shared_memory_subscriber_interface::create_instance(m_name.c_str());
+        char ready = subscriber ? 1 : 0;
+        correlated_sample_set held_set = {};
+        bool is_received = write(ready_pipe[1], &ready, 1) == 1 && subscriber && subscriber->receive(held_set, 5000) == status_no_error;
+        _exit(is_received ? 0 : 1);
+    }
+    char ready = 0;
+    ASSERT_EQ(1, read(ready_pipe[0], &ready, 1));
+    close(ready_pipe[0]);
+    close(ready_pipe[1]);
+    ASSERT_EQ(1, ready);
+    ASSERT_EQ(status_no_error, publish(1));
+    int child_status = -1;
+    ASSERT_EQ(child, waitpid(child, &child_status, 0));
+    ASSERT_EQ(0, child_status);
+
+    //the first slot stays held by the terminated subscriber until the publisher finds no other slot
+    ASSERT_EQ(status_no_error, publish(2));
+    EXPECT_EQ(status_no_error, publish(3));
+    EXPECT_EQ(0u, m_publisher->query_dropped_count());
+}
+
+TEST_F(shared_memory_transport_tests, motion_only_set_is_received)
+{
+    correlated_sample_set motion_set = {};
+    motion_set[motion_type::gyro] = { motion_type::gyro, 33, 1, { 0.5f, 0.f, 0.f } };
+    ASSERT_EQ(status_no_error, m_publisher->publish(motion_set));
+    correlated_sample_set sample_set = {};
+    ASSERT_EQ(status_no_error, m_subscriber->receive(sample_set, 1000));
+    EXPECT_EQ(nullptr, sample_set[stream_type::depth]);
+    EXPECT_EQ(1u, sample_set[motion_type::gyro].frame_number);
+    EXPECT_FLOAT_EQ(0.5f, sample_set[motion_type::gyro].data[0]);
+    //a set without images doesn't hold its slot
+    EXPECT_EQ(status_no_error, publish(2));
+    EXPECT_EQ(status_no_error, publish(3));
+}
+
+TEST_F(shared_memory_transport_tests, received_images_outlive_the_publisher)
+{
+    ASSERT_EQ(status_no_error, publish(1));
+    correlated_sample_set sample_set = {};
+    ASSERT_EQ(status_no_error, m_subscriber->receive(sample_set, 1000));
+    m_publisher.reset();
+
+    EXPECT_EQ(status_device_lost, m_subscriber->receive(sample_set, 1000));
+    EXPECT_EQ(0, memcmp(m_color_data.data(), sample_set[stream_type::color]->query_data(), m_color_data.size()));
+    release_images(sample_set);
+    EXPECT_EQ(nullptr, shared_memory_subscriber_interface::create_instance(m_name.c_str()));
+}
+
+TEST_F(shared_memory_transport_tests, invalid_arguments_are_rejected)
+{
+    EXPECT_EQ(nullptr, shared_memory_publisher_interface::create_instance((m_name + "_single_slot").c_str(), 1, slot_size));
+    EXPECT_EQ(nullptr, shared_memory_subscriber_interface::create_instance((m_name + "_missing").c_str()));
+
+    correlated_sample_set empty_set = {};
+    EXPECT_EQ(status_invalid_argument, m_publisher->publish(empty_set));
+
+    vector<uint8_t> large_data(slot_size + 1);
+    image_info info = { static_cast<int32_t>(large_data.size()), 1, pixel_format::y8, static_cast<int32_t>(large_data.size()) };
+    correlated_sample_set large_set = {};
+    large_set[stream_type::infrared] = image_interface::create_instance_from_raw_data(&info, { large_data.data(), nullptr }, stream_type::infrared,
+                                                                                      image_interface::flag::any, 0, 0);
+    EXPECT_EQ(status_invalid_argument, m_publisher->publish(large_set));
+    release_images(large_set);
+}
@@ -0,0 +1,320 @@
+// License: Apache 2.0. See LICENSE file in root directory.
+// Copyright(c) 2016 Intel Corporation. All Rights Reserved.
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <librealsense/rs.hpp>
+#include "gtest/gtest.h"
+#include "rs/synthetic/synthetic_context.h"
+#include "rs/record/record_context.h"
+#include "rs/record/record_device.h"
+#include "rs/playback/playback_context.h"
+#include "rs/playback/playback_device.h"
+
+using namespace std;
+using namespace rs::synthetic;
+
+namespace synthetic_device_tests_setup
+{
+    static const string file_path = "synthetic_device_test.rssdk";
+
+    static const stream_config depth_config = {rs::stream::depth, 320, 240, rs::format::z16, 300, 0, 0};
+    static const stream_config color_config = {rs::stream::color, 640, 480, rs::format::rgb8, 300, 0, 0};
+    static const motion_config no_motion = {0, 0};
+}
+
+using namespace synthetic_device_tests_setup;
+
+GTEST_TEST(synthetic_device_tests, frame_callbacks_follow_the_configured_rate)
+{
+    device_config config = {{depth_config}, no_motion};
+    config.streams[0].jitter_us = 500;
+    context synthetic_context(config);
+    ASSERT_EQ(1, synthetic_context.get_device_count());
+    rs::device * device = synthetic_context.get_device(0);
+    EXPECT_TRUE(device->supports(rs::capabilities::depth));
+    EXPECT_FALSE(device->supports(rs::capabilities::motion_events));
+    EXPECT_THROW(device->enable_stream(rs::stream::color, rs::preset::best_quality), std::runtime_error);
+    EXPECT_THROW(device->enable_stream(rs::stream::depth, 640, 480, rs::format::z16, 300), std::runtime_error);
+
+    std::mutex numbers_lock;
+    std::vector<unsigned long long> numbers;
+    std::vector<double> time_stamps;
+    device->enable_stream(rs::stream::depth, 320, 240, rs::format::z16, 0);
+    device->set_frame_callback(rs::stream::depth, [&](rs::frame frame)
+    {
+        ASSERT_NE(nullptr, frame.get_data());
+        std::lock_guard<std::mutex> lock(numbers_lock);
+        numbers.push_back(frame.get_frame_number());
+        time_stamps.push_back(frame.get_timestamp());
+    });
+    device->start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    device->stop();
+
+    //half a second at 300 fps, with a generous margin for loaded machines
+    ASSERT_LE(100u, numbers.size());
+    EXPECT_GE(160u, numbers.size());
+    for(size_t i = 0; i < numbers.size(); i++)
+    {
+        EXPECT_EQ(i + 1, numbers[i]);
+        const double nominal_time_stamp = (numbers[i] - 1) * 1000.0 / depth_config.framerate;
+        EXPECT_LE(nominal_time_stamp, time_stamps[i]);
+        EXPECT_GE(nominal_time_stamp + 0.5, time_stamps[i]);
+    }
+}
+
+GTEST_TEST(synthetic_device_tests, dropped_frames_leave_gaps_and_are_counted)
+{
+    device_config config = {{depth_config}, no_motion};
+    config.streams[0].drop_interval = 4;
+    context synthetic_context(config);
+    rs::device * device = synthetic_context.get_device(0);
+
+    std::atomic<int> frames_count(0), dropped_numbers_count(0);
+    device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+    device->set_frame_callback(rs::stream::depth, [&](rs::frame frame)
+    {
+        frames_count++;
+        if(frame.get_frame_number() % 4 == 0)
+            dropped_numbers_count++;
+    });
+    device->start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    device->stop();
+
+    EXPECT_LT(0, frames_count.load());
+    EXPECT_EQ(0, dropped_numbers_count.load());
+    const double drops = device->get_option(rs::option::total_frame_drops);
+    EXPECT_LE(frames_count / 3 - 1, drops);
+    EXPECT_GE(frames_count / 3 + 1, drops);
+}
+
+GTEST_TEST(synthetic_device_tests, wait_for_frames_returns_all_the_streams)
+{
+    context synthetic_context({{depth_config, color_config}, no_motion});
+    rs::device * device = synthetic_context.get_device(0);
+    device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+    device->enable_stream(rs::stream::color, rs::preset::best_quality);
+    device->start();
+    unsigned long long last_number = 0;
+    for(int i = 0; i < 30; i++)
+    {
+        device->wait_for_frames();
+        ASSERT_NE(nullptr, device->get_frame_data(rs::stream::depth));
+        ASSERT_NE(nullptr, device->get_frame_data(rs::stream::color));
+        EXPECT_LT(last_number, device->get_frame_number(rs::stream::depth));
+        last_number = device->get_frame_number(rs::stream::depth);
+    }
+    device->stop();
+    EXPECT_FALSE(device->poll_for_frames());
+}
+
+GTEST_TEST(synthetic_device_tests, motion_events_follow_the_configured_rate)
+{
+    context synthetic_context({{depth_config}, {2000, 0}});
+    rs::device * device = synthetic_context.get_device(0);
+    EXPECT_TRUE(device->supports(rs::capabilities::motion_events));
+
+    std::atomic<int> accel_count(0), gyro_count(0), depth_time_stamps_count(0);
+    device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+    device->set_frame_callback(rs::stream::depth, [](rs::frame frame) {});
+    device->enable_motion_tracking([&](rs::motion_data data)
+    {
+        if(data.timestamp_data.source_id == RS_EVENT_IMU_ACCEL) accel_count++;
+        if(data.timestamp_data.source_id == RS_EVENT_IMU_GYRO) gyro_count++;
+    },
+    [&](rs::timestamp_data data)
+    {
+        if(data.source_id == RS_EVENT_IMU_DEPTH_CAM) depth_time_stamps_count++;
+    });
+    device->start(rs::source::all_sources);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    device->stop(rs::source::all_sources);
+
+    //a quarter of a second at 2000 events per second
+    EXPECT_LE(350, accel_count.load());
+    EXPECT_GE(550, accel_count.load());
+    EXPECT_EQ(accel_count.load(), gyro_count.load());
+    EXPECT_LT(0, depth_time_stamps_count.load());
+}
+
+GTEST_TEST(synthetic_device_tests, record_and_playback_a_synthetic_device)
+{
+    const int frames_count = 60;
+    {
+        context synthetic_context({{depth_config, color_config}, no_motion});
+        rs::record::context record_context(file_path.c_str(), synthetic_context);
+        rs::device * device = record_context.get_device(0);
+        device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        device->enable_stream(rs::stream::color, rs::preset::best_quality);
+        device->start();
+        for(int i = 0; i < frames_count; i++)
+        {
+            device->wait_for_frames();
+        }
+        device->stop();
+    }
+
+    {
+        rs::playback::context playback_context(file_path.c_str());
+        ASSERT_EQ(1, playback_context.get_device_count());
+        rs::device * device = playback_context.get_device(0);
+        EXPECT_EQ(depth_config.width, device->get_stream_width(rs::stream::depth));
+        EXPECT_EQ(color_config.framerate, device->get_stream_framerate(rs::stream::color));
+        device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        device->enable_stream(rs::stream::color, rs::preset::best_quality);
+        device->start();
+        device->wait_for_frames();
+        EXPECT_NE(nullptr, device->get_frame_data(rs::stream::depth));
+        device->stop();
+    }
+    ::remove(file_path.c_str());
+}
+
+GTEST_TEST(synthetic_device_tests, record_and_playback_two_synthetic_devices_in_one_file)
+{
+    const stream_config second_depth_config = {rs::stream::depth, 480, 270, rs::format::z16, 300, 0, 0};
+    {
+        context synthetic_context(vector<device_config>{{{depth_config, color_config}, no_motion}, {{second_depth_config}, no_motion}});
+        rs::record::context record_context(file_path.c_str(), synthetic_context);
+        ASSERT_EQ(2, record_context.get_device_count());
+        rs::device * first = record_context.get_device(0);
+        rs::device * second = record_context.get_device(1);
+        first->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        first->enable_stream(rs::stream::color, rs::preset::best_quality);
+        second->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        first->set_frame_callback(rs::stream::depth, [](rs::frame frame) {});
+        first->set_frame_callback(rs::stream::color, [](rs::frame frame) {});
+        second->set_frame_callback(rs::stream::depth, [](rs::frame frame) {});
+        first->start();
+        second->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        first->stop();
+        second->stop();
+    }
+
+    {
+        rs::playback::context playback_context(file_path.c_str());
+        ASSERT_EQ(2, playback_context.get_device_count());
+        rs::playback::device * first = playback_context.get_playback_device(0);
+        rs::playback::device * second = playback_context.get_playback_device(1);
+        EXPECT_EQ(depth_config.width, first->get_stream_width(rs::stream::depth));
+        EXPECT_EQ(color_config.width, first->get_stream_width(rs::stream::color));
+        EXPECT_EQ(second_depth_config.width, second->get_stream_width(rs::stream::depth));
+        EXPECT_TRUE(first->supports(rs::capabilities::color));
+        EXPECT_FALSE(second->supports(rs::capabilities::color));
+        EXPECT_LT(0, first->get_frame_count(rs::stream::depth));
+        EXPECT_LT(0, second->get_frame_count(rs::stream::depth));
+
+        //both devices are played by the same reader, each receives only the frames of its own streams
+        std::atomic<int> first_frames(0), second_frames(0), wrong_frames(0);
+        first->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        second->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        first->set_frame_callback(rs::stream::depth, [&](rs::frame frame)
+        {
+            first_frames++;
+            if(frame.get_width() != depth_config.width) wrong_frames++;
+        });
+        second->set_frame_callback(rs::stream::depth, [&](rs::frame frame)
+        {
+            second_frames++;
+            if(frame.get_width() != second_depth_config.width) wrong_frames++;
+        });
+        first->start();
+        second->start();
+        for(int i = 0; i < 100 && (first_frames == 0 || second_frames == 0); i++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        first->stop();
+        second->stop();
+        EXPECT_LT(0, first_frames.load());
+        EXPECT_LT(0, second_frames.load());
+        EXPECT_EQ(0, wrong_frames.load());
+    }
+    ::remove(file_path.c_str());
+}
+
+GTEST_TEST(synthetic_device_tests, record_with_frame_decimation_and_recorded_frame_rate)
+{
+    std::atomic<int> depth_frames(0), color_frames(0);
+    {
+        context synthetic_context({{depth_config, color_config}, no_motion});
+        rs::record::context record_context(file_path.c_str(), synthetic_context);
+        rs::record::device * device = record_context.get_record_device(0);
+        EXPECT_EQ(rs::core::status_invalid_argument, device->set_frame_decimation(rs::stream::depth, 0));
+        EXPECT_EQ(rs::core::status_invalid_argument, device->set_recorded_frame_rate(rs::stream::color, -1));
+        EXPECT_EQ(rs::core::status_no_error, device->set_frame_decimation(rs::stream::depth, 3));
+        EXPECT_EQ(rs::core::status_no_error, device->set_recorded_frame_rate(rs::stream::color, color_config.framerate / 6.0));
+        device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        device->enable_stream(rs::stream::color, rs::preset::best_quality);
+        device->set_frame_callback(rs::stream::depth, [&](rs::frame frame) { depth_frames++; });
+        device->set_frame_callback(rs::stream::color, [&](rs::frame frame) { color_frames++; });
+        device->start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        EXPECT_EQ(rs::core::status_invalid_state, device->set_frame_decimation(rs::stream::depth, 2));
+        device->stop();
+    }
+
+    {
+        //the application receives all the frames, the file holds only the recorded share of them
+        rs::playback::context playback_context(file_path.c_str());
+        rs::playback::device * device = playback_context.get_playback_device();
+        EXPECT_EQ(depth_config.framerate, device->get_stream_framerate(rs::stream::depth));
+        EXPECT_NEAR((depth_frames.load() + 2) / 3, device->get_frame_count(rs::stream::depth), 1);
+        EXPECT_NEAR(color_frames.load() / 6.0, device->get_frame_count(rs::stream::color), color_frames.load() / 60.0 + 1);
+    }
+    ::remove(file_path.c_str());
+}
+
+GTEST_TEST(synthetic_device_tests, record_and_playback_a_region_of_interest)
+{
+    const rs::core::rect roi = {64, 32, 128, 96};
+    rs_intrinsics camera_intrinsics = {};
+    {
+        context synthetic_context({{depth_config, color_config}, no_motion});
+        rs::record::context record_context(file_path.c_str(), synthetic_context);
+        rs::record::device * device = record_context.get_record_device(0);
+        const rs::core::rect negative_roi = {-1, 0, 10, 10};
+        EXPECT_EQ(rs::core::status_invalid_argument, device->set_region_of_interest(rs::stream::depth, negative_roi));
+        EXPECT_EQ(rs::core::status_no_error, device->set_region_of_interest(rs::stream::depth, roi));
+        device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        device->enable_stream(rs::stream::color, rs::preset::best_quality);
+        camera_intrinsics = device->get_stream_intrinsics(rs::stream::depth);
+        device->start();
+        for(int i = 0; i < 30; i++)
+            device->wait_for_frames();
+        device->stop();
+    }
+
+    {
+        rs::playback::context playback_context(file_path.c_str());
+        rs::playback::device * device = playback_context.get_playback_device();
+        auto recorded_roi = device->get_region_of_interest(rs::stream::depth);
+        EXPECT_EQ(roi.x, recorded_roi.x);
+        EXPECT_EQ(roi.y, recorded_roi.y);
+        EXPECT_EQ(roi.width, recorded_roi.width);
+        EXPECT_EQ(roi.height, recorded_roi.height);
+        EXPECT_EQ(0, device->get_region_of_interest(rs::stream::color).width);
+        EXPECT_EQ(roi.width, device->get_stream_width(rs::stream::depth));
+        EXPECT_EQ(roi.height, device->get_stream_height(rs::stream::depth));
+        EXPECT_EQ(color_config.width, device->get_stream_width(rs::stream::color));
+
+        //the intrinsics of the region keep the projection of the camera pixels
+        auto intrinsics = device->get_stream_intrinsics(rs::stream::depth);
+        EXPECT_FLOAT_EQ(camera_intrinsics.ppx - roi.x, intrinsics.ppx);
+        EXPECT_FLOAT_EQ(camera_intrinsics.ppy - roi.y, intrinsics.ppy);
+        EXPECT_FLOAT_EQ(camera_intrinsics.fx, intrinsics.fx);
+
+        device->enable_stream(rs::stream::depth, rs::preset::best_quality);
+        device->start();
+        device->wait_for_frames();
+        EXPECT_NE(nullptr, device->get_frame_data(rs::stream::depth));
+        device->stop();
+    }
+    ::remove(file_path.c_str());
+}